@@ -16,6 +16,7 @@
 #include "BackendConnectionInterface.h"
 #include "PartialReadCounter.h"
 
+#include <climits>
 #include <iostream>
 
 #include <boost/optional/optional_io.hpp>
@@ -239,22 +240,12 @@ try
                                                         p.first,
                                                         insist_on_latest);
 
-            for (const auto& s : p.second)
-            {
-                const size_t res = sio.pread(s.buf,
-                                             s.size,
-                                             s.offset);
-                if(res != s.size)
-                {
-                    LOG_ERROR(ns << "/" << p.first <<
-                              ": read less (" << res <<
-                              ") than expected (" << s.size << ") from offset " <<
-                              s.offset);
-                    throw BackendRestoreException();
-                }
-
-                ++prc.slow;
-            }
+            read_slices(ns,
+                        p.first,
+                        sio,
+                        p.second);
+
+            prc.slow += p.second.size();
         }
     }
 
@@ -265,6 +256,66 @@ CATCH_STD_ALL_EWHAT({
         throw; // redundant
     })
 
+void
+BackendConnectionInterface::read_slices(const Namespace& ns,
+                                        const std::string& object_name,
+                                        youtils::FileDescriptor& fd,
+                                        const ObjectSlices& slices)
+{
+    std::vector<struct iovec> iov;
+    iov.reserve(std::min<size_t>(slices.size(),
+                                 IOV_MAX));
+
+    uint64_t off = 0;
+    size_t size = 0;
+
+    auto flush([&]
+               {
+                   if (not iov.empty())
+                   {
+                       const size_t res = fd.preadv(iov.data(),
+                                                    iov.size(),
+                                                    off);
+                       if (res != size)
+                       {
+                           LOG_ERROR(ns << "/" << object_name <<
+                                     ": read less (" << res <<
+                                     ") than expected (" << size << ") from offset " <<
+                                     off);
+                           throw BackendRestoreException();
+                       }
+
+                       iov.clear();
+                       size = 0;
+                   }
+               });
+
+    for (const auto& s : slices)
+    {
+        if (iov.empty() or
+            off + size != s.offset or
+            iov.size() == IOV_MAX)
+        {
+            flush();
+            off = s.offset;
+        }
+
+        if (not iov.empty() and
+            static_cast<uint8_t*>(iov.back().iov_base) + iov.back().iov_len == s.buf)
+        {
+            iov.back().iov_len += s.size;
+        }
+        else
+        {
+            iov.push_back({ s.buf, s.size });
+        }
+
+        size += s.size;
+    }
+
+    flush();
+}
+
 void
 BackendConnectionInterface::write(const Namespace& nspace,
                                   const boost::filesystem::path& location,
@@ -277,6 +328,126 @@ BackendConnectionInterface::write(const Namespace& nspace,
     return write_(nspace, location, name, overwrite, chksum, cond);
 }
 
+void
+BackendConnectionInterface::write_buffer(const Namespace& nspace,
+                                         const void* buf,
+                                         size_t size,
+                                         const std::string& name,
+                                         const OverwriteObject overwrite,
+                                         const youtils::CheckSum* chksum,
+                                         const boost::shared_ptr<Condition>& cond)
+{
+    Logger l(__FUNCTION__, nspace, name);
+    return write_buffer_(nspace, buf, size, name, overwrite, chksum, cond);
+}
+
+void
+BackendConnectionInterface::write_buffer_(const Namespace& nspace,
+                                          const void* buf,
+                                          size_t size,
+                                          const std::string& name,
+                                          const OverwriteObject overwrite,
+                                          const youtils::CheckSum* chksum,
+                                          const boost::shared_ptr<Condition>& cond)
+{
+    const fs::path p(yt::FileUtils::create_temp_file_in_temp_dir(name));
+    ALWAYS_CLEANUP_FILE(p);
+
+    {
+        yt::FileDescriptor fd(p,
+                              yt::FDMode::Write,
+                              CreateIfNecessary::F,
+                              SyncOnCloseAndDestructor::F);
+        fd.write(buf, size);
+    }
+
+    write_(nspace, p, name, overwrite, chksum, cond);
+}
+
+std::string
+BackendConnectionInterface::begin_multipart_upload(const Namespace& nspace,
+                                                   const std::string& name,
+                                                   const OverwriteObject overwrite)
+{
+    Logger l(__FUNCTION__, nspace, name);
+    return begin_multipart_upload_(nspace, name, overwrite);
+}
+
+std::string
+BackendConnectionInterface::upload_part(const Namespace& nspace,
+                                        const std::string& name,
+                                        const std::string& upload_id,
+                                        uint32_t part,
+                                        const void* buf,
+                                        size_t size)
+{
+    Logger l(__FUNCTION__, nspace, name);
+    return upload_part_(nspace, name, upload_id, part, buf, size);
+}
+
+void
+BackendConnectionInterface::complete_multipart_upload(const Namespace& nspace,
+                                                      const std::string& name,
+                                                      const std::string& upload_id,
+                                                      const std::vector<std::string>& parts,
+                                                      const OverwriteObject overwrite,
+                                                      const boost::shared_ptr<Condition>& cond)
+{
+    Logger l(__FUNCTION__, nspace, name);
+    return complete_multipart_upload_(nspace, name, upload_id, parts, overwrite, cond);
+}
+
+void
+BackendConnectionInterface::abort_multipart_upload(const Namespace& nspace,
+                                                   const std::string& name,
+                                                   const std::string& upload_id)
+{
+    Logger l(__FUNCTION__, nspace, name);
+    return abort_multipart_upload_(nspace, name, upload_id);
+}
+
+std::string
+BackendConnectionInterface::begin_multipart_upload_(const Namespace& nspace,
+                                                    const std::string& name,
+                                                    const OverwriteObject)
+{
+    LOG_ERROR(nspace << "/" << name << ": multipart uploads are not supported by this backend");
+    throw BackendNotImplementedException();
+}
+
+std::string
+BackendConnectionInterface::upload_part_(const Namespace& nspace,
+                                         const std::string& name,
+                                         const std::string&,
+                                         uint32_t,
+                                         const void*,
+                                         size_t)
+{
+    LOG_ERROR(nspace << "/" << name << ": multipart uploads are not supported by this backend");
+    throw BackendNotImplementedException();
+}
+
+void
+BackendConnectionInterface::complete_multipart_upload_(const Namespace& nspace,
+                                                       const std::string& name,
+                                                       const std::string&,
+                                                       const std::vector<std::string>&,
+                                                       const OverwriteObject,
+                                                       const boost::shared_ptr<Condition>&)
+{
+    LOG_ERROR(nspace << "/" << name << ": multipart uploads are not supported by this backend");
+    throw BackendNotImplementedException();
+}
+
+void
+BackendConnectionInterface::abort_multipart_upload_(const Namespace& nspace,
+                                                    const std::string& name,
+                                                    const std::string&)
+{
+    LOG_ERROR(nspace << "/" << name << ": multipart uploads are not supported by this backend");
+    throw BackendNotImplementedException();
+}
+
 std::unique_ptr<yt::UniqueObjectTag>
 BackendConnectionInterface::write_tag(const Namespace& nspace,
                                       const fs::path& src,
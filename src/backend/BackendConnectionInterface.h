@@ -22,6 +22,8 @@
 #include "Namespace.h"
 
 #include <iosfwd>
+#include <limits>
+#include <vector>
 
 #include <boost/date_time/posix_time/posix_time_types.hpp>
 #include <boost/filesystem.hpp>
@@ -164,6 +166,68 @@ protected:
           const youtils::CheckSum* = nullptr,
           const boost::shared_ptr<Condition>& = nullptr);
 
+    // Upload an object straight from memory. If a checksum is passed it is
+    // verified against the buffer before the object is put in place.
+    void
+    write_buffer(const Namespace&,
+                 const void* buf,
+                 size_t size,
+                 const std::string&,
+                 const OverwriteObject = OverwriteObject::F,
+                 const youtils::CheckSum* = nullptr,
+                 const boost::shared_ptr<Condition>& = nullptr);
+
+    // Multipart uploads: the parts of an object are uploaded (and retried)
+    // independently, possibly over different connections. The object only
+    // becomes visible once complete_multipart_upload succeeds. Parts are
+    // numbered from 0, upload_part returns a token that identifies the part
+    // to complete_multipart_upload.
+    bool
+    multipart_upload_supported() const
+    {
+        return multipart_upload_supported_();
+    }
+
+    // Minimum size of all but the last part.
+    uint64_t
+    multipart_upload_min_part_size() const
+    {
+        return multipart_upload_min_part_size_();
+    }
+
+    uint32_t
+    multipart_upload_max_parts() const
+    {
+        return multipart_upload_max_parts_();
+    }
+
+    std::string
+    begin_multipart_upload(const Namespace&,
+                           const std::string& name,
+                           const OverwriteObject = OverwriteObject::F);
+
+    std::string
+    upload_part(const Namespace&,
+                const std::string& name,
+                const std::string& upload_id,
+                uint32_t part,
+                const void* buf,
+                size_t size);
+
+    // The condition (if any) is checked when the object is put in place.
+    void
+    complete_multipart_upload(const Namespace&,
+                              const std::string& name,
+                              const std::string& upload_id,
+                              const std::vector<std::string>& parts,
+                              const OverwriteObject = OverwriteObject::F,
+                              const boost::shared_ptr<Condition>& = nullptr);
+
+    void
+    abort_multipart_upload(const Namespace&,
+                           const std::string& name,
+                           const std::string& upload_id);
+
     std::unique_ptr<youtils::UniqueObjectTag>
     write_tag(const Namespace&,
               const boost::filesystem::path&,
@@ -234,6 +298,15 @@ public:
                   InsistOnLatestVersion,
                   PartialReadCounter&) = 0;
 
+    // Reads the slices of an object from a local file, issuing a single
+    // preadv for each run of slices that are adjacent in the object.
+    // Throws BackendRestoreException on short reads.
+    static void
+    read_slices(const Namespace&,
+                const std::string& object_name,
+                youtils::FileDescriptor&,
+                const ObjectSlices&);
+
     virtual void
     write_(const Namespace&,
            const boost::filesystem::path&,
@@ -242,6 +315,62 @@ public:
            const youtils::CheckSum* = nullptr,
            const boost::shared_ptr<Condition>& = nullptr) = 0;
 
+    // Connections that cannot upload from memory make do with this default,
+    // which spills the buffer to a temporary file and hands that to write_.
+    virtual void
+    write_buffer_(const Namespace&,
+                  const void* buf,
+                  size_t size,
+                  const std::string&,
+                  const OverwriteObject = OverwriteObject::F,
+                  const youtils::CheckSum* = nullptr,
+                  const boost::shared_ptr<Condition>& = nullptr);
+
+    // The multipart upload defaults throw BackendNotImplementedException.
+    virtual bool
+    multipart_upload_supported_() const
+    {
+        return false;
+    }
+
+    virtual uint64_t
+    multipart_upload_min_part_size_() const
+    {
+        return 0;
+    }
+
+    virtual uint32_t
+    multipart_upload_max_parts_() const
+    {
+        return std::numeric_limits<uint32_t>::max();
+    }
+
+    virtual std::string
+    begin_multipart_upload_(const Namespace&,
+                            const std::string& name,
+                            const OverwriteObject);
+
+    virtual std::string
+    upload_part_(const Namespace&,
+                 const std::string& name,
+                 const std::string& upload_id,
+                 uint32_t part,
+                 const void* buf,
+                 size_t size);
+
+    virtual void
+    complete_multipart_upload_(const Namespace&,
+                               const std::string& name,
+                               const std::string& upload_id,
+                               const std::vector<std::string>& parts,
+                               const OverwriteObject,
+                               const boost::shared_ptr<Condition>&);
+
+    virtual void
+    abort_multipart_upload_(const Namespace&,
+                            const std::string& name,
+                            const std::string& upload_id);
+
     virtual std::unique_ptr<youtils::UniqueObjectTag>
     write_tag_(const Namespace&,
                const boost::filesystem::path&,
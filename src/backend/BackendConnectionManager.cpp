@@ -27,6 +27,7 @@
 
 #include <numeric>
 
+#include <boost/asio/io_service.hpp>
 #include <boost/iostreams/stream.hpp>
 #include <boost/thread/thread.hpp>
 
@@ -78,6 +79,62 @@ BackendConnectionManager::BackendConnectionManager(const bpt::ptree& pt,
     THROW_WHEN(connection_pools_.empty());
 }
 
+class BackendConnectionManager::UploadPool
+{
+public:
+    explicit UploadPool(size_t nthreads)
+        : work_(std::make_unique<boost::asio::io_service::work>(io_service_))
+    {
+        for (size_t i = 0; i < nthreads; ++i)
+        {
+            threads_.create_thread([this]
+                                   {
+                                       io_service_.run();
+                                   });
+        }
+    }
+
+    ~UploadPool()
+    {
+        work_.reset();
+        threads_.join_all();
+    }
+
+    UploadPool(const UploadPool&) = delete;
+
+    UploadPool&
+    operator=(const UploadPool&) = delete;
+
+    void
+    post(std::function<void()> job)
+    {
+        io_service_.post(std::move(job));
+    }
+
+private:
+    boost::asio::io_service io_service_;
+    std::unique_ptr<boost::asio::io_service::work> work_;
+    boost::thread_group threads_;
+};
+
+BackendConnectionManager::~BackendConnectionManager() = default;
+
+void
+BackendConnectionManager::post_upload_job(std::function<void()> job)
+{
+    std::call_once(upload_pool_once_,
+                   [&]
+                   {
+                       const size_t n =
+                           std::max<size_t>(1,
+                                            multipart_upload_parallelism());
+                       LOG_INFO("starting " << n << " multipart upload threads");
+                       upload_pool_ = std::make_unique<UploadPool>(n);
+                   });
+
+    upload_pool_->post(std::move(job));
+}
+
 BackendConnectionManagerPtr
 BackendConnectionManager::create(const boost::property_tree::ptree& pt,
                                  const RegisterComponent registrate,
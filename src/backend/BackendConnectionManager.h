@@ -22,6 +22,10 @@
 #include "ConnectionManagerParameters.h"
 #include "Namespace.h"
 
+#include <functional>
+#include <memory>
+#include <mutex>
+
 #include <boost/chrono.hpp>
 #include <boost/optional.hpp>
 
@@ -67,7 +71,7 @@ public:
            const RegisterComponent = RegisterComponent::T,
            const EnableConnectionHooks = EnableConnectionHooks::F);
 
-    ~BackendConnectionManager() = default;
+    ~BackendConnectionManager();
 
     BackendConnectionManager(const BackendConnectionManager&) = delete;
 
@@ -154,6 +158,23 @@ public:
         return params_.backend_interface_partial_read_nullio.value();
     }
 
+    uint64_t
+    multipart_upload_part_size() const
+    {
+        return params_.backend_interface_multipart_upload_part_size.value();
+    }
+
+    uint32_t
+    multipart_upload_parallelism() const
+    {
+        return params_.backend_interface_multipart_upload_parallelism.value();
+    }
+
+    // Runs the parts of multipart uploads on threads shared by all
+    // BackendInterfaces. These are only started on first use.
+    void
+    post_upload_job(std::function<void()>);
+
     // REVISIT (pun intended): I don't like offering this - it might
     // be better to move the code that uses this (cf. BackendInterface)
     // into a method of this class?
@@ -172,6 +193,10 @@ private:
 
     ConnectionManagerParameters params_;
     ConnectionPools connection_pools_;
+
+    class UploadPool;
+    std::once_flag upload_pool_once_;
+    std::unique_ptr<UploadPool> upload_pool_;
     std::unique_ptr<BackendConfig> config_;
     std::atomic<uint64_t> next_pool_;
 
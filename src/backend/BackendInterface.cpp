@@ -23,9 +23,12 @@
 #include "PartialReadCounter.h"
 #include "RoundRobinPoolSelector.h"
 
+#include <exception>
+
 #include <boost/chrono.hpp>
 #include <boost/thread.hpp>
 
+#include <youtils/FileDescriptor.h>
 #include <youtils/ScopeExit.h>
 
 namespace backend
@@ -337,14 +340,288 @@ BackendInterface::write(const fs::path& src,
                             std::uncaught_exception());
              }));
 
+    boost::system::error_code ec;
+    const uint64_t size = fs::file_size(src, ec);
+    const uint64_t part_size = ec ? 0 : multipart_upload_part_size_(size);
+
+    if (part_size != 0)
+    {
+        write_multipart_(src,
+                         size,
+                         name,
+                         overwrite,
+                         chksum,
+                         cond,
+                         part_size,
+                         params);
+    }
+    else
+    {
+        wrap_<void,
+              decltype(src),
+              decltype(name),
+              OverwriteObject,
+              decltype(chksum),
+              decltype(cond)>(params,
+                              &BackendConnectionInterface::write,
+                              src,
+                              name,
+                              overwrite,
+                              chksum,
+                              cond);
+    }
+}
+
+// The configured part size is adjusted to the limits of the backend (e.g. S3:
+// at least 5 MiB per part and no more than 10000 parts).
+uint64_t
+BackendInterface::multipart_upload_part_size_(const uint64_t size)
+{
+    uint64_t part_size = conn_manager_->multipart_upload_part_size();
+    if (part_size == 0 or size <= part_size)
+    {
+        return 0;
+    }
+
+    BackendConnectionInterfacePtr
+        conn(conn_manager_->getConnection(ForceNewConnection::F,
+                                          nspace_));
+    if (not conn->multipart_upload_supported())
+    {
+        return 0;
+    }
+
+    const uint64_t min_part_size = conn->multipart_upload_min_part_size();
+    if (part_size < min_part_size)
+    {
+        LOG_DEBUG(nspace_ << ": configured part size " << part_size <<
+                  " is below the backend's minimum, using " << min_part_size);
+        part_size = min_part_size;
+    }
+
+    const uint64_t max_parts = conn->multipart_upload_max_parts();
+    VERIFY(max_parts > 0);
+
+    if ((size + part_size - 1) / part_size > max_parts)
+    {
+        part_size = (size + max_parts - 1) / max_parts;
+        LOG_DEBUG(nspace_ << ": " << size << " bytes exceed the backend's limit of " <<
+                  max_parts << " parts, using a part size of " << part_size);
+    }
+
+    return size > part_size ? part_size : 0;
+}
+
+// src is read sequentially (verifying the checksum on the way) into part sized
+// buffers which are uploaded concurrently by the connection manager's upload
+// threads, each with its own retries. The object is only committed (subject to
+// the condition, if any) once all parts made it and the checksum matched.
+void
+BackendInterface::write_multipart_(const fs::path& src,
+                                   uint64_t size,
+                                   const std::string& name,
+                                   const OverwriteObject overwrite,
+                                   const yt::CheckSum* chksum,
+                                   const boost::shared_ptr<Condition>& cond,
+                                   uint64_t part_size,
+                                   const BackendRequestParameters& params)
+{
+    const std::string
+        upload_id(wrap_<std::string,
+                        decltype(name),
+                        OverwriteObject>(params,
+                                         &BackendConnectionInterface::begin_multipart_upload,
+                                         name,
+                                         overwrite));
+
+    const size_t nparts = (size + part_size - 1) / part_size;
+    const size_t parallelism =
+        std::max<size_t>(1, conn_manager_->multipart_upload_parallelism());
+
+    LOG_DEBUG(nspace_ << ": uploading " << src << " (" << size << " bytes) as " <<
+              name << " in " << nparts << " parts, upload ID " << upload_id);
+
+    struct Uploads
+    {
+        boost::mutex lock;
+        boost::condition_variable cond;
+        // protected by lock
+        size_t in_flight = 0;
+        std::exception_ptr eptr;
+    };
+
+    auto uploads(std::make_shared<Uploads>());
+
+    // the outstanding parts refer to this stack frame, so all exit paths
+    // have to wait for them
+    auto wait_for_uploads([&](size_t max_in_flight) -> std::exception_ptr
+        {
+            boost::unique_lock<boost::mutex> u(uploads->lock);
+            uploads->cond.wait(u,
+                               [&]
+                               {
+                                   return uploads->in_flight <= max_in_flight;
+                               });
+            return uploads->eptr;
+        });
+
+    std::vector<std::string> parts(nparts);
+
+    try
+    {
+        yt::FileDescriptor fd(src,
+                              yt::FDMode::Read);
+        yt::CheckSum cs;
+
+        for (size_t i = 0; i < nparts; ++i)
+        {
+            std::exception_ptr eptr(wait_for_uploads(parallelism - 1));
+            if (eptr)
+            {
+                std::rethrow_exception(eptr);
+            }
+
+            const uint64_t off = i * part_size;
+            auto buf(std::make_shared<std::vector<uint8_t>>(std::min(part_size,
+                                                                     size - off)));
+            const size_t r = fd.pread(buf->data(),
+                                      buf->size(),
+                                      off);
+            if (r != buf->size())
+            {
+                LOG_ERROR(nspace_ << ": short read from " << src << " at offset " <<
+                          off << ": got " << r << ", expected " << buf->size());
+                throw BackendInputException();
+            }
+
+            cs.update(buf->data(),
+                      buf->size());
+
+            {
+                boost::lock_guard<boost::mutex> g(uploads->lock);
+                ++uploads->in_flight;
+            }
+
+            conn_manager_->post_upload_job([this, uploads, buf, i, &parts, &name, &upload_id, &params]
+            {
+                try
+                {
+                    const uint32_t part = i;
+                    const void* data = buf->data();
+                    const size_t len = buf->size();
+
+                    parts[i] =
+                        wrap_<std::string,
+                              decltype(name),
+                              const std::string&,
+                              uint32_t,
+                              const void*,
+                              size_t>(params,
+                                      &BackendConnectionInterface::upload_part,
+                                      name,
+                                      upload_id,
+                                      part,
+                                      data,
+                                      len);
+                }
+                catch (...)
+                {
+                    boost::lock_guard<boost::mutex> g(uploads->lock);
+                    if (not uploads->eptr)
+                    {
+                        uploads->eptr = std::current_exception();
+                    }
+                }
+
+                {
+                    boost::lock_guard<boost::mutex> g(uploads->lock);
+                    --uploads->in_flight;
+                }
+
+                uploads->cond.notify_all();
+            });
+        }
+
+        std::exception_ptr eptr(wait_for_uploads(0));
+        if (eptr)
+        {
+            std::rethrow_exception(eptr);
+        }
+
+        if (chksum and cs != *chksum)
+        {
+            LOG_FATAL(nspace_ << ": " << src << ": checksum mismatch: expected " <<
+                      *chksum << ", calculated " << cs);
+            throw BackendInputException();
+        }
+
+        wrap_<void,
+              decltype(name),
+              const std::string&,
+              const std::vector<std::string>&,
+              OverwriteObject,
+              decltype(cond)>(params,
+                              &BackendConnectionInterface::complete_multipart_upload,
+                              name,
+                              upload_id,
+                              parts,
+                              overwrite,
+                              cond);
+    }
+    catch (...)
+    {
+        wait_for_uploads(0);
+
+        try
+        {
+            wrap_<void,
+                  decltype(name),
+                  const std::string&>(params,
+                                       &BackendConnectionInterface::abort_multipart_upload,
+                                       name,
+                                       upload_id);
+        }
+        CATCH_STD_ALL_LOG_IGNORE(nspace_ << ": failed to abort multipart upload " <<
+                                 upload_id << " of " << name);
+        throw;
+    }
+}
+
+void
+BackendInterface::write_buffer(const void* buf,
+                               size_t size,
+                               const std::string& name,
+                               const OverwriteObject overwrite,
+                               const yt::CheckSum* chksum,
+                               const boost::shared_ptr<Condition>& cond,
+                               const BackendRequestParameters& params)
+{
+    tracepoint(openvstorage_backend,
+               backend_interface_put_object_start,
+               nspace_.str().c_str(),
+               name.c_str(),
+               "",
+               overwrite == OverwriteObject::T);
+
+    auto exit(yt::make_scope_exit([&]
+             {
+                 tracepoint(openvstorage_backend,
+                            backend_interface_put_object_end,
+                            nspace_.str().c_str(),
+                            name.c_str(),
+                            std::uncaught_exception());
+             }));
+
     wrap_<void,
-          decltype(src),
+          decltype(buf),
+          decltype(size),
           decltype(name),
           OverwriteObject,
           decltype(chksum),
           decltype(cond)>(params,
-                          &BackendConnectionInterface::write,
-                          src,
+                          &BackendConnectionInterface::write_buffer,
+                          buf,
+                          size,
                           name,
                           overwrite,
                           chksum,
@@ -21,6 +21,7 @@
 #include "Condition.h"
 #include "SwitchConnectionPoolPolicy.h"
 
+#include <atomic>
 #include <functional>
 
 #include <boost/date_time/posix_time/posix_time_types.hpp>
@@ -75,6 +76,16 @@ public:
           const boost::shared_ptr<Condition>& = nullptr,
           const BackendRequestParameters& = default_request_parameters());
 
+    // The buffer must stay valid until the call returns (retries included).
+    void
+    write_buffer(const void* buf,
+                 size_t size,
+                 const std::string& name,
+                 const OverwriteObject = OverwriteObject::F,
+                 const youtils::CheckSum* chksum = 0,
+                 const boost::shared_ptr<Condition>& = nullptr,
+                 const BackendRequestParameters& = default_request_parameters());
+
     std::unique_ptr<youtils::UniqueObjectTag>
     write_tag(const boost::filesystem::path&,
               const std::string&,
@@ -309,7 +320,8 @@ private:
 
     const Namespace nspace_;
     BackendConnectionManagerPtr conn_manager_;
-    uint64_t retry_counter_;
+    // bumped concurrently by the parts of a multipart upload
+    std::atomic<uint64_t> retry_counter_;
 
     // only the BackendConnectionManager is allowed to create it - everyone else needs to
     // use BackendInterfacePtrs obtained from the BackendConnectionManager.
@@ -341,6 +353,20 @@ private:
              ReturnType(BackendConnectionInterface::*mem_fun)(Args...),
              Args... args);
 
+    // 0 if an object of this size is not to be uploaded in parts.
+    uint64_t
+    multipart_upload_part_size_(uint64_t size);
+
+    void
+    write_multipart_(const boost::filesystem::path& src,
+                     uint64_t size,
+                     const std::string& name,
+                     const OverwriteObject,
+                     const youtils::CheckSum*,
+                     const boost::shared_ptr<Condition>&,
+                     uint64_t part_size,
+                     const BackendRequestParameters&);
+
     template<typename R>
     R
     handle_eventual_consistency_(InsistOnLatestVersion insist_on_latest,
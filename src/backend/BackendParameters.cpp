@@ -212,6 +212,20 @@ DEFINE_INITIALIZED_PARAM_WITH_DEFAULT(backend_interface_switch_connection_pool_o
                                       be::SwitchConnectionPoolOnErrorPolicy::OnBackendError bitor
                                       be::SwitchConnectionPoolOnErrorPolicy::OnTimeout);
 
+DEFINE_INITIALIZED_PARAM_WITH_DEFAULT(backend_interface_multipart_upload_part_size,
+                                      backend_connection_manager_name,
+                                      "backend_interface_multipart_upload_part_size",
+                                      "objects larger than this (in bytes) are uploaded in parts if the backend supports it (raised to the backend's minimum part size, e.g. 5 MiB for S3, if necessary), 0 disables multipart uploads",
+                                      ShowDocumentation::T,
+                                      0ULL);
+
+DEFINE_INITIALIZED_PARAM_WITH_DEFAULT(backend_interface_multipart_upload_parallelism,
+                                      backend_connection_manager_name,
+                                      "backend_interface_multipart_upload_parallelism",
+                                      "number of parts of a multipart upload that are uploaded concurrently",
+                                      ShowDocumentation::T,
+                                      4U);
+
 DEFINE_INITIALIZED_PARAM_WITH_DEFAULT(backend_type,
                                       backend_connection_manager_name,
                                       "backend_type",
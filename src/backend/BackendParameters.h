@@ -84,6 +84,11 @@ DECLARE_RESETTABLE_INITIALIZED_PARAM_WITH_DEFAULT(backend_interface_switch_conne
 DECLARE_RESETTABLE_INITIALIZED_PARAM_WITH_DEFAULT(backend_interface_switch_connection_pool_on_error_policy,
                                                   std::atomic<uint32_t>);
 
+DECLARE_RESETTABLE_INITIALIZED_PARAM_WITH_DEFAULT(backend_interface_multipart_upload_part_size,
+                                                  std::atomic<uint64_t>);
+DECLARE_RESETTABLE_INITIALIZED_PARAM_WITH_DEFAULT(backend_interface_multipart_upload_parallelism,
+                                                  std::atomic<uint32_t>);
+
 DECLARE_INITIALIZED_PARAM_WITH_DEFAULT(backend_type, backend::BackendType);
 DECLARE_INITIALIZED_PARAM(local_connection_path, std::string);
 DECLARE_INITIALIZED_PARAM_WITH_DEFAULT(local_connection_tv_sec, int);
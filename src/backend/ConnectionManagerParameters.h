@@ -38,6 +38,8 @@ struct ConnectionManagerParameters
         , backend_interface_switch_connection_pool_policy(pt)
         , backend_interface_switch_connection_pool_partial_read_policy(pt)
         , backend_interface_switch_connection_pool_on_error_policy(pt)
+        , backend_interface_multipart_upload_part_size(pt)
+        , backend_interface_multipart_upload_parallelism(pt)
     {}
 
     ~ConnectionManagerParameters() = default;
@@ -60,6 +62,8 @@ struct ConnectionManagerParameters
         backend_interface_switch_connection_pool_policy.update(pt, rep);
         backend_interface_switch_connection_pool_partial_read_policy.update(pt, rep);
         backend_interface_switch_connection_pool_on_error_policy.update(pt, rep);
+        backend_interface_multipart_upload_part_size.update(pt, rep);
+        backend_interface_multipart_upload_parallelism.update(pt, rep);
     }
 
     void
@@ -75,6 +79,8 @@ struct ConnectionManagerParameters
         backend_interface_switch_connection_pool_policy.persist(pt, rep);
         backend_interface_switch_connection_pool_partial_read_policy.persist(pt, rep);
         backend_interface_switch_connection_pool_on_error_policy.persist(pt, rep);
+        backend_interface_multipart_upload_part_size.persist(pt, rep);
+        backend_interface_multipart_upload_parallelism.persist(pt, rep);
     }
 
     DECLARE_PARAMETER(backend_connection_pool_capacity);
@@ -86,6 +92,8 @@ struct ConnectionManagerParameters
     DECLARE_PARAMETER(backend_interface_switch_connection_pool_policy);
     DECLARE_PARAMETER(backend_interface_switch_connection_pool_partial_read_policy);
     DECLARE_PARAMETER(backend_interface_switch_connection_pool_on_error_policy);
+    DECLARE_PARAMETER(backend_interface_multipart_upload_part_size);
+    DECLARE_PARAMETER(backend_interface_multipart_upload_parallelism);
 };
 
 }
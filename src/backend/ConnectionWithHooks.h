@@ -44,6 +44,11 @@ enum Operation
     Remove,
     GetSize,
     GetCheckSum,
+    WriteBuffer,
+    BeginMultipartUpload,
+    UploadPart,
+    CompleteMultipartUpload,
+    AbortMultipartUpload,
 };
 
 template<typename... Args>
@@ -146,6 +151,99 @@ public:
                                 cond);
     }
 
+    void
+    write_buffer_(const Namespace& nspace,
+                  const void* buf,
+                  size_t size,
+                  const std::string& name,
+                  const OverwriteObject overwrite,
+                  const youtils::CheckSum* chksum = nullptr,
+                  const boost::shared_ptr<Condition>& cond = nullptr) final
+    {
+        wrap_<Operation::WriteBuffer>(&BackendConnectionInterface::write_buffer_,
+                                      nspace,
+                                      buf,
+                                      size,
+                                      name,
+                                      overwrite,
+                                      chksum,
+                                      cond);
+    }
+
+    bool
+    multipart_upload_supported_() const final
+    {
+        return inner_->multipart_upload_supported();
+    }
+
+    uint64_t
+    multipart_upload_min_part_size_() const final
+    {
+        return inner_->multipart_upload_min_part_size();
+    }
+
+    uint32_t
+    multipart_upload_max_parts_() const final
+    {
+        return inner_->multipart_upload_max_parts();
+    }
+
+    std::string
+    begin_multipart_upload_(const Namespace& nspace,
+                            const std::string& name,
+                            const OverwriteObject overwrite) final
+    {
+        return wrap_<Operation::BeginMultipartUpload>(&BackendConnectionInterface::begin_multipart_upload_,
+                                                      nspace,
+                                                      name,
+                                                      overwrite);
+    }
+
+    std::string
+    upload_part_(const Namespace& nspace,
+                 const std::string& name,
+                 const std::string& upload_id,
+                 uint32_t part,
+                 const void* buf,
+                 size_t size) final
+    {
+        return wrap_<Operation::UploadPart>(&BackendConnectionInterface::upload_part_,
+                                            nspace,
+                                            name,
+                                            upload_id,
+                                            part,
+                                            buf,
+                                            size);
+    }
+
+    void
+    complete_multipart_upload_(const Namespace& nspace,
+                               const std::string& name,
+                               const std::string& upload_id,
+                               const std::vector<std::string>& parts,
+                               const OverwriteObject overwrite,
+                               const boost::shared_ptr<Condition>& cond) final
+    {
+        wrap_<Operation::CompleteMultipartUpload>(&BackendConnectionInterface::complete_multipart_upload_,
+                                                  nspace,
+                                                  name,
+                                                  upload_id,
+                                                  parts,
+                                                  overwrite,
+                                                  cond);
+    }
+
+    void
+    abort_multipart_upload_(const Namespace& nspace,
+                            const std::string& name,
+                            const std::string& upload_id) final
+    {
+        wrap_<Operation::AbortMultipartUpload>(&BackendConnectionInterface::abort_multipart_upload_,
+                                               nspace,
+                                               name,
+                                               upload_id);
+    }
+
     std::unique_ptr<youtils::UniqueObjectTag>
     write_tag_(const Namespace& nspace,
                const boost::filesystem::path& src,
@@ -336,6 +434,41 @@ private:
                           const youtils::CheckSum*,
                           const boost::shared_ptr<Condition>&>;
 
+    using WriteBufferKey = boost::mpl::int_<Operation::WriteBuffer>;
+    using WriteBufferVal = Hook<const Namespace&,
+                                const void*,
+                                size_t,
+                                const std::string&,
+                                const OverwriteObject,
+                                const youtils::CheckSum*,
+                                const boost::shared_ptr<Condition>&>;
+
+    using BeginMultipartUploadKey = boost::mpl::int_<Operation::BeginMultipartUpload>;
+    using BeginMultipartUploadVal = Hook<const Namespace&,
+                                         const std::string&,
+                                         const OverwriteObject>;
+
+    using UploadPartKey = boost::mpl::int_<Operation::UploadPart>;
+    using UploadPartVal = Hook<const Namespace&,
+                               const std::string&,
+                               const std::string&,
+                               uint32_t,
+                               const void*,
+                               size_t>;
+
+    using CompleteMultipartUploadKey = boost::mpl::int_<Operation::CompleteMultipartUpload>;
+    using CompleteMultipartUploadVal = Hook<const Namespace&,
+                                            const std::string&,
+                                            const std::string&,
+                                            const std::vector<std::string>&,
+                                            const OverwriteObject,
+                                            const boost::shared_ptr<Condition>&>;
+
+    using AbortMultipartUploadKey = boost::mpl::int_<Operation::AbortMultipartUpload>;
+    using AbortMultipartUploadVal = Hook<const Namespace&,
+                                         const std::string&,
+                                         const std::string&>;
+
     using PartialReadKey = boost::mpl::int_<Operation::PartialRead>;
     using PartialReadVal = Hook<const Namespace&,
                                 const BackendConnectionInterface::PartialReads&,
@@ -386,6 +519,7 @@ private:
         boost::mpl::pair<ListNamespacesKey, ListNamespacesVal>,
         boost::mpl::pair<GetTagKey, GetTagVal>,
         boost::mpl::pair<WriteKey, WriteVal>,
+        boost::mpl::pair<WriteBufferKey, WriteBufferVal>,
         boost::mpl::pair<ReadKey, ReadVal>,
         boost::mpl::pair<ReadTagKey, ReadTagVal>,
         boost::mpl::pair<WriteTagKey, WriteTagVal>,
@@ -393,7 +527,11 @@ private:
         boost::mpl::pair<RemoveKey, RemoveVal>,
         boost::mpl::pair<GetSizeKey, GetSizeVal>,
         boost::mpl::pair<GetCheckSumKey, GetCheckSumVal>,
-        boost::mpl::pair<PartialReadKey, PartialReadVal>
+        boost::mpl::pair<PartialReadKey, PartialReadVal>,
+        boost::mpl::pair<BeginMultipartUploadKey, BeginMultipartUploadVal>,
+        boost::mpl::pair<UploadPartKey, UploadPartVal>,
+        boost::mpl::pair<CompleteMultipartUploadKey, CompleteMultipartUploadVal>,
+        boost::mpl::pair<AbortMultipartUploadKey, AbortMultipartUploadVal>
         >;
 
     template<Operation op,
@@ -17,12 +17,14 @@
 #include "PartialReadCounter.h"
 
 #include <boost/filesystem/fstream.hpp>
+#include <boost/lexical_cast.hpp>
 
 #include <youtils/Assert.h>
 #include <youtils/CheckSum.h>
 #include <youtils/FileUtils.h>
 #include <youtils/FileDescriptor.h>
 #include <youtils/ObjectDigest.h>
+#include <youtils/UUID.h>
 
 namespace backend
 {
@@ -188,12 +190,37 @@ Connection::write_(const Namespace& nspace,
 
     LOG_DEBUG("src path " << src << " name " << name);
 
+    LOCK_BACKEND();
+
+    copy_(nspace,
+          src,
+          name,
+          overwrite,
+          cond ? &cond->object_name() : nullptr,
+          cond ? &cond->object_tag() : nullptr,
+          chksum);
+}
+
+void
+Connection::write_buffer_(const Namespace& nspace,
+                          const void* buf,
+                          size_t size,
+                          const std::string& name,
+                          const OverwriteObject overwrite,
+                          const yt::CheckSum* chksum,
+                          const boost::shared_ptr<Condition>& cond)
+{
+    nanosleep(&timespec_,0);
+
+    LOG_DEBUG("buffer of " << size << " bytes, name " << name);
+
     if (chksum != 0)
     {
-        yt::CheckSum calc(youtils::FileUtils::calculate_checksum(src));
+        yt::CheckSum calc;
+        calc.update(buf, size);
         if (calc != *chksum)
         {
-            LOG_FATAL(src << ": checksum mismatch: expected " << *chksum <<
+            LOG_FATAL(name << ": checksum mismatch: expected " << *chksum <<
                       ", calculated " << calc);
 
             throw BackendInputException();
@@ -202,12 +229,164 @@ Connection::write_(const Namespace& nspace,
 
     LOCK_BACKEND();
 
-    copy_(nspace,
-          src,
-          name,
-          overwrite,
-          cond ? &cond->object_name() : nullptr,
-          cond ? &cond->object_tag() : nullptr);
+    store_(nspace,
+           name,
+           overwrite,
+           cond ? &cond->object_name() : nullptr,
+           cond ? &cond->object_tag() : nullptr,
+           [&](const fs::path& dst)
+           {
+               yt::FileUtils::safe_write(buf,
+                                         size,
+                                         dst,
+                                         yt::SyncFileBeforeRename(sync_object_after_write_));
+           });
+}
+
+fs::path
+Connection::multipart_path_(const std::string& upload_id)
+{
+    return yt::FileUtils::temp_path("local_backend_multipart") / upload_id;
+}
+
+fs::path
+Connection::part_path_(const std::string& upload_id,
+                       uint32_t part)
+{
+    return multipart_path_(upload_id) / ("part-" + boost::lexical_cast<std::string>(part));
+}
+
+std::string
+Connection::begin_multipart_upload_(const Namespace& nspace,
+                                    const std::string& name,
+                                    const OverwriteObject overwrite)
+{
+    nanosleep(&timespec_,0);
+
+    checkedNamespacePath_(nspace);
+
+    if (F(overwrite) and objectExists_(nspace,
+                                       name))
+    {
+        LOG_ERROR(nspace << "/" << name << ": object already exists");
+        throw BackendAssertionFailedException();
+    }
+
+    const std::string upload_id(yt::UUID().str());
+    fs::create_directories(multipart_path_(upload_id));
+
+    LOG_DEBUG(nspace << "/" << name << ": started multipart upload " << upload_id);
+    return upload_id;
+}
+
+// The token of a part is its checksum which is verified again when
+// assembling the object.
+std::string
+Connection::upload_part_(const Namespace& nspace,
+                         const std::string& name,
+                         const std::string& upload_id,
+                         uint32_t part,
+                         const void* buf,
+                         size_t size)
+{
+    nanosleep(&timespec_,0);
+
+    if (not fs::exists(multipart_path_(upload_id)))
+    {
+        LOG_ERROR(nspace << "/" << name << ": no such multipart upload " << upload_id);
+        throw BackendStoreException();
+    }
+
+    yt::FileUtils::safe_write(buf,
+                              size,
+                              part_path_(upload_id,
+                                         part),
+                              yt::SyncFileBeforeRename::F);
+
+    yt::CheckSum cs;
+    cs.update(buf, size);
+
+    return boost::lexical_cast<std::string>(cs.getValue());
+}
+
+void
+Connection::complete_multipart_upload_(const Namespace& nspace,
+                                       const std::string& name,
+                                       const std::string& upload_id,
+                                       const std::vector<std::string>& parts,
+                                       const OverwriteObject overwrite,
+                                       const boost::shared_ptr<Condition>& cond)
+{
+    nanosleep(&timespec_,0);
+
+    LOCK_BACKEND();
+
+    store_(nspace,
+           name,
+           overwrite,
+           cond ? &cond->object_name() : nullptr,
+           cond ? &cond->object_tag() : nullptr,
+           [&](const fs::path& dst)
+           {
+               const fs::path tmp(yt::FileUtils::create_temp_file(dst));
+               ALWAYS_CLEANUP_FILE(tmp);
+
+               {
+                   yt::FileDescriptor out(tmp,
+                                          yt::FDMode::Write,
+                                          CreateIfNecessary::F,
+                                          SyncOnCloseAndDestructor::F);
+                   std::vector<uint8_t> buf(1ULL << 20);
+
+                   for (size_t i = 0; i < parts.size(); ++i)
+                   {
+                       yt::FileDescriptor in(part_path_(upload_id,
+                                                        i),
+                                             yt::FDMode::Read);
+                       yt::CheckSum cs;
+
+                       while (true)
+                       {
+                           const size_t ret = in.read(buf.data(), buf.size());
+                           if (ret == 0)
+                           {
+                               break;
+                           }
+                           cs.update(buf.data(), ret);
+                           out.write(buf.data(), ret);
+                       }
+
+                       if (boost::lexical_cast<std::string>(cs.getValue()) != parts[i])
+                       {
+                           LOG_ERROR(nspace << "/" << name << ": part " << i <<
+                                     " of multipart upload " << upload_id <<
+                                     " has checksum " << cs << ", expected " << parts[i]);
+                           throw BackendStoreException();
+                       }
+                   }
+
+                   if (T(sync_object_after_write_))
+                   {
+                       out.sync();
+                   }
+               }
+
+               fs::rename(tmp,
+                          dst);
+           });
+
+    fs::remove_all(multipart_path_(upload_id));
+    LOG_DEBUG(nspace << "/" << name << ": completed multipart upload " << upload_id <<
+              " (" << parts.size() << " parts)");
+}
+
+void
+Connection::abort_multipart_upload_(const Namespace& nspace,
+                                    const std::string& name,
+                                    const std::string& upload_id)
+{
+    LOG_INFO(nspace << "/" << name << ": aborting multipart upload " << upload_id);
+    fs::remove_all(multipart_path_(upload_id));
 }
 
 void
@@ -243,7 +422,60 @@ Connection::copy_(const Namespace& nspace,
                   const std::string& name,
                   const OverwriteObject overwrite,
                   const std::string* tag_name,
-                  const yt::UniqueObjectTag* prev_tag)
+                  const yt::UniqueObjectTag* prev_tag,
+                  const yt::CheckSum* chksum)
+{
+    try
+    {
+        store_(nspace,
+               name,
+               overwrite,
+               tag_name,
+               prev_tag,
+               [&](const fs::path& dst)
+               {
+                   LOG_DEBUG("copying " << src << " -> " << dst);
+
+                   const auto sync = yt::SyncFileBeforeRename(sync_object_after_write_);
+
+                   // the checksum is verified while copying to save
+                   // another pass over src
+                   if (chksum)
+                   {
+                       youtils::FileUtils::safe_copy(src,
+                                                     dst,
+                                                     *chksum,
+                                                     sync);
+                   }
+                   else
+                   {
+                       youtils::FileUtils::safe_copy(src,
+                                                     dst,
+                                                     sync);
+                   }
+
+                   LOG_DEBUG("copied " << src << " -> " << dst);
+               });
+    }
+    catch (youtils::FileUtils::CopyCheckSumMismatchException&)
+    {
+        LOG_FATAL(src << ": checksum mismatch, expected " << *chksum);
+        throw BackendInputException();
+    }
+    catch (youtils::FileUtils::CopyNoSourceException& e)
+    {
+        LOG_ERROR("Source does not exist " << src);
+        throw BackendInputException();
+    }
+}
+
+void
+Connection::store_(const Namespace& nspace,
+                   const std::string& name,
+                   const OverwriteObject overwrite,
+                   const std::string* tag_name,
+                   const yt::UniqueObjectTag* prev_tag,
+                   const std::function<void(const fs::path&)>& fun)
 {
     verify_tag_(nspace,
                 tag_name,
@@ -259,25 +491,24 @@ Connection::copy_(const Namespace& nspace,
     }
     try
     {
-        LOG_DEBUG("copying " << src << " -> " << dst);
-        youtils::FileUtils::safe_copy(src,
-                                      dst,
-                                      youtils::SyncFileBeforeRename(sync_object_after_write_));
+        fun(dst);
+
         if(pre_exists)
         {
             lruCache().erase_no_evict(dst);
         }
-
-        LOG_DEBUG("copied " << src << " -> " << dst);
     }
-    catch (youtils::FileUtils::CopyNoSourceException& e)
+    catch (youtils::FileUtils::CopyCheckSumMismatchException&)
     {
-        LOG_ERROR("Source does not exist " << src);
-        throw BackendInputException();
+        throw;
+    }
+    catch (youtils::FileUtils::CopyNoSourceException&)
+    {
+        throw;
     }
     catch (std::exception& e)
     {
-        LOG_ERROR("Failed to copy " << src << " -> " << dst << ": " << e.what());
+        LOG_ERROR("Failed to store " << dst << ": " << e.what());
         throw BackendStoreException();
     }
 }
@@ -402,24 +633,20 @@ Connection::partial_read_(const Namespace& ns,
 {
     if (enable_partial_read_ == EnablePartialRead::T)
     {
+        nanosleep(&timespec_,0);
+
         for(const auto& partial_read : partial_reads)
         {
             auto sio = lruCache().find(objectPath_(ns,
                                                    partial_read.first),
                                        OpenASCO);
 
-            for (const auto& slice : partial_read.second)
-            {
-                size_t res = sio->pread(slice.buf,
-                                        slice.size,
-                                        slice.offset);
-                if(res != slice.size)
-                {
-                    throw BackendRestoreException();
-                }
-
-                ++prc.fast;
-            }
+            read_slices(ns,
+                        partial_read.first,
+                        *sio,
+                        partial_read.second);
+
+            prc.fast += partial_read.second.size();
         }
 
         return true;
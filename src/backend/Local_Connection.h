@@ -20,6 +20,8 @@
 #include "BackendException.h"
 #include "LocalConfig.h"
 
+#include <functional>
+
 #include <boost/interprocess/sync/named_mutex.hpp>
 #include <boost/thread/mutex.hpp>
 
@@ -108,6 +110,47 @@ public:
            const youtils::CheckSum* = nullptr,
            const boost::shared_ptr<Condition>& = nullptr) override final;
 
+    virtual void
+    write_buffer_(const Namespace&,
+                  const void* buf,
+                  size_t size,
+                  const std::string&,
+                  const OverwriteObject,
+                  const youtils::CheckSum* = nullptr,
+                  const boost::shared_ptr<Condition>& = nullptr) override final;
+
+    virtual bool
+    multipart_upload_supported_() const override final
+    {
+        return true;
+    }
+
+    virtual std::string
+    begin_multipart_upload_(const Namespace&,
+                            const std::string& name,
+                            const OverwriteObject) override final;
+
+    virtual std::string
+    upload_part_(const Namespace&,
+                 const std::string& name,
+                 const std::string& upload_id,
+                 uint32_t part,
+                 const void* buf,
+                 size_t size) override final;
+
+    virtual void
+    complete_multipart_upload_(const Namespace&,
+                               const std::string& name,
+                               const std::string& upload_id,
+                               const std::vector<std::string>& parts,
+                               const OverwriteObject,
+                               const boost::shared_ptr<Condition>&) override final;
+
+    virtual void
+    abort_multipart_upload_(const Namespace&,
+                            const std::string& name,
+                            const std::string& upload_id) override final;
+
     virtual std::unique_ptr<youtils::UniqueObjectTag>
     write_tag_(const Namespace&,
                const boost::filesystem::path&,
@@ -202,7 +245,27 @@ protected:
           const std::string& obj_name,
           const OverwriteObject,
           const std::string* tag_name,
-          const youtils::UniqueObjectTag* prev_tag);
+          const youtils::UniqueObjectTag* prev_tag,
+          const youtils::CheckSum* chksum = nullptr);
+
+    // Parts of multipart uploads are staged in a directory per upload
+    // outside of the namespace until the upload is completed.
+    static boost::filesystem::path
+    multipart_path_(const std::string& upload_id);
+
+    static boost::filesystem::path
+    part_path_(const std::string& upload_id,
+               uint32_t part);
+
+    // Checks the preconditions of a write and has fun store the object at
+    // the path passed to it.
+    void
+    store_(const Namespace&,
+           const std::string& obj_name,
+           const OverwriteObject,
+           const std::string* tag_name,
+           const youtils::UniqueObjectTag* prev_tag,
+           const std::function<void(const boost::filesystem::path&)>& fun);
 };
 
 }
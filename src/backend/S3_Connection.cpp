@@ -16,6 +16,9 @@
 #include "S3_Connection.h"
 #include "BackendException.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include <boost/chrono.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/lexical_cast.hpp>
@@ -701,6 +704,107 @@ struct ObjectWriteCallback
     ws::MD5Digest digest_;
 };
 
+// Uploads from memory: MD5 and CRC are calculated in a single pass over the
+// buffer - chunk by chunk so the CRC is computed while the data is still in
+// the CPU cache - and the upload is served straight from it.
+struct BufferWriteCallback
+    : public WsPutRequestUploader
+{
+    BufferWriteCallback(const void* buf,
+                        size_t size,
+                        const std::string& name,
+                        const yt::CheckSum* cs)
+        : buf_(static_cast<const uint8_t*>(buf))
+        , size_(size)
+        , pos_(0)
+    {
+        LOG_TRACE(name << ": " << size << " bytes");
+
+        static const size_t chunk_size = 32 * 1024;
+
+        yt::CheckSum crc;
+        MD5_CTX md5_context;
+        MD5_Init(&md5_context);
+
+        for (size_t off = 0; off < size_; off += chunk_size)
+        {
+            const size_t len = std::min(chunk_size,
+                                        size_ - off);
+
+            MD5_Update(&md5_context,
+                       buf_ + off,
+                       len);
+
+            if (cs)
+            {
+                crc.update(buf_ + off,
+                           len);
+            }
+        }
+
+        MD5_Final(digest_.data(),
+                  &md5_context);
+
+        if (cs and *cs != crc)
+        {
+            LOG_ERROR(name << ": checksum mismatch - expected " << *cs <<
+                      ", got " << crc);
+            throw BackendInputException();
+        }
+    }
+
+    virtual ~BufferWriteCallback() = default;
+
+    size_t
+    onUpload(void* chunkBuf, size_t chunkSize) override final
+    {
+        const size_t n = std::min(chunkSize,
+                                  size_ - pos_);
+        memcpy(chunkBuf,
+               buf_ + pos_,
+               n);
+        pos_ += n;
+
+        return n;
+    }
+
+    ws::WsPutRequestUploader::SeekResult
+    onSeek(off_t off, ws::WsPutRequestUploader::SeekWhence whence) override final
+    {
+        off_t base = 0;
+
+        switch (whence)
+        {
+        case ws::WsPutRequestUploader::SeekWhence::Set:
+            break;
+        case ws::WsPutRequestUploader::SeekWhence::Cur:
+            base = pos_;
+            break;
+        case ws::WsPutRequestUploader::SeekWhence::End:
+            base = size_;
+            break;
+        }
+
+        const off_t pos = base + off;
+        if (pos < 0 or static_cast<size_t>(pos) > size_)
+        {
+            LOG_ERROR("failed to seek to off " << off << " (whence: " <<
+                      static_cast<int>(whence) << ")");
+            return ws::WsPutRequestUploader::SeekResult::Fail;
+        }
+
+        pos_ = pos;
+        return ws::WsPutRequestUploader::SeekResult::Ok;
+    }
+
+    DECLARE_LOGGER("BufferWriteCallback");
+
+    const uint8_t* const buf_;
+    const size_t size_;
+    size_t pos_;
+    ws::MD5Digest digest_;
+};
+
 PRAGMA_IGNORE_WARNING_END;
 
 }
@@ -747,6 +851,170 @@ Connection::write_(const Namespace& nspace,
 }
 
 
+void
+Connection::write_buffer_(const Namespace& nspace,
+                          const void* buf,
+                          size_t size,
+                          const std::string& name,
+                          const OverwriteObject overwrite_object,
+                          const yt::CheckSum* cs,
+                          const boost::shared_ptr<Condition>& cond)
+{
+    if (cond)
+    {
+        LOG_ERROR("conditional write support is not available yet for S3 backend");
+        throw BackendNotImplementedException();
+    }
+
+    if(F(overwrite_object) and objectExists_(nspace,
+                                             name))
+    {
+        LOG_ERROR("object " << name << " already exists on the backend " << nspace <<
+                  " and you didn't ask overwrite ");
+        throw BackendAssertionFailedException();
+    }
+
+    BufferWriteCallback cb(buf, size, name, cs);
+
+    try
+    {
+        ws_connection_->put(nspace.c_str(),
+                            name.c_str(),
+                            &cb,
+                            size,
+                            &cb.digest_);
+    }
+    catch(WsException& e)
+    {
+        LOG_ERROR("PUT failed " << e.what());
+        throw BackendStoreException();
+    }
+}
+
+// S3 part numbers start at 1, ours at 0. The ETag of a part is the token
+// handed back to complete_multipart_upload_.
+std::string
+Connection::begin_multipart_upload_(const Namespace& nspace,
+                                    const std::string& name,
+                                    const OverwriteObject overwrite_object)
+{
+    if(F(overwrite_object) and objectExists_(nspace,
+                                             name))
+    {
+        LOG_ERROR("object " << name << " already exists on the backend " << nspace <<
+                  " and you didn't ask overwrite ");
+        throw BackendAssertionFailedException();
+    }
+
+    try
+    {
+        WsInitiateMultipartUploadResponse rsp;
+        ws_connection_->initiateMultipartUpload(nspace.c_str(),
+                                                name.c_str(),
+                                                nullptr, // content type
+                                                false, // make public
+                                                false, // server side encryption
+                                                &rsp);
+        return rsp.uploadId;
+    }
+    catch(WsException& e)
+    {
+        LOG_ERROR("initiating multipart upload of " << name << " failed: " << e.what());
+        throw BackendStoreException();
+    }
+}
+
+std::string
+Connection::upload_part_(const Namespace& nspace,
+                         const std::string& name,
+                         const std::string& upload_id,
+                         uint32_t part,
+                         const void* buf,
+                         size_t size)
+{
+    try
+    {
+        WsPutResponse rsp;
+        ws_connection_->putPart(nspace.c_str(),
+                                name.c_str(),
+                                upload_id.c_str(),
+                                part + 1,
+                                buf,
+                                size,
+                                &rsp);
+        return rsp.etag;
+    }
+    catch(WsException& e)
+    {
+        LOG_ERROR("uploading part " << part << " of " << name << " (upload ID " <<
+                  upload_id << ") failed: " << e.what());
+        throw BackendStoreException();
+    }
+}
+
+void
+Connection::complete_multipart_upload_(const Namespace& nspace,
+                                       const std::string& name,
+                                       const std::string& upload_id,
+                                       const std::vector<std::string>& parts,
+                                       const OverwriteObject overwrite_object,
+                                       const boost::shared_ptr<Condition>& cond)
+{
+    if (cond)
+    {
+        LOG_ERROR("conditional write support is not available yet for S3 backend");
+        throw BackendNotImplementedException();
+    }
+
+    if(F(overwrite_object) and objectExists_(nspace,
+                                             name))
+    {
+        LOG_ERROR("object " << name << " already exists on the backend " << nspace <<
+                  " and you didn't ask overwrite ");
+        throw BackendAssertionFailedException();
+    }
+
+    std::vector<WsPutResponse> rsps(parts.size());
+    for (size_t i = 0; i < parts.size(); ++i)
+    {
+        rsps[i].etag = parts[i];
+    }
+
+    try
+    {
+        ws_connection_->completeMultipartUpload(nspace.c_str(),
+                                                name.c_str(),
+                                                upload_id.c_str(),
+                                                rsps.data(),
+                                                rsps.size());
+    }
+    catch(WsException& e)
+    {
+        LOG_ERROR("completing multipart upload of " << name << " (upload ID " <<
+                  upload_id << ") failed: " << e.what());
+        throw BackendStoreException();
+    }
+}
+
+void
+Connection::abort_multipart_upload_(const Namespace& nspace,
+                                    const std::string& name,
+                                    const std::string& upload_id)
+{
+    try
+    {
+        ws_connection_->abortMultipartUpload(nspace.c_str(),
+                                             name.c_str(),
+                                             upload_id.c_str());
+    }
+    catch(WsException& e)
+    {
+        LOG_ERROR("aborting multipart upload of " << name << " (upload ID " <<
+                  upload_id << ") failed: " << e.what());
+        throw BackendStoreException();
+    }
+}
+
 std::unique_ptr<yt::UniqueObjectTag>
 Connection::get_tag_(const Namespace&,
                      const std::string&)
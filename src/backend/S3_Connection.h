@@ -128,6 +128,61 @@ private
            const youtils::CheckSum* = nullptr,
            const boost::shared_ptr<Condition>& = nullptr) override final;
 
+    virtual void
+    write_buffer_(const Namespace&,
+                  const void* buf,
+                  size_t size,
+                  const std::string&,
+                  OverwriteObject,
+                  const youtils::CheckSum* = nullptr,
+                  const boost::shared_ptr<Condition>& = nullptr) override final;
+
+    virtual bool
+    multipart_upload_supported_() const override final
+    {
+        return true;
+    }
+
+    // S3 rejects parts (but the last one) smaller than 5 MiB and uploads
+    // consisting of more than 10000 parts.
+    virtual uint64_t
+    multipart_upload_min_part_size_() const override final
+    {
+        return 5ULL << 20;
+    }
+
+    virtual uint32_t
+    multipart_upload_max_parts_() const override final
+    {
+        return 10000;
+    }
+
+    virtual std::string
+    begin_multipart_upload_(const Namespace&,
+                            const std::string& name,
+                            const OverwriteObject) override final;
+
+    virtual std::string
+    upload_part_(const Namespace&,
+                 const std::string& name,
+                 const std::string& upload_id,
+                 uint32_t part,
+                 const void* buf,
+                 size_t size) override final;
+
+    virtual void
+    complete_multipart_upload_(const Namespace&,
+                               const std::string& name,
+                               const std::string& upload_id,
+                               const std::vector<std::string>& parts,
+                               const OverwriteObject,
+                               const boost::shared_ptr<Condition>&) override final;
+
+    virtual void
+    abort_multipart_upload_(const Namespace&,
+                            const std::string& name,
+                            const std::string& upload_id) override final;
+
     virtual std::unique_ptr<youtils::UniqueObjectTag>
     write_tag_(const Namespace&,
                const boost::filesystem::path&,
@@ -17,6 +17,8 @@
 #include "../BackendRequestParameters.h"
 #include "../ConnectionWithHooks.h"
 
+#include <atomic>
+
 #include <boost/filesystem.hpp>
 #include <boost/make_shared.hpp>
 #include <boost/property_tree/ptree.hpp>
@@ -270,6 +272,146 @@ TEST_F(BackendInterfaceTest, conditional_operations)
     EXPECT_FALSE(bi->objectExists(oname));
 }
 
+TEST_F(BackendInterfaceTest, multipart_upload)
+{
+    const uint64_t part_size = 64ULL << 10;
+    const uint64_t fsize = 10 * part_size + 4096;
+
+    const std::string oname("some-object");
+    const fs::path opath(path_ / oname);
+    const yt::CheckSum cs(createTestFile(opath,
+                                         fsize,
+                                         "some pattern"));
+
+    {
+        bpt::ptree pt;
+        cm_->persist(pt);
+        ip::PARAMETER_TYPE(backend_interface_multipart_upload_part_size)(part_size).persist(pt);
+        ip::PARAMETER_TYPE(backend_interface_multipart_upload_parallelism)(3).persist(pt);
+        ip::PARAMETER_TYPE(backend_interface_retry_interval_secs)(0).persist(pt);
+
+        yt::ConfigurationReport crep;
+        ASSERT_TRUE(cm_->checkConfig(pt,
+                                     crep));
+        yt::UpdateReport urep;
+        cm_->update(pt,
+                    urep);
+    }
+
+    std::unique_ptr<BackendTestSetup::WithRandomNamespace>
+        nspace(make_random_namespace());
+    BackendInterfacePtr bi(cm_->newBackendInterface(nspace->ns()));
+
+    const bool multipart = cm_->getConnection()->multipart_upload_supported();
+
+    yt::CheckSum wrong_cs(1);
+    ASSERT_NE(wrong_cs,
+              cs);
+
+    ASSERT_THROW(bi->write(opath,
+                           oname,
+                           OverwriteObject::F,
+                           &wrong_cs),
+                 BackendInputException);
+
+    ASSERT_FALSE(bi->objectExists(oname));
+
+    // a failing part is retried on its own
+    std::atomic<uint32_t> failures(0);
+    auto h(ConnectionWithHooks::add_hook<Operation::UploadPart>([&](const Namespace&,
+                                                                    const std::string&,
+                                                                    const std::string&,
+                                                                    uint32_t part,
+                                                                    const void*,
+                                                                    size_t)
+        {
+            if (part == 3 and failures++ == 0)
+            {
+                throw BackendConnectFailureException();
+            }
+        }));
+
+    const uint64_t retries = bi->retry_counter();
+
+    bi->write(opath,
+              oname,
+              OverwriteObject::F,
+              &cs);
+
+    if (multipart)
+    {
+        EXPECT_EQ(2U,
+                  failures.load());
+        EXPECT_EQ(retries + 1,
+                  bi->retry_counter());
+    }
+
+    EXPECT_EQ(fsize,
+              bi->getSize(oname));
+
+    EXPECT_THROW(bi->write(opath,
+                           oname,
+                           OverwriteObject::F,
+                           &cs),
+                 BackendAssertionFailedException);
+
+    const fs::path r(path_ / "r");
+    bi->read(r,
+             oname,
+             InsistOnLatestVersion::T);
+
+    EXPECT_TRUE(verifyTestFile(r,
+                               fsize,
+                               "some pattern",
+                               &cs));
+
+    // conditional uploads also go through the multipart path and are checked
+    // on completion
+    auto make_tag([&](const std::string& n) -> std::unique_ptr<yt::UniqueObjectTag>
+                  {
+                      const fs::path cpath(path_ / n);
+                      fs::ofstream(cpath) << cpath;
+                      return bi->write_tag(cpath,
+                                           n,
+                                           nullptr,
+                                           OverwriteObject::T);
+                  });
+
+    const std::string cname("cond");
+    const auto cond(boost::make_shared<Condition>(cname,
+                                                  make_tag(cname)));
+    const auto bogus_cond(boost::make_shared<Condition>(cname,
+                                                        make_tag("another_cond")));
+
+    const std::string oname2("some-other-object");
+    const uint32_t before = failures.load();
+
+    EXPECT_THROW(bi->write(opath,
+                           oname2,
+                           OverwriteObject::F,
+                           &cs,
+                           bogus_cond),
+                 BackendAssertionFailedException);
+
+    EXPECT_FALSE(bi->objectExists(oname2));
+
+    bi->write(opath,
+              oname2,
+              OverwriteObject::F,
+              &cs,
+              cond);
+
+    EXPECT_EQ(fsize,
+              bi->getSize(oname2));
+
+    if (multipart)
+    {
+        // the hook counts the uploads of part 3
+        EXPECT_LT(before,
+                  failures.load());
+    }
+}
+
 // https://github.com/openvstorage/volumedriver/issues/336
 TEST_F(BackendInterfaceTest, retry_on_connection_errors)
 {
@@ -485,6 +485,59 @@ TEST_F(BackendObjectTest, checksum_mismatch)
     ASSERT_FALSE(bi->objectExists(oname));
 }
 
+TEST_F(BackendObjectTest, write_buffer)
+{
+    const std::string oname("some-object");
+    const fs::path dst(path_ / oname);
+
+    std::vector<char> buf(1ULL << 20);
+    for (size_t i = 0; i < buf.size(); ++i)
+    {
+        buf[i] = 'a' + i % 26;
+    }
+
+    yt::CheckSum cs;
+    cs.update(buf.data(), buf.size());
+
+    BackendInterfacePtr bi(bi_(nspace_->ns()));
+
+    yt::CheckSum wrong_cs(1);
+    ASSERT_NE(wrong_cs,
+              cs);
+
+    ASSERT_THROW(bi->write_buffer(buf.data(),
+                                  buf.size(),
+                                  oname,
+                                  OverwriteObject::F,
+                                  &wrong_cs),
+                 BackendInputException);
+
+    ASSERT_FALSE(bi->objectExists(oname));
+
+    bi->write_buffer(buf.data(),
+                     buf.size(),
+                     oname,
+                     OverwriteObject::F,
+                     &cs);
+
+    ASSERT_TRUE(bi->objectExists(oname));
+    EXPECT_EQ(buf.size(),
+              bi->getSize(oname));
+
+    EXPECT_THROW(bi->write_buffer(buf.data(),
+                                  buf.size(),
+                                  oname,
+                                  OverwriteObject::F),
+                 BackendAssertionFailedException);
+
+    bi->read(dst,
+             oname,
+             InsistOnLatestVersion::T);
+
+    EXPECT_EQ(cs,
+              yt::FileUtils::calculate_checksum(dst));
+}
+
 }
 
 // Local Variables: **
@@ -80,6 +80,33 @@ struct PickleTraits<volumedriver::OwnerTag>
     }
 };
 
+template<>
+struct PickleTraits<volumedriver::LatencyHistogram>
+{
+    using IArchive = boost::archive::xml_iarchive;
+    using OArchive = boost::archive::xml_oarchive;
+
+    static std::string
+    str(const volumedriver::LatencyHistogram& h)
+    {
+        std::stringstream ss;
+        OArchive oa(ss);
+        oa << boost::serialization::make_nvp("LatencyHistogram",
+                                             h);
+        return ss.str();
+    }
+
+    static void
+    unstr(volumedriver::LatencyHistogram& h,
+          const std::string& s)
+    {
+        std::stringstream ss(s);
+        IArchive ia(ss);
+        ia >> boost::serialization::make_nvp("LatencyHistogram",
+                                             h);
+    }
+};
+
 template<typename T, typename BucketTraits>
 struct PickleTraits<volumedriver::PerformanceCounter<T, BucketTraits>>
 {
@@ -1291,6 +1291,30 @@ BOOST_PYTHON_MODULE(storagerouterclient)
     register_perf_counter<vd::RequestSizeCounter>("RequestSizeCounter");
     register_perf_counter<vd::RequestUSecsCounter>("RequestUSecsCounter");
 
+    bpy::class_<vd::LatencyHistogram>("LatencyHistogram",
+                                      "latency histogram, values in microseconds")
+        .def("__eq__",
+             &vd::LatencyHistogram::operator==)
+        .def("__repr__",
+             &repr<vd::LatencyHistogram>)
+        .def("events",
+             &vd::LatencyHistogram::events)
+        .def("max",
+             &vd::LatencyHistogram::max)
+        .def("sum",
+             &vd::LatencyHistogram::sum)
+        .def("distribution",
+             &vd::LatencyHistogram::distribution,
+             "@returns: dict, bucket lower bound -> number of events")
+        .def("percentile",
+             &vd::LatencyHistogram::percentile,
+             (bpy::args("p")),
+             "Get the latency at the given percentile\n"
+             "@param p: float, percentile (0 < p <= 100)\n"
+             "@returns: int, microseconds\n")
+        .def_pickle(PickleSuite<vd::LatencyHistogram>())
+        ;
+
 #define DEF_READONLY_PROP_(name)                                        \
     .add_property(#name,                                                \
                   bpy::make_getter(&vd::PerformanceCounters::name,      \
@@ -1312,6 +1336,17 @@ BOOST_PYTHON_MODULE(storagerouterclient)
         DEF_READONLY_PROP_(backend_read_request_size)
         DEF_READONLY_PROP_(backend_read_request_usecs)
         DEF_READONLY_PROP_(sync_request_usecs)
+        DEF_READONLY_PROP_(read_ahead_hit_size)
+        DEF_READONLY_PROP_(read_ahead_waste_size)
+        DEF_READONLY_PROP_(write_copy_size)
+        DEF_READONLY_PROP_(read_latency)
+        DEF_READONLY_PROP_(write_latency)
+        DEF_READONLY_PROP_(metadata_lookup_latency)
+        DEF_READONLY_PROP_(cluster_cache_latency)
+        DEF_READONLY_PROP_(sco_read_latency)
+        DEF_READONLY_PROP_(backend_partial_read_latency)
+        DEF_READONLY_PROP_(dtl_send_latency)
+        DEF_READONLY_PROP_(throttle_latency)
         .def_pickle(PerformanceCountersPickleSuite())
         ;
 #undef DEF_READONLY_PROP_
@@ -157,6 +157,15 @@ VolumeMetaDataStoreDataPoint::VolumeMetaDataStoreDataPoint(const vd::VolumeId& v
     used_clusters = m.used_clusters;
     cached_pages = m.cached_pages;
     max_pages = m.max_pages;
+
+    corked_clusters = 0;
+    for (const auto& p : m.corked_clusters)
+    {
+        corked_clusters += p.second;
+    }
+
+    cork_lookups = m.cork_lookups;
+    cork_lookup_depth = m.cork_lookup_depth;
 }
 
 constexpr const char* VolumeMetaDataStoreDataPoint::name;
@@ -171,7 +180,10 @@ operator<<(std::ostream& os,
         ",cache_misses=" << vmc.cache_misses <<
         ",used_clusters=" << vmc.used_clusters <<
         ",cached_pages=" << vmc.cached_pages <<
-        ",max_pages=" << vmc.max_pages;
+        ",max_pages=" << vmc.max_pages <<
+        ",corked_clusters=" << vmc.corked_clusters <<
+        ",cork_lookups=" << vmc.cork_lookups <<
+        ",cork_lookup_depth=" << vmc.cork_lookup_depth;
 }
 
 VolumeClusterCacheDataPoint::VolumeClusterCacheDataPoint(const vd::VolumeId& vid)
@@ -279,6 +291,23 @@ stream_perf_counter(std::ostream& os,
     return os;
 }
 
+std::ostream&
+stream_latency_histogram(std::ostream& os,
+                         const vd::LatencyHistogram& h,
+                         const char* pfx)
+{
+    os <<
+        "," << pfx << "_events=" << h.events() <<
+        "," << pfx << "_sum=" << h.sum() <<
+        "," << pfx << "_max=" << h.max() <<
+        "," << pfx << "_p50=" << h.percentile(50) <<
+        "," << pfx << "_p90=" << h.percentile(90) <<
+        "," << pfx << "_p99=" << h.percentile(99) <<
+        "," << pfx << "_p999=" << h.percentile(99.9);
+
+    return os;
+}
+
 }
 
 VolumePerformanceCountersDataPoint::VolumePerformanceCountersDataPoint(const vd::VolumeId& vid)
@@ -327,6 +356,31 @@ operator<<(std::ostream& os,
         stream_perf_counter(os,
                             dp.perf_counters.sync_request_usecs,
                             "sync_request_usecs");
+        stream_perf_counter(os,
+                            dp.perf_counters.read_ahead_hit_size,
+                            "read_ahead_hit_size");
+        stream_perf_counter(os,
+                            dp.perf_counters.read_ahead_waste_size,
+                            "read_ahead_waste_size");
+        stream_perf_counter(os,
+                            dp.perf_counters.write_copy_size,
+                            "write_copy_size");
+
+#define H(x)                                            \
+        stream_latency_histogram(os,                    \
+                                 dp.perf_counters.x,    \
+                                 #x)
+
+        H(read_latency);
+        H(write_latency);
+        H(metadata_lookup_latency);
+        H(cluster_cache_latency);
+        H(sco_read_latency);
+        H(backend_partial_read_latency);
+        H(dtl_send_latency);
+        H(throttle_latency);
+
+#undef H
 
         return os;
 }
@@ -115,6 +115,9 @@ struct VolumeMetaDataStoreDataPoint
     uint64_t used_clusters;
     uint64_t cached_pages;
     uint64_t max_pages;
+    uint64_t corked_clusters;
+    uint64_t cork_lookups;
+    uint64_t cork_lookup_depth;
 
     explicit VolumeMetaDataStoreDataPoint(const volumedriver::VolumeId&);
 };
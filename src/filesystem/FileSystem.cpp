@@ -31,12 +31,17 @@
 #include <dirent.h>
 #include <unistd.h>
 
+#include <atomic>
+#include <map>
+
+#include <boost/chrono.hpp>
 #include <boost/filesystem/fstream.hpp>
 #include <boost/serialization/shared_ptr.hpp>
 
 #include <youtils/Assert.h>
 #include <youtils/Logging.h>
 #include <youtils/ScopeExit.h>
+#include <youtils/Timer.h>
 
 #include <volumedriver/MDSNodeConfig.h>
 #include <volumedriver/MetaDataBackendConfig.h>
@@ -45,6 +50,7 @@ namespace volumedriverfs
 {
 
 namespace ara = arakoon;
+namespace bc = boost::chrono;
 namespace bpt = boost::property_tree;
 namespace fs = boost::filesystem;
 namespace ip = initialized_params;
@@ -185,7 +191,9 @@ FileSystem::FileSystem(const bpt::ptree& pt,
     DECLARE_PARAMETER(fs_max_open_files)(pt);
     setlimit(RLIMIT_NOFILE, fs_max_open_files.value());
 
-    restart_(restart_volumes);
+    DECLARE_PARAMETER(fs_restart_parallelism)(pt);
+    restart_(restart_volumes,
+             fs_restart_parallelism.value());
 
     InstantiateXMLRPCS<xmlrpcs>::doit(xmlrpc_svc_, *this);
     xmlrpc_svc_.start();
@@ -402,8 +410,33 @@ FileSystem::is_volume_path_(const FrontendPath& p) const
 }
 
 void
-FileSystem::restart_(const RestartVolumes restart_volumes)
+FileSystem::restart_object_(const FrontendPath& p,
+                            const ObjectId& id)
 {
+    LOG_TRACE(p << ": trying to restart " << id);
+
+    yt::SteadyTimer t;
+
+    try
+    {
+        if (router_.maybe_restart(id,
+                                  ForceRestart::F))
+        {
+            LOG_INFO(p << ": restarted " << id << ", took " <<
+                     bc::duration_cast<bc::milliseconds>(t.elapsed()).count() << " ms");
+        }
+    }
+    CATCH_STD_ALL_LOG_IGNORE(p << ": failed to restart volume " <<
+                             id);
+}
+
+void
+FileSystem::restart_(const RestartVolumes restart_volumes,
+                     const uint32_t parallelism)
+{
+    using Entry = std::pair<FrontendPath, ObjectId>;
+    std::vector<Entry> entries;
+
     auto fun([&](const FrontendPath& p, const DirectoryEntryPtr dentry)
              {
                  const ObjectId& id = dentry->object_id();
@@ -415,20 +448,121 @@ FileSystem::restart_(const RestartVolumes restart_volumes)
                      }
                      else
                      {
-                         LOG_TRACE(p << ": trying to restart " << id);
-                         try
-                         {
-                             router_.maybe_restart(id,
-                                                   ForceRestart::F);
-                         }
-                         CATCH_STD_ALL_LOG_IGNORE(p << ": failed to restart volume " <<
-                                                  id);
+                         entries.emplace_back(p, id);
                      }
                  }
              });
 
     mdstore_.walk(FrontendPath("/"),
                   std::move(fun));
+
+    // Clones are only restarted once their parents (if these are to be
+    // restarted here as well) were dealt with. To that end the objects are
+    // grouped into waves by their depth in the clone tree; the objects
+    // within a wave are restarted concurrently.
+    std::map<ObjectId, boost::optional<ObjectId>> parents;
+
+    for (const auto& e : entries)
+    {
+        boost::optional<ObjectId> parent;
+
+        try
+        {
+            const ObjectRegistrationPtr
+                reg(router_.object_registry()->find(e.second,
+                                                    IgnoreCache::F));
+            if (reg)
+            {
+                parent = reg->treeconfig.parent_volume;
+            }
+        }
+        CATCH_STD_ALL_LOG_IGNORE(e.first << ": failed to look up registration of " <<
+                                 e.second);
+
+        parents.emplace(e.second,
+                        parent);
+    }
+
+    auto depth([&](const ObjectId& id) -> size_t
+               {
+                   size_t d = 0;
+                   auto it = parents.find(id);
+
+                   // bounded to guard against a (bogus) cycle in the registry
+                   while (it != parents.end() and
+                          it->second and
+                          d < parents.size())
+                   {
+                       it = parents.find(*it->second);
+                       if (it != parents.end())
+                       {
+                           ++d;
+                       }
+                   }
+
+                   return d;
+               });
+
+    std::map<size_t, std::vector<Entry>> waves;
+    for (auto& e : entries)
+    {
+        waves[depth(e.second)].emplace_back(std::move(e));
+    }
+
+    const size_t total = entries.size();
+    std::atomic<size_t> done(0);
+    yt::SteadyTimer t;
+
+    LOG_INFO("restarting " << total << " objects in " << waves.size() <<
+             " wave(s), parallelism " << parallelism);
+
+    for (const auto& w : waves)
+    {
+        const std::vector<Entry>& wave = w.second;
+        std::atomic<size_t> next(0);
+
+        auto work([&]
+                  {
+                      while (true)
+                      {
+                          const size_t i = next++;
+                          if (i >= wave.size())
+                          {
+                              break;
+                          }
+
+                          restart_object_(wave[i].first,
+                                          wave[i].second);
+
+                          LOG_INFO("restart progress: " << ++done << "/" << total);
+                      }
+                  });
+
+        const size_t nthreads = std::min<size_t>(std::max<uint32_t>(parallelism, 1),
+                                                 wave.size());
+        std::vector<std::thread> threads;
+        threads.reserve(nthreads - 1);
+
+        try
+        {
+            for (size_t i = 1; i < nthreads; ++i)
+            {
+                threads.emplace_back(work);
+            }
+        }
+        CATCH_STD_ALL_LOG_IGNORE("failed to spawn restart thread, continuing with " <<
+                                 (threads.size() + 1) << " thread(s)");
+
+        work();
+
+        for (auto& th : threads)
+        {
+            th.join();
+        }
+    }
+
+    LOG_INFO("restarted " << total << " objects, took " <<
+             bc::duration_cast<bc::milliseconds>(t.elapsed()).count() << " ms");
 }
 
 void
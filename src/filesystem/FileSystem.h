@@ -621,7 +621,12 @@ private:
                                const FrontendPath& to);
 
     void
-    restart_(const RestartVolumes);
+    restart_(const RestartVolumes,
+             const uint32_t parallelism);
+
+    void
+    restart_object_(const FrontendPath&,
+                    const ObjectId&);
 
     void
     create_volume_(const FrontendPath&,
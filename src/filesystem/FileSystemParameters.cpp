@@ -318,6 +318,13 @@ DEFINE_INITIALIZED_PARAM_WITH_DEFAULT(fs_max_open_files,
                                       ShowDocumentation::T,
                                       65536);
 
+DEFINE_INITIALIZED_PARAM_WITH_DEFAULT(fs_restart_parallelism,
+                                      filesystem_component_name,
+                                      "fs_restart_parallelism",
+                                      "Maximum number of volumes that are restarted concurrently on startup",
+                                      ShowDocumentation::T,
+                                      4);
+
 DEFINE_INITIALIZED_PARAM_WITH_DEFAULT(fs_internal_suffix,
                                       filesystem_component_name,
                                       "fs_internal_suffix",
@@ -1467,6 +1467,37 @@ QueueSize::execute_internal(XmlRpc::XmlRpcValue& params,
     result[XMLRPCKeys::queue_size] = XMLVAL(res);
 }
 
+void
+BackendQueueStats::execute_internal(XmlRpc::XmlRpcValue& params,
+                                    XmlRpc::XmlRpcValue& result)
+{
+    with_api_exception_conversion([&]()
+    {
+        const vd::VolumeId volName(getID(params[0]));
+        const youtils::ThreadPoolQueueStats stats(api::getBackendQueueStats(volName));
+
+        result[XMLRPCKeys::queue_depth] = XMLVAL(stats.queued);
+        result[XMLRPCKeys::queue_depth_max] = XMLVAL(stats.max_queued);
+        result[XMLRPCKeys::queue_dispatched] = XMLVAL(stats.dispatched);
+        result[XMLRPCKeys::queue_wait_usecs] = XMLVAL(stats.total_wait_usecs);
+        result[XMLRPCKeys::queue_wait_usecs_max] = XMLVAL(stats.max_wait_usecs);
+        result[XMLRPCKeys::queue_weight] = XMLVAL(stats.weight);
+    });
+}
+
+void
+SetBackendQueueWeight::execute_internal(XmlRpc::XmlRpcValue& params,
+                                        XmlRpc::XmlRpcValue& /* result */)
+{
+    with_api_exception_conversion([&]()
+    {
+        auto& param = params[0];
+        const vd::VolumeId volName(getID(param));
+        api::setBackendQueueWeight(volName,
+                                   getUIntVal<uint32_t>(param[XMLRPCKeys::queue_weight]));
+    });
+}
+
 void
 TLogUsed::execute_internal(XmlRpc::XmlRpcValue& params,
                            XmlRpc::XmlRpcValue& result)
@@ -540,6 +540,16 @@ REGISTER_XMLRPC(XMLRPCCallTimingLock,
                 "queueSize",
                 "Returns the total size of SCO's waiting to be written to the backend");
 
+REGISTER_XMLRPC(XMLRPCCallTimingLock,
+                BackendQueueStats,
+                "backendQueueStats",
+                "Returns depth, wait time and weight of the volume's backend queue");
+
+REGISTER_XMLRPC(XMLRPCCallTimingLock,
+                SetBackendQueueWeight,
+                "setBackendQueueWeight",
+                "Set the volume's share of the backend thread pool");
+
 REGISTER_XMLRPC(XMLRPCCallTimingLock,
                 TLogUsed,
                 "tlogUsed",
@@ -812,6 +822,8 @@ typedef LOKI_TYPELIST_91(
                          DataStoreReadUsed,
                          QueueCount,
                          QueueSize,
+                         BackendQueueStats,
+                         SetBackendQueueWeight,
                          TLogUsed,
                          SnapshotSCOCount,
                          CurrentSCOCount,
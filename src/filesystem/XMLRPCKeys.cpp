@@ -101,7 +101,13 @@ DEFINE_XMLRPC_KEY(prefetch);
 DEFINE_XMLRPC_KEY(problem);
 DEFINE_XMLRPC_KEY(problems);
 DEFINE_XMLRPC_KEY(queue_count);
+DEFINE_XMLRPC_KEY(queue_depth);
+DEFINE_XMLRPC_KEY(queue_depth_max);
+DEFINE_XMLRPC_KEY(queue_dispatched);
 DEFINE_XMLRPC_KEY(queue_size);
+DEFINE_XMLRPC_KEY(queue_wait_usecs);
+DEFINE_XMLRPC_KEY(queue_wait_usecs_max);
+DEFINE_XMLRPC_KEY(queue_weight);
 DEFINE_XMLRPC_KEY(redirect_fenced);
 DEFINE_XMLRPC_KEY(restart_local);
 DEFINE_XMLRPC_KEY(reset);
@@ -104,7 +104,13 @@ struct XMLRPCKeys
     static const std::string problem;
     static const std::string problems;
     static const std::string queue_count;
+    static const std::string queue_depth;
+    static const std::string queue_depth_max;
+    static const std::string queue_dispatched;
     static const std::string queue_size;
+    static const std::string queue_wait_usecs;
+    static const std::string queue_wait_usecs_max;
+    static const std::string queue_weight;
     static const std::string redirect_fenced;
     static const std::string restart_local;
     static const std::string reset;
@@ -642,6 +642,20 @@ api::getQueueSize(const VolumeId& volName)
     return VolManager::get()->getQueueSize(volName);
 }
 
+youtils::ThreadPoolQueueStats
+api::getBackendQueueStats(const VolumeId& volName)
+{
+    return VolManager::get()->getBackendQueueStats(volName);
+}
+
+void
+api::setBackendQueueWeight(const VolumeId& volName,
+                           uint32_t weight)
+{
+    VolManager::get()->setBackendQueueWeight(volName,
+                                             weight);
+}
+
 uint64_t
 api::getTLogUsed(const vd::VolumeId& volName)
 {
@@ -987,6 +1001,19 @@ api::getClusterCacheLimit(const vd::VolumeId& volName)
     return VolManager::get()->find_volume(volName)->get_cluster_cache_limit();
 }
 
+void
+api::setWeedAlgorithm(const vd::VolumeId& volName,
+                      const youtils::WeedAlgorithm algo)
+{
+    VolManager::get()->find_volume(volName)->set_weed_algorithm(algo);
+}
+
+youtils::WeedAlgorithm
+api::getWeedAlgorithm(const vd::VolumeId& volName)
+{
+    return VolManager::get()->find_volume(volName)->get_weed_algorithm();
+}
+
 std::vector<scrubbing::ScrubWork>
 api::getScrubbingWork(const vd::VolumeId& volName,
                       const boost::optional<vd::SnapshotName>& start_snap,
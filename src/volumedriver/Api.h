@@ -323,6 +323,13 @@ public:
     static uint64_t
     getQueueSize(const volumedriver::VolumeId& volName);
 
+    static youtils::ThreadPoolQueueStats
+    getBackendQueueStats(const volumedriver::VolumeId&);
+
+    static void
+    setBackendQueueWeight(const volumedriver::VolumeId&,
+                          uint32_t weight);
+
     static uint64_t
     getTLogUsed(const volumedriver::VolumeId&);
 
@@ -501,6 +508,13 @@ public:
     static boost::optional<volumedriver::ClusterCount>
     getClusterCacheLimit(const volumedriver::VolumeId&);
 
+    static void
+    setWeedAlgorithm(const volumedriver::VolumeId&,
+                     const youtils::WeedAlgorithm);
+
+    static youtils::WeedAlgorithm
+    getWeedAlgorithm(const volumedriver::VolumeId&);
+
     static std::vector<scrubbing::ScrubWork>
     getScrubbingWork(const volumedriver::VolumeId&,
                      const boost::optional<volumedriver::SnapshotName>& start_snap,
@@ -433,6 +433,65 @@ ArakoonMetaDataBackend::getPage(CachePage& p)
     }
 }
 
+void
+ArakoonMetaDataBackend::getPages(const std::vector<CachePage*>& pages)
+{
+    LOG_TRACE(ns_ << ": " << pages.size() << " pages");
+
+    std::vector<CachePage*> todo;
+    todo.reserve(pages.size());
+
+    ara::value_list keys;
+
+    for (CachePage* p : pages)
+    {
+        if (not get_page_from_write_sequence_(*p))
+        {
+            todo.push_back(p);
+            keys.add(ArakoonMetaDataPageKey(page_dir_,
+                                            p->page_address()));
+        }
+    }
+
+    if (todo.empty())
+    {
+        return;
+    }
+
+    try
+    {
+        const ara::value_list vals(cluster_.multi_get(keys));
+        VERIFY(vals.size() == todo.size());
+
+        ara::value_list::iterator it(vals.begin());
+        ara::arakoon_buffer buf;
+
+        for (CachePage* p : todo)
+        {
+            VERIFY(it.next(buf));
+            VERIFY(buf.first == CachePage::size());
+            memcpy(p->data(), buf.second, buf.first);
+        }
+
+        return;
+    }
+    catch (ara::error_not_found&)
+    {
+        // multi_get fails as a whole if one of the keys doesn't exist; the
+        // missing ones might have to come from the parent.
+        LOG_DEBUG(ns_ << ": not all pages found, falling back to fetching them one by one");
+    }
+    CATCH_STD_ALL_LOG_RETHROW(ns_ << ": failed to get pages from arakoon")
+
+    for (CachePage* p : todo)
+    {
+        if (not getPage(*p))
+        {
+            p->reset();
+        }
+    }
+}
+
 bool
 ArakoonMetaDataBackend::pageExistsInParent(const PageAddress pa) const
 {
@@ -48,6 +48,9 @@ public:
     bool
     getPage(CachePage& p) override final;
 
+    void
+    getPages(const std::vector<CachePage*>& pages) override final;
+
     inline bool
     getPage(CachePage& p,
             bool try_parent);
@@ -18,6 +18,7 @@
 #include "DataStoreCallBack.h"
 #include "OwnerTag.h"
 #include "SnapshotManagement.h"
+#include "TLogCodec.h"
 #include "TransientException.h"
 #include "Volume.h"
 #include "VolumeDriverError.h"
@@ -40,6 +41,7 @@ namespace yt = youtils;
 
 using ::youtils::FileUtils;
 using ::youtils::BarrierTask;
+using ::youtils::TaskPriority;
 
 namespace
 {
@@ -71,6 +73,13 @@ WriteSCO::getName() const
     return name;
 }
 
+// Bulk data: volumes waiting on a TLog or snapshot write go first.
+TaskPriority
+WriteSCO::priority() const
+{
+    return TaskPriority::Low;
+}
+
 const fs::path
 WriteSCO::getSource() const
 {
@@ -131,12 +140,14 @@ WriteTLog::WriteTLog(VolumeInterface* vol,
                      const fs::path& tlogpath,
                      const TLogId& tlogid,
                      const SCO sconame,
-                     const CheckSum& checksum)
+                     const CheckSum& checksum,
+                     const CompactTLog compact)
     : TaskBase(vol, BarrierTask::T)
     , tlogpath_(tlogpath)
     , tlogid_(tlogid)
     , sconame_(sconame)
     , checksum_(checksum)
+    , compact_(compact)
 {
     if(not fs::exists(tlogpath))
     {
@@ -155,6 +166,13 @@ WriteTLog::getName() const
     return name;
 }
 
+// Gates isSyncedToBackend and trimming the DTL.
+TaskPriority
+WriteTLog::priority() const
+{
+    return TaskPriority::High;
+}
+
 void
 WriteTLog::run(int /*threadid*/)
 {
@@ -162,12 +180,34 @@ WriteTLog::run(int /*threadid*/)
 
     try
     {
-        volume_->getBackendInterface()->write(tlogpath_.string(),
-                                              boost::lexical_cast<std::string>(tlogid_),
-                                              OverwriteObject::T,
-                                              &checksum_,
-                                              volume_->backend_write_condition(),
-                                              fail_fast_request_params);
+        if (compact_ == CompactTLog::T)
+        {
+            // The TLog CRC recorded in the snapshots file stays the one of the
+            // raw TLog; the backend verifies what it is handed.
+            std::vector<uint8_t> buf;
+            TLogCodec::encode(tlogpath_, buf);
+
+            CheckSum cs;
+            cs.update(buf.data(), buf.size());
+
+            volume_->getBackendInterface()->write_buffer(buf.data(),
+                                                         buf.size(),
+                                                         boost::lexical_cast<std::string>(tlogid_),
+                                                         OverwriteObject::T,
+                                                         &cs,
+                                                         volume_->backend_write_condition(),
+                                                         fail_fast_request_params);
+        }
+        else
+        {
+            volume_->getBackendInterface()->write(tlogpath_.string(),
+                                                  boost::lexical_cast<std::string>(tlogid_),
+                                                  OverwriteObject::T,
+                                                  &checksum_,
+                                                  volume_->backend_write_condition(),
+                                                  fail_fast_request_params);
+        }
+
         volume_->tlogWrittenToBackendCallback(tlogid_,
                                               sconame_);
     }
@@ -219,21 +259,28 @@ WriteSnapshot::getName() const
     return name;
 }
 
+TaskPriority
+WriteSnapshot::priority() const
+{
+    return TaskPriority::High;
+}
+
 void
 WriteSnapshot::run(int /*threadID*/)
 {
     try
     {
-        const fs::path tmpfile = volume_->getSnapshotManagement().saveSnapshotToTempFile();
-        CheckSum chk = FileUtils::calculate_checksum(tmpfile);
-        ALWAYS_CLEANUP_FILE(tmpfile);
-
-        volume_->getBackendInterface()->write(tmpfile,
-                                              snapshotFilename(),
-                                              OverwriteObject::T,
-                                              &chk,
-                                              volume_->backend_write_condition(),
-                                              fail_fast_request_params);
+        const std::string snaps(volume_->getSnapshotManagement().saveSnapshotToString());
+        CheckSum chk;
+        chk.update(snaps.data(), snaps.size());
+
+        volume_->getBackendInterface()->write_buffer(snaps.data(),
+                                                     snaps.size(),
+                                                     snapshotFilename(),
+                                                     OverwriteObject::T,
+                                                     &chk,
+                                                     volume_->backend_write_condition(),
+                                                     fail_fast_request_params);
     }
     catch (be::BackendAssertionFailedException&)
     {
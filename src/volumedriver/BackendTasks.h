@@ -21,6 +21,7 @@
 #include "VolumeInterface.h"
 #include "VolumeThreadPool.h"
 
+#include <youtils/BooleanEnum.h>
 #include <youtils/CheckSum.h>
 #include <youtils/FileUtils.h>
 #include <youtils/ThreadPool.h>
@@ -38,6 +39,8 @@ class Volume;
 namespace backend_task
 {
 
+VD_BOOLEAN_ENUM(CompactTLog);
+
 typedef volumedriver::VolPoolTask TaskType;
 typedef TaskType::Producer_t ProducerType;
 
@@ -99,6 +102,9 @@ public:
     virtual void
     run(int threadid) override;
 
+    virtual youtils::TaskPriority
+    priority() const override;
+
     const fs::path
     getSource() const;
 
@@ -119,7 +125,8 @@ public:
               const fs::path & source,
               const TLogId& tlogid,
               const SCO sconame,
-              const CheckSum& checksum);
+              const CheckSum& checksum,
+              const CompactTLog compact = CompactTLog::F);
 
     virtual const std::string&
     getName() const override;
@@ -127,6 +134,9 @@ public:
     virtual void
     run(int threadid) override;
 
+    virtual youtils::TaskPriority
+    priority() const override;
+
 private:
     DECLARE_LOGGER("WriteTLogTask");
 
@@ -134,6 +144,8 @@ private:
     const TLogId tlogid_;
     const SCO sconame_;
     const CheckSum checksum_;
+    // store the TLog TLogCodec encoded on the backend
+    const CompactTLog compact_;
 };
 
 class DeleteTLog final
@@ -192,6 +204,9 @@ public:
     virtual const std::string&
     getName() const override;
 
+    virtual youtils::TaskPriority
+    priority() const override;
+
 private:
     DECLARE_LOGGER("WriteSnapshotTask")
 };
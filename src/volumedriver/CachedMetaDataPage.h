@@ -19,6 +19,8 @@
 #include "ClusterLocationAndHash.h"
 #include "Types.h"
 
+#include <atomic>
+
 #include <boost/thread/mutex.hpp>
 #include <boost/intrusive/set.hpp>
 #include <boost/intrusive/list.hpp>
@@ -41,6 +43,7 @@ public:
                        ClusterLocationAndHash* data)
         : page_address_(pa)
         , data_(data)
+        , referenced_(false)
         , dirty(false)
         , written_clusters_since_last_backend_write(0)
         , discarded_clusters_since_last_backend_write(0)
@@ -54,6 +57,7 @@ public:
               ClusterLocationAndHash* data)
         : page_address_(other.page_address_)
         , data_(data)
+        , referenced_(other.referenced())
         , dirty(other.dirty)
         , written_clusters_since_last_backend_write(other.written_clusters_since_last_backend_write)
         , discarded_clusters_since_last_backend_write(other.discarded_clusters_since_last_backend_write)
@@ -65,6 +69,7 @@ public:
     CachePage(const CachePage&& other)
         : page_address_(other.page_address_)
         , data_(other.data_)
+        , referenced_(other.referenced())
         , dirty(other.dirty)
         , written_clusters_since_last_backend_write(other.written_clusters_since_last_backend_write)
         , discarded_clusters_since_last_backend_write(other.discarded_clusters_since_last_backend_write)
@@ -79,6 +84,8 @@ public:
             ASSERT(other.data_ != nullptr);
 
             const_cast<PageAddress&>(page_address_) = other.page_address_;
+            referenced_.store(other.referenced(),
+                              std::memory_order_relaxed);
             dirty = other.dirty;
             written_clusters_since_last_backend_write =
                 other.written_clusters_since_last_backend_write;
@@ -117,6 +124,34 @@ public:
         return set_base_hook::is_linked();
     }
 
+    // Cache hits only hold a shared lock, so the recency information used
+    // for (CLOCK) eviction is kept in an atomic reference bit instead of
+    // relinking the page in an LRU list. The bit is only written if it's not
+    // set yet to keep the cache line shared between concurrent readers.
+    inline void
+    touch() const
+    {
+        if (not referenced_.load(std::memory_order_relaxed))
+        {
+            referenced_.store(true,
+                              std::memory_order_relaxed);
+        }
+    }
+
+    inline bool
+    referenced() const
+    {
+        return referenced_.load(std::memory_order_relaxed);
+    }
+
+    // returns whether the page was referenced since the last call
+    inline bool
+    clear_referenced()
+    {
+        return referenced_.exchange(false,
+                                    std::memory_order_relaxed);
+    }
+
     bool
     operator>(const CachePage& rhs) const
     {
@@ -240,6 +275,7 @@ private:
     const static uint8_t page_bits_;
     PageAddress page_address_;
     ClusterLocationAndHash* data_;
+    mutable std::atomic<bool> referenced_;
 
 public:
     bool dirty;
@@ -23,6 +23,8 @@
 #include "VolManager.h"
 #include "VolumeConfig.h"
 
+#include <algorithm>
+
 #include <boost/foreach.hpp>
 #include <boost/scope_exit.hpp>
 
@@ -66,6 +68,31 @@ namespace yt = youtils;
 #define ASSERT_BACKEND_LOCKED                   \
     ASSERT(not backend_lock_.try_lock());
 
+#define LOCK_WRITEBACKS                                                 \
+    boost::lock_guard<decltype(writeback_lock_)> wbg__(writeback_lock_)
+
+namespace
+{
+
+struct PageCmp
+{
+    bool
+    operator()(const PageAddress& pa,
+               const CachePage& cp) const
+    {
+        return pa < cp.page_address();
+    }
+
+    bool
+    operator()(const CachePage& cp,
+               const PageAddress& pa) const
+    {
+        return cp.page_address() < pa;
+    }
+};
+
+}
+
 uint64_t CachedMetaDataStore::replayClustersCached =
     yt::System::get_env_with_default<uint64_t>("METADATASTORE_REPLAY_CLUSTERS_CACHED",
                                                1ULL << 20);
@@ -80,11 +107,14 @@ CachedMetaDataStore::CachedMetaDataStore(const MetaDataBackendInterfacePtr& back
     : backend_(backend)
     , page_data_(capacity * CachePage::capacity())
     , num_pages_(0)
+    , clock_hand_(0)
     , cache_hits_(0)
     , cache_misses_(0)
     , written_clusters_(0)
     , discarded_clusters_(0)
     , id_(id)
+    , cork_lookups_(0)
+    , cork_lookup_depth_(0)
 {
     VERIFY(capacity > 0);
 
@@ -107,6 +137,7 @@ void
 CachedMetaDataStore::init_pages_(size_t capacity)
 {
     pages_.reserve(capacity);
+    clock_hand_ = 0;
 
     for (uint64_t i = 0; i < capacity; ++i)
     {
@@ -128,17 +159,25 @@ CachedMetaDataStore::readCluster(const ClusterAddress caddr,
         LOCK_CORKS_READ;
         // It seems that after a backend restart we *dont* have a current tlog?
         //        ASSERT(not corks_.empty());
+        uint64_t depth = 0;
+
         BOOST_REVERSE_FOREACH(const cork_t& crk, corks_)
         {
-            ca_loc_map_type::const_iterator it = crk.second->find(caddr);
-            if(it != crk.second->end())
+            ++depth;
+            const ClusterLocationAndHash* l = crk.second->find(caddr);
+            if (l != nullptr)
             {
-                loc = it->second;
+                loc = *l;
                 cache_hits_++;
+                ++cork_lookups_;
+                cork_lookup_depth_ += depth;
                 LOG_TRACE(id_ << ": ca " << caddr << " -> loc: " << loc);
                 return;
             }
         }
+
+        ++cork_lookups_;
+        cork_lookup_depth_ += depth;
     }
 
     get_cluster_location_(caddr, loc, false);
@@ -157,6 +196,150 @@ CachedMetaDataStore::readCluster(const ClusterAddress caddr,
     LOG_TRACE(id_ << ": ca " << caddr << " -> loc: " << loc);
 }
 
+void
+CachedMetaDataStore::readClusters(const ClusterAddress start,
+                                  const size_t count,
+                                  std::vector<ClusterLocationAndHash>& locs)
+{
+    LOG_TRACE(id_ << ": ca " << start << ", count " << count);
+
+    locs.assign(count,
+                ClusterLocationAndHash());
+
+    if (count == 0)
+    {
+        return;
+    }
+
+    const ClusterAddress end = start + count;
+
+    // entries found in the corks take precedence over those in the pages.
+    // (thread local to avoid an allocation per read)
+    static thread_local std::vector<bool> resolved;
+    resolved.assign(count, false);
+    size_t nresolved = 0;
+
+    {
+        LOCK_CORKS_READ;
+        uint64_t depth = 0;
+
+        BOOST_REVERSE_FOREACH(const cork_t& crk, corks_)
+        {
+            ++depth;
+            crk.second->for_each_in_range(start,
+                                          end,
+                                          [&](const ClusterAddress ca,
+                                              const ClusterLocationAndHash& loc)
+                                          {
+                                              const size_t idx = ca - start;
+                                              if (not resolved[idx])
+                                              {
+                                                  resolved[idx] = true;
+                                                  locs[idx] = loc;
+                                                  ++nresolved;
+                                                  ++cache_hits_;
+                                              }
+                                          });
+
+            if (nresolved == count)
+            {
+                break;
+            }
+        }
+
+        ++cork_lookups_;
+        cork_lookup_depth_ += depth;
+    }
+
+    // Don't try to bring in more pages than the cache can hold at once as
+    // they'd evict each other.
+    const size_t max_fetch = std::max<size_t>(1, pages_.size() / 2);
+    std::vector<PageAddress> missing;
+    bool first_round = true;
+
+    while (nresolved < count)
+    {
+        missing.clear();
+
+        {
+            LOCK_CACHE_READ;
+
+            for (PageAddress pa = CachePage::pageAddress(start);
+                 pa <= CachePage::pageAddress(end - 1);
+                 ++pa)
+            {
+                const ClusterAddress ca_first =
+                    std::max<ClusterAddress>(start,
+                                             CachePage::clusterAddress(pa));
+                const ClusterAddress ca_last =
+                    std::min<ClusterAddress>(end,
+                                             CachePage::clusterAddress(pa + 1));
+
+                bool done = true;
+                for (ClusterAddress ca = ca_first; ca < ca_last; ++ca)
+                {
+                    if (not resolved[ca - start])
+                    {
+                        done = false;
+                        break;
+                    }
+                }
+
+                if (done)
+                {
+                    continue;
+                }
+
+                auto it = page_map_.find(pa,
+                                         PageCmp());
+                if (it == page_map_.end())
+                {
+                    if (missing.size() < max_fetch)
+                    {
+                        missing.push_back(pa);
+                    }
+                    continue;
+                }
+
+                it->touch();
+
+                for (ClusterAddress ca = ca_first; ca < ca_last; ++ca)
+                {
+                    const size_t idx = ca - start;
+                    if (not resolved[idx])
+                    {
+                        resolved[idx] = true;
+                        locs[idx] = (*it)[CachePage::offset(ca)];
+                        ++nresolved;
+                        if (first_round)
+                        {
+                            ++cache_hits_;
+                        }
+                    }
+                }
+            }
+        }
+
+        first_round = false;
+
+        if (not missing.empty())
+        {
+            fetch_pages_(missing);
+        }
+    }
+
+    if (ClusterLocationAndHash::use_hash())
+    {
+        for (auto& loc : locs)
+        {
+            if (loc.clusterLocation.isNull())
+            {
+                loc = ClusterLocationAndHash::discarded_location_and_hash();
+            }
+        }
+    }
+}
+
 // must not be called concurrently by consumers.
 void
 CachedMetaDataStore::writeCluster(const ClusterAddress caddr,
@@ -166,7 +349,25 @@ CachedMetaDataStore::writeCluster(const ClusterAddress caddr,
 
     LOCK_CORKS_WRITE;
     ASSERT(not corks_.empty());
-    (*corks_.back().second)[caddr] = loc;
+    corks_.back().second->insert(caddr,
+                                 loc);
+}
+
+void
+CachedMetaDataStore::writeClusters(const ClusterAddress* addrs,
+                                   const ClusterLocationAndHash* locs,
+                                   const size_t count)
+{
+    LOG_TRACE(id_ << ": count " << count);
+
+    LOCK_CORKS_WRITE;
+    ASSERT(not corks_.empty());
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        corks_.back().second->insert(addrs[i],
+                                     locs[i]);
+    }
 }
 
 void
@@ -213,6 +414,8 @@ CachedMetaDataStore::for_each(MetaDataStoreFunctor& f,
         // VERIFY(page_list_.size() == 0);
     }
 
+    drain_writebacks_();
+
     LOCK_BACKEND;
     return backend_->for_each(f,
                               max_address);
@@ -230,6 +433,8 @@ CachedMetaDataStore::getStats(MetaDataStoreStats& stats)
     stats.cache_misses = cache_misses_;
     stats.cached_pages = num_pages_;
     stats.max_pages = pages_.size();
+    stats.cork_lookups = cork_lookups_;
+    stats.cork_lookup_depth = cork_lookup_depth_;
     stats.corked_clusters.clear();
 
     getCorkedClusters(stats.corked_clusters);
@@ -277,8 +482,10 @@ CachedMetaDataStore::cork(const yt::UUID& cork)
     }
     else
     {
+        // TLogs (and hence corks) tend to be of similar size.
+        const size_t hint = corks_.empty() ? 0 : corks_.back().second->size();
         corks_.emplace_back(cork,
-                            std::make_shared<ca_loc_map_type>());
+                            std::make_shared<CorkedClusters>(hint));
     }
 }
 
@@ -327,7 +534,7 @@ CachedMetaDataStore::unCork(const boost::optional<yt::UUID>& cork)
 
         // cork() could modify the corks_ list at the same time, so we'd technically
         // be in for undefined behaviour when reading at the same time without locking.
-        ca_loc_map_ptr_type m;
+        corked_clusters_ptr_type m;
         {
             LOCK_CORKS_READ;
 
@@ -340,19 +547,33 @@ CachedMetaDataStore::unCork(const boost::optional<yt::UUID>& cork)
             m = corks_.front().second;
         }
 
-        for (const auto& val : *m)
+        // Hand the entries off page by page, i.e. one page lookup and one
+        // cache lock round trip per page instead of per entry.
+        const std::vector<CorkedClusters::Entry> entries(m->sorted_entries());
+
+        auto it = entries.begin();
+        while (it != entries.end())
         {
+            const PageAddress pa = CachePage::pageAddress(it->first);
+            auto next = std::find_if(it,
+                                     entries.end(),
+                                     [&](const CorkedClusters::Entry& e)
+                                     {
+                                         return CachePage::pageAddress(e.first) != pa;
+                                     });
+
             // AR: why is this here? The corked entries (map) itself should not be
             // modified (see above, and if it was, the whole loop would have to be locked)?
             LOCK_CORKS_READ;
-            // Y42 not correct, just write to the own cache
-            // Ordening here might be better
-            if (not get_cluster_location_(val.first, const_cast<ClusterLocationAndHash&>(val.second), true))
+            if (not write_page_entries_(it, next))
             {
                 misses++;
             }
+
+            it = next;
         }
-        LOG_INFO(id_ << ": written " << corks_.front().second->size() <<
+
+        LOG_INFO(id_ << ": written " << entries.size() <<
                  " entries to pages, " << misses << " cache misses");
     }
 
@@ -370,6 +591,8 @@ CachedMetaDataStore::unCork(const boost::optional<yt::UUID>& cork)
         LOG_INFO(id_ << ": written out " << dirty_count << " dirty pages");
     }
 
+    drain_writebacks_();
+
     LOCK_CORKS_WRITE;
 
     {
@@ -425,6 +648,8 @@ CachedMetaDataStore::processCloneTLogs(const CloneTLogs& ctl,
             maybeWritePage_locked_context(p, false);
         }
 
+        drain_writebacks_();
+
         if (cork != boost::none)
         {
             LOCK_BACKEND;
@@ -510,6 +735,30 @@ CachedMetaDataStore::do_write_dirty_pages_to_backend_and_clear_page_list(bool sy
     ASSERT(page_map_.empty());
     ASSERT(num_pages_ == 0);
 
+    if (sync)
+    {
+        try
+        {
+            drain_writebacks_();
+        }
+        CATCH_STD_ALL_EWHAT({
+                LOG_ERROR(id_ << ": failed to write back evicted pages: " << EWHAT);
+                if (not ignore_errors)
+                {
+                    throw;
+                }
+            });
+    }
+    else
+    {
+        discard_writebacks_();
+    }
+
+    for (auto& f : page_fetches_)
+    {
+        f.second->stale = true;
+    }
+
     for (auto& p : pages_)
     {
         p.reset();
@@ -531,28 +780,8 @@ CachedMetaDataStore::write_dirty_pages_to_backend_keeping_page_list()
             page.dirty = false;
         }
     }
-}
-
-namespace
-{
-
-struct PageCmp
-{
-    bool
-    operator()(const PageAddress& pa,
-               const CachePage& cp) const
-    {
-        return pa < cp.page_address();
-    }
-
-    bool
-    operator()(const CachePage& cp,
-               const PageAddress& pa) const
-    {
-        return cp.page_address() < pa;
-    }
-};
 
+    drain_writebacks_();
 }
 
 ApplyRelocsResult
@@ -595,20 +824,24 @@ CachedMetaDataStore::applyRelocs(RelocationReaderFactory& factory,
 
         ClusterLocationAndHash l_current;
 
-        LOCK_CACHE_WRITE;
-
-        get_cluster_location_unlocked_(a_old,
-                                       l_current,
-                                       false);
-
-        if (l_current.clusterLocation == l_old)
         {
-            ClusterLocationAndHash l_new = e_new->clusterLocationAndHash();
-            l_new.clusterLocation.cloneID(scid);
+            LOCK_CACHE_WRITE;
+
             get_cluster_location_unlocked_(a_old,
-                                           l_new,
-                                           true);
+                                           l_current,
+                                           false);
+
+            if (l_current.clusterLocation == l_old)
+            {
+                ClusterLocationAndHash l_new = e_new->clusterLocationAndHash();
+                l_new.clusterLocation.cloneID(scid);
+                get_cluster_location_unlocked_(a_old,
+                                               l_new,
+                                               true);
+            }
         }
+
+        flush_writebacks_();
         relocNum++;
     }
 
@@ -625,11 +858,43 @@ CachedMetaDataStore::get_cluster_location_(const ClusterAddress ca,
                                ClusterLocationAndHash& loc,
                                bool for_write)
 {
-    LOCK_CACHE_WRITE;
+    if (not for_write)
+    {
+        bool hit = true;
+
+        while (true)
+        {
+            {
+                LOCK_CACHE_READ;
+                if (get_cached_cluster_location_(ca,
+                                                 loc))
+                {
+                    if (hit)
+                    {
+                        ++cache_hits_;
+                    }
+                    return hit;
+                }
+            }
+
+            // The page might have been evicted again (or the fetch was
+            // invalidated) by the time we get here, hence the loop.
+            hit = false;
+            fetch_pages_({ CachePage::pageAddress(ca) });
+        }
+    }
+
+    bool hit;
+
+    {
+        LOCK_CACHE_WRITE;
+        hit = get_cluster_location_unlocked_(ca,
+                                             loc,
+                                             for_write);
+    }
 
-    return get_cluster_location_unlocked_(ca,
-                                          loc,
-                                          for_write);
+    flush_writebacks_();
+    return hit;
 }
 
 void
@@ -657,6 +922,398 @@ CachedMetaDataStore::set_cache_capacity(const size_t new_capacity)
     }
 }
 
+bool
+CachedMetaDataStore::get_cached_cluster_location_(const ClusterAddress ca,
+                                                  ClusterLocationAndHash& loc)
+{
+    ASSERT_CACHE_READ_LOCKED;
+
+    auto it = page_map_.find(CachePage::pageAddress(ca),
+                             PageCmp());
+    if (it == page_map_.end())
+    {
+        return false;
+    }
+    else
+    {
+        it->touch();
+        loc = (*it)[CachePage::offset(ca)];
+        return true;
+    }
+}
+
+void
+CachedMetaDataStore::fetch_pages_(const std::vector<PageAddress>& pas)
+{
+    using Fetch = std::pair<PageAddress, std::shared_ptr<PageFetch>>;
+
+    std::vector<Fetch> fetches;
+    std::vector<std::shared_future<void>> pending;
+
+    {
+        LOCK_CACHE_WRITE;
+
+        for (const auto& pa : pas)
+        {
+            if (page_map_.find(pa, PageCmp()) != page_map_.end())
+            {
+                continue;
+            }
+
+            // evicted but not written back yet - the copy is more recent
+            // than what the backend has
+            const PageWritebackPtr wb(find_writeback_(pa));
+            if (wb)
+            {
+                ++cache_misses_;
+                install_page_(wb->page);
+                continue;
+            }
+
+            auto it = page_fetches_.find(pa);
+            if (it != page_fetches_.end())
+            {
+                pending.push_back(it->second->future);
+            }
+            else
+            {
+                ++cache_misses_;
+                auto fetch(std::make_shared<PageFetch>());
+                page_fetches_.emplace(pa,
+                                      fetch);
+                fetches.emplace_back(pa,
+                                     fetch);
+            }
+        }
+    }
+
+    if (not fetches.empty())
+    {
+        auto unregister([&]
+                        {
+                            ASSERT_CACHE_WRITE_LOCKED;
+                            for (const auto& f : fetches)
+                            {
+                                auto it = page_fetches_.find(f.first);
+                                if (it != page_fetches_.end() and
+                                    it->second == f.second)
+                                {
+                                    page_fetches_.erase(it);
+                                }
+                            }
+                        });
+
+        try
+        {
+            std::vector<ClusterLocationAndHash> data(fetches.size() *
+                                                     CachePage::capacity());
+            std::vector<CachePage> tmp;
+            tmp.reserve(fetches.size());
+
+            std::vector<CachePage*> ptrs;
+            ptrs.reserve(fetches.size());
+
+            for (size_t i = 0; i < fetches.size(); ++i)
+            {
+                tmp.emplace_back(fetches[i].first,
+                                 &data[i * CachePage::capacity()]);
+                ptrs.push_back(&tmp.back());
+            }
+
+            if (backend_->concurrent_reads())
+            {
+                backend_->getPages(ptrs);
+            }
+            else
+            {
+                LOCK_BACKEND;
+                backend_->getPages(ptrs);
+            }
+
+            LOCK_CACHE_WRITE;
+            unregister();
+
+            for (size_t i = 0; i < fetches.size(); ++i)
+            {
+                if (fetches[i].second->stale)
+                {
+                    LOG_TRACE(id_ << ": discarding stale fetch of page " <<
+                              fetches[i].first);
+                }
+                else
+                {
+                    install_page_(tmp[i]);
+                }
+            }
+        }
+        catch (...)
+        {
+            {
+                LOCK_CACHE_WRITE;
+                unregister();
+            }
+
+            for (auto& f : fetches)
+            {
+                f.second->promise.set_exception(std::current_exception());
+            }
+
+            throw;
+        }
+
+        for (auto& f : fetches)
+        {
+            f.second->promise.set_value();
+        }
+    }
+
+    flush_writebacks_();
+
+    for (auto& f : pending)
+    {
+        LOG_TRACE(id_ << ": waiting for pending page fetch");
+        // rethrows the fetcher's exception, if any
+        f.get();
+    }
+}
+
+void
+CachedMetaDataStore::install_page_(const CachePage& src)
+{
+    ASSERT_CACHE_WRITE_LOCKED;
+    ASSERT(page_map_.find(src.page_address(), PageCmp()) == page_map_.end());
+
+    CachePage* page = &grab_page_slot_();
+    page = new(page) CachePage(src.page_address(), page->data());
+    memcpy(page->data(), src.data(), CachePage::size());
+
+    page_map_.insert(*page);
+    page_list_.push_back(*page);
+    ++num_pages_;
+}
+
+CachePage&
+CachedMetaDataStore::grab_page_slot_()
+{
+    ASSERT_CACHE_WRITE_LOCKED;
+
+    CachePage* page;
+
+    if (num_pages_ < pages_.size())
+    {
+        page = &pages_[num_pages_];
+    }
+    else
+    {
+        page = &select_victim_page_();
+        page->unlink_from_list();
+        page->unlink_from_set();
+        --num_pages_;
+
+        if (page->dirty)
+        {
+            queue_writeback_(*page);
+            page->dirty = false;
+        }
+    }
+
+    ASSERT(not page->dirty);
+    ASSERT(not page->is_in_set());
+    ASSERT(not page->is_in_list());
+    ASSERT(num_pages_ < pages_.size());
+
+    return *page;
+}
+
+// CLOCK: sweep the slots, giving pages that were referenced (hit) since the
+// hand last passed them a second chance. All slots are occupied when we get
+// here, so a victim is found after at most one revolution.
+CachePage&
+CachedMetaDataStore::select_victim_page_()
+{
+    ASSERT_CACHE_WRITE_LOCKED;
+    ASSERT(num_pages_ == pages_.size());
+
+    while (true)
+    {
+        CachePage& page = pages_[clock_hand_];
+        clock_hand_ = (clock_hand_ + 1) % pages_.size();
+
+        ASSERT(page.is_in_set());
+        if (not page.clear_referenced())
+        {
+            return page;
+        }
+    }
+}
+
+void
+CachedMetaDataStore::queue_writeback_(const CachePage& page)
+{
+    ASSERT_CACHE_WRITE_LOCKED;
+    ASSERT(page.dirty);
+
+    auto wb(std::make_shared<PageWriteback>(page));
+
+    LOCK_WRITEBACKS;
+
+    auto it = page_writebacks_.find(page.page_address());
+    if (it != page_writebacks_.end())
+    {
+        wb->prev = it->second->future;
+        it->second = wb;
+    }
+    else
+    {
+        page_writebacks_.emplace(page.page_address(),
+                                 wb);
+    }
+
+    queued_writebacks_.push_back(wb);
+}
+
+CachedMetaDataStore::PageWritebackPtr
+CachedMetaDataStore::find_writeback_(const PageAddress& pa) const
+{
+    LOCK_WRITEBACKS;
+
+    auto it = page_writebacks_.find(pa);
+    if (it != page_writebacks_.end())
+    {
+        return it->second;
+    }
+    else
+    {
+        return nullptr;
+    }
+}
+
+void
+CachedMetaDataStore::flush_writebacks_()
+{
+    std::vector<PageWritebackPtr> wbs;
+
+    {
+        LOCK_WRITEBACKS;
+        std::swap(wbs,
+                  queued_writebacks_);
+    }
+
+    for (auto& wb : wbs)
+    {
+        if (wb->prev.valid())
+        {
+            wb->prev.wait();
+        }
+
+        try
+        {
+            maybe_write_page_(wb->page,
+                              false);
+            wb->promise.set_value();
+        }
+        catch (...)
+        {
+            // already logged by maybe_write_page_
+            wb->promise.set_exception(std::current_exception());
+
+            LOCK_WRITEBACKS;
+            if (not writeback_error_)
+            {
+                writeback_error_ = std::current_exception();
+            }
+        }
+
+        LOCK_WRITEBACKS;
+
+        auto it = page_writebacks_.find(wb->page.page_address());
+        if (it != page_writebacks_.end() and
+            it->second == wb)
+        {
+            page_writebacks_.erase(it);
+        }
+    }
+}
+
+void
+CachedMetaDataStore::drain_writebacks_()
+{
+    flush_writebacks_();
+
+    std::vector<std::shared_future<void>> pending;
+
+    {
+        LOCK_WRITEBACKS;
+        pending.reserve(page_writebacks_.size());
+        for (const auto& p : page_writebacks_)
+        {
+            pending.push_back(p.second->future);
+        }
+    }
+
+    for (auto& f : pending)
+    {
+        f.wait();
+    }
+
+    std::exception_ptr err;
+
+    {
+        LOCK_WRITEBACKS;
+        std::swap(err,
+                  writeback_error_);
+    }
+
+    if (err)
+    {
+        std::rethrow_exception(err);
+    }
+}
+
+void
+CachedMetaDataStore::discard_writebacks_()
+{
+    std::vector<PageWritebackPtr> wbs;
+    std::vector<std::shared_future<void>> pending;
+
+    {
+        LOCK_WRITEBACKS;
+        std::swap(wbs,
+                  queued_writebacks_);
+
+        for (const auto& wb : wbs)
+        {
+            auto it = page_writebacks_.find(wb->page.page_address());
+            if (it != page_writebacks_.end() and
+                it->second == wb)
+            {
+                page_writebacks_.erase(it);
+            }
+
+            // might be in progress
+            if (wb->prev.valid())
+            {
+                pending.push_back(wb->prev);
+            }
+        }
+
+        for (const auto& p : page_writebacks_)
+        {
+            pending.push_back(p.second->future);
+        }
+    }
+
+    for (auto& wb : wbs)
+    {
+        wb->promise.set_value();
+    }
+
+    for (auto& f : pending)
+    {
+        f.wait();
+    }
+}
+
 std::pair<CachePage*, bool>
 CachedMetaDataStore::get_page_(const ClusterAddress ca)
 {
@@ -670,33 +1327,34 @@ CachedMetaDataStore::get_page_(const ClusterAddress ca)
     {
         ++cache_misses_;
 
-        if (num_pages_ < pages_.size())
-        {
-            page = &pages_[num_pages_];
-        }
-        else
+        // a reader might be fetching the same page without holding the lock;
+        // the version we're about to bring in takes precedence.
+        auto fit = page_fetches_.find(pa);
+        if (fit != page_fetches_.end())
         {
-            page = &page_list_.front();
-            page->unlink_from_list();
-            page->unlink_from_set();
-            --num_pages_;
-            maybeWritePage_locked_context(*page, false);
+            fit->second->stale = true;
         }
 
-        ASSERT(not page->dirty);
-        ASSERT(not page->is_in_set());
-        ASSERT(not page->is_in_list());
-        ASSERT(num_pages_ < pages_.size());
-
+        page = &grab_page_slot_();
         page = new(page) CachePage(pa, page->data());
 
-        const bool found = backend_->getPage(*page);
-        if (not found)
+        const PageWritebackPtr wb(find_writeback_(pa));
+        if (wb)
         {
-            page->reset();
+            memcpy(page->data(), wb->page.data(), CachePage::size());
+        }
+        else
+        {
+            LOCK_BACKEND;
+            const bool found = backend_->getPage(*page);
+            if (not found)
+            {
+                page->reset();
+            }
         }
 
         page_map_.insert(*page);
+        page_list_.push_back(*page);
         ++num_pages_;
     }
     else
@@ -704,14 +1362,12 @@ CachedMetaDataStore::get_page_(const ClusterAddress ca)
         ++cache_hits_;
         hit = true;
         page = &(*it);
-        page->unlink_from_list();
+        page->touch();
     }
 
-    ASSERT(not page->is_in_list());
+    ASSERT(page->is_in_list());
     ASSERT(page->is_in_set());
 
-    page_list_.push_back(*page);
-
     return std::make_pair(page, hit);
 }
 
@@ -737,16 +1393,19 @@ CachedMetaDataStore::get_page(const ClusterAddress ca)
 
         for (const auto& cork : corks_)
         {
-            for (const auto& p : *cork.second)
-            {
-                if (p.first >= ca_start and p.first < ca_end)
-                {
-                    tmp[CachePage::offset(p.first)] = ClusterLocationAndHash::discarded_location_and_hash();
-                }
-            }
+            cork.second->for_each_in_range(ca_start,
+                                           ca_end,
+                                           [&](const ClusterAddress ca,
+                                               const ClusterLocationAndHash&)
+                                           {
+                                               tmp[CachePage::offset(ca)] =
+                                                   ClusterLocationAndHash::discarded_location_and_hash();
+                                           });
         }
     }
 
+    flush_writebacks_();
+
     for (auto& clh : tmp)
     {
         vec.emplace_back(clh.clusterLocation);
@@ -767,22 +1426,9 @@ CachedMetaDataStore::get_cluster_location_unlocked_(const ClusterAddress ca,
 
     if (for_write)
     {
-        ClusterLocationAndHash& clh = (*page)[CachePage::offset(ca)];
-        if (clh.clusterLocation.isNull() and
-            not loc.clusterLocation.isNull())
-        {
-            page->written_clusters_since_last_backend_write++;
-            written_clusters_++;
-        }
-        else if (not clh.clusterLocation.isNull() and
-                 loc.clusterLocation.isNull())
-        {
-            page->discarded_clusters_since_last_backend_write++;
-            discarded_clusters_++;
-        }
-
-        clh = loc;
-        page->dirty = true;
+        update_page_entry_(*page,
+                           ca,
+                           loc);
     }
     else
     {
@@ -792,6 +1438,62 @@ CachedMetaDataStore::get_cluster_location_unlocked_(const ClusterAddress ca,
     return hit;
 }
 
+bool
+CachedMetaDataStore::write_page_entries_(std::vector<CorkedClusters::Entry>::const_iterator begin,
+                                         std::vector<CorkedClusters::Entry>::const_iterator end)
+{
+    ASSERT(begin != end);
+
+    bool hit;
+
+    {
+        LOCK_CACHE_WRITE;
+
+        CachePage* page;
+        std::tie(page, hit) = get_page_(begin->first);
+        ASSERT(page);
+
+        // keep the stats as if the entries were written one by one
+        cache_hits_ += std::distance(begin, end) - 1;
+
+        for (auto it = begin; it != end; ++it)
+        {
+            ASSERT(CachePage::pageAddress(it->first) == page->page_address());
+            update_page_entry_(*page,
+                               it->first,
+                               it->second);
+        }
+    }
+
+    flush_writebacks_();
+    return hit;
+}
+
+void
+CachedMetaDataStore::update_page_entry_(CachePage& page,
+                                        const ClusterAddress ca,
+                                        const ClusterLocationAndHash& loc)
+{
+    ASSERT_CACHE_WRITE_LOCKED;
+
+    ClusterLocationAndHash& clh = page[CachePage::offset(ca)];
+    if (clh.clusterLocation.isNull() and
+        not loc.clusterLocation.isNull())
+    {
+        page.written_clusters_since_last_backend_write++;
+        written_clusters_++;
+    }
+    else if (not clh.clusterLocation.isNull() and
+             loc.clusterLocation.isNull())
+    {
+        page.discarded_clusters_since_last_backend_write++;
+        discarded_clusters_++;
+    }
+
+    clh = loc;
+    page.dirty = true;
+}
+
 void
 CachedMetaDataStore::dispose_page(backend_mem_fun dispose, CachePage& p)
 {
@@ -813,7 +1515,6 @@ CachedMetaDataStore::dispose_page(backend_mem_fun dispose, CachePage& p)
 bool
 CachedMetaDataStore::possibly_discard_page_(CachePage& p)
 {
-    ASSERT_CACHE_READ_LOCKED;
     ASSERT(p.dirty);
 
     LOCK_BACKEND;
@@ -837,6 +1538,16 @@ CachedMetaDataStore::maybeWritePage_locked_context(CachePage& p,
     //other readers don't change the dirtyness, discarded_clusters_, written_clusters_
 
     ASSERT_CACHE_READ_LOCKED;
+    return maybe_write_page_(p,
+                             ignore_errors);
+}
+
+// Also used for evicted pages, which are not reachable through the cache
+// anymore and hence don't need the cache lock.
+bool
+CachedMetaDataStore::maybe_write_page_(CachePage& p,
+                                       bool ignore_errors)
+{
     if (p.dirty)
     {
         try
@@ -17,15 +17,22 @@
 #define CACHED_METADATA_STORE_H_
 
 #include "CachedMetaDataPage.h"
+#include "CorkedClusters.h"
 #include "MetaDataBackendInterface.h"
 #include "MetaDataStoreInterface.h"
 #include "PageSortingGenerator.h"
 #include "ScrubId.h"
 #include "Types.h"
 
+#include <atomic>
+#include <exception>
+#include <future>
+#include <map>
 #include <memory>
+#include <vector>
 
 #include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
 #include <boost/thread/shared_mutex.hpp>
 
 #include <youtils/Generator.h>
@@ -78,6 +85,16 @@ public:
     readCluster(const ClusterAddress caddr,
                 ClusterLocationAndHash& loc) override final;
 
+    virtual void
+    readClusters(const ClusterAddress start,
+                 const size_t count,
+                 std::vector<ClusterLocationAndHash>& locs) override final;
+
+    virtual void
+    writeClusters(const ClusterAddress* addrs,
+                  const ClusterLocationAndHash* locs,
+                  const size_t count) override final;
+
     // must not be called concurrently by consumers.
     virtual void
     writeCluster(const ClusterAddress caddr,
@@ -221,16 +238,72 @@ private:
     typedef bi::set<CachePage,
                     bi::constant_time_size<false> > map_type;
 
+    // The list holds all cached pages in the order they were brought in - it
+    // is *not* kept in LRU order as that would require relinking (and hence an
+    // exclusive lock) on each cache hit. Eviction instead runs a CLOCK hand
+    // over pages_ (see select_victim_page_).
     typedef bi::list<CachePage,
                      bi::constant_time_size<false> > list_type;
 
     map_type page_map_;
     list_type page_list_;
     uint64_t num_pages_;
-    uint64_t cache_hits_;
-    uint64_t cache_misses_;
-    uint64_t written_clusters_;
-    uint64_t discarded_clusters_;
+    size_t clock_hand_;
+    std::atomic<uint64_t> cache_hits_;
+    std::atomic<uint64_t> cache_misses_;
+
+    // Pages that are being fetched from the backend by a reader that does not
+    // hold the cache lock. Concurrent misses on the same page wait for the
+    // pending fetch instead of issuing another one.
+    struct PageFetch
+    {
+        PageFetch()
+            : future(promise.get_future().share())
+            , stale(false)
+        {}
+
+        std::promise<void> promise;
+        std::shared_future<void> future;
+        // set (under the exclusive cache lock) if the page was brought in or
+        // the cache was invalidated by other means while the fetch was in
+        // progress - the fetched data must not be used then.
+        bool stale;
+    };
+
+    typedef std::map<PageAddress, std::shared_ptr<PageFetch>> page_fetches_type;
+    page_fetches_type page_fetches_;
+
+    // Dirty pages are not written back while evicting them under the cache
+    // lock but handed off to a writeback that is carried out once the lock was
+    // dropped. Until then lookups of the page use the copy kept here instead
+    // of going to the backend.
+    struct PageWriteback
+    {
+        explicit PageWriteback(const CachePage& p)
+            : data(CachePage::capacity())
+            , page(p, data.data())
+            , future(promise.get_future().share())
+        {}
+
+        std::vector<ClusterLocationAndHash> data;
+        CachePage page;
+        std::promise<void> promise;
+        std::shared_future<void> future;
+        // an earlier writeback of the same page that has to go first
+        std::shared_future<void> prev;
+    };
+
+    typedef std::shared_ptr<PageWriteback> PageWritebackPtr;
+
+    // protected by writeback_lock_: the latest writeback per page, the ones
+    // nobody has started yet and the first error no one was told about.
+    std::map<PageAddress, PageWritebackPtr> page_writebacks_;
+    std::vector<PageWritebackPtr> queued_writebacks_;
+    std::exception_ptr writeback_error_;
+
+    // written back pages are accounted without holding the cache lock
+    std::atomic<uint64_t> written_clusters_;
+    std::atomic<uint64_t> discarded_clusters_;
 
     const std::string id_;
 
@@ -240,22 +313,28 @@ private:
     mutable boost::mutex uncork_dbg_mutex_;
 #endif
 
-    // Ze locks - to be taken in this very order.
+    // Ze locks - to be taken in this very order. The writeback lock is never
+    // held while taking the backend lock, waiting for a writeback or a fetch.
     mutable boost::shared_mutex corks_lock_;
     mutable boost::shared_mutex cache_lock_;
+    mutable boost::mutex writeback_lock_;
     mutable boost::mutex backend_lock_;
 
     boost::optional<youtils::UUID> cork_uuid_;
     MaybeScrubId scrub_id_;
 
-    typedef std::map<ClusterAddress, ClusterLocationAndHash> ca_loc_map_type;
-    typedef std::shared_ptr<ca_loc_map_type> ca_loc_map_ptr_type;
-    typedef std::pair<youtils::UUID, ca_loc_map_ptr_type> cork_t;
+    typedef std::shared_ptr<CorkedClusters> corked_clusters_ptr_type;
+    typedef std::pair<youtils::UUID, corked_clusters_ptr_type> cork_t;
     // orders latest cork at the end
     typedef std::list<cork_t> corks_t;
 
     corks_t corks_;
 
+    // number of lookups that went through the corks and the total number of
+    // corks probed by them (-> average lookup depth)
+    std::atomic<uint64_t> cork_lookups_;
+    std::atomic<uint64_t> cork_lookup_depth_;
+
     uint64_t
     processPages(std::unique_ptr<youtils::Generator<PageData>> r,
                  SCOCloneID cloneid);
@@ -280,6 +359,15 @@ private:
                                    ClusterLocationAndHash& loc,
                                    bool for_write);
 
+    bool
+    write_page_entries_(std::vector<CorkedClusters::Entry>::const_iterator begin,
+                        std::vector<CorkedClusters::Entry>::const_iterator end);
+
+    void
+    update_page_entry_(CachePage& page,
+                       const ClusterAddress ca,
+                       const ClusterLocationAndHash& loc);
+
     bool
     get_cluster_location_(const ClusterAddress,
                           ClusterLocationAndHash&,
@@ -288,6 +376,47 @@ private:
     std::pair<CachePage*, bool>
     get_page_(const ClusterAddress);
 
+    // requires (at least) a shared cache lock
+    bool
+    get_cached_cluster_location_(const ClusterAddress,
+                                 ClusterLocationAndHash&);
+
+    // to be called without holding the cache lock
+    void
+    fetch_pages_(const std::vector<PageAddress>&);
+
+    void
+    install_page_(const CachePage&);
+
+    // Dirty victims are queued for writeback - callers need to
+    // flush_writebacks_() once they dropped the cache lock.
+    CachePage&
+    grab_page_slot_();
+
+    // requires the exclusive cache lock
+    void
+    queue_writeback_(const CachePage&);
+
+    PageWritebackPtr
+    find_writeback_(const PageAddress&) const;
+
+    // Carries out the queued writebacks; to be called without holding the
+    // cache lock. Errors are logged and reported by the next drain_writebacks_.
+    void
+    flush_writebacks_();
+
+    // Carries out the queued writebacks and waits for those in progress, which
+    // is required before moving the cork on the backend.
+    void
+    drain_writebacks_();
+
+    // Drops the queued writebacks and waits for those in progress.
+    void
+    discard_writebacks_();
+
+    CachePage&
+    select_victim_page_();
+
     typedef void (MetaDataBackendInterface::*backend_mem_fun)(const CachePage&,
                                                               int32_t);
 
@@ -302,6 +431,10 @@ private:
     maybeWritePage_locked_context(CachePage& p,
                                   bool ignore_errors);
 
+    bool
+    maybe_write_page_(CachePage& p,
+                      bool ignore_errors);
+
     uint64_t
     processTLogReaderInterface(std::shared_ptr<TLogReaderInterface> r,
                                SCOCloneID cloneid);
@@ -29,8 +29,10 @@
 #include "ClusterCacheMode.h"
 #include "ClusterLocationAndHash.h"
 
-#include <atomic>
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <deque>
 #include <list>
 #include <string>
 #include <utility>
@@ -42,12 +44,16 @@
 #include <boost/filesystem/fstream.hpp>
 #include <boost/intrusive/list.hpp>
 #include <boost/intrusive/set.hpp>
+#include <boost/optional.hpp>
+#include <boost/thread/condition_variable.hpp>
 #include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
 
 #include <youtils/Catchers.h>
 #include <youtils/FileUtils.h>
 #include <youtils/Logging.h>
 #include <youtils/RWLock.h>
+#include <youtils/ScopeExit.h>
 #include <youtils/Serialization.h>
 #include <youtils/VolumeDriverComponent.h>
 #include <youtils/Md5.h>
@@ -80,10 +86,22 @@ struct SearchOldInNews
         {
             if (mpc.path == mpc_.path)
             {
-                if (mpc.size == mpc_.size)
+                if (mpc.size == mpc_.size and
+                    mpc.io_mode == mpc_.io_mode)
                 {
                     return true;
                 }
+                else if (mpc.size == mpc_.size)
+                {
+                    std::stringstream ss;
+
+                    ss << "Cannot change the io mode of mountpoint " << mpc_.path
+                       << " from " << mpc_.io_mode
+                       << " to " << mpc.io_mode;
+                    message = ss.str();
+
+                    return false;
+                }
                 else
                 {
                     std::stringstream ss;
@@ -239,6 +257,30 @@ struct SListNodeValueTraits: NodeValueTraits<T, SListNodeTraits>
     static const boost::intrusive::link_mode_type link_mode = boost::intrusive::normal_link;
 };
 
+// A cluster to be looked up with ClusterCacheT::read(handle, reqs). The fill_*
+// members record the state of the cache at lookup time such that a miss can be
+// filled in later on without overwriting newer data (cf. ClusterCacheT::fill).
+struct ClusterCacheReadRequest
+{
+    ClusterCacheReadRequest(const ClusterAddress a,
+                            const youtils::Weed& w,
+                            uint8_t* b)
+        : ca(a)
+        , weed(w)
+        , buf(b)
+        , hit(false)
+        , fill_generation(0)
+        , fill_epoch(0)
+    {}
+
+    ClusterAddress ca;
+    youtils::Weed weed;
+    uint8_t* buf;
+    bool hit;
+    uint64_t fill_generation;
+    uint64_t fill_epoch;
+};
+
 template<typename T,
          uint64_t logging_interval = (1 << 19)>
 class ClusterCacheT
@@ -274,6 +316,56 @@ private:
 
     typedef boost::intrusive::circular_list_algorithms<DListNodeTraits<ClusterCacheEntry>> dlist_algo;
 
+    // The cache is split into shards (picked by a hash of the ClusterCacheKey)
+    // so concurrent readers and writers don't all contend on a single lock and
+    // a single LRU list. Each shard has its own rwlock, its own listlock (which
+    // protects the LRU lists against concurrent updates by readers) and its own
+    // global LRU / invalidated entries.
+    // An entry belongs to exactly one shard at any time and is only accessed with
+    // that shard locked. Operations spanning several shards (namespace
+    // (de)registration, limits, device offlining) lock all of them in index order.
+    static constexpr uint64_t shard_bits_ = 5;
+    static constexpr size_t num_shards_ = 1ULL << shard_bits_;
+
+    // LocationBased entries can be overwritten or invalidated while a fill (cf.
+    // fill()) for the same key is pending. This is detected with a generation
+    // counter per bucket of key hashes, bumped with the key's shard locked
+    // exclusively.
+    static constexpr uint64_t fill_generation_bits_ = 12;
+    static constexpr size_t num_fill_generations_ = 1ULL << fill_generation_bits_;
+
+    // Upper bound for the data of fills queued for the background thread.
+    static constexpr uint64_t max_pending_fill_bytes_ = 64ULL << 20;
+
+    struct Fill
+    {
+        Fill(const ClusterCacheHandle h,
+             const ClusterCacheKey& k,
+             const uint8_t* buf,
+             const size_t size,
+             const uint64_t gen,
+             const uint64_t ep)
+            : handle(h)
+            , key(k)
+            , data(buf, buf + size)
+            , generation(gen)
+            , epoch(ep)
+        {}
+
+        ClusterCacheHandle handle;
+        ClusterCacheKey key;
+        std::vector<uint8_t> data;
+        uint64_t generation;
+        uint64_t epoch;
+    };
+
+    // The part of a Namespace that lives in one shard.
+    struct Slice
+    {
+        cachemap_t map;
+        dlist_t lru;
+    };
+
     // A ClusterCache Namespace (CNS, associated with a ClusterCacheHandle) is used to
     // limit the size of the cachemap it contains. The idea is to maintain a global
     // LRU and an LRU per CNS.
@@ -283,13 +375,18 @@ private:
     // * size limit and size limit reached:
     // * check the CNS'es LRU
     // .
+    // The map is split into one Slice per shard. A CNS with a size limit keeps all
+    // its entries in the Slice of its home shard (cf. home_shard_) such that its
+    // LRU remains exact.
     // NB: Yes, there's some potential for confusion with backend::Namespace - feel
     // free to rename to something better.
     struct Namespace
     {
-        cachemap_t map;
-        dlist_t lru;
+        std::array<Slice, num_shards_> slices;
         boost::optional<uint64_t> max_entries;
+        // spine size exponent of the namespace as a whole - this is what gets
+        // serialized, the owner lays out the slices accordingly.
+        uint64_t size_exp = 0;
 
         Namespace() = default;
 
@@ -300,6 +397,39 @@ private:
         Namespace&
         operator=(const Namespace&) = delete;
 
+        uint64_t
+        entries() const
+        {
+            uint64_t n = 0;
+            for (const auto& s : slices)
+            {
+                n += s.map.entries();
+            }
+
+            return n;
+        }
+
+        void
+        resize(const uint64_t exp,
+               const size_t home)
+        {
+            size_exp = exp;
+
+            for (size_t i = 0; i < slices.size(); ++i)
+            {
+                if (max_entries)
+                {
+                    slices[i].map.resize(i == home ? exp : 0);
+                }
+                else
+                {
+                    slices[i].map.resize(exp > shard_bits_ ?
+                                         exp - shard_bits_ :
+                                         0);
+                }
+            }
+        }
+
         BOOST_SERIALIZATION_SPLIT_MEMBER();
 
         template<typename Archive>
@@ -307,13 +437,14 @@ private:
         load(Archive& ar,
              const unsigned /* version */)
         {
-            VERIFY(map.empty());
-            VERIFY(lru.empty());
+            for (const auto& s : slices)
+            {
+                VERIFY(s.map.empty());
+                VERIFY(s.lru.empty());
+            }
 
             ar & max_entries;
-            uint64_t size_exp;
             ar & size_exp;
-            map.resize(size_exp);
         }
 
         template<typename Archive>
@@ -322,24 +453,95 @@ private:
              const unsigned int /* version */) const
         {
             ar & max_entries;
-            const uint64_t size_exp = map.spine_size_exp();
             ar & size_exp;
         }
     };
 
+    struct Shard
+    {
+        Shard()
+            : rwlock("ClusterCacheShard")
+            , hits(0)
+            , misses(0)
+        {}
+
+        ~Shard() = default;
+
+        Shard(const Shard&) = delete;
+
+        Shard&
+        operator=(const Shard&) = delete;
+
+        mutable fungi::RWLock rwlock;
+        mutable boost::mutex listlock;
+        dlist_t lru;
+        dlist_t invalidated_entries;
+        std::atomic<uint64_t> hits;
+        std::atomic<uint64_t> misses;
+    };
+
+    using ShardArray = std::array<Shard, num_shards_>;
+
+    template<bool exclusive>
+    class AllShardsLock
+    {
+    public:
+        explicit AllShardsLock(const ShardArray& shards)
+            : shards_(shards)
+        {
+            for (const auto& s : shards_)
+            {
+                if (exclusive)
+                {
+                    s.rwlock.writeLock();
+                }
+                else
+                {
+                    s.rwlock.readLock();
+                }
+            }
+        }
+
+        ~AllShardsLock()
+        {
+            for (auto it = shards_.rbegin(); it != shards_.rend(); ++it)
+            {
+                it->rwlock.unlock();
+            }
+        }
+
+        AllShardsLock(const AllShardsLock&) = delete;
+
+        AllShardsLock&
+        operator=(const AllShardsLock&) = delete;
+
+    private:
+        const ShardArray& shards_;
+    };
+
+    using AllShardsReadLock = AllShardsLock<false>;
+    using AllShardsWriteLock = AllShardsLock<true>;
+
 public:
     struct NamespaceInfo
     {
         NamespaceInfo(const ClusterCacheHandle h,
                       const Namespace& n)
             : handle(h)
-            , entries(n.map.entries())
+            , entries(n.entries())
             , max_entries(n.max_entries)
-            , map_stats(n.map.stats().size())
         {
-            for (const auto& s : n.map.stats())
+            for (const auto& slice : n.slices)
             {
-                map_stats[s.first] = s.second;
+                for (const auto& s : slice.map.stats())
+                {
+                    if (map_stats.size() <= s.first)
+                    {
+                        map_stats.resize(s.first + 1);
+                    }
+
+                    map_stats[s.first] += s.second;
+                }
             }
         }
 
@@ -358,8 +560,7 @@ private:
     typedef boost::mutex register_lock_type;
     register_lock_type register_lock_;
 
-    mutable fungi::RWLock rwlock;
-    mutable boost::mutex listlock;
+    ShardArray shards_;
 
     DECLARE_PARAMETER(serialize_read_cache);
     DECLARE_PARAMETER(read_cache_serialization_path);
@@ -371,12 +572,21 @@ private:
     ManagerType manager_;
 
     using NamespaceMap = std::map<ClusterCacheHandle, std::unique_ptr<Namespace>>;
+    // only modified with all shards locked exclusively, hence holding any
+    // shard lock is good enough for lookups
     NamespaceMap namespaces_;
 
-    dlist_t invalidated_entries_;
-    dlist_t lru_;
-    std::atomic<uint64_t> num_hits;
-    std::atomic<uint64_t> num_misses;
+    // Fills are handed to fill_thread_ if any mountpoint is in DirectAsync mode
+    // to keep the writes to the cache devices off the read path.
+    bool async_fills_;
+    boost::mutex fill_lock_;
+    boost::condition_variable fill_cond_;
+    std::deque<Fill> fills_;
+    bool stop_fills_;
+    std::array<std::atomic<uint64_t>, num_fill_generations_> fill_generations_;
+    // bumped whenever a namespace is removed, which also invalidates pending fills
+    std::atomic<uint64_t> deregistrations_;
+    boost::thread fill_thread_;
 
     BOOST_SERIALIZATION_SPLIT_MEMBER();
 
@@ -413,11 +623,17 @@ private:
             VERIFY(size_exp < 64);
 
             Namespace* nspace = maybe_create_namespace_(content_based_handle);
-            nspace->map.resize(size_exp);
+            nspace->resize(size_exp,
+                           home_shard_(content_based_handle));
         }
         else
         {
             ar & namespaces_;
+            for (auto& v : namespaces_)
+            {
+                v.second->resize(v.second->size_exp,
+                                 home_shard_(v.first));
+            }
         }
 
         auto load_entry([&](T*& device,
@@ -493,19 +709,24 @@ private:
                     device->check(*entry);
                 }
 
-                Namespace* nspace = find_namespace_(make_handle_(entry->mode(),
-                                                                 entry->key));
+                const ClusterCacheHandle handle(make_handle_(entry->mode(),
+                                                             entry->key));
+                Namespace* nspace = find_namespace_(handle);
 
                 VERIFY(nspace);
-                nspace->map.insert(*entry);
+                const size_t idx = shard_index_(handle,
+                                                *nspace,
+                                                entry->key);
+                Slice& slice = nspace->slices[idx];
+                slice.map.insert(*entry);
                 if (nspace->max_entries)
                 {
-                    VERIFY(nspace->map.entries() <= *nspace->max_entries);
-                    nspace->lru.push_back(*entry);
+                    VERIFY(slice.map.entries() <= *nspace->max_entries);
+                    slice.lru.push_back(*entry);
                 }
                 else
                 {
-                    lru_.push_back(*entry);
+                    shards_[idx].lru.push_back(*entry);
                 }
             }
         }
@@ -529,7 +750,7 @@ private:
                            entry);
                 if (entry)
                 {
-                    invalidated_entries_.push_back(*entry);
+                    shards_[key_shard_(entry->key)].invalidated_entries.push_back(*entry);
                 }
             }
         }
@@ -552,7 +773,7 @@ private:
         uint32_t size = 0;
         for (const auto& v : namespaces_)
         {
-            size += v.second->map.entries();
+            size += v.second->entries();
         }
 
         ar & size;
@@ -592,20 +813,34 @@ private:
                           });
 
         for (const auto& v : namespaces_)
+        {
+            for (const auto& slice : v.second->slices)
+            {
+                save_entries("entries",
+                             slice.lru);
+            }
+        }
+
+        for (const auto& shard : shards_)
         {
             save_entries("entries",
-                         v.second->lru);
+                         shard.lru);
         }
 
-        save_entries("entries",
-                     lru_);
+        size = 0;
+        for (const auto& shard : shards_)
+        {
+            size += shard.invalidated_entries.size();
+        }
 
-        size = invalidated_entries_.size();
         ar & size;
         k = 0;
 
-        save_entries("invalidated entries",
-                     invalidated_entries_);
+        for (const auto& shard : shards_)
+        {
+            save_entries("invalidated entries",
+                         shard.invalidated_entries);
+        }
     }
 
 private:
@@ -643,8 +878,9 @@ private:
         if (not nspace)
         {
             auto ns(std::make_unique<Namespace>());
-            ns->map.resize(average_entries_per_bin.value(),
-                           manager_.totalSizeInEntries());
+            ns->resize(cachemap_t::best_size(average_entries_per_bin.value(),
+                                             manager_.totalSizeInEntries()),
+                       home_shard_(handle));
 
             auto res(namespaces_.emplace(handle,
                                          std::move(ns)));
@@ -671,18 +907,165 @@ private:
         VERIFY(0 == "venturing into unchartered code paths");
     }
 
+    static uint64_t
+    key_hash_(const ClusterCacheKey& key)
+    {
+        // ClusterCacheMap picks the bin from the low bits of the first word of the
+        // key - mix in the second word and use the high bits of the (Fibonacci)
+        // hash to keep shard and bin selection independent.
+        const uint64_t* w = reinterpret_cast<const uint64_t*>(&key);
+        return (w[0] ^ (w[1] * fib_hash_mult_)) * fib_hash_mult_;
+    }
+
+    static size_t
+    key_shard_(const ClusterCacheKey& key)
+    {
+        return key_hash_(key) >> (64 - shard_bits_);
+    }
+
+    std::atomic<uint64_t>&
+    fill_generation_(const ClusterCacheKey& key)
+    {
+        return fill_generations_[key_hash_(key) >> (64 - fill_generation_bits_)];
+    }
+
+    static boost::optional<ClusterCacheKey>
+    make_key_(const ClusterCacheHandle handle,
+              const ClusterAddress ca,
+              const youtils::Weed& weed)
+    {
+        if (handle != content_based_handle)
+        {
+            return ClusterCacheKey(handle,
+                                   ca);
+        }
+        else if (weed != youtils::Weed::null())
+        {
+            return ClusterCacheKey(weed);
+        }
+        else
+        {
+            return boost::none;
+        }
+    }
+
+    static size_t
+    home_shard_(const ClusterCacheHandle handle)
+    {
+        return (static_cast<uint64_t>(handle) * fib_hash_mult_) >> (64 - shard_bits_);
+    }
+
+    static size_t
+    shard_index_(const ClusterCacheHandle handle,
+                 const Namespace& nspace,
+                 const ClusterCacheKey& key)
+    {
+        return nspace.max_entries ?
+            home_shard_(handle) :
+            key_shard_(key);
+    }
+
+    // Invokes fun(Namespace&, shard index) with the shard the key belongs to
+    // locked. The shard depends on whether the namespace has a size limit which
+    // can only be looked at with a shard lock held, hence the retry.
+    template<typename Lock,
+             typename F>
+    auto
+    with_locked_shard_(const ClusterCacheHandle handle,
+                       const ClusterCacheKey& key,
+                       F&& fun) -> decltype(fun(std::declval<Namespace&>(),
+                                                std::declval<size_t>()))
+    {
+        size_t idx = key_shard_(key);
+
+        while (true)
+        {
+            Lock l(shards_[idx].rwlock);
+
+            Namespace* nspace = find_namespace_(handle);
+            VERIFY(nspace);
+
+            const size_t home = shard_index_(handle,
+                                             *nspace,
+                                             key);
+            if (home == idx)
+            {
+                return fun(*nspace,
+                           idx);
+            }
+
+            idx = home;
+        }
+    }
+
     ClusterCacheEntry*
-    get_invalidated_cache_entry_()
+    get_invalidated_cache_entry_(Shard& shard)
     {
-        if (not invalidated_entries_.empty())
+        if (not shard.invalidated_entries.empty())
         {
-            ClusterCacheEntry* entry = &invalidated_entries_.back();
-            invalidated_entries_.pop_back();
+            ClusterCacheEntry* entry = &shard.invalidated_entries.back();
+            shard.invalidated_entries.pop_back();
             return entry;
         }
         return nullptr;
     }
 
+    // Requires shard idx to be locked exclusively.
+    ClusterCacheEntry*
+    recycle_lru_entry_(const size_t idx)
+    {
+        Shard& shard = shards_[idx];
+        if (shard.lru.empty())
+        {
+            return nullptr;
+        }
+
+        ClusterCacheEntry* entry = &shard.lru.back();
+        shard.lru.pop_back();
+
+        Namespace* old_nspace = find_namespace_(make_handle_(entry->mode(),
+                                                             entry->key));
+        VERIFY(old_nspace);
+        const bool ignore = old_nspace->slices[idx].map.remove(*entry);
+        VERIFY(ignore);
+
+        return entry;
+    }
+
+    // Last resort if the shard idx (locked exclusively by the caller) has nothing
+    // left to recycle: take an entry from another shard. Only try locks are used
+    // as we're already holding a shard lock.
+    ClusterCacheEntry*
+    steal_entry_(const size_t idx)
+    {
+        for (size_t i = 1; i < shards_.size(); ++i)
+        {
+            const size_t other = (idx + i) % shards_.size();
+            Shard& shard = shards_[other];
+
+            if (shard.rwlock.tryWriteLock())
+            {
+                auto on_exit(youtils::make_scope_exit([&]
+                                                      {
+                                                          shard.rwlock.unlock();
+                                                      }));
+
+                ClusterCacheEntry* entry = get_invalidated_cache_entry_(shard);
+                if (not entry)
+                {
+                    entry = recycle_lru_entry_(other);
+                }
+
+                if (entry)
+                {
+                    return entry;
+                }
+            }
+        }
+
+        return nullptr;
+    }
+
     ClusterCacheMode
     get_cache_entry_mode(const ClusterCacheHandle handle)
     {
@@ -704,16 +1087,21 @@ public:
         : VolumeDriverComponent(registerizle,
                                 pt)
         , register_lock_()
-        , rwlock("rwlock")
         , serialize_read_cache(pt)
         , read_cache_serialization_path(pt)
         , average_entries_per_bin(pt)
         , clustercache_mount_points(pt)
         , cluster_size_(csize)
         , manager_(cluster_size_)
-        , num_hits(0)
-        , num_misses(0)
+        , async_fills_(false)
+        , stop_fills_(false)
+        , deregistrations_(0)
     {
+        for (auto& g : fill_generations_)
+        {
+            g = 0;
+        }
+
         fs::path serialization_path(getClusterCacheSerializationPath());
         if (serialize_read_cache.value())
         {
@@ -753,8 +1141,16 @@ public:
              it != clustercache_mount_points.value().end();
              ++it)
         {
+            // the io mode of reinstated devices is not serialized
+            T* dev = manager_.getDeviceFromPath(it->path);
+            if (dev)
+            {
+                dev->set_io_mode(it->io_mode);
+            }
+
             if (maybeAddDevice(it->path,
-                               it->size))
+                               it->size,
+                               it->io_mode))
             {
                 ++added;
             }
@@ -762,6 +1158,11 @@ public:
             {
                 ++not_added;
             }
+
+            if (it->io_mode == MountPointIoMode::DirectAsync)
+            {
+                async_fills_ = true;
+            }
         }
 
         LOG_INFO("Added " << added << " devices, "
@@ -769,6 +1170,11 @@ public:
 
         Namespace* cns = maybe_create_namespace_(content_based_handle);
         VERIFY(cns);
+
+        fill_thread_ = boost::thread([this]
+                                     {
+                                         run_fills_();
+                                     });
     }
 
     virtual void
@@ -789,7 +1195,8 @@ public:
         for (const auto& mp : new_mount_points.value())
         {
             maybeAddDevice(mp.path,
-                           mp.size);
+                           mp.size,
+                           mp.io_mode);
         }
     }
 
@@ -828,6 +1235,8 @@ public:
 
     ~ClusterCacheT()
     {
+        stop_fill_thread_();
+
         if (serialize_read_cache.value())
         {
             try
@@ -859,7 +1268,7 @@ public:
                                         static_cast<uint64_t>(otag) :
                                         0);
 
-        fungi::ScopedWriteLock l(rwlock);
+        AllShardsWriteLock l(shards_);
 
         if (mode == ClusterCacheMode::ContentBased)
         {
@@ -877,7 +1286,7 @@ public:
         VERIFY(otag != OwnerTag(0));
         const ClusterCacheHandle handle(static_cast<uint64_t>(otag));
 
-        fungi::ScopedWriteLock l(rwlock);
+        AllShardsWriteLock l(shards_);
         deregister_(handle);
     }
 
@@ -891,95 +1300,135 @@ public:
             throw InvalidClusterCacheConfig("Invalid max entries");
         }
 
-        fungi::ScopedWriteLock l(rwlock);
+        AllShardsWriteLock l(shards_);
 
         Namespace* nspace = find_namespace_or_throw_(handle);
 
         LOG_INFO(handle << ": changing max entries from " <<
                  nspace->max_entries << " to " << limit);
 
+        const size_t home = home_shard_(handle);
+        const uint64_t size_exp =
+            cachemap_t::best_size(average_entries_per_bin.value(),
+                                  limit ?
+                                  *limit :
+                                  manager_.totalSizeInEntries());
+
+        if (not nspace->max_entries and not limit)
+        {
+            nspace->resize(size_exp,
+                           home);
+            return;
+        }
+
+        // Take all entries out of the namespace, most recently used ones first, and
+        // put them back (into the slices they belong to under the new limit)
+        // afterwards, invalidating the least recently used ones that exceed it.
+        dlist_t entries;
+        uint64_t count = 0;
+
         if (nspace->max_entries)
         {
-            if (limit)
+            Slice& slice = nspace->slices[home];
+            while (not slice.lru.empty())
             {
-                const int64_t surplus = nspace->map.entries() - *limit;
-                for (int64_t i = 0; i < surplus; ++i)
-                {
-                    VERIFY(not nspace->lru.empty());
-                    ClusterCacheEntry& e = nspace->lru.back();
-                    nspace->lru.pop_back();
-                    nspace->map.remove(e);
-                    invalidated_entries_.push_front(e);
-                }
+                ClusterCacheEntry& e = slice.lru.front();
+                slice.lru.pop_front();
+                const bool ok = slice.map.remove(e);
+                VERIFY(ok);
+                entries.push_back(e);
+                ++count;
+            }
+        }
+        else
+        {
+            // There's no LRU order across shards. Use the order of keys instead
+            // (lower ones get dropped first), which is what iterating over the
+            // map used to amount to.
+            std::vector<ClusterCacheEntry*> vec;
+            vec.reserve(nspace->entries());
 
-                VERIFY(nspace->map.entries() <= *limit);
+            for (auto& slice : nspace->slices)
+            {
+                slice.map.for_each([&](ClusterCacheEntry& e)
+                                   {
+                                       unlink_entry_from_dlist_(e);
+                                       vec.push_back(&e);
+                                   });
             }
-            else
+
+            if (vec.size() > *limit)
             {
-                while (not nspace->lru.empty())
-                {
-                    ClusterCacheEntry& e = nspace->lru.front();
-                    nspace->lru.pop_front();
-                    lru_.push_back(e);
-                }
+                LOG_INFO(handle << ": imposing a max entries limit of " <<
+                         *limit <<
+                         " on a previously unlimited namespace that contains " <<
+                         vec.size() <<
+                         " - this is expensive and loses LRU information!");
+            }
+
+            std::sort(vec.begin(),
+                      vec.end(),
+                      [](const ClusterCacheEntry* a,
+                         const ClusterCacheEntry* b)
+                      {
+                          return a->key.cluster_address() < b->key.cluster_address();
+                      });
+
+            for (ClusterCacheEntry* e : vec)
+            {
+                const bool ok = nspace->slices[key_shard_(e->key)].map.remove(*e);
+                VERIFY(ok);
+                entries.push_front(*e);
+                ++count;
             }
         }
-        else
+
+        if (limit)
         {
-            VERIFY(nspace->lru.empty());
-            if (limit)
+            for (; count > *limit; --count)
             {
-                int64_t surplus = nspace->map.entries() - *limit;
+                VERIFY(not entries.empty());
+                ClusterCacheEntry& e = entries.back();
+                entries.pop_back();
+                shards_[key_shard_(e.key)].invalidated_entries.push_front(e);
+            }
+        }
 
-                if (surplus > 0)
-                {
-                    LOG_INFO(handle << ": imposing a max entries limit of " <<
-                             *limit <<
-                             " on a previously unlimited namespace that contains " <<
-                             nspace->map.entries() <<
-                             " - this is expensive and loses LRU information!");
-                }
+        nspace->max_entries = limit;
+        nspace->resize(size_exp,
+                       home);
 
-                dlist_t to_invalidate;
-                nspace->map.for_each([&](ClusterCacheEntry& e)
-                                     {
-                                         unlink_entry_from_dlist_(e);
-                                         if (surplus > 0)
-                                         {
-                                             to_invalidate.push_front(e);
-                                             --surplus;
-                                         }
-                                         else
-                                         {
-                                             nspace->lru.push_front(e);
-                                         }
-                                     });
+        while (not entries.empty())
+        {
+            ClusterCacheEntry& e = entries.front();
+            entries.pop_front();
 
-                while (not to_invalidate.empty())
-                {
-                    ClusterCacheEntry& e = to_invalidate.front();
-                    to_invalidate.pop_front();
-                    const bool ok = nspace->map.remove(e);
-                    VERIFY(ok);
-                    invalidated_entries_.push_front(e);
-                }
+            const size_t idx = shard_index_(handle,
+                                            *nspace,
+                                            e.key);
+            Slice& slice = nspace->slices[idx];
+            slice.map.insert(e);
 
-                VERIFY(nspace->map.entries() <= *limit);
+            if (limit)
+            {
+                slice.lru.push_back(e);
+            }
+            else
+            {
+                shards_[idx].lru.push_back(e);
             }
         }
 
-        nspace->map.resize(average_entries_per_bin.value(),
-                           limit ?
-                           *limit :
-                           manager_.totalSizeInEntries());
-
-        nspace->max_entries = limit;
+        if (limit)
+        {
+            VERIFY(nspace->entries() <= *limit);
+        }
     }
 
     boost::optional<uint64_t>
     get_max_entries(const ClusterCacheHandle handle) const
     {
-        fungi::ScopedReadLock l(rwlock);
+        fungi::ScopedReadLock l(shards_[0].rwlock);
 
         Namespace* nspace = find_namespace_or_throw_(handle);
         return nspace->max_entries;
@@ -988,7 +1437,7 @@ public:
     NamespaceInfo
     namespace_info(const ClusterCacheHandle handle) const
     {
-        fungi::ScopedReadLock l(rwlock);
+        AllShardsReadLock l(shards_);
 
         Namespace* nspace = find_namespace_or_throw_(handle);
         return NamespaceInfo(handle,
@@ -1004,7 +1453,7 @@ public:
             throw InvalidClusterCacheOperation("Cannot remove the handle for ContentBased entries");
         }
 
-        fungi::ScopedWriteLock l(rwlock);
+        AllShardsWriteLock l(shards_);
         deregister_(handle);
     }
 
@@ -1012,7 +1461,7 @@ public:
     list_namespaces() const
     {
         std::vector<ClusterCacheHandle> vec;
-        fungi::ScopedReadLock l(rwlock);
+        fungi::ScopedReadLock l(shards_[0].rwlock);
         vec.reserve(namespaces_.size());
 
         for (const auto& v : namespaces_)
@@ -1052,16 +1501,22 @@ public:
     {
         if (handle != content_based_handle)
         {
-            fungi::ScopedWriteLock l(rwlock);
-            Namespace* nspace = find_namespace_(handle);
-            VERIFY(nspace);
-            ClusterCacheEntry* entry = nspace->map.find(key);
-            if (entry)
+            with_locked_shard_<fungi::ScopedWriteLock>(handle,
+                                                       key,
+                                                       [&](Namespace& nspace,
+                                                           const size_t idx)
             {
-                nspace->map.remove(*entry);
-                unlink_entry_from_dlist_(*entry);
-                invalidated_entries_.push_back(*entry);
-            }
+                ++fill_generation_(key);
+
+                Slice& slice = nspace.slices[idx];
+                ClusterCacheEntry* entry = slice.map.find(key);
+                if (entry)
+                {
+                    slice.map.remove(*entry);
+                    unlink_entry_from_dlist_(*entry);
+                    shards_[idx].invalidated_entries.push_back(*entry);
+                }
+            });
         }
     }
 
@@ -1097,123 +1552,30 @@ public:
     {
         VERIFY(bufsize == static_cast<size_t>(cluster_size()));
 
-        fungi::ScopedWriteLock l(rwlock);
-
-        // Really only serves as documentation - the rwlock should rule
-        // out concurrent accesses already hence we can be lazy and use
-        // listlock rather coarsely.
-        boost::lock_guard<decltype(listlock)> llg(listlock);
-
-        Namespace* nspace = find_namespace_(handle);
-        VERIFY(nspace);
+        T* failed =
+            with_locked_shard_<fungi::ScopedWriteLock>(handle,
+                                                       key,
+                                                       [&](Namespace& nspace,
+                                                           const size_t idx) -> T*
+            {
+                if (handle != content_based_handle)
+                {
+                    ++fill_generation_(key);
+                }
 
-        bool reinit = true;
-        T* read_cache = nullptr;
+                return add_locked_(handle,
+                                   key,
+                                   nspace,
+                                   idx,
+                                   buf);
+            });
 
-        ClusterCacheEntry* entry = nspace->map.find(key);
-        if (entry)
+        if (failed)
         {
-            /* ContentBased cache is immutable */
-            if (handle == content_based_handle)
-            {
-                return;
-            }
-            /* This means that the entry has not been invalidated yet
-             * but needs a buffer update. LocationBased cache is
-             * mutable.
-             */
-            reinit = false;
-            unlink_entry_from_dlist_(*entry);
+            AllShardsWriteLock l(shards_);
+            offlineDevice(failed);
         }
-
-        if (not entry and
-            nspace->max_entries and
-            nspace->map.entries() == *nspace->max_entries)
-        {
-            // the namespace reached its size limit - recycle an entry from its
-            // private LRU
-            if (*nspace->max_entries == 0)
-            {
-                LOG_DEBUG("namespace " << handle << " is misconfigured with size 0, not caching anything");
-                return;
-            }
-
-            dlist_t& lru = nspace->lru;
-            VERIFY(not lru.empty());
-            entry = &lru.back();
-            lru.pop_back();
-            const bool ignore = nspace->map.remove(*entry);
-            VERIFY(ignore);
-        }
-
-        if (not entry)
-        {
-            /* Try to allocate an invalidated entry first */
-            entry = get_invalidated_cache_entry_();
-        }
-
-        if (not entry)
-        {
-            /* otherwise get the next free one */
-            entry = manager_.getNextFreeCluster(key,
-                                                read_cache);
-        }
-
-        if (not entry and not lru_.empty())
-        {
-            // finally we have no other option but to recycle an existing one
-            // from the global LRU list
-            entry = &lru_.back();
-            lru_.pop_back();
-
-            Namespace* old_nspace = find_namespace_(make_handle_(entry->mode(),
-                                                                 entry->key));
-            VERIFY(old_nspace);
-            const bool ignore = old_nspace->map.remove(*entry);
-            VERIFY(ignore);
-        }
-
-        if (not entry)
-        {
-            LOG_WARN("Failed to allocate an entry for handle " << handle <<
-                     " - are all devices gone or all entries consumed by other namespaces?");
-            return;
-        }
-
-        VERIFY(entry);
-
-        if (not read_cache)
-        {
-            read_cache = manager_.getDeviceFromEntry(entry);
-        }
-
-        VERIFY(read_cache);
-
-        if (reinit)
-        {
-            entry = new(entry) ClusterCacheEntry(key,
-                                                 get_cache_entry_mode(handle));
-            nspace->map.insert(*entry);
-        }
-
-        if (nspace->max_entries)
-        {
-            VERIFY(nspace->map.entries() <= *nspace->max_entries);
-            nspace->lru.push_front(*entry);
-        }
-        else
-        {
-            lru_.push_front(*entry);
-        }
-
-        ssize_t res = read_cache->write(buf,
-                                        entry);
-        if (res != static_cast<ssize_t>(cluster_size()))
-        {
-            LOG_ERROR("Couldn't write to " << read_cache << " - offlining it");
-            offlineDevice(read_cache);
-        }
-    }
+    }
 
     bool
     read(const ClusterCacheHandle handle,
@@ -1239,7 +1601,8 @@ public:
         }
         else
         {
-            ++num_misses;
+            // no key to pick a shard by - any one will do for the stats
+            ++shards_[0].misses;
             return false;
         }
     }
@@ -1252,35 +1615,41 @@ public:
     {
         VERIFY(bufsize == static_cast<size_t>(cluster_size()));
 
-        T* read_cache = 0;
-        {
-            fungi::ScopedReadLock l(rwlock);
-            Namespace* nspace = find_namespace_(handle);
-            VERIFY(nspace);
-            ClusterCacheEntry* entry = nspace->map.find(key);
-            if (not entry)
-            {
-                ++num_misses;
-                return false;
-            }
-            else
+        T* failed = nullptr;
+        size_t shard_idx = 0;
+
+        const bool hit =
+            with_locked_shard_<fungi::ScopedReadLock>(handle,
+                                                      key,
+                                                      [&](Namespace& nspace,
+                                                          const size_t idx) -> bool
             {
+                shard_idx = idx;
+
+                Slice& slice = nspace.slices[idx];
+                ClusterCacheEntry* entry = slice.map.find(key);
+                if (not entry)
+                {
+                    return false;
+                }
+
                 // VERIFY(entry->read_cache_);
                 // quicker... just ask the manager to read...
-                read_cache = manager_.getDeviceFromEntry(entry);
+                T* read_cache = manager_.getDeviceFromEntry(entry);
                 ASSERT(read_cache);
                 ssize_t res = read_cache->read(buf,
                                                entry);
 
                 if (static_cast<ssize_t>(cluster_size()) == res)
                 {
-                    num_hits++;
+                    Shard& shard = shards_[idx];
+                    shard.hits++;
 
-                    dlist_t& lru = nspace->max_entries ?
-                        nspace->lru :
-                        lru_;
+                    dlist_t& lru = nspace.max_entries ?
+                        slice.lru :
+                        shard.lru;
 
-                    boost::lock_guard<decltype(listlock)> llg(listlock);
+                    boost::lock_guard<decltype(shard.listlock)> llg(shard.listlock);
                     unlink_entry_from_dlist_(*entry);
                     lru.push_front(*entry);
                     return true;
@@ -1288,63 +1657,287 @@ public:
                 else
                 {
                     LOG_ERROR("Couldn't read from " << read_cache << " - offlining it");
+                    failed = read_cache;
+                    return false;
                 }
-            }
+            });
+
+        if (hit)
+        {
+            return true;
         }
 
-        fungi::ScopedWriteLock l(rwlock);
-        offlineDevice(read_cache);
-        ++num_misses;
+        if (failed)
+        {
+            AllShardsWriteLock l(shards_);
+            offlineDevice(failed);
+        }
+
+        ++shards_[shard_idx].misses;
         return false;
     }
 
+    // Looks up a batch of clusters of one namespace at once. The reads of the
+    // hits are submitted in one go per device; ClusterCacheReadRequest::hit
+    // tells the outcome. Misses can be filled in with fill() once their data was
+    // obtained elsewhere.
     void
-    get_stats(uint64_t& hits,
-              uint64_t& misses,
-              uint64_t& entries)
+    read(const ClusterCacheHandle handle,
+         std::vector<ClusterCacheReadRequest>& reqs)
     {
-        fungi::ScopedReadLock ls(rwlock);
+        if (reqs.empty())
+        {
+            return;
+        }
 
-        hits = num_hits;
-        misses = num_misses;
-        entries = 0;
+        // Scratch space is kept per thread to keep the allocator out of
+        // the (hit) path.
+        static thread_local std::vector<boost::optional<ClusterCacheKey>> keys;
+        keys.clear();
 
-        for (const auto& v : namespaces_)
+        // The shards to lock: the ones the keys map to and the home shard (which
+        // all of them map to if the namespace is limited).
+        static_assert(num_shards_ <= 64,
+                      "shard bitmap too small");
+        uint64_t shard_map = 1ULL << home_shard_(handle);
+
+        for (auto& req : reqs)
+        {
+            req.hit = false;
+            keys.emplace_back(make_key_(handle,
+                                        req.ca,
+                                        req.weed));
+            if (keys.back())
+            {
+                shard_map |= 1ULL << key_shard_(*keys.back());
+            }
+        }
+
+        struct Hit
+        {
+            T* device;
+            size_t req;
+            size_t shard;
+            ClusterCacheEntry* entry;
+        };
+
+        static thread_local std::vector<Hit> hits;
+        static thread_local std::vector<typename T::StoreReadRequest> rds;
+        hits.clear();
+
+        std::vector<T*> failed;
+
+        {
+            for (size_t i = 0; i < shards_.size(); ++i)
+            {
+                if (shard_map & (1ULL << i))
+                {
+                    shards_[i].rwlock.readLock();
+                }
+            }
+
+            auto on_exit(youtils::make_scope_exit([&]
+                                                  {
+                                                      for (size_t i = shards_.size(); i > 0; --i)
+                                                      {
+                                                          if (shard_map & (1ULL << (i - 1)))
+                                                          {
+                                                              shards_[i - 1].rwlock.unlock();
+                                                          }
+                                                      }
+                                                  }));
+
+            Namespace* nspace = find_namespace_(handle);
+            VERIFY(nspace);
+
+            auto miss([&](const size_t i,
+                          const size_t idx)
+                      {
+                          ++shards_[idx].misses;
+                          if (handle != content_based_handle)
+                          {
+                              reqs[i].fill_generation = fill_generation_(*keys[i]);
+                          }
+                          reqs[i].fill_epoch = deregistrations_;
+                      });
+
+            for (size_t i = 0; i < reqs.size(); ++i)
+            {
+                if (not keys[i])
+                {
+                    // no key to pick a shard by - any one will do for the stats
+                    ++shards_[0].misses;
+                    continue;
+                }
+
+                const size_t idx = shard_index_(handle,
+                                                *nspace,
+                                                *keys[i]);
+                ClusterCacheEntry* entry = nspace->slices[idx].map.find(*keys[i]);
+                if (not entry)
+                {
+                    miss(i, idx);
+                    continue;
+                }
+
+                T* read_cache = manager_.getDeviceFromEntry(entry);
+                ASSERT(read_cache);
+
+                hits.push_back(Hit{ read_cache, i, idx, entry });
+            }
+
+            // group the hits by device (std::sort doesn't allocate, unlike
+            // std::stable_sort) - each device gets one batch
+            std::sort(hits.begin(),
+                      hits.end(),
+                      [](const Hit& a, const Hit& b)
+                      {
+                          return a.device < b.device or
+                              (a.device == b.device and a.req < b.req);
+                      });
+
+            for (size_t start = 0; start < hits.size(); )
+            {
+                T* read_cache = hits[start].device;
+                size_t end = start;
+
+                rds.clear();
+
+                for (; end < hits.size() and hits[end].device == read_cache; ++end)
+                {
+                    rds.emplace_back(reqs[hits[end].req].buf,
+                                     read_cache->getIndex(hits[end].entry));
+                }
+
+                read_cache->read(rds);
+
+                for (size_t j = 0; j < rds.size(); ++j)
+                {
+                    const Hit& h = hits[start + j];
+
+                    if (rds[j].result == static_cast<ssize_t>(cluster_size()))
+                    {
+                        reqs[h.req].hit = true;
+
+                        Shard& shard = shards_[h.shard];
+                        shard.hits++;
+
+                        dlist_t& lru = nspace->max_entries ?
+                            nspace->slices[h.shard].lru :
+                            shard.lru;
+
+                        boost::lock_guard<decltype(shard.listlock)> llg(shard.listlock);
+                        unlink_entry_from_dlist_(*h.entry);
+                        lru.push_front(*h.entry);
+                    }
+                    else
+                    {
+                        if (failed.empty() or failed.back() != read_cache)
+                        {
+                            LOG_ERROR("Couldn't read from " << read_cache << " - offlining it");
+                            failed.push_back(read_cache);
+                        }
+
+                        miss(h.req, h.shard);
+                    }
+                }
+
+                start = end;
+            }
+        }
+
+        if (not failed.empty())
         {
-            entries += v.second->map.entries();
+            AllShardsWriteLock l(shards_);
+            for (T* read_cache : failed)
+            {
+                offlineDevice(read_cache);
+            }
         }
     }
 
+    // Adds the data of a miss of read(handle, reqs) - req.buf needs to be filled
+    // in by now. The fill is dropped if the cache was modified in a conflicting
+    // way since the lookup (e.g. the LocationBased entry was added or invalidated
+    // by a write). With DirectAsync mountpoints this happens in the background and
+    // fills are dropped if too many of them are pending, otherwise it happens
+    // right away.
     void
-    remove_device_from_list_and_delete(dlist_t& list,
-                                       T* read_cache)
+    fill(const ClusterCacheHandle handle,
+         const ClusterCacheReadRequest& req)
     {
-        auto it = list.begin();
-        while (it != list.end())
+        VERIFY(not req.hit);
+
+        const boost::optional<ClusterCacheKey> key(make_key_(handle,
+                                                             req.ca,
+                                                             req.weed));
+        if (not key)
         {
-            ClusterCacheEntry& e = *it;
-            if (manager_.getDeviceFromEntry(&e) == read_cache)
-            {
-                it = list.erase(it);
+            return;
+        }
 
-                Namespace* nspace = find_namespace_(make_handle_(e.mode(),
-                                                                 e.key));
-                VERIFY(nspace);
-                bool ignore = nspace->map.remove(e);
-                VERIFY(ignore);
-            }
-            else
+        if (async_fills_)
+        {
+            boost::lock_guard<decltype(fill_lock_)> g(fill_lock_);
+
+            if (fills_.size() * static_cast<size_t>(cluster_size()) >= max_pending_fill_bytes_)
             {
-                ++it;
+                LOG_TRACE(handle << ": too many pending fills, dropping this one");
+                return;
             }
+
+            fills_.emplace_back(handle,
+                                *key,
+                                req.buf,
+                                static_cast<size_t>(cluster_size()),
+                                req.fill_generation,
+                                req.fill_epoch);
+            fill_cond_.notify_one();
+        }
+        else
+        {
+            apply_fill_(handle,
+                        *key,
+                        req.buf,
+                        req.fill_generation,
+                        req.fill_epoch);
+        }
+    }
+
+    void
+    get_stats(uint64_t& hits,
+              uint64_t& misses,
+              uint64_t& entries)
+    {
+        AllShardsReadLock l(shards_);
+
+        hits = 0;
+        misses = 0;
+        entries = 0;
+
+        for (const auto& s : shards_)
+        {
+            hits += s.hits;
+            misses += s.misses;
+        }
+
+        for (const auto& v : namespaces_)
+        {
+            entries += v.second->entries();
         }
     }
 
+    // Requires all shards to be locked exclusively.
     void
     offlineDevice(T* read_cache,
                   const bool log_error = true)
     {
-        rwlock.assertWriteLocked();
+#ifndef NDEBUG
+        for (const auto& s : shards_)
+        {
+            s.rwlock.assertWriteLocked();
+        }
+#endif
 
         VERIFY(read_cache);
 
@@ -1364,14 +1957,37 @@ public:
 
         LOG_INFO("Offlining read_cache " << read_cache);
 
-        remove_device_from_list_and_delete(lru_,
-                                           read_cache);
-        remove_device_from_list_and_delete(invalidated_entries_,
-                                           read_cache);
-        for (auto& v : namespaces_)
+        for (size_t i = 0; i < shards_.size(); ++i)
         {
-            remove_device_from_list_and_delete(v.second->lru,
-                                               read_cache);
+            remove_device_entries_(shards_[i].lru,
+                                   read_cache,
+                                   [&](ClusterCacheEntry& e)
+                                   {
+                                       Namespace* nspace =
+                                           find_namespace_(make_handle_(e.mode(),
+                                                                        e.key));
+                                       VERIFY(nspace);
+                                       const bool ignore = nspace->slices[i].map.remove(e);
+                                       VERIFY(ignore);
+                                   });
+
+            // invalidated entries aren't in any map anymore
+            remove_device_entries_(shards_[i].invalidated_entries,
+                                   read_cache,
+                                   [](ClusterCacheEntry&)
+                                   {});
+
+            for (auto& v : namespaces_)
+            {
+                Slice& slice = v.second->slices[i];
+                remove_device_entries_(slice.lru,
+                                       read_cache,
+                                       [&](ClusterCacheEntry& e)
+                                       {
+                                           const bool ignore = slice.map.remove(e);
+                                           VERIFY(ignore);
+                                       });
+            }
         }
 
         manager_.removeDevice(read_cache);
@@ -1386,7 +2002,7 @@ public:
         T* read_cache = manager_.getDeviceFromPath(path);
         if (read_cache)
         {
-            fungi::ScopedWriteLock l(rwlock);
+            AllShardsWriteLock l(shards_);
             offlineDevice(read_cache);
         }
     }
@@ -1395,7 +2011,7 @@ public:
     onlineDevice(const fs::path& path)
     {
         MountPointConfig mp_cfg = mountpointconfig_from_path(path);
-        maybeAddDevice(mp_cfg.path, mp_cfg.size);
+        maybeAddDevice(mp_cfg.path, mp_cfg.size, mp_cfg.io_mode);
     }
 
     void
@@ -1431,11 +2047,279 @@ public:
 private:
 
     static constexpr uint64_t test_frequency_ = 8192;
+    static constexpr uint64_t fib_hash_mult_ = 11400714819323198485ULL;
     static const ClusterCacheHandle content_based_handle;
 
+    // Requires shard idx to be locked exclusively. Returns the device if writing
+    // to it failed - it needs to be offlined (which requires all shards to be
+    // locked) by the caller.
+    T*
+    add_locked_(const ClusterCacheHandle handle,
+                const ClusterCacheKey& key,
+                Namespace& nspace,
+                const size_t idx,
+                const uint8_t* buf)
+    {
+        Shard& shard = shards_[idx];
+        Slice& slice = nspace.slices[idx];
+
+        // Really only serves as documentation - the shard's rwlock should rule
+        // out concurrent accesses already hence we can be lazy and use
+        // listlock rather coarsely.
+        boost::lock_guard<decltype(shard.listlock)> llg(shard.listlock);
+
+        bool reinit = true;
+        T* read_cache = nullptr;
+
+        ClusterCacheEntry* entry = slice.map.find(key);
+        if (entry)
+        {
+            /* ContentBased cache is immutable */
+            if (handle == content_based_handle)
+            {
+                return nullptr;
+            }
+            /* This means that the entry has not been invalidated yet
+             * but needs a buffer update. LocationBased cache is
+             * mutable.
+             */
+            reinit = false;
+            unlink_entry_from_dlist_(*entry);
+        }
+
+        if (not entry and
+            nspace.max_entries and
+            slice.map.entries() == *nspace.max_entries)
+        {
+            // the namespace reached its size limit - recycle an entry from its
+            // private LRU
+            if (*nspace.max_entries == 0)
+            {
+                LOG_DEBUG("namespace " << handle << " is misconfigured with size 0, not caching anything");
+                return nullptr;
+            }
+
+            dlist_t& lru = slice.lru;
+            VERIFY(not lru.empty());
+            entry = &lru.back();
+            lru.pop_back();
+            const bool ignore = slice.map.remove(*entry);
+            VERIFY(ignore);
+        }
+
+        if (not entry)
+        {
+            /* Try to allocate an invalidated entry first */
+            entry = get_invalidated_cache_entry_(shard);
+        }
+
+        if (not entry)
+        {
+            /* otherwise get the next free one */
+            entry = manager_.getNextFreeCluster(key,
+                                                read_cache);
+        }
+
+        if (not entry)
+        {
+            // finally we have no other option but to recycle an existing one
+            // from the shard's LRU list ...
+            entry = recycle_lru_entry_(idx);
+        }
+
+        if (not entry)
+        {
+            // ... or from another shard
+            entry = steal_entry_(idx);
+        }
+
+        if (not entry)
+        {
+            LOG_WARN("Failed to allocate an entry for handle " << handle <<
+                     " - are all devices gone or all entries consumed by other namespaces?");
+            return nullptr;
+        }
+
+        VERIFY(entry);
+
+        if (not read_cache)
+        {
+            read_cache = manager_.getDeviceFromEntry(entry);
+        }
+
+        VERIFY(read_cache);
+
+        if (reinit)
+        {
+            entry = new(entry) ClusterCacheEntry(key,
+                                                 get_cache_entry_mode(handle));
+            slice.map.insert(*entry);
+        }
+
+        if (nspace.max_entries)
+        {
+            VERIFY(slice.map.entries() <= *nspace.max_entries);
+            slice.lru.push_front(*entry);
+        }
+        else
+        {
+            shard.lru.push_front(*entry);
+        }
+
+        ssize_t res = read_cache->write(buf,
+                                        entry);
+        if (res != static_cast<ssize_t>(cluster_size()))
+        {
+            LOG_ERROR("Couldn't write to " << read_cache << " - offlining it");
+            // The device is only offlined once the shard lock was dropped - make
+            // sure nobody gets to read the garbage in the meantime.
+            slice.map.remove(*entry);
+            unlink_entry_from_dlist_(*entry);
+            shard.invalidated_entries.push_back(*entry);
+            return read_cache;
+        }
+
+        return nullptr;
+    }
+
+    void
+    apply_fill_(const ClusterCacheHandle handle,
+                const ClusterCacheKey& key,
+                const uint8_t* buf,
+                const uint64_t generation,
+                const uint64_t epoch)
+    {
+        T* failed = nullptr;
+        size_t idx = key_shard_(key);
+
+        while (true)
+        {
+            fungi::ScopedWriteLock l(shards_[idx].rwlock);
+
+            if (deregistrations_ != epoch)
+            {
+                // the namespace might be gone or even be a new incarnation
+                return;
+            }
+
+            Namespace* nspace = find_namespace_(handle);
+            VERIFY(nspace);
+
+            const size_t home = shard_index_(handle,
+                                             *nspace,
+                                             key);
+            if (home != idx)
+            {
+                idx = home;
+                continue;
+            }
+
+            if (handle != content_based_handle and
+                fill_generation_(key) != generation)
+            {
+                LOG_TRACE(handle << ": entry was modified since the lookup, dropping fill");
+                return;
+            }
+
+            failed = add_locked_(handle,
+                                 key,
+                                 *nspace,
+                                 idx,
+                                 buf);
+            break;
+        }
+
+        if (failed)
+        {
+            AllShardsWriteLock l(shards_);
+            offlineDevice(failed);
+        }
+    }
+
+    void
+    run_fills_()
+    {
+        std::deque<Fill> fills;
+
+        while (true)
+        {
+            {
+                boost::unique_lock<decltype(fill_lock_)> u(fill_lock_);
+
+                while (not stop_fills_ and fills_.empty())
+                {
+                    fill_cond_.wait(u);
+                }
+
+                if (stop_fills_)
+                {
+                    return;
+                }
+
+                fills.swap(fills_);
+            }
+
+            for (const auto& f : fills)
+            {
+                try
+                {
+                    apply_fill_(f.handle,
+                                f.key,
+                                f.data.data(),
+                                f.generation,
+                                f.epoch);
+                }
+                CATCH_STD_ALL_LOG_IGNORE(f.handle << ": failed to fill in cache entry");
+            }
+
+            fills.clear();
+        }
+    }
+
+    void
+    stop_fill_thread_()
+    {
+        {
+            boost::lock_guard<decltype(fill_lock_)> g(fill_lock_);
+            stop_fills_ = true;
+        }
+
+        fill_cond_.notify_all();
+
+        if (fill_thread_.joinable())
+        {
+            fill_thread_.join();
+        }
+
+        fills_.clear();
+    }
+
+    template<typename F>
+    void
+    remove_device_entries_(dlist_t& list,
+                           const T* read_cache,
+                           F&& fun)
+    {
+        auto it = list.begin();
+        while (it != list.end())
+        {
+            ClusterCacheEntry& e = *it;
+            if (manager_.getDeviceFromEntry(&e) == read_cache)
+            {
+                it = list.erase(it);
+                fun(e);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
     bool
     maybeAddDevice(const fs::path& path,
-                   const uint64_t size)
+                   const uint64_t size,
+                   const MountPointIoMode io_mode)
     {
         if (manager_.getDeviceFromPath(path))
         {
@@ -1447,7 +2331,8 @@ private:
         {
             LOG_INFO("Adding " << path);
             return manager_.addDevice(path,
-                                      size);
+                                      size,
+                                      io_mode);
         }
     }
 
@@ -1482,12 +2367,17 @@ private:
         auto it = namespaces_.find(handle);
         if (it != namespaces_.end())
         {
-            it->second->map.for_each([&](ClusterCacheEntry& e)
-                                     {
-                                         unlink_entry_from_dlist_(e);
-                                         invalidated_entries_.push_front(e);
-                                     });
+            for (size_t i = 0; i < shards_.size(); ++i)
+            {
+                Shard& shard = shards_[i];
+                it->second->slices[i].map.for_each([&](ClusterCacheEntry& e)
+                                                   {
+                                                       unlink_entry_from_dlist_(e);
+                                                       shard.invalidated_entries.push_front(e);
+                                                   });
+            }
             namespaces_.erase(it);
+            ++deregistrations_;
         }
     }
 
@@ -1496,8 +2386,11 @@ private:
     {
         manager_.clear();
         namespaces_.clear();
-        lru_.clear();
-        invalidated_entries_.clear();
+        for (auto& s : shards_)
+        {
+            s.lru.clear();
+            s.invalidated_entries.clear();
+        }
     }
 };
 
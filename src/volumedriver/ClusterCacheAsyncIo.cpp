@@ -0,0 +1,269 @@
+// Copyright (C) 2016 iNuron NV
+//
+// This file is part of Open vStorage Open Source Edition (OSE),
+// as available from
+//
+//      http://www.openvstorage.org and
+//      http://www.openvstorage.com.
+//
+// This file is free software; you can redistribute it and/or modify it
+// under the terms of the GNU Affero General Public License v3 (GNU AGPLv3)
+// as published by the Free Software Foundation, in version 3 as it comes in
+// the LICENSE.txt file of the Open vStorage OSE distribution.
+// Open vStorage is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY of any kind.
+
+#include "ClusterCacheAsyncIo.h"
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include <youtils/Assert.h>
+#include <youtils/ScopeExit.h>
+
+namespace volumedriver
+{
+
+namespace yt = youtils;
+
+namespace
+{
+
+int
+io_setup_(unsigned nr,
+          aio_context_t* ctx)
+{
+    return ::syscall(__NR_io_setup, nr, ctx);
+}
+
+int
+io_destroy_(aio_context_t ctx)
+{
+    return ::syscall(__NR_io_destroy, ctx);
+}
+
+long
+io_submit_(aio_context_t ctx,
+           long nr,
+           struct iocb** iocbpp)
+{
+    return ::syscall(__NR_io_submit, ctx, nr, iocbpp);
+}
+
+long
+io_getevents_(aio_context_t ctx,
+              long min_nr,
+              long nr,
+              struct io_event* events)
+{
+    return ::syscall(__NR_io_getevents, ctx, min_nr, nr, events, nullptr);
+}
+
+}
+
+const unsigned
+ClusterCacheAsyncIo::default_queue_depth = 128;
+
+ClusterCacheAsyncIo::ClusterCacheAsyncIo(const unsigned queue_depth)
+    : queue_depth_(queue_depth)
+{
+    VERIFY(queue_depth_ > 0);
+}
+
+ClusterCacheAsyncIo::~ClusterCacheAsyncIo()
+{
+    for (const auto& ctx : idle_contexts_)
+    {
+        if (io_destroy_(ctx) < 0)
+        {
+            LOG_ERROR("Failed to destroy AIO context: " << strerror(errno) <<
+                      " - ignoring");
+        }
+    }
+}
+
+aio_context_t
+ClusterCacheAsyncIo::get_context_()
+{
+    {
+        boost::lock_guard<decltype(lock_)> g(lock_);
+        if (not idle_contexts_.empty())
+        {
+            const aio_context_t ctx = idle_contexts_.back();
+            idle_contexts_.pop_back();
+            return ctx;
+        }
+    }
+
+    aio_context_t ctx = 0;
+    if (io_setup_(queue_depth_, &ctx) < 0)
+    {
+        // most likely fs.aio-max-nr was hit
+        LOG_WARN("Failed to set up AIO context: " << strerror(errno));
+        return 0;
+    }
+
+    return ctx;
+}
+
+void
+ClusterCacheAsyncIo::put_context_(aio_context_t ctx)
+{
+    boost::lock_guard<decltype(lock_)> g(lock_);
+    idle_contexts_.push_back(ctx);
+}
+
+void
+ClusterCacheAsyncIo::submit(std::vector<Request>& reqs)
+{
+    if (reqs.empty())
+    {
+        return;
+    }
+
+    const aio_context_t ctx = get_context_();
+    if (ctx == 0)
+    {
+        for (auto& req : reqs)
+        {
+            submit_sync_(req);
+        }
+
+        return;
+    }
+
+    auto on_exit(yt::make_scope_exit([&]
+                                     {
+                                         put_context_(ctx);
+                                     }));
+
+    for (size_t off = 0; off < reqs.size(); off += queue_depth_)
+    {
+        submit_(ctx,
+                reqs.data() + off,
+                std::min<size_t>(queue_depth_,
+                                 reqs.size() - off));
+    }
+}
+
+void
+ClusterCacheAsyncIo::submit_(aio_context_t ctx,
+                             Request* reqs,
+                             const size_t count)
+{
+    // Per thread scratch space sized to the queue depth (which count never
+    // exceeds) so batched cache reads don't need to go to the allocator.
+    static thread_local std::vector<struct iocb> iocbs;
+    static thread_local std::vector<struct iocb*> iocbps;
+    static thread_local std::vector<struct io_event> events;
+
+    if (iocbs.size() < count)
+    {
+        const size_t size = std::max<size_t>(count,
+                                             queue_depth_);
+        iocbs.resize(size);
+        iocbps.resize(size);
+        events.resize(size);
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        struct iocb& cb = iocbs[i];
+        memset(&cb, 0x0, sizeof(cb));
+
+        cb.aio_data = i;
+        cb.aio_lio_opcode = reqs[i].op == Op::Read ?
+            IOCB_CMD_PREAD :
+            IOCB_CMD_PWRITE;
+        cb.aio_fildes = reqs[i].fd;
+        cb.aio_buf = reinterpret_cast<uint64_t>(reqs[i].buf);
+        cb.aio_nbytes = reqs[i].size;
+        cb.aio_offset = reqs[i].offset;
+
+        iocbps[i] = &cb;
+    }
+
+    size_t submitted = 0;
+
+    while (submitted < count)
+    {
+        const long ret = io_submit_(ctx,
+                                    count - submitted,
+                                    iocbps.data() + submitted);
+        if (ret > 0)
+        {
+            submitted += ret;
+        }
+        else if (ret < 0 and errno == EINTR)
+        {
+            continue;
+        }
+        else
+        {
+            const int err = ret < 0 ? errno : EAGAIN;
+            LOG_WARN("io_submit failed: " << strerror(err) <<
+                     " - falling back to synchronous I/O for " <<
+                     (count - submitted) << " requests");
+
+            for (size_t i = submitted; i < count; ++i)
+            {
+                submit_sync_(reqs[i]);
+            }
+
+            break;
+        }
+    }
+
+    // We must not return before all submitted requests have completed as the
+    // kernel still refers to the buffers (and the iocbs).
+    size_t completed = 0;
+
+    while (completed < submitted)
+    {
+        const long ret = io_getevents_(ctx,
+                                       1,
+                                       submitted - completed,
+                                       events.data());
+        if (ret < 0)
+        {
+            const int err = errno;
+            if (err != EINTR)
+            {
+                LOG_ERROR("io_getevents failed: " << strerror(err));
+                VERIFY(err == EINTR);
+            }
+
+            continue;
+        }
+
+        for (long i = 0; i < ret; ++i)
+        {
+            const struct io_event& ev = events[i];
+            VERIFY(ev.data < count);
+            reqs[ev.data].result = ev.res;
+        }
+
+        completed += ret;
+    }
+}
+
+void
+ClusterCacheAsyncIo::submit_sync_(Request& req)
+{
+    const ssize_t ret = req.op == Op::Read ?
+        ::pread(req.fd,
+                req.buf,
+                req.size,
+                req.offset) :
+        ::pwrite(req.fd,
+                 req.buf,
+                 req.size,
+                 req.offset);
+
+    req.result = ret < 0 ? -errno : ret;
+}
+
+}
@@ -0,0 +1,114 @@
+// Copyright (C) 2016 iNuron NV
+//
+// This file is part of Open vStorage Open Source Edition (OSE),
+// as available from
+//
+//      http://www.openvstorage.org and
+//      http://www.openvstorage.com.
+//
+// This file is free software; you can redistribute it and/or modify it
+// under the terms of the GNU Affero General Public License v3 (GNU AGPLv3)
+// as published by the Free Software Foundation, in version 3 as it comes in
+// the LICENSE.txt file of the Open vStorage OSE distribution.
+// Open vStorage is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY of any kind.
+
+#ifndef VD_CLUSTER_CACHE_ASYNC_IO_H_
+#define VD_CLUSTER_CACHE_ASYNC_IO_H_
+
+#include <linux/aio_abi.h>
+
+#include <vector>
+
+#include <boost/thread/lock_guard.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <youtils/Logging.h>
+
+namespace volumedriver
+{
+
+// Submits batches of reads / writes to the kernel's native AIO interface with a
+// single io_submit call and waits for all of them to complete. This only results
+// in truly asynchronous I/O with O_DIRECT file descriptors (and suitably
+// aligned buffers, offsets and sizes).
+// The raw syscalls are used instead of libaio to avoid pulling in another
+// library.
+// A kernel AIO context cannot be shared by concurrent waiters as they'd steal
+// each other's completions, so a pool of contexts is kept and each submit()
+// call uses one of them exclusively.
+class ClusterCacheAsyncIo
+{
+public:
+    enum class Op
+    {
+        Read,
+        Write,
+    };
+
+    struct Request
+    {
+        Request(const Op o,
+                const int f,
+                uint8_t* b,
+                const size_t s,
+                const off_t off)
+            : op(o)
+            , fd(f)
+            , buf(b)
+            , size(s)
+            , offset(off)
+            , result(-1)
+        {}
+
+        Op op;
+        int fd;
+        uint8_t* buf;
+        size_t size;
+        off_t offset;
+        // number of bytes transferred or -errno
+        ssize_t result;
+    };
+
+    explicit ClusterCacheAsyncIo(const unsigned queue_depth = default_queue_depth);
+
+    ~ClusterCacheAsyncIo();
+
+    ClusterCacheAsyncIo(const ClusterCacheAsyncIo&) = delete;
+
+    ClusterCacheAsyncIo&
+    operator=(const ClusterCacheAsyncIo&) = delete;
+
+    // Blocks until all requests have completed. Errors are reported per request
+    // (Request::result). Batches exceeding the queue depth are split up.
+    void
+    submit(std::vector<Request>& reqs);
+
+    static const unsigned default_queue_depth;
+
+private:
+    DECLARE_LOGGER("ClusterCacheAsyncIo");
+
+    const unsigned queue_depth_;
+
+    boost::mutex lock_;
+    std::vector<aio_context_t> idle_contexts_;
+
+    aio_context_t
+    get_context_();
+
+    void
+    put_context_(aio_context_t);
+
+    void
+    submit_(aio_context_t ctx,
+            Request* reqs,
+            const size_t count);
+
+    static void
+    submit_sync_(Request& req);
+};
+
+}
+
+#endif // !VD_CLUSTER_CACHE_ASYNC_IO_H_
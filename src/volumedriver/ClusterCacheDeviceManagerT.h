@@ -291,7 +291,8 @@ public:
              ++it)
         {
             addDevice(it->path,
-                      it->size);
+                      it->size,
+                      it->io_mode);
         }
     }
 
@@ -338,13 +339,15 @@ public:
 
     bool
     addDevice(const fs::path p,
-              const uint64_t size = 0)
+              const uint64_t size = 0,
+              const MountPointIoMode io_mode = MountPointIoMode::Buffered)
     {
         fungi::ScopedWriteLock l(rwlock);
 
         auto dev(std::make_unique<ManagedType>(p,
                                                size,
-                                               cluster_size_));
+                                               cluster_size_,
+                                               io_mode));
 
         uuid_ = UUID();
         for (auto& dev : devices)
@@ -482,7 +485,9 @@ public:
     {
         ClusterCacheEntry* entry = nullptr;
 
-        // This is called in a locked context
+        // The ClusterCache allocates from several shards concurrently.
+        fungi::ScopedWriteLock l(rwlock);
+
         if(full)
         {
             return 0;
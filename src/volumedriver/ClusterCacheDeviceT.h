@@ -18,6 +18,7 @@
 
 #include "ClusterCacheDeviceManagerT.h"
 #include "ClusterCacheEntry.h"
+#include "MountPointConfig.h"
 #include "Types.h"
 
 #include <sys/ioctl.h>
@@ -25,6 +26,7 @@
 #include <sys/mount.h>
 
 #include <list>
+#include <vector>
 
 #include <boost/archive/binary_oarchive.hpp>
 #include <boost/archive/binary_iarchive.hpp>
@@ -43,12 +45,16 @@ class ClusterCacheDeviceT
     friend class ClusterCacheDeviceManagerT<ClusterCacheDeviceT>;
 
 public:
+    using StoreReadRequest = typename StoreType::ReadRequest;
+
     ClusterCacheDeviceT(const fs::path& path,
                         const uint64_t size,
-                        const size_t csize)
+                        const size_t csize,
+                        const MountPointIoMode io_mode = MountPointIoMode::Buffered)
         : store_(path,
                  size,
-                 csize)
+                 csize,
+                 io_mode)
         , entries_reloaded_(std::numeric_limits<uint64_t>::max())
     {
         ASSERT(store_.total_size() / cluster_size() < memory_.max_size());
@@ -73,6 +79,13 @@ public:
                            getIndex(entry));
     }
 
+    // StoreReadRequest::index is the one obtained via getIndex().
+    void
+    read(std::vector<StoreReadRequest>& reqs)
+    {
+        store_.read(reqs);
+    }
+
     ssize_t
     write(const uint8_t* buf,
           ClusterCacheEntry* entry)
@@ -173,6 +186,12 @@ public:
         store_.reinstate();
     }
 
+    void
+    set_io_mode(const MountPointIoMode mode)
+    {
+        store_.set_io_mode(mode);
+    }
+
     void
     check(const ClusterCacheEntry& e)
     {
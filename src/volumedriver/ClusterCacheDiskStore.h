@@ -16,16 +16,26 @@
 #ifndef READ_CACHE_DISK_STORE
 #define READ_CACHE_DISK_STORE
 
+#include "ClusterCacheAsyncIo.h"
+#include "MountPointConfig.h"
 #include "Types.h"
 
 #include <sys/ioctl.h>
 #include <fcntl.h>
 #include <sys/mount.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
 
 #include <youtils/Assert.h>
 #include <youtils/IOException.h>
 #include <youtils/Logging.h>
 #include <youtils/Md5.h>
+#include <youtils/WeedAlgorithm.h>
 
 namespace volumedriver
 {
@@ -36,17 +46,36 @@ class ClusterCacheDiskStore
 public:
     MAKE_EXCEPTION(VerificationFailedException, fungi::IOException);
 
+    struct ReadRequest
+    {
+        ReadRequest(uint8_t* b,
+                    uint32_t i)
+            : buf(b)
+            , index(i)
+            , result(-1)
+        {}
+
+        uint8_t* buf;
+        uint32_t index;
+        ssize_t result;
+    };
+
     ClusterCacheDiskStore()
         : cluster_size_(0)
         , total_size_(0)
         , device_fd_(-1)
+        , direct_fd_(-1)
+        , io_mode_(MountPointIoMode::Buffered)
     {}
 
     ClusterCacheDiskStore(const fs::path& path,
                           const uint64_t size,
-                          const size_t cluster_size)
+                          const size_t cluster_size,
+                          const MountPointIoMode io_mode = MountPointIoMode::Buffered)
         : path_(path)
         , cluster_size_(cluster_size)
+        , direct_fd_(-1)
+        , io_mode_(MountPointIoMode::Buffered)
     {
         device_fd_ = open(path_.string().c_str(),
                           O_RDWR);
@@ -80,10 +109,14 @@ public:
         ASSERT(total_size_ > cluster_size_);
         ASSERT(total_size_ % cluster_size_ == 0);
         total_size_ -= cluster_size_;
+
+        set_io_mode(io_mode);
     }
 
     ~ClusterCacheDiskStore()
     {
+        close_direct_fd_();
+
         if(device_fd_ >= 0)
         {
             int ret = ::close(device_fd_);
@@ -162,6 +195,11 @@ public:
         device_fd_ = open(path_.string().c_str(),
                           O_WRONLY);
         ASSERT(device_fd_ >= 0);
+
+        if (direct_fd_ >= 0)
+        {
+            reopen_direct_fd_(O_WRONLY);
+        }
     }
 
     void
@@ -177,22 +215,157 @@ public:
         device_fd_ = open(path_.string().c_str(),
                           O_RDONLY);
         ASSERT(device_fd_ >= 0);
+
+        if (direct_fd_ >= 0)
+        {
+            reopen_direct_fd_(O_RDONLY);
+        }
+    }
+
+    // The guid is always accessed through the page cache (device_fd_), the
+    // clusters with O_DIRECT (direct_fd_) in DirectAsync mode. The latter falls
+    // back to Buffered if O_DIRECT isn't supported (e.g. tmpfs) or the cluster
+    // size isn't suitably aligned.
+    // Not to be invoked while the store is in use.
+    void
+    set_io_mode(const MountPointIoMode mode)
+    {
+        close_direct_fd_();
+        io_mode_ = MountPointIoMode::Buffered;
+
+        if (mode == MountPointIoMode::DirectAsync)
+        {
+            if (cluster_size_ % direct_io_alignment_ != 0)
+            {
+                LOG_WARN(path_ << ": cluster size " << cluster_size_ <<
+                         " is not a multiple of " << direct_io_alignment_ <<
+                         " - falling back to " << io_mode_);
+                return;
+            }
+
+            reopen_direct_fd_(O_RDWR);
+            if (direct_fd_ >= 0)
+            {
+                aio_ = std::make_unique<ClusterCacheAsyncIo>();
+                io_mode_ = mode;
+            }
+        }
+
+        LOG_INFO(path_ << ": io mode " << io_mode_);
+    }
+
+    MountPointIoMode
+    io_mode() const
+    {
+        return io_mode_;
     }
 
     ssize_t
     read(uint8_t* buf,
          uint32_t index)
     {
+        if (direct_fd_ >= 0)
+        {
+            if (is_aligned_(buf))
+            {
+                return pread(direct_fd_, buf, cluster_size_, offset_(index));
+            }
+
+            AlignedBuffer bounce(make_aligned_buffer_(cluster_size_));
+            const ssize_t res = pread(direct_fd_, bounce.get(), cluster_size_, offset_(index));
+            if (res == static_cast<ssize_t>(cluster_size_))
+            {
+                memcpy(buf, bounce.get(), cluster_size_);
+            }
+
+            return res;
+        }
+
         VERIFY(device_fd_ >= 0);
-        return pread(device_fd_, buf, cluster_size_, (index+1) * cluster_size_);
+        return pread(device_fd_, buf, cluster_size_, offset_(index));
+    }
+
+    // Reads a batch of clusters. In DirectAsync mode they are all submitted at
+    // once, otherwise this amounts to a series of pread calls. The outcome of each
+    // read is stored in ReadRequest::result.
+    void
+    read(std::vector<ReadRequest>& reqs)
+    {
+        if (direct_fd_ < 0)
+        {
+            for (auto& req : reqs)
+            {
+                req.result = read(req.buf,
+                                  req.index);
+            }
+
+            return;
+        }
+
+        const size_t unaligned = std::count_if(reqs.begin(),
+                                               reqs.end(),
+                                               [](const ReadRequest& req)
+                                               {
+                                                   return not is_aligned_(req.buf);
+                                               });
+
+        AlignedBuffer bounce;
+        if (unaligned)
+        {
+            bounce = make_aligned_buffer_(unaligned * cluster_size_);
+        }
+
+        // per thread scratch space, like the rest of the read path's
+        static thread_local std::vector<ClusterCacheAsyncIo::Request> ios;
+        ios.clear();
+
+        size_t b = 0;
+        for (const auto& req : reqs)
+        {
+            uint8_t* buf = req.buf;
+            if (not is_aligned_(buf))
+            {
+                buf = bounce.get() + b++ * cluster_size_;
+            }
+
+            ios.emplace_back(ClusterCacheAsyncIo::Op::Read,
+                             direct_fd_,
+                             buf,
+                             cluster_size_,
+                             offset_(req.index));
+        }
+
+        aio_->submit(ios);
+
+        for (size_t i = 0; i < reqs.size(); ++i)
+        {
+            reqs[i].result = ios[i].result;
+            if (ios[i].buf != reqs[i].buf and
+                ios[i].result == static_cast<ssize_t>(cluster_size_))
+            {
+                memcpy(reqs[i].buf, ios[i].buf, cluster_size_);
+            }
+        }
     }
 
     ssize_t
     write(const uint8_t* buf,
           uint32_t index)
     {
+        if (direct_fd_ >= 0)
+        {
+            if (is_aligned_(buf))
+            {
+                return pwrite(direct_fd_, buf, cluster_size_, offset_(index));
+            }
+
+            AlignedBuffer bounce(make_aligned_buffer_(cluster_size_));
+            memcpy(bounce.get(), buf, cluster_size_);
+            return pwrite(direct_fd_, bounce.get(), cluster_size_, offset_(index));
+        }
+
         VERIFY(device_fd_ >= 0);
-        return pwrite(device_fd_, buf, cluster_size_, (index+1)*cluster_size_);
+        return pwrite(device_fd_, buf, cluster_size_, offset_(index));
     }
 
     void
@@ -214,14 +387,24 @@ public:
     {
         VERIFY(device_fd_ >= 0);
         std::vector<uint8_t> vec(cluster_size_);
-        VERIFY(pread(device_fd_, &vec[0], cluster_size_, (index+1) * cluster_size_) == (ssize_t)cluster_size_);
-        youtils::Weed w (vec);
-        if (w != key)
+        VERIFY(read(&vec[0], index) == (ssize_t)cluster_size_);
+
+        // Weeds don't carry the algorithm they were created with and content
+        // based entries of volumes with different ones can coexist.
+        for (const auto algo : { youtils::WeedAlgorithm::Md5,
+                                 youtils::WeedAlgorithm::Murmur3_128 })
         {
-            LOG_ERROR("MD5 mismatch detected: path_ " << path_ << " index " << index);
-            throw VerificationFailedException("MD5 mismatch detected",
-                                              path_.string().c_str());
+            if (youtils::make_weed(algo,
+                                   vec.data(),
+                                   vec.size()) == key)
+            {
+                return;
+            }
         }
+
+        LOG_ERROR("Weed mismatch detected: path_ " << path_ << " index " << index);
+        throw VerificationFailedException("Weed mismatch detected",
+                                          path_.string().c_str());
     }
 
     uint64_t
@@ -310,10 +493,93 @@ private:
 
     static const size_t default_cluster_size_;
 
+    // O_DIRECT requires buffers, offsets and sizes to be aligned to the logical
+    // block size of the device - use the most conservative value.
+    static constexpr size_t direct_io_alignment_ = 4096;
+
+    struct FreeDeleter
+    {
+        void
+        operator()(uint8_t* p) const
+        {
+            ::free(p);
+        }
+    };
+
+    using AlignedBuffer = std::unique_ptr<uint8_t, FreeDeleter>;
+
     const fs::path path_;
     uint64_t cluster_size_;
     uint64_t total_size_;
     int device_fd_;
+    // only open in DirectAsync mode, and not serialized as the io mode is taken
+    // from the configuration
+    int direct_fd_;
+    MountPointIoMode io_mode_;
+    std::unique_ptr<ClusterCacheAsyncIo> aio_;
+
+    uint64_t
+    offset_(uint32_t index) const
+    {
+        return (index + 1) * cluster_size_;
+    }
+
+    static bool
+    is_aligned_(const void* p)
+    {
+        return reinterpret_cast<uintptr_t>(p) % direct_io_alignment_ == 0;
+    }
+
+    static AlignedBuffer
+    make_aligned_buffer_(const size_t size)
+    {
+        void* p = nullptr;
+        if (::posix_memalign(&p,
+                             direct_io_alignment_,
+                             size) != 0)
+        {
+            throw std::bad_alloc();
+        }
+
+        return AlignedBuffer(static_cast<uint8_t*>(p));
+    }
+
+    void
+    reopen_direct_fd_(int flags)
+    {
+        if (direct_fd_ >= 0)
+        {
+            int ret = ::close(direct_fd_);
+            direct_fd_ = -1;
+            VERIFY(ret == 0);
+        }
+
+        direct_fd_ = open(path_.string().c_str(),
+                          flags | O_DIRECT);
+        if (direct_fd_ < 0)
+        {
+            LOG_WARN(path_ << ": failed to open with O_DIRECT: " << strerror(errno) <<
+                     " - falling back to buffered I/O");
+        }
+    }
+
+    void
+    close_direct_fd_()
+    {
+        aio_.reset();
+
+        if (direct_fd_ >= 0)
+        {
+            int ret = ::close(direct_fd_);
+            if (ret < 0)
+            {
+                int err = errno;
+                LOG_ERROR(path_ << ": failed to close O_DIRECT fd: " << ::strerror(err) <<
+                          " - ignoring");
+            }
+            direct_fd_ = -1;
+        }
+    }
 
     friend class boost::serialization::access;
 
@@ -0,0 +1,139 @@
+// Copyright (C) 2016 iNuron NV
+//
+// This file is part of Open vStorage Open Source Edition (OSE),
+// as available from
+//
+//      http://www.openvstorage.org and
+//      http://www.openvstorage.com.
+//
+// This file is free software; you can redistribute it and/or modify it
+// under the terms of the GNU Affero General Public License v3 (GNU AGPLv3)
+// as published by the Free Software Foundation, in version 3 as it comes in
+// the LICENSE.txt file of the Open vStorage OSE distribution.
+// Open vStorage is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY of any kind.
+
+#include "CorkedClusters.h"
+
+#include <algorithm>
+
+namespace volumedriver
+{
+
+constexpr ClusterAddress CorkedClusters::empty_slot_;
+constexpr size_t CorkedClusters::min_slots_;
+
+namespace
+{
+
+size_t
+slots_for(size_t n)
+{
+    size_t slots = 1;
+    // keep the load factor at or below 1/2
+    while (slots < 2 * n)
+    {
+        slots <<= 1;
+    }
+
+    return slots;
+}
+
+}
+
+CorkedClusters::CorkedClusters(size_t capacity_hint)
+    : size_(0)
+    , shift_(0)
+{
+    resize_(std::max(min_slots_,
+                     slots_for(capacity_hint)));
+}
+
+void
+CorkedClusters::insert(const ClusterAddress ca,
+                       const ClusterLocationAndHash& loc)
+{
+    VERIFY(ca != empty_slot_);
+
+    if (2 * (size_ + 1) > slots_.size())
+    {
+        resize_(2 * slots_.size());
+    }
+
+    for (size_t i = slot_(ca); true; i = (i + 1) & mask_())
+    {
+        Entry& e = slots_[i];
+        if (e.first == ca)
+        {
+            e.second = loc;
+            return;
+        }
+        else if (e.first == empty_slot_)
+        {
+            e.first = ca;
+            e.second = loc;
+            ++size_;
+            return;
+        }
+    }
+}
+
+void
+CorkedClusters::resize_(size_t nslots)
+{
+    ASSERT(nslots >= 2 * size_);
+    // power of 2
+    ASSERT((nslots & (nslots - 1)) == 0);
+
+    std::vector<Entry> old(nslots,
+                           Entry(empty_slot_,
+                                 ClusterLocationAndHash()));
+    std::swap(old, slots_);
+    size_ = 0;
+
+    shift_ = 64;
+    while (nslots > 1)
+    {
+        --shift_;
+        nslots >>= 1;
+    }
+
+    for (const auto& e : old)
+    {
+        if (e.first != empty_slot_)
+        {
+            insert(e.first,
+                   e.second);
+        }
+    }
+}
+
+std::vector<CorkedClusters::Entry>
+CorkedClusters::sorted_entries() const
+{
+    std::vector<Entry> vec;
+    vec.reserve(size_);
+
+    for (const auto& e : slots_)
+    {
+        if (e.first != empty_slot_)
+        {
+            vec.push_back(e);
+        }
+    }
+
+    std::sort(vec.begin(),
+              vec.end(),
+              [](const Entry& a, const Entry& b)
+              {
+                  return a.first < b.first;
+              });
+
+    return vec;
+}
+
+}
+
+// Local Variables: **
+// mode: c++ **
+// End: **
@@ -0,0 +1,165 @@
+// Copyright (C) 2016 iNuron NV
+//
+// This file is part of Open vStorage Open Source Edition (OSE),
+// as available from
+//
+//      http://www.openvstorage.org and
+//      http://www.openvstorage.com.
+//
+// This file is free software; you can redistribute it and/or modify it
+// under the terms of the GNU Affero General Public License v3 (GNU AGPLv3)
+// as published by the Free Software Foundation, in version 3 as it comes in
+// the LICENSE.txt file of the Open vStorage OSE distribution.
+// Open vStorage is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY of any kind.
+
+#ifndef VD_CORKED_CLUSTERS_H_
+#define VD_CORKED_CLUSTERS_H_
+
+#include "ClusterLocationAndHash.h"
+#include "Types.h"
+
+#include <limits>
+#include <vector>
+
+#include <youtils/Assert.h>
+#include <youtils/Logging.h>
+
+namespace volumedriver
+{
+
+// The cluster locations written under one cork, i.e. the entries of a TLog
+// that is not yet on the backend.
+// This is a flat, open addressing (linear probing) hash table as
+// (a) there's one insert per written cluster between TLog rollovers and
+// (b) each read probes all corks before going to the page cache. Entries are
+// never removed individually - the whole thing is dropped once it was handed
+// off to the page cache.
+class CorkedClusters
+{
+public:
+    using Entry = std::pair<ClusterAddress, ClusterLocationAndHash>;
+
+    explicit CorkedClusters(size_t capacity_hint = 0);
+
+    ~CorkedClusters() = default;
+
+    CorkedClusters(const CorkedClusters&) = default;
+
+    CorkedClusters&
+    operator=(const CorkedClusters&) = default;
+
+    void
+    insert(const ClusterAddress ca,
+           const ClusterLocationAndHash& loc);
+
+    const ClusterLocationAndHash*
+    find(const ClusterAddress ca) const
+    {
+        ASSERT(ca != empty_slot_);
+
+        for (size_t i = slot_(ca); true; i = (i + 1) & mask_())
+        {
+            const Entry& e = slots_[i];
+            if (e.first == ca)
+            {
+                return &e.second;
+            }
+            else if (e.first == empty_slot_)
+            {
+                return nullptr;
+            }
+        }
+    }
+
+    size_t
+    size() const
+    {
+        return size_;
+    }
+
+    bool
+    empty() const
+    {
+        return size_ == 0;
+    }
+
+    // Calls f(ClusterAddress, const ClusterLocationAndHash&) for all entries in
+    // [begin, end), in no particular order.
+    template<typename F>
+    void
+    for_each_in_range(const ClusterAddress begin,
+                      const ClusterAddress end,
+                      F&& f) const
+    {
+        if (end <= begin or empty())
+        {
+            return;
+        }
+
+        if (end - begin < size_)
+        {
+            for (ClusterAddress ca = begin; ca < end; ++ca)
+            {
+                const ClusterLocationAndHash* loc = find(ca);
+                if (loc)
+                {
+                    f(ca, *loc);
+                }
+            }
+        }
+        else
+        {
+            for (const auto& e : slots_)
+            {
+                if (e.first != empty_slot_ and
+                    e.first >= begin and
+                    e.first < end)
+                {
+                    f(e.first, e.second);
+                }
+            }
+        }
+    }
+
+    // The entries sorted by ClusterAddress and hence grouped by page - used to
+    // hand them off to the page cache in bulk.
+    std::vector<Entry>
+    sorted_entries() const;
+
+private:
+    DECLARE_LOGGER("CorkedClusters");
+
+    static constexpr ClusterAddress empty_slot_ =
+        std::numeric_limits<ClusterAddress>::max();
+
+    static constexpr size_t min_slots_ = 1ULL << 10;
+
+    std::vector<Entry> slots_;
+    size_t size_;
+    unsigned shift_;
+
+    size_t
+    mask_() const
+    {
+        return slots_.size() - 1;
+    }
+
+    size_t
+    slot_(const ClusterAddress ca) const
+    {
+        // Fibonacci hashing - spreads both sequential and strided addresses.
+        return (ca * 11400714819323198485ULL) >> shift_;
+    }
+
+    void
+    resize_(size_t nslots);
+};
+
+}
+
+#endif // !VD_CORKED_CLUSTERS_H_
+
+// Local Variables: **
+// mode: c++ **
+// End: **
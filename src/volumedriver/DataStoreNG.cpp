@@ -14,12 +14,14 @@
 // but WITHOUT ANY WARRANTY of any kind.
 
 #include "DataStoreNG.h"
+#include "PartialReadExecutor.h"
 #include "TracePoints_tp.h"
 #include "TransientException.h"
 #include "Volume.h"
 #include "VolManager.h"
 
 #include <cerrno>
+#include <climits>
 #include <algorithm>
 
 #include <youtils/Assert.h>
@@ -66,6 +68,9 @@ DataStoreNG::DataStoreNG(const VolumeConfig& cfg,
     , cacheHitCounter_(0)
     , cacheMissCounter_(0)
     , currentCheckSum_(nullptr)
+    , reserved_clusters_(0)
+    , stale_clusters_(0)
+    , reservation_generation_(0)
 {
     WLOCK_DATASTORE();
     validateConfig_();
@@ -412,14 +417,27 @@ DataStoreNG::pushSCO_(SCO sco)
 }
 
 void
-DataStoreNG::readFromSCO_(uint8_t* buf,
+DataStoreNG::readFromSCO_(const std::vector<struct iovec>& iov,
                           OpenSCOPtr osco,
                           size_t read_size,
                           size_t read_off)
 {
-    ssize_t res = osco->pread(buf,
-                              read_size,
-                              read_off);
+    VERIFY(not iov.empty());
+    VERIFY(iov.size() <= IOV_MAX);
+
+    yt::SteadyTimer t;
+
+    const ssize_t res = iov.size() == 1 ?
+        osco->pread(iov[0].iov_base,
+                    read_size,
+                    read_off) :
+        osco->preadv(iov.data(),
+                     iov.size(),
+                     read_off);
+
+    const auto duration_us(bc::duration_cast<bc::microseconds>(t.elapsed()));
+    getVolume()->performance_counters().sco_read_latency.record(duration_us.count());
+
     if (res != static_cast<ssize_t>(read_size))
     {
         LOG_ERROR("Read size " << res << " != requested size " << read_size);
@@ -521,36 +539,57 @@ DataStoreNG::readClusters(const std::vector<ClusterReadDescriptor>& descs)
 
     const size_t csize = getClusterSize();
 
+    // Runs of clusters at consecutive SCO offsets are read with a single
+    // preadv even if their buffers are not contiguous (e.g. because of
+    // interleaved cluster cache hits); adjacent buffers share an iovec.
+    static thread_local std::vector<struct iovec> iov;
+
     for (size_t start = 0; start < num_descs; )
     {
         size_t num_clusters = 1;
         const ClusterLocation& prev = descs[start].getClusterLocation();
         SCOCloneID start_cid = prev.cloneID();
 
+        iov.clear();
+        iov.push_back({ descs[start].getBuffer(), csize });
+
         for (size_t i = start + 1; i < num_descs; ++i)
         {
             // Can be optimized by comparing against the first clusterloc
             // const ClusterLocation& prev = descs[i - 1].getClusterLocation();
             const ClusterLocation& cur = descs[i].getClusterLocation();
-            if (prev.number() == cur.number() and
-                prev.version() == cur.version() and
-                start_cid == cur.cloneID() and
-                prev.offset() + (i-start) == cur.offset() and
-                // use preadv and get rid of that:
-                descs[i - 1].getBuffer() + getClusterSize() == descs[i].getBuffer())
+            if (prev.number() != cur.number() or
+                prev.version() != cur.version() or
+                start_cid != cur.cloneID() or
+                prev.offset() + (i-start) != cur.offset())
+            {
+                break;
+            }
+
+            uint8_t* buf = descs[i].getBuffer();
+            struct iovec& last = iov.back();
+
+            if (static_cast<uint8_t*>(last.iov_base) + last.iov_len == buf)
             {
-                ++num_clusters;
+                last.iov_len += csize;
+            }
+            else if (iov.size() < IOV_MAX)
+            {
+                iov.push_back({ buf, csize });
             }
             else
             {
                 break;
             }
+
+            ++num_clusters;
         }
 
         RLOCK_DATASTORE();
 
         bool hit = read_adjacent_clusters_(descs[start],
                                            num_clusters,
+                                           iov,
                                            false);
         if (not hit)
         {
@@ -563,6 +602,7 @@ DataStoreNG::readClusters(const std::vector<ClusterReadDescriptor>& descs)
                 // fetch from the FOC if present
                 hit = read_adjacent_clusters_(descs[start],
                                               num_clusters,
+                                              iov,
                                               true);
                 VERIFY(hit);
             }
@@ -570,15 +610,23 @@ DataStoreNG::readClusters(const std::vector<ClusterReadDescriptor>& descs)
             {
                 // the SCO is (supposed to be) on the backend
                 sco.cloneID(SCOCloneID(0));
-                be::BackendConnectionInterface::ObjectSlice
-                    slice(num_clusters * csize,
-                          descs[start].getClusterLocation().offset() * csize,
-                          descs[start].getBuffer());
 
                 be::BackendConnectionInterface::PartialReads&
                     partial_reads = partial_reads_map[start_cid];
-                const auto res(partial_reads[sco.str()].emplace(std::move(slice)));
-                VERIFY(res.second);
+                be::BackendConnectionInterface::ObjectSlices&
+                    slices = partial_reads[sco.str()];
+
+                // one slice per buffer - the backends coalesce slices that
+                // are adjacent in the object
+                uint64_t off = descs[start].getClusterLocation().offset() * csize;
+                for (const auto& v : iov)
+                {
+                    const auto res(slices.emplace(v.iov_len,
+                                                  off,
+                                                  static_cast<uint8_t*>(v.iov_base)));
+                    VERIFY(res.second);
+                    off += v.iov_len;
+                }
             }
         }
 
@@ -590,72 +638,133 @@ DataStoreNG::readClusters(const std::vector<ClusterReadDescriptor>& descs)
         InsistOnLatestVersion::F :
         InsistOnLatestVersion::T;
 
-    // Candidate for parallelization
-    for (const auto& partial_reads : partial_reads_map)
-    {
-        yt::SteadyTimer t;
+    // The partial reads of a clone (namespace) go to the backend as a batch,
+    // and the batches of different clones - possibly also several batches of a
+    // clone with many SCOs - run concurrently so their latencies don't add up.
+    VolManager* vm = VolManager::get();
+    const size_t max_in_flight =
+        std::max<size_t>(1, vm->max_concurrent_partial_reads.value());
+    const size_t batches_per_clone =
+        std::max<size_t>(1, max_in_flight / std::max<size_t>(1, partial_reads_map.size()));
 
-        const SCOCloneID cid = partial_reads.first;
-        auto& bi = getVolume()->getBackendInterface(cid);
-        auto fun([&](SCO sco,
-                     bool& cached,
-                     InsistOnLatestVersion) -> CachedSCOPtr
-                 {
-                     sco.cloneID(cid);
+    using PartialReads = be::BackendConnectionInterface::PartialReads;
 
-                     RLOCK_DATASTORE();
-                     return getSCO_(sco,
-                                    bi->clone(),
-                                    cached,
-                                    nullptr);
-                 });
+    std::vector<std::pair<SCOCloneID, PartialReads>> batches;
+    std::vector<PartialReadExecutor::Job> jobs;
 
-        PartialReadFallback fallback(fun);
+    for (const auto& p : partial_reads_map)
+    {
+        const SCOCloneID cid = p.first;
+        const size_t nbatches = std::min(batches_per_clone,
+                                         p.second.size());
 
-        try
+        if (nbatches <= 1)
         {
-            const be::PartialReadCounter prc(bi->partial_read(partial_reads.second,
-                                                              fallback,
-                                                              insist_on_latest));
-            LOCK_PARTIAL_READ_COUNTER();
-            partial_read_counter_ += prc;
+            const PartialReads& partial_reads = p.second;
+            jobs.emplace_back([this, cid, &partial_reads, insist_on_latest]
+                              {
+                                  partial_read_(cid,
+                                                partial_reads,
+                                                insist_on_latest);
+                              });
         }
-        catch (be::BackendConnectFailureException&)
+        else
         {
-            throw TransientException("Backend connection failure");
+            const size_t per_batch = (p.second.size() + nbatches - 1) / nbatches;
+            for (const auto& q : p.second)
+            {
+                if (batches.empty() or
+                    batches.back().first != cid or
+                    batches.back().second.size() == per_batch)
+                {
+                    batches.emplace_back(cid,
+                                         PartialReads());
+                }
+                batches.back().second.insert(q);
+            }
         }
+    }
 
-        cacheHitCounter_ += fallback.hits;
-        cacheMissCounter_ += fallback.misses;
+    for (const auto& b : batches)
+    {
+        jobs.emplace_back([this, &b, insist_on_latest]
+                          {
+                              partial_read_(b.first,
+                                            b.second,
+                                            insist_on_latest);
+                          });
+    }
 
-        if (fallback.misses or
-            (fallback.hits == 0 and fallback.misses == 0))
-        {
-            const auto duration_us(bc::duration_cast<bc::microseconds>(t.elapsed()));
-            PerformanceCounters& c = getVolume()->performance_counters();
-            c.backend_read_request_usecs.count(duration_us.count());
+    vm->partial_read_executor().run(std::move(jobs),
+                                    max_in_flight);
+}
+
+void
+DataStoreNG::partial_read_(const SCOCloneID cid,
+                           const be::BackendConnectionInterface::PartialReads& partial_reads,
+                           InsistOnLatestVersion insist_on_latest)
+{
+    yt::SteadyTimer t;
+
+    auto& bi = getVolume()->getBackendInterface(cid);
+    auto fun([&](SCO sco,
+                 bool& cached,
+                 InsistOnLatestVersion) -> CachedSCOPtr
+             {
+                 sco.cloneID(cid);
 
-            uint64_t bytes = 0;
-            for (const auto& pr : partial_reads.second)
+                 RLOCK_DATASTORE();
+                 return getSCO_(sco,
+                                bi->clone(),
+                                cached,
+                                nullptr);
+             });
+
+    PartialReadFallback fallback(fun);
+
+    try
+    {
+        const be::PartialReadCounter prc(bi->partial_read(partial_reads,
+                                                          fallback,
+                                                          insist_on_latest));
+        LOCK_PARTIAL_READ_COUNTER();
+        partial_read_counter_ += prc;
+    }
+    catch (be::BackendConnectFailureException&)
+    {
+        throw TransientException("Backend connection failure");
+    }
+
+    cacheHitCounter_ += fallback.hits;
+    cacheMissCounter_ += fallback.misses;
+
+    if (fallback.misses or
+        (fallback.hits == 0 and fallback.misses == 0))
+    {
+        const auto duration_us(bc::duration_cast<bc::microseconds>(t.elapsed()));
+        PerformanceCounters& c = getVolume()->performance_counters();
+        c.backend_read_request_usecs.count(duration_us.count());
+        c.backend_partial_read_latency.record(duration_us.count());
+
+        uint64_t bytes = 0;
+        for (const auto& pr : partial_reads)
+        {
+            for (const auto& slice : pr.second)
             {
-                for (const auto& slice : pr.second)
-                {
-                    bytes += slice.size;
-                }
+                bytes += slice.size;
             }
-
-            c.backend_read_request_size.count(bytes);
         }
+
+        c.backend_read_request_size.count(bytes);
     }
 }
 
 bool
 DataStoreNG::read_adjacent_clusters_(const ClusterReadDescriptor& desc,
                                      size_t num_clusters,
+                                     const std::vector<struct iovec>& iov,
                                      bool fetch_if_necessary)
 {
-    uint8_t* buf = desc.getBuffer();
-
     const ClusterLocation& loc = desc.getClusterLocation();
     SCO sconame = loc.sco();
 
@@ -729,7 +838,7 @@ DataStoreNG::read_adjacent_clusters_(const ClusterReadDescriptor& desc,
 
     try
     {
-        readFromSCO_(buf,
+        readFromSCO_(iov,
                      osco,
                      num_clusters * cluster_size_,
                      loc.offset() * cluster_size_);
@@ -813,6 +922,8 @@ DataStoreNG::pushAndUpdateCurrentSCO_(bool ignore_transient_errors)
     LOG_DEBUG("Pushing sco " << currentSCO_()->sco_ptr()->getSCO() << "to the backend");
 
     VERIFY(currentSCO_() != 0);
+    VERIFY(reserved_clusters_ == 0);
+    VERIFY(stale_clusters_ == 0);
 
     pushSCO_(currentSCO_()->sco_name());
 
@@ -846,10 +957,22 @@ void
 DataStoreNG::writeClusterToLocation(const uint8_t* buf,
                                     const ClusterLocation& loc,
                                     uint32_t& throttle)
+{
+    writeClustersToLocation(buf,
+                            loc,
+                            1,
+                            throttle);
+}
+
+void
+DataStoreNG::writeClustersToLocation(const uint8_t* buf,
+                                     const ClusterLocation& loc,
+                                     size_t num_locs,
+                                     uint32_t& throttle)
 {
     WLOCK_DATASTORE();
-    LOG_DEBUG(nspace_ << ": forced write to " << loc << ", current loc: " <<
-              currentClusterLoc_);
+    LOG_DEBUG(nspace_ << ": forced write of " << num_locs << " clusters to " <<
+              loc << ", current loc: " << currentClusterLoc_);
 
     VERIFY(loc.cloneID() == 0);
     VERIFY(loc.version() == 0);
@@ -862,9 +985,11 @@ DataStoreNG::writeClusterToLocation(const uint8_t* buf,
                                  nspace_.c_str());
     }
 
-    std::vector<ClusterLocation> dummy(1);
-    writeClusters_(buf, dummy, 1, throttle);
-    VERIFY(dummy[0] == loc);
+    VERIFY(num_locs > 0);
+
+    std::vector<ClusterLocation> locs(num_locs);
+    writeClusters_(buf, locs, num_locs, throttle);
+    VERIFY(locs[0] == loc);
 }
 
 void
@@ -942,6 +1067,171 @@ DataStoreNG::writeClusters_(const uint8_t* buf,
     LOG_DEBUG("CurrentClusterLoc after write: " << currentClusterLoc_);
 }
 
+size_t
+DataStoreNG::reserveClusters(size_t num_locs,
+                             SCOWriteReservation& res)
+{
+    WLOCK_DATASTORE();
+
+    if (stale_clusters_ > 0)
+    {
+        LOG_DEBUG(nspace_ << ": " << stale_clusters_ <<
+                  " clusters of discarded reservations are still in flight");
+        return 0;
+    }
+
+    if (currentSCO_() == 0)
+    {
+        VERIFY(reserved_clusters_ == 0);
+        LOG_DEBUG("current SCO == 0 - previous cache full event?");
+        updateCurrentSCO_();
+    }
+
+    VERIFY(currentSCO_() != 0);
+
+    const ssize_t cap =
+        sco_mult_.t - currentClusterLoc_.offset() - reserved_clusters_;
+    if (cap <= 0)
+    {
+        return 0;
+    }
+
+    res.num_locs = std::min(num_locs,
+                            static_cast<size_t>(cap));
+    res.osco = currentSCO_();
+    res.loc = ClusterLocation(currentClusterLoc_.number(),
+                              currentClusterLoc_.offset() + reserved_clusters_);
+    res.generation = reservation_generation_;
+    res.error = boost::none;
+
+    reserved_clusters_ += res.num_locs;
+
+    return res.num_locs;
+}
+
+void
+DataStoreNG::writeReservedClusters(SCOWriteReservation& res,
+                                   const uint8_t* buf,
+                                   uint32_t& throttle_usecs)
+{
+    VERIFY(res.osco != nullptr);
+
+    const uint64_t wsize = res.num_locs * cluster_size_;
+
+    try
+    {
+        const off_t off = res.loc.offset() * cluster_size_;
+        const ssize_t ret = res.osco->pwrite(buf,
+                                             wsize,
+                                             off,
+                                             throttle_usecs);
+        if (ret != static_cast<ssize_t>(wsize))
+        {
+            LOG_ERROR("Written size " << ret << " != expected size " <<
+                      wsize);
+            throw fungi::IOException("Wrote less than expected",
+                                     res.osco->sco_ptr()->path().string().c_str(),
+                                     EIO);
+        }
+    }
+    catch (std::exception& e)
+    {
+        LOG_ERROR(nspace_ << ": failed to write " << res.num_locs <<
+                  " clusters starting at " << res.loc << ": " << e.what());
+        res.error = std::string(e.what());
+    }
+    catch (...)
+    {
+        LOG_ERROR(nspace_ << ": failed to write " << res.num_locs <<
+                  " clusters starting at " << res.loc << ": unknown exception");
+        res.error = std::string("unknown exception");
+    }
+}
+
+void
+DataStoreNG::commitClusters(const SCOWriteReservation& res,
+                            const uint8_t* buf,
+                            std::vector<ClusterLocation>& locs)
+{
+    WLOCK_DATASTORE();
+
+    if (res.generation != reservation_generation_)
+    {
+        VERIFY(stale_clusters_ >= res.num_locs);
+        stale_clusters_ -= res.num_locs;
+
+        LOG_WARN(nspace_ << ": discarding reservation of " << res.num_locs <<
+                 " clusters at " << res.loc <<
+                 " as a preceding one failed");
+        throw TransientException("SCO write reservation was invalidated");
+    }
+
+    // The SCO might have been reopened (and refetched from the DTL) after a
+    // read error in the meantime in which case the data we wrote to the old
+    // one is lost.
+    if (res.error or res.osco != currentSCO_())
+    {
+        // The reservations following this one were handed out ranges behind
+        // it and might still be writing to them - fence them off until they're
+        // all discarded instead of handing out their ranges again.
+        VERIFY(reserved_clusters_ >= res.num_locs);
+        ++reservation_generation_;
+        stale_clusters_ = reserved_clusters_ - res.num_locs;
+        reserved_clusters_ = 0;
+
+        if (res.osco == currentSCO_())
+        {
+            reportIOError_(res.osco->sco_ptr(),
+                           false,
+                           res.error->c_str());
+        }
+        else
+        {
+            throw TransientException("SCO was reopened during write");
+        }
+    }
+
+    VERIFY(res.loc.number() == currentClusterLoc_.number());
+    VERIFY(res.loc.offset() == currentClusterLoc_.offset());
+    VERIFY(reserved_clusters_ >= res.num_locs);
+
+    currentCheckSum_->update(buf,
+                             res.num_locs * cluster_size_);
+
+    for (size_t i = 0; i < res.num_locs; ++i)
+    {
+        locs[i] = ClusterLocation(currentClusterLoc_.number(),
+                                  currentClusterLoc_.offset() + i);
+    }
+
+    currentClusterLoc_.offset(currentClusterLoc_.offset() + res.num_locs);
+    reserved_clusters_ -= res.num_locs;
+}
+
+void
+DataStoreNG::discardReservation(const SCOWriteReservation& res)
+{
+    WLOCK_DATASTORE();
+
+    if (res.generation != reservation_generation_)
+    {
+        VERIFY(stale_clusters_ >= res.num_locs);
+        stale_clusters_ -= res.num_locs;
+        return;
+    }
+
+    LOG_WARN(nspace_ << ": discarding uncommitted reservation of " <<
+             res.num_locs << " clusters at " << res.loc);
+
+    VERIFY(res.loc.number() == currentClusterLoc_.number());
+    VERIFY(res.loc.offset() == currentClusterLoc_.offset());
+    VERIFY(reserved_clusters_ >= res.num_locs);
+
+    ++reservation_generation_;
+    stale_clusters_ = reserved_clusters_ - res.num_locs;
+    reserved_clusters_ = 0;
+}
+
 MaybeCheckSum
 DataStoreNG::sync_()
 {
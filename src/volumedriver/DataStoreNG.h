@@ -28,11 +28,15 @@
 #include "VolumeConfig.h"
 #include "WriteSCOCache.h"
 
+#include <sys/uio.h>
+
+#include <string>
 #include <vector>
 #include <set>
 
 #include <boost/archive/text_oarchive.hpp>
 #include <boost/archive/text_iarchive.hpp>
+#include <boost/optional.hpp>
 #include <boost/serialization/utility.hpp>
 #include <boost/thread/locks.hpp>
 #include <boost/thread/shared_mutex.hpp>
@@ -51,18 +55,19 @@ class WriteOnlyVolume;
 class VolManagerTestSetup;
 
 // should NOT have a backend interface...
+// ... so it at least doesn't own one: bi is shared by all descriptors of a
+// clone within a request and needs to outlive them (it's the volume's).
 class ClusterReadDescriptor
 {
 public:
     ClusterReadDescriptor(const ClusterLocationAndHash& loc_and_hash,
                           ClusterAddress ca,
                           uint8_t* buf,
-                          BackendInterfacePtr bi)
+                          const BackendInterface* bi)
         : loc_and_hash_(loc_and_hash)
         , ca_(ca)
         , buf_(buf)
-        , bi_(std::move(bi))
-
+        , bi_(bi)
     { }
 
     ClusterReadDescriptor(const ClusterReadDescriptor& other) = delete;
@@ -71,7 +76,7 @@ public:
         : loc_and_hash_(other.loc_and_hash_)
         , ca_(other.ca_)
         , buf_(other.buf_)
-        , bi_(std::move(other.bi_))
+        , bi_(other.bi_)
     {}
 
     ~ClusterReadDescriptor() = default;
@@ -114,7 +119,19 @@ private:
     const ClusterLocationAndHash loc_and_hash_;
     const ClusterAddress ca_;
     uint8_t* buf_;
-    std::unique_ptr<BackendInterface> bi_;
+    const BackendInterface* bi_;
+};
+
+// Concurrent writers (cf. Volume::write_aligned_) reserve a range of the
+// current SCO, write their data to it without holding the DataStore lock
+// and subsequently commit the range - in reservation order.
+struct SCOWriteReservation
+{
+    OpenSCOPtr osco;
+    ClusterLocation loc;
+    size_t num_locs = 0;
+    uint64_t generation = 0;
+    boost::optional<std::string> error;
 };
 
 class DataStoreNG
@@ -151,12 +168,48 @@ public:
                            const ClusterLocation& loc,
                            uint32_t& throttle);
 
+    // Writes `num_locs' clusters to consecutive locations starting at `loc',
+    // which needs to be the current location (DTL replay).
+    void
+    writeClustersToLocation(const uint8_t* buf,
+                            const ClusterLocation& loc,
+                            size_t num_locs,
+                            uint32_t& throttle);
+
     void
     writeClusters(const uint8_t* buf,
                   std::vector<ClusterLocation>& locs,
                   size_t num_locs,
                   uint32_t& throttle_usecs);
 
+    // Returns the number of clusters reserved (<= num_locs). 0 indicates that
+    // the current SCO is fully reserved (or fenced off after a failed write)
+    // and the pending reservations need to be committed before the SCO can be
+    // rolled over / used again.
+    size_t
+    reserveClusters(size_t num_locs,
+                    SCOWriteReservation& res);
+
+    // Does not throw - errors are recorded in the reservation and dealt with
+    // by commitClusters.
+    void
+    writeReservedClusters(SCOWriteReservation& res,
+                          const uint8_t* buf,
+                          uint32_t& throttle_usecs);
+
+    // Throws a TransientException if writing the reserved clusters failed or
+    // if the reservation was invalidated by an error of a preceding one.
+    void
+    commitClusters(const SCOWriteReservation& res,
+                   const uint8_t* buf,
+                   std::vector<ClusterLocation>& locs);
+
+    // For writers that give up on a reservation before committing it - also
+    // needs to be called in reservation order. The following reservations are
+    // fenced off as after a failed write.
+    void
+    discardReservation(const SCOWriteReservation& res);
+
     void
     touchCluster(const ClusterLocation&);
 
@@ -292,6 +345,15 @@ private:
 
     std::unique_ptr<CheckSum> currentCheckSum_;
 
+    // Clusters of the current SCO that were handed out by reserveClusters but
+    // are not committed yet, and the generation of these reservations which is
+    // bumped if they need to be discarded. Discarded reservations might still
+    // be writing to the SCO so no new ones are handed out until all of them
+    // came by commitClusters (stale_clusters_ == 0). Protected by rw_lock_.
+    size_t reserved_clusters_;
+    size_t stale_clusters_;
+    uint64_t reservation_generation_;
+
     OpenSCOPtr
     currentSCO_() const;
 
@@ -330,13 +392,23 @@ private:
     MaybeCheckSum
     pushAndUpdateCurrentSCO_(bool ignore_transient_errors = true);
 
+    // iov: the buffers of the count clusters starting at the
+    // ClusterReadDescriptor's location
     bool
     read_adjacent_clusters_(const ClusterReadDescriptor&,
                             size_t count,
+                            const std::vector<struct iovec>& iov,
                             bool fetch_if_necessary);
 
+    // Called concurrently for the SCOs of a read request - must not be
+    // invoked with rw_lock_ held.
+    void
+    partial_read_(const SCOCloneID,
+                  const backend::BackendConnectionInterface::PartialReads&,
+                  InsistOnLatestVersion);
+
     void
-    readFromSCO_(uint8_t* buf,
+    readFromSCO_(const std::vector<struct iovec>& iov,
                  OpenSCOPtr osco,
                  size_t read_size,
                  size_t read_off);
@@ -56,6 +56,29 @@ public:
                uint64_t start_address,
                const uint8_t* data) = 0;
 
+    // Two phase variant of addEntries for callers that want to give up their
+    // own ordering constraints before waiting for the DTL's acknowledgement
+    // (cf. Volume::write_aligned_): sendEntries queues / sends the entries in
+    // call order and hands out a ticket to be passed to waitForEntries, with 0
+    // meaning that there's nothing to wait for.
+    virtual bool
+    sendEntries(const std::vector<ClusterLocation>& locs,
+                size_t num_locs,
+                uint64_t start_address,
+                const uint8_t* data,
+                uint64_t& ticket)
+    {
+        ticket = 0;
+        return addEntries(locs,
+                          num_locs,
+                          start_address,
+                          data);
+    }
+
+    virtual void
+    waitForEntries(uint64_t /* ticket */)
+    {}
+
     virtual bool
     backup() = 0;
 
@@ -145,6 +145,13 @@ FailOverCacheProxy::setBusyLoopDuration(const bc::microseconds usecs)
 
 void
 FailOverCacheProxy::addEntries(std::vector<FailOverCacheEntry> entries)
+{
+    sendAddEntries(std::move(entries));
+    checkAddEntries();
+}
+
+void
+FailOverCacheProxy::sendAddEntries(std::vector<FailOverCacheEntry> entries)
 {
 #ifndef NDEBUG
     if (not entries.empty())
@@ -158,7 +165,13 @@ FailOverCacheProxy::addEntries(std::vector<FailOverCacheEntry> entries)
 #endif
 
     const CommandData<AddEntries> comd(std::move(entries));
-    stream_ << comd;
+    volumedriver::sendAddEntries(stream_, comd);
+}
+
+void
+FailOverCacheProxy::checkAddEntries()
+{
+    checkStreamOK("AddEntries");
 }
 
 void
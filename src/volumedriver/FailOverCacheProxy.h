@@ -53,6 +53,15 @@ public:
     void
     addEntries(std::vector<FailOverCacheEntry>);
 
+    // Pipelined variant of addEntries: the acknowledgements of the sent
+    // requests have to be collected (in order) with checkAddEntries before
+    // issuing any other request.
+    void
+    sendAddEntries(std::vector<FailOverCacheEntry>);
+
+    void
+    checkAddEntries();
+
     // returns the SCO size - 0 indicates a problem.
     // Z42: throw instead!
     uint64_t
@@ -0,0 +1,323 @@
+// Copyright (C) 2016 iNuron NV
+//
+// This file is part of Open vStorage Open Source Edition (OSE),
+// as available from
+//
+//      http://www.openvstorage.org and
+//      http://www.openvstorage.com.
+//
+// This file is free software; you can redistribute it and/or modify it
+// under the terms of the GNU Affero General Public License v3 (GNU AGPLv3)
+// as published by the Free Software Foundation, in version 3 as it comes in
+// the LICENSE.txt file of the Open vStorage OSE distribution.
+// Open vStorage is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY of any kind.
+
+#include "FailOverCacheProxy.h"
+#include "FailOverCacheReplayer.h"
+
+#include <deque>
+#include <exception>
+
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <youtils/Assert.h>
+#include <youtils/Catchers.h>
+#include <youtils/ScopeExit.h>
+#include <youtils/Timer.h>
+
+namespace volumedriver
+{
+
+namespace bc = boost::chrono;
+namespace yt = youtils;
+
+namespace
+{
+
+using BatchPtr = std::unique_ptr<FailOverCacheReplayer::Batch>;
+
+// Thrown into the receiver to get out of FailOverCacheProxy::getEntries once
+// another stage failed.
+struct ReplayAborted
+    : public std::exception
+{
+    virtual const char*
+    what() const noexcept override final
+    {
+        return "DTL replay aborted";
+    }
+};
+
+// Bounded FIFO between two stages. close() signals the end of the stream,
+// abort() makes producers and consumers bail out right away.
+class BatchQueue
+{
+public:
+    explicit BatchQueue(size_t capacity)
+        : capacity_(capacity)
+        , closed_(false)
+        , aborted_(false)
+    {
+        VERIFY(capacity_ > 0);
+    }
+
+    // returns false if the queue was aborted
+    bool
+    push(BatchPtr b)
+    {
+        boost::unique_lock<decltype(lock_)> u(lock_);
+        cond_.wait(u,
+                   [&]
+                   {
+                       return aborted_ or q_.size() < capacity_;
+                   });
+
+        if (aborted_)
+        {
+            return false;
+        }
+
+        VERIFY(not closed_);
+        q_.emplace_back(std::move(b));
+        cond_.notify_all();
+
+        return true;
+    }
+
+    // returns nullptr at the end of the stream or if the queue was aborted
+    BatchPtr
+    pop()
+    {
+        boost::unique_lock<decltype(lock_)> u(lock_);
+        cond_.wait(u,
+                   [&]
+                   {
+                       return aborted_ or closed_ or not q_.empty();
+                   });
+
+        if (aborted_ or q_.empty())
+        {
+            return nullptr;
+        }
+
+        BatchPtr b(std::move(q_.front()));
+        q_.pop_front();
+        cond_.notify_all();
+
+        return b;
+    }
+
+    void
+    close()
+    {
+        boost::lock_guard<decltype(lock_)> g(lock_);
+        closed_ = true;
+        cond_.notify_all();
+    }
+
+    void
+    abort()
+    {
+        boost::lock_guard<decltype(lock_)> g(lock_);
+        aborted_ = true;
+        cond_.notify_all();
+    }
+
+private:
+    DECLARE_LOGGER("FailOverCacheReplayerQueue");
+
+    boost::mutex lock_;
+    boost::condition_variable cond_;
+    std::deque<BatchPtr> q_;
+    const size_t capacity_;
+    bool closed_;
+    bool aborted_;
+};
+
+}
+
+FailOverCacheReplayer::FailOverCacheReplayer(const ClusterSize csize,
+                                             const size_t max_batch_clusters,
+                                             const size_t queue_depth)
+    : cluster_size_(csize)
+    , max_batch_clusters_(max_batch_clusters)
+    , queue_depth_(queue_depth)
+{
+    VERIFY(max_batch_clusters_ > 0);
+    VERIFY(queue_depth_ > 0);
+}
+
+size_t
+FailOverCacheReplayer::default_max_batch_clusters()
+{
+    return 256;
+}
+
+size_t
+FailOverCacheReplayer::default_queue_depth()
+{
+    return 4;
+}
+
+FailOverCacheReplayer::Stats
+FailOverCacheReplayer::operator()(FailOverCacheProxy& foc,
+                                  BatchFun write,
+                                  BatchFun apply)
+{
+    const size_t csize = static_cast<size_t>(cluster_size_);
+
+    BatchQueue received(queue_depth_);
+    BatchQueue written(queue_depth_);
+
+    boost::mutex error_lock;
+    std::exception_ptr error;
+
+    auto fail([&](std::exception_ptr e)
+              {
+                  {
+                      boost::lock_guard<decltype(error_lock)> g(error_lock);
+                      if (not error)
+                      {
+                          error = e;
+                      }
+                  }
+
+                  received.abort();
+                  written.abort();
+              });
+
+    Stats stats;
+    yt::SteadyTimer timer;
+
+    boost::thread receiver([&]
+        {
+            try
+            {
+                BatchPtr batch;
+
+                auto push([&]
+                          {
+                              if (batch)
+                              {
+                                  ++stats.batches;
+                                  if (not received.push(std::move(batch)))
+                                  {
+                                      throw ReplayAborted();
+                                  }
+                              }
+                          });
+
+                foc.getEntries([&](ClusterLocation loc,
+                                   Lba lba,
+                                   const uint8_t* buf,
+                                   size_t size)
+                               {
+                                   VERIFY(size == csize);
+
+                                   if (batch and
+                                       (batch->size() == max_batch_clusters_ or
+                                        loc.sco() != batch->loc.sco() or
+                                        loc.offset() != batch->loc.offset() + batch->size()))
+                                   {
+                                       push();
+                                   }
+
+                                   if (not batch)
+                                   {
+                                       batch = std::make_unique<Batch>();
+                                       batch->loc = loc;
+                                       batch->lbas.reserve(max_batch_clusters_);
+                                       batch->data.reserve(max_batch_clusters_ * csize);
+                                   }
+
+                                   batch->lbas.push_back(lba.t);
+                                   batch->data.insert(batch->data.end(),
+                                                      buf,
+                                                      buf + size);
+                               });
+
+                push();
+                received.close();
+            }
+            catch (ReplayAborted&)
+            {}
+            catch (...)
+            {
+                fail(std::current_exception());
+            }
+        });
+
+    boost::thread writer([&]
+        {
+            try
+            {
+                while (BatchPtr batch = received.pop())
+                {
+                    write(*batch);
+                    VERIFY(batch->addrs.size() == batch->size());
+                    VERIFY(batch->locs_and_hashes.size() == batch->size());
+
+                    if (not written.push(std::move(batch)))
+                    {
+                        return;
+                    }
+                }
+
+                written.close();
+            }
+            catch (...)
+            {
+                fail(std::current_exception());
+            }
+        });
+
+    // only relevant if joining below throws
+    auto on_exit(yt::make_scope_exit([&]
+                                     {
+                                         received.abort();
+                                         written.abort();
+
+                                         if (receiver.joinable())
+                                         {
+                                             receiver.join();
+                                         }
+
+                                         if (writer.joinable())
+                                         {
+                                             writer.join();
+                                         }
+                                     }));
+
+    try
+    {
+        while (BatchPtr batch = written.pop())
+        {
+            apply(*batch);
+            stats.clusters += batch->size();
+        }
+    }
+    catch (...)
+    {
+        fail(std::current_exception());
+    }
+
+    receiver.join();
+    writer.join();
+
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+
+    stats.duration = bc::duration_cast<bc::microseconds>(timer.elapsed());
+    return stats;
+}
+
+}
+
+// Local Variables: **
+// mode: c++ **
+// End: **
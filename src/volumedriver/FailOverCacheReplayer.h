@@ -0,0 +1,117 @@
+// Copyright (C) 2016 iNuron NV
+//
+// This file is part of Open vStorage Open Source Edition (OSE),
+// as available from
+//
+//      http://www.openvstorage.org and
+//      http://www.openvstorage.com.
+//
+// This file is free software; you can redistribute it and/or modify it
+// under the terms of the GNU Affero General Public License v3 (GNU AGPLv3)
+// as published by the Free Software Foundation, in version 3 as it comes in
+// the LICENSE.txt file of the Open vStorage OSE distribution.
+// Open vStorage is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY of any kind.
+
+#ifndef VD_FAILOVER_CACHE_REPLAYER_H_
+#define VD_FAILOVER_CACHE_REPLAYER_H_
+
+#include "ClusterLocation.h"
+#include "ClusterLocationAndHash.h"
+#include "SCO.h"
+#include "Types.h"
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <boost/chrono.hpp>
+
+#include <youtils/CheckSum.h>
+#include <youtils/Logging.h>
+
+namespace volumedriver
+{
+
+class FailOverCacheProxy;
+
+// Replays the entries of a DTL (FailOverCacheProxy::getEntries) in a three
+// stage pipeline instead of one cluster at a time:
+// (1) a receiver thread pulls the entries off the wire and groups them into
+//     batches of consecutive clusters of a SCO,
+// (2) a writer thread hands each batch to the `write' callback (SCO data),
+// (3) the calling thread hands each batch to the `apply' callback (metadata).
+// The stages are connected by bounded queues, so receiving, writing to the
+// SCO and updating the metadata overlap while the memory use stays bounded.
+// Batches are processed in order by each stage.
+class FailOverCacheReplayer
+{
+public:
+    struct Batch
+    {
+        // location of the first cluster, the others follow consecutively
+        ClusterLocation loc;
+        std::vector<uint64_t> lbas;
+        std::vector<uint8_t> data;
+
+        // filled in by the write stage
+        std::vector<ClusterAddress> addrs;
+        std::vector<ClusterLocationAndHash> locs_and_hashes;
+        MaybeCheckSum forced_rollover;
+        unsigned throttle_usecs = 0;
+
+        size_t
+        size() const
+        {
+            return lbas.size();
+        }
+    };
+
+    using BatchFun = std::function<void(Batch&)>;
+
+    struct Stats
+    {
+        uint64_t clusters = 0;
+        uint64_t batches = 0;
+        boost::chrono::microseconds duration = boost::chrono::microseconds(0);
+    };
+
+    FailOverCacheReplayer(const ClusterSize,
+                          const size_t max_batch_clusters = default_max_batch_clusters(),
+                          const size_t queue_depth = default_queue_depth());
+
+    ~FailOverCacheReplayer() = default;
+
+    FailOverCacheReplayer(const FailOverCacheReplayer&) = delete;
+
+    FailOverCacheReplayer&
+    operator=(const FailOverCacheReplayer&) = delete;
+
+    // Exceptions thrown by any of the stages are rethrown after all of them
+    // stopped.
+    Stats
+    operator()(FailOverCacheProxy&,
+               BatchFun write,
+               BatchFun apply);
+
+    static size_t
+    default_max_batch_clusters();
+
+    static size_t
+    default_queue_depth();
+
+private:
+    DECLARE_LOGGER("FailOverCacheReplayer");
+
+    const ClusterSize cluster_size_;
+    const size_t max_batch_clusters_;
+    const size_t queue_depth_;
+};
+
+}
+
+#endif // !VD_FAILOVER_CACHE_REPLAYER_H_
+
+// Local Variables: **
+// mode: c++ **
+// End: **
@@ -65,6 +65,13 @@ operator>>(fungi::IOBaseStream& stream, CommandData<Register>& data)
 
 fungi::IOBaseStream&
 operator<<(fungi::IOBaseStream& stream, const CommandData<AddEntries>& data)
+{
+    sendAddEntries(stream, data);
+    return checkStreamOK(stream, "AddEntries");
+}
+
+fungi::IOBaseStream&
+sendAddEntries(fungi::IOBaseStream& stream, const CommandData<AddEntries>& data)
 {
     if (not data.entries_.empty())
     {
@@ -100,7 +107,7 @@ operator<<(fungi::IOBaseStream& stream, const CommandData<AddEntries>& data)
         }
     }
     stream << fungi::IOBaseStream::uncork;
-    return checkStreamOK(stream, "AddEntries");
+    return stream;
 }
 
 fungi::IOBaseStream&
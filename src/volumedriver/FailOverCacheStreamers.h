@@ -115,6 +115,11 @@ struct CommandData<AddEntries>
 fungi::IOBaseStream&
 operator<<(fungi::IOBaseStream& stream, const CommandData<AddEntries>& data);
 
+// Like the above, but does not wait for the acknowledgement, which has to be
+// picked up with checkStreamOK before anything else is read from the stream.
+fungi::IOBaseStream&
+sendAddEntries(fungi::IOBaseStream& stream, const CommandData<AddEntries>& data);
+
 
 fungi::IOBaseStream&
 operator>>(fungi::IOBaseStream& stream, CommandData<AddEntries>& data);
@@ -25,8 +25,16 @@ namespace volumedriver
 #define LOCK()                                          \
     boost::lock_guard<decltype(mutex_)> lg__(mutex_)
 
+// Lock and wait for all queued entries to be sent and acknowledged.
+#define LOCK_DRAINED()                                  \
+    boost::unique_lock<decltype(mutex_)> ul__(mutex_);  \
+    drain_(ul__)
+
 FailOverCacheSyncBridge::FailOverCacheSyncBridge(const size_t max_entries)
     : FailOverCacheClientInterface(max_entries)
+    , sending_(false)
+    , tickets_issued_(0)
+    , tickets_done_(0)
 {}
 
 void
@@ -53,7 +61,7 @@ FailOverCacheSyncBridge::backup()
 void
 FailOverCacheSyncBridge::newCache(std::unique_ptr<FailOverCacheProxy> cache)
 {
-    LOCK();
+    LOCK_DRAINED();
 
     if(cache_)
     {
@@ -67,14 +75,14 @@ FailOverCacheSyncBridge::newCache(std::unique_ptr<FailOverCacheProxy> cache)
 void
 FailOverCacheSyncBridge::destroy(SyncFailOverToBackend /*sync*/)
 {
-    LOCK();
+    LOCK_DRAINED();
     cache_ = nullptr;
 }
 
 void
 FailOverCacheSyncBridge::setRequestTimeout(const boost::chrono::seconds seconds)
 {
-    LOCK();
+    LOCK_DRAINED();
 
     if(cache_)
     {
@@ -92,7 +100,7 @@ FailOverCacheSyncBridge::setRequestTimeout(const boost::chrono::seconds seconds)
 void
 FailOverCacheSyncBridge::setBusyLoopDuration(const boost::chrono::microseconds usecs)
 {
-    LOCK();
+    LOCK_DRAINED();
 
     if(cache_)
     {
@@ -112,42 +120,172 @@ FailOverCacheSyncBridge::addEntries(const std::vector<ClusterLocation>& locs,
                                     size_t num_locs,
                                     uint64_t start_address,
                                     const uint8_t* data)
+{
+    uint64_t ticket = 0;
+    const bool res = sendEntries(locs,
+                                 num_locs,
+                                 start_address,
+                                 data,
+                                 ticket);
+    VERIFY(res);
+
+    waitForEntries(ticket);
+    return true;
+}
+
+bool
+FailOverCacheSyncBridge::sendEntries(const std::vector<ClusterLocation>& locs,
+                                     size_t num_locs,
+                                     uint64_t start_address,
+                                     const uint8_t* data,
+                                     uint64_t& ticket)
 {
     LOCK();
 
-    if(cache_)
+    ticket = 0;
+
+    if(cache_ and num_locs > 0)
     {
         const size_t cluster_size =
             static_cast<size_t>(cache_->lba_size()) *
             static_cast<size_t>(cache_->cluster_multiplier());
 
-        std::vector<FailOverCacheEntry> entries;
-        entries.reserve(num_locs);
-        uint64_t lba = start_address;
-        for (size_t i = 0; i < num_locs; i++)
+        // Group commit: piggyback on the last queued batch if it's for the
+        // same SCO and not too large yet.
+        if (pending_.empty() or
+            pending_.back().entries.back().cli_.sco() != locs[0].sco() or
+            pending_.back().entries.size() + num_locs > max_entries())
         {
-            entries.emplace_back(locs[i],
-                                 lba, data + i * cluster_size,
-                                 cluster_size);
+            pending_.emplace_back(Batch());
+            pending_.back().entries.reserve(num_locs);
+        }
 
-            lba += cache_->cluster_multiplier();
+        Batch& batch = pending_.back();
+        const size_t queued = batch.entries.size();
+
+        // Entries without a ticket would be sent on behalf of later writers
+        // after our caller's data went away.
+        try
+        {
+            uint64_t lba = start_address;
+            for (size_t i = 0; i < num_locs; i++)
+            {
+                batch.entries.emplace_back(locs[i],
+                                           lba, data + i * cluster_size,
+                                           cluster_size);
+
+                lba += cache_->cluster_multiplier();
+            }
         }
+        catch (...)
+        {
+            batch.entries.erase(batch.entries.begin() + queued,
+                                batch.entries.end());
+            if (queued == 0)
+            {
+                pending_.pop_back();
+            }
+            throw;
+        }
+
+        ticket = ++tickets_issued_;
+        batch.last_ticket = ticket;
+    }
+
+    return true;
+}
+
+void
+FailOverCacheSyncBridge::waitForEntries(uint64_t ticket)
+{
+    boost::unique_lock<decltype(mutex_)> u(mutex_);
+
+    while (tickets_done_ < ticket)
+    {
+        if (sending_)
+        {
+            cond_.wait(u);
+        }
+        else
+        {
+            // our entries are still queued - send them along with the
+            // other queued ones
+            send_pending_(u);
+        }
+    }
+}
+
+void
+FailOverCacheSyncBridge::send_pending_(boost::unique_lock<boost::mutex>& u)
+{
+    ASSERT(u.owns_lock());
+    VERIFY(not sending_);
+
+    if (pending_.empty())
+    {
+        return;
+    }
+
+    std::vector<Batch> batches;
+    std::swap(batches,
+              pending_);
+
+    const uint64_t last_ticket = batches.back().last_ticket;
+
+    if (cache_)
+    {
+        sending_ = true;
+        u.unlock();
+
+        // keep all batches in flight before collecting the acknowledgements
         try
         {
-            cache_->addEntries(std::move(entries));
+            for (auto& b : batches)
+            {
+                cache_->sendAddEntries(std::move(b.entries));
+            }
+
+            for (size_t i = 0; i < batches.size(); ++i)
+            {
+                cache_->checkAddEntries();
+            }
+
+            u.lock();
         }
         catch (std::exception& e)
         {
+            u.lock();
             handleException(e, "addEntries");
         }
+
+        sending_ = false;
+    }
+
+    // With the DTL gone (degraded) there's no point in holding up the writers.
+    tickets_done_ = last_ticket;
+    cond_.notify_all();
+}
+
+void
+FailOverCacheSyncBridge::drain_(boost::unique_lock<boost::mutex>& u)
+{
+    while (sending_ or not pending_.empty())
+    {
+        if (sending_)
+        {
+            cond_.wait(u);
+        }
+        else
+        {
+            send_pending_(u);
+        }
     }
-    return true;
 }
 
 void
 FailOverCacheSyncBridge::Flush()
 {
-    LOCK();
+    LOCK_DRAINED();
 
     if(cache_)
     {
@@ -165,7 +303,7 @@ FailOverCacheSyncBridge::Flush()
 void
 FailOverCacheSyncBridge::removeUpTo(const SCO& sconame)
 {
-    LOCK();
+    LOCK_DRAINED();
 
     if(cache_)
     {
@@ -183,7 +321,7 @@ FailOverCacheSyncBridge::removeUpTo(const SCO& sconame)
 void
 FailOverCacheSyncBridge::Clear()
 {
-    LOCK();
+    LOCK_DRAINED();
 
     if(cache_)
     {
@@ -202,7 +340,7 @@ uint64_t
 FailOverCacheSyncBridge::getSCOFromFailOver(SCO sconame,
                                             SCOProcessorFun processor)
 {
-    LOCK();
+    LOCK_DRAINED();
 
     if (cache_)
     {
@@ -22,6 +22,11 @@
 #include "FailOverCacheClientInterface.h"
 #include "SCO.h"
 
+#include <vector>
+
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+
 #include <youtils/FileDescriptor.h>
 #include <youtils/IOException.h>
 
@@ -30,6 +35,11 @@ namespace volumedriver
 
 class FailOverCacheTester;
 
+// Writes are acknowledged only once the DTL acknowledged them. Concurrent
+// writers are grouped: entries are queued by sendEntries, and the first writer
+// to wait for its acknowledgement sends all queued entries (coalescing
+// consecutive ones of the same SCO into one AddEntries request) before
+// collecting the acknowledgements, while the others wait for it to do so.
 class FailOverCacheSyncBridge
     : public FailOverCacheClientInterface
 {
@@ -60,6 +70,16 @@ public:
                uint64_t start_address,
                const uint8_t* data) override;
 
+    virtual bool
+    sendEntries(const std::vector<ClusterLocation>& locs,
+                size_t num_locs,
+                uint64_t start_address,
+                const uint8_t* data,
+                uint64_t& ticket) override;
+
+    virtual void
+    waitForEntries(uint64_t ticket) override;
+
     virtual bool
     backup() override;
 
@@ -91,10 +111,30 @@ public:
 private:
     DECLARE_LOGGER("FailOverCacheSyncBridge");
 
+    struct Batch
+    {
+        std::vector<FailOverCacheEntry> entries;
+        uint64_t last_ticket;
+    };
+
     boost::mutex mutex_;
+    boost::condition_variable cond_;
     std::unique_ptr<FailOverCacheProxy> cache_;
     DegradedFun degraded_fun_;
 
+    // protected by mutex_; cache_ must not be touched by anyone but the sender
+    // while sending_ is set.
+    std::vector<Batch> pending_;
+    bool sending_;
+    uint64_t tickets_issued_;
+    uint64_t tickets_done_;
+
+    void
+    send_pending_(boost::unique_lock<boost::mutex>&);
+
+    void
+    drain_(boost::unique_lock<boost::mutex>&);
+
     void
     handleException(std::exception& e,
                     const char* where);
@@ -0,0 +1,389 @@
+// Copyright (C) 2016 iNuron NV
+//
+// This file is part of Open vStorage Open Source Edition (OSE),
+// as available from
+//
+//      http://www.openvstorage.org and
+//      http://www.openvstorage.com.
+//
+// This file is free software; you can redistribute it and/or modify it
+// under the terms of the GNU Affero General Public License v3 (GNU AGPLv3)
+// as published by the Free Software Foundation, in version 3 as it comes in
+// the LICENSE.txt file of the Open vStorage OSE distribution.
+// Open vStorage is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY of any kind.
+
+#ifndef VD_LATENCY_HISTOGRAM_H_
+#define VD_LATENCY_HISTOGRAM_H_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <map>
+
+#include <boost/serialization/map.hpp>
+#include <boost/serialization/nvp.hpp>
+#include <boost/serialization/split_member.hpp>
+#include <boost/serialization/version.hpp>
+
+namespace volumedriver
+{
+
+// Lock-free latency histogram with HDR style log-linear buckets: values below
+// 2^sub_bucket_bits are counted exactly, larger ones go to one of
+// 2^sub_bucket_bits linear sub-buckets per power of two, i.e. the relative
+// error is below 1 / 2^sub_bucket_bits. Values that don't fit into
+// max_value_bits end up in the last bucket.
+//
+// Recorders update one of a few shards (picked per thread) with relaxed
+// atomics so concurrent recorders hardly ever share a cacheline. Copies,
+// operator+= and serialization aggregate the shards, so these are the
+// (comparatively expensive) on-demand operations.
+class LatencyHistogram
+{
+public:
+    static constexpr unsigned sub_bucket_bits = 3;
+    static constexpr unsigned max_value_bits = 32;
+    static constexpr size_t sub_buckets = 1ULL << sub_bucket_bits;
+    static constexpr size_t num_buckets =
+        sub_buckets + (max_value_bits - sub_bucket_bits) * sub_buckets;
+    static constexpr size_t num_shards = 4;
+
+    LatencyHistogram()
+    {
+        reset();
+    }
+
+    ~LatencyHistogram() = default;
+
+    LatencyHistogram(const LatencyHistogram& other)
+    {
+        reset();
+        add_(other);
+    }
+
+    LatencyHistogram&
+    operator=(const LatencyHistogram& other)
+    {
+        if (this != &other)
+        {
+            const LatencyHistogram tmp(other);
+            reset();
+            add_(tmp);
+        }
+
+        return *this;
+    }
+
+    LatencyHistogram&
+    operator+=(const LatencyHistogram& other)
+    {
+        if (this == &other)
+        {
+            const LatencyHistogram tmp(other);
+            add_(tmp);
+        }
+        else
+        {
+            add_(other);
+        }
+
+        return *this;
+    }
+
+    bool
+    operator==(const LatencyHistogram& other) const
+    {
+        return
+            sum() == other.sum() and
+            max() == other.max() and
+            distribution() == other.distribution();
+    }
+
+    bool
+    operator!=(const LatencyHistogram& other) const
+    {
+        return not operator==(other);
+    }
+
+    void
+    record(uint64_t val)
+    {
+        Shard& s = shards_[shard_index_()];
+
+        s.buckets[bucket_index(val)].fetch_add(1,
+                                               std::memory_order_relaxed);
+        s.sum.fetch_add(val,
+                        std::memory_order_relaxed);
+        update_max_(s, val);
+    }
+
+    void
+    reset()
+    {
+        for (auto& s : shards_)
+        {
+            for (auto& b : s.buckets)
+            {
+                b.store(0, std::memory_order_relaxed);
+            }
+
+            s.sum.store(0, std::memory_order_relaxed);
+            s.max.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    uint64_t
+    events() const
+    {
+        uint64_t n = 0;
+
+        for (const auto& s : shards_)
+        {
+            for (const auto& b : s.buckets)
+            {
+                n += b.load(std::memory_order_relaxed);
+            }
+        }
+
+        return n;
+    }
+
+    uint64_t
+    sum() const
+    {
+        uint64_t n = 0;
+
+        for (const auto& s : shards_)
+        {
+            n += s.sum.load(std::memory_order_relaxed);
+        }
+
+        return n;
+    }
+
+    uint64_t
+    max() const
+    {
+        uint64_t m = 0;
+
+        for (const auto& s : shards_)
+        {
+            m = std::max(m,
+                         s.max.load(std::memory_order_relaxed));
+        }
+
+        return m;
+    }
+
+    // lower bound of a bucket -> number of events, empty buckets are omitted
+    std::map<uint64_t, uint64_t>
+    distribution() const
+    {
+        std::map<uint64_t, uint64_t> m;
+
+        for (size_t i = 0; i < num_buckets; ++i)
+        {
+            uint64_t n = 0;
+            for (const auto& s : shards_)
+            {
+                n += s.buckets[i].load(std::memory_order_relaxed);
+            }
+
+            if (n)
+            {
+                m[bucket_lower_bound(i)] = n;
+            }
+        }
+
+        return m;
+    }
+
+    // Highest value that is equivalent to the one at the given percentile
+    // (0 < p <= 100), 0 if no events were recorded.
+    uint64_t
+    percentile(double p) const
+    {
+        const auto dist(distribution());
+
+        uint64_t total = 0;
+        for (const auto& d : dist)
+        {
+            total += d.second;
+        }
+
+        if (total == 0)
+        {
+            return 0;
+        }
+
+        const double rank = std::min<double>(std::max<double>(p, 0), 100) * total / 100;
+        uint64_t n = 0;
+
+        for (const auto& d : dist)
+        {
+            n += d.second;
+            if (n >= rank)
+            {
+                return std::min(bucket_upper_bound(bucket_index(d.first)) - 1,
+                                max());
+            }
+        }
+
+        return max();
+    }
+
+    static size_t
+    bucket_index(uint64_t val)
+    {
+        if (val < sub_buckets)
+        {
+            return val;
+        }
+
+        const unsigned e = 63 - __builtin_clzll(val);
+        if (e >= max_value_bits)
+        {
+            return num_buckets - 1;
+        }
+
+        return
+            (e - sub_bucket_bits + 1) * sub_buckets +
+            ((val >> (e - sub_bucket_bits)) - sub_buckets);
+    }
+
+    static uint64_t
+    bucket_lower_bound(size_t idx)
+    {
+        if (idx < sub_buckets)
+        {
+            return idx;
+        }
+
+        const size_t group = idx / sub_buckets;
+        return (sub_buckets + idx % sub_buckets) << (group - 1);
+    }
+
+    static uint64_t
+    bucket_upper_bound(size_t idx)
+    {
+        if (idx < sub_buckets)
+        {
+            return idx + 1;
+        }
+
+        const size_t group = idx / sub_buckets;
+        return bucket_lower_bound(idx) + (1ULL << (group - 1));
+    }
+
+private:
+    struct Shard
+    {
+        std::array<std::atomic<uint64_t>, num_buckets> buckets;
+        std::atomic<uint64_t> sum;
+        std::atomic<uint64_t> max;
+        // keeps the hot counters of neighbouring shards off each other's
+        // cachelines
+        char pad[64];
+    };
+
+    std::array<Shard, num_shards> shards_;
+
+    static size_t
+    shard_index_()
+    {
+        static std::atomic<size_t> next(0);
+        static thread_local const size_t idx =
+            next.fetch_add(1, std::memory_order_relaxed) % num_shards;
+        return idx;
+    }
+
+    static void
+    update_max_(Shard& s,
+                uint64_t val)
+    {
+        uint64_t m = s.max.load(std::memory_order_relaxed);
+        while (m < val and
+               not s.max.compare_exchange_weak(m,
+                                               val,
+                                               std::memory_order_relaxed))
+        {}
+    }
+
+    void
+    add_(const LatencyHistogram& other)
+    {
+        Shard& s = shards_[0];
+
+        for (const auto& o : other.shards_)
+        {
+            for (size_t i = 0; i < num_buckets; ++i)
+            {
+                s.buckets[i].fetch_add(o.buckets[i].load(std::memory_order_relaxed),
+                                       std::memory_order_relaxed);
+            }
+
+            s.sum.fetch_add(o.sum.load(std::memory_order_relaxed),
+                            std::memory_order_relaxed);
+            update_max_(s,
+                        o.max.load(std::memory_order_relaxed));
+        }
+    }
+
+    friend class boost::serialization::access;
+
+    BOOST_SERIALIZATION_SPLIT_MEMBER();
+
+    template<typename Archive>
+    void
+    load(Archive& ar,
+         const unsigned /* version */)
+    {
+        reset();
+
+        uint64_t s = 0;
+        uint64_t m = 0;
+        std::map<uint64_t, uint64_t> dist;
+
+        ar & boost::serialization::make_nvp("sum",
+                                            s);
+        ar & boost::serialization::make_nvp("max",
+                                            m);
+        ar & boost::serialization::make_nvp("distribution",
+                                            dist);
+
+        Shard& shard = shards_[0];
+
+        for (const auto& d : dist)
+        {
+            shard.buckets[bucket_index(d.first)].fetch_add(d.second,
+                                                           std::memory_order_relaxed);
+        }
+
+        shard.sum.store(s, std::memory_order_relaxed);
+        shard.max.store(m, std::memory_order_relaxed);
+    }
+
+    template<typename Archive>
+    void
+    save(Archive& ar,
+         const unsigned /* version */) const
+    {
+        const uint64_t s = sum();
+        const uint64_t m = max();
+        const std::map<uint64_t, uint64_t> dist(distribution());
+
+        ar & boost::serialization::make_nvp("sum",
+                                            s);
+        ar & boost::serialization::make_nvp("max",
+                                            m);
+        ar & boost::serialization::make_nvp("distribution",
+                                            dist);
+    }
+};
+
+}
+
+BOOST_CLASS_VERSION(volumedriver::LatencyHistogram, 0);
+
+#endif // !VD_LATENCY_HISTOGRAM_H_
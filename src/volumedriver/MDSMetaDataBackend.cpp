@@ -190,6 +190,36 @@ MDSMetaDataBackend::getPage(CachePage& p)
     }
 }
 
+void
+MDSMetaDataBackend::getPages(const std::vector<CachePage*>& pages)
+{
+    LOG_TRACE(table_->nspace() << ": " << pages.size() << " pages");
+
+    mds::TableInterface::Keys keys;
+    keys.reserve(pages.size());
+
+    for (const CachePage* p : pages)
+    {
+        keys.emplace_back(mds::Key(p->page_address()));
+    }
+
+    const mds::TableInterface::MaybeStrings ms(table_->multiget(keys));
+    VERIFY(ms.size() == pages.size());
+
+    for (size_t i = 0; i < pages.size(); ++i)
+    {
+        if (ms[i] != boost::none)
+        {
+            VERIFY(ms[i]->size() == CachePage::size());
+            memcpy(pages[i]->data(), ms[i]->data(), ms[i]->size());
+        }
+        else
+        {
+            pages[i]->reset();
+        }
+    }
+}
+
 void
 MDSMetaDataBackend::putPage(const CachePage& p,
                             int32_t used_clusters_delta)
@@ -278,6 +308,12 @@ MDSMetaDataBackend::setCork(const yt::UUID& cork_id)
                      *owner_tag_);
 }
 
+const std::string&
+MDSMetaDataBackend::cork_record_key()
+{
+    return cork_key;
+}
+
 boost::optional<yt::UUID>
 MDSMetaDataBackend::lastCorkUUID()
 {
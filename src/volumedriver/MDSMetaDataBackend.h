@@ -70,6 +70,16 @@ public:
     bool
     getPage(CachePage& p) override final;
 
+    void
+    getPages(const std::vector<CachePage*>& pages) override final;
+
+    // the table serializes requests itself
+    bool
+    concurrent_reads() const override final
+    {
+        return true;
+    }
+
     void
     putPage(const CachePage& p,
             int32_t used_clusters_delta) override final;
@@ -148,6 +158,11 @@ public:
         return 0;
     }
 
+    // The key of the record holding the cork: the MDS uses it to find the points
+    // in a master's stream of updates where a slave can (re)join it.
+    static const std::string&
+    cork_record_key();
+
     void
     set_master()
     {
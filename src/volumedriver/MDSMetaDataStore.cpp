@@ -51,7 +51,8 @@ MDSMetaDataStore::MDSMetaDataStore(const MDSMetaDataBackendConfig& cfg,
                                    const fs::path& home,
                                    const OwnerTag owner_tag,
                                    uint64_t num_pages_cached,
-                                   DefaultMaxTLogsBehindFun default_max_tlogs_behind_fun)
+                                   DefaultMaxTLogsBehindFun default_max_tlogs_behind_fun,
+                                   PushToSlavesFun push_to_slaves_fun)
     : VolumeBackPointer(getLogger__())
     , rwlock_("mdsmdstore-" + bi->getNS().str())
     , bi_(std::move(bi))
@@ -60,6 +61,7 @@ MDSMetaDataStore::MDSMetaDataStore(const MDSMetaDataBackendConfig& cfg,
     , timeout_(cfg.timeout())
     , max_tlogs_behind_(cfg.max_tlogs_behind())
     , default_max_tlogs_behind_fun_(std::move(default_max_tlogs_behind_fun))
+    , push_to_slaves_fun_(std::move(push_to_slaves_fun))
     , num_pages_cached_(num_pages_cached)
     , home_(home)
     , owner_tag_(owner_tag)
@@ -99,6 +101,8 @@ MDSMetaDataStore::MDSMetaDataStore(const MDSMetaDataBackendConfig& cfg,
                       node_configs_[0] << ": " << EWHAT);
             mdstore_ = do_failover_(true);
         });
+
+    register_slaves_();
 }
 
 void
@@ -201,6 +205,8 @@ MDSMetaDataStore::failover_(MetaDataStorePtr& md,
         mdstore_->drop_cache_including_dirty_pages();
         mdstore_ = md;
 
+        register_slaves_();
+
         try
         {
             getVolume()->metaDataBackendConfigHasChanged(get_config_());
@@ -421,6 +427,21 @@ MDSMetaDataStore::readCluster(const ClusterAddress addr,
                                      loc);
 }
 
+void
+MDSMetaDataStore::readClusters(const ClusterAddress start,
+                               const size_t count,
+                               std::vector<ClusterLocationAndHash>& locs)
+{
+    handle_<void,
+            ClusterAddress,
+            size_t,
+            std::vector<ClusterLocationAndHash>&>(__FUNCTION__,
+                                                  &MetaDataStoreInterface::readClusters,
+                                                  start,
+                                                  count,
+                                                  locs);
+}
+
 void
 MDSMetaDataStore::writeCluster(const ClusterAddress addr,
                                const ClusterLocationAndHash& loc)
@@ -433,6 +454,21 @@ MDSMetaDataStore::writeCluster(const ClusterAddress addr,
                            loc);
 }
 
+void
+MDSMetaDataStore::writeClusters(const ClusterAddress* addrs,
+                                const ClusterLocationAndHash* locs,
+                                const size_t count)
+{
+    handle_<void,
+            const ClusterAddress*,
+            const ClusterLocationAndHash*,
+            size_t>(__FUNCTION__,
+                    &MetaDataStoreInterface::writeClusters,
+                    addrs,
+                    locs,
+                    count);
+}
+
 void
 MDSMetaDataStore::clear_all_keys()
 {
@@ -670,6 +706,8 @@ MDSMetaDataStore::set_config(const MDSMetaDataBackendConfig& cfg)
     timeout_ = cfg.timeout();
     max_tlogs_behind_ = cfg.max_tlogs_behind();
 
+    register_slaves_();
+
 #ifndef NDEBUG
     LOG_INFO(bi_->getNS() << ": active config: ");
     LOG_INFO("\tapply scrub results to slaves: " << cfg.apply_relocations_to_slaves());
@@ -681,6 +719,34 @@ MDSMetaDataStore::set_config(const MDSMetaDataBackendConfig& cfg)
 #endif
 }
 
+void
+MDSMetaDataStore::register_slaves_() const
+{
+    if (not push_to_slaves_fun_())
+    {
+        return;
+    }
+
+    VERIFY(not node_configs_.empty());
+
+    const MDSNodeConfigs slaves(node_configs_.begin() + 1,
+                                node_configs_.end());
+
+    LOG_INFO(bi_->getNS() << ": asking " << node_configs_[0] << " to push updates to " <<
+             slaves.size() << " slaves");
+
+    try
+    {
+        auto client(mds::ClientNG::create(node_configs_[0]));
+        client->timeout(timeout_);
+        client->open(bi_->getNS().str())->set_slaves(slaves,
+                                                     owner_tag_);
+    }
+    CATCH_STD_ALL_LOG_IGNORE(bi_->getNS() << ": failed to register slaves with " <<
+                             node_configs_[0] <<
+                             " - they will keep catching up from the backend");
+}
+
 MDSMetaDataBackendConfig
 MDSMetaDataStore::get_config() const
 {
@@ -48,13 +48,15 @@ public:
                    MetaDataStoreException);
 
     using DefaultMaxTLogsBehindFun = std::function<boost::optional<uint32_t>()>;
+    using PushToSlavesFun = std::function<bool()>;
 
     MDSMetaDataStore(const MDSMetaDataBackendConfig&,
                      backend::BackendInterfacePtr,
                      const boost::filesystem::path& home,
                      const OwnerTag,
                      uint64_t num_pages_cached,
-                     DefaultMaxTLogsBehindFun = []() -> boost::optional<uint32_t> { return boost::none; });
+                     DefaultMaxTLogsBehindFun = []() -> boost::optional<uint32_t> { return boost::none; },
+                     PushToSlavesFun = []() -> bool { return false; });
 
     ~MDSMetaDataStore() = default;
 
@@ -70,6 +72,16 @@ public:
     readCluster(const ClusterAddress addr,
                 ClusterLocationAndHash& loc) override;
 
+    virtual void
+    readClusters(const ClusterAddress start,
+                 const size_t count,
+                 std::vector<ClusterLocationAndHash>& locs) override;
+
+    virtual void
+    writeClusters(const ClusterAddress* addrs,
+                  const ClusterLocationAndHash* locs,
+                  const size_t count) override;
+
     virtual void
     writeCluster(const ClusterAddress addr,
                  const ClusterLocationAndHash& loc) override;
@@ -174,6 +186,7 @@ private:
     std::chrono::seconds timeout_;
     boost::optional<uint32_t> max_tlogs_behind_;
     DefaultMaxTLogsBehindFun default_max_tlogs_behind_fun_;
+    PushToSlavesFun push_to_slaves_fun_;
 
     const uint64_t num_pages_cached_;
     const boost::filesystem::path home_;
@@ -220,6 +233,11 @@ private:
 
     void
     check_config_(const MDSMetaDataBackendConfig&);
+
+    // Ask the current master to stream its updates to the other nodes, if
+    // configured to do so.
+    void
+    register_slaves_() const;
 };
 
 }
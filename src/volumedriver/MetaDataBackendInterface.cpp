@@ -14,3 +14,25 @@
 // but WITHOUT ANY WARRANTY of any kind.
 
 #include "MetaDataBackendInterface.h"
+#include "CachedMetaDataPage.h"
+
+namespace volumedriver
+{
+
+void
+MetaDataBackendInterface::getPages(const std::vector<CachePage*>& pages)
+{
+    for (CachePage* p : pages)
+    {
+        if (not getPage(*p))
+        {
+            p->reset();
+        }
+    }
+}
+
+}
+
+// Local Variables: **
+// mode: c++ **
+// End: **
@@ -41,6 +41,19 @@ public:
     virtual bool
     getPage(CachePage& p) = 0;
 
+    // Fetch several pages in one go; pages that don't exist in the backend
+    // are reset. The default implementation falls back to getPage.
+    virtual void
+    getPages(const std::vector<CachePage*>& pages);
+
+    // Whether getPage(s) can be invoked concurrently with each other and
+    // with the remaining members.
+    virtual bool
+    concurrent_reads() const
+    {
+        return false;
+    }
+
     virtual bool
     isEmancipated() const = 0;
 
@@ -14,3 +14,39 @@
 // but WITHOUT ANY WARRANTY of any kind.
 
 #include "MetaDataStoreInterface.h"
+#include "ClusterLocationAndHash.h"
+
+namespace volumedriver
+{
+
+void
+MetaDataStoreInterface::readClusters(const ClusterAddress start,
+                                     const size_t count,
+                                     std::vector<ClusterLocationAndHash>& locs)
+{
+    locs.resize(count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        readCluster(start + i,
+                    locs[i]);
+    }
+}
+
+void
+MetaDataStoreInterface::writeClusters(const ClusterAddress* addrs,
+                                      const ClusterLocationAndHash* locs,
+                                      const size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        writeCluster(addrs[i],
+                     locs[i]);
+    }
+}
+
+}
+
+// Local Variables: **
+// mode: c++ **
+// End: **
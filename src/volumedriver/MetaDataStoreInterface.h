@@ -68,10 +68,25 @@ public:
     readCluster(const ClusterAddress addr,
                 ClusterLocationAndHash& loc) = 0;
 
+    // Look up `count' consecutive clusters starting at `start'; `locs' is
+    // resized accordingly. The default implementation calls readCluster for
+    // each of them.
+    virtual void
+    readClusters(const ClusterAddress start,
+                 const size_t count,
+                 std::vector<ClusterLocationAndHash>& locs);
+
     virtual void
     writeCluster(const ClusterAddress addr,
                  const ClusterLocationAndHash& loc) = 0;
 
+    // Write `count' entries, `addrs' and `locs' being of that size. The
+    // default implementation calls writeCluster for each of them.
+    virtual void
+    writeClusters(const ClusterAddress* addrs,
+                  const ClusterLocationAndHash* locs,
+                  const size_t count);
+
     virtual void
     clear_all_keys() = 0;
 
@@ -34,6 +34,8 @@ struct MetaDataStoreStats
         , used_clusters(0)
         , max_pages(0)
         , cached_pages(0)
+        , cork_lookups(0)
+        , cork_lookup_depth(0)
     {}
 
     uint64_t cache_hits;
@@ -41,6 +43,10 @@ struct MetaDataStoreStats
     uint64_t used_clusters;
     uint32_t max_pages;
     uint32_t cached_pages;
+    // lookups that went through the corks and the sum of the number of corks
+    // they probed - cork_lookup_depth / cork_lookups is the average depth.
+    uint64_t cork_lookups;
+    uint64_t cork_lookup_depth;
     // contains also discarded clusters!
     std::vector< std::pair<youtils::UUID, uint64_t> > corked_clusters;
 };
@@ -15,14 +15,79 @@
 
 #include "MountPointConfig.h"
 
+#include <iostream>
+
+#include <boost/bimap.hpp>
+
+#include <youtils/StreamUtils.h>
+
 namespace volumedriver
 {
 
+namespace yt = youtils;
+
+namespace
+{
+
+void
+reminder(MountPointIoMode) __attribute__((unused));
+
+void
+reminder(MountPointIoMode m)
+{
+    switch (m)
+    {
+    case MountPointIoMode::Buffered:
+    case MountPointIoMode::DirectAsync:
+        // If the compiler yells at you that you've forgotten dealing with an enum
+        // value here chances are that it's also missing from the translations map
+        // below. If so add it NOW.
+        break;
+    }
+}
+
+using TranslationsMap = boost::bimap<MountPointIoMode, std::string>;
+
+TranslationsMap
+init_translations()
+{
+    const std::vector<TranslationsMap::value_type> initv{
+        { MountPointIoMode::Buffered, "Buffered" },
+        { MountPointIoMode::DirectAsync, "DirectAsync" },
+    };
+
+    return TranslationsMap(initv.begin(),
+                           initv.end());
+}
+
+}
+
+std::ostream&
+operator<<(std::ostream& os,
+           const MountPointIoMode m)
+{
+    static const TranslationsMap translations(init_translations());
+    return yt::StreamUtils::stream_out(translations.left,
+                                       os,
+                                       m);
+}
+
+std::istream&
+operator>>(std::istream& is,
+           MountPointIoMode& m)
+{
+    static const TranslationsMap translations(init_translations());
+    return yt::StreamUtils::stream_in(translations.right,
+                                      is,
+                                      m);
+}
+
 bool
 MountPointConfig::operator==(const MountPointConfig& other) const
 {
     return path == other.path and
-        size == other.size;
+        size == other.size and
+        io_mode == other.io_mode;
 }
 
 bool
@@ -35,7 +100,7 @@ std::ostream&
 operator<<(std::ostream& os,
            const MountPointConfig& cfg)
 {
-    return os << "(" << cfg.path << ", " << cfg.size << ")";
+    return os << "(" << cfg.path << ", " << cfg.size << ", " << cfg.io_mode << ")";
 }
 
 std::ostream&
@@ -78,4 +143,7 @@ PropertyTreeVectorAccessor<vd::MountPointConfig>::path_key("path");
 const std::string
 PropertyTreeVectorAccessor<vd::MountPointConfig>::size_key("size");
 
+const std::string
+PropertyTreeVectorAccessor<vd::MountPointConfig>::io_mode_key("io_mode");
+
 }
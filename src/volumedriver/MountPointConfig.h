@@ -26,15 +26,37 @@
 namespace volumedriver
 {
 
+// How the data on a mountpoint is accessed. Only honoured by the ClusterCache,
+// the SCOCache ignores it.
+enum class MountPointIoMode
+{
+    // pread / pwrite through the page cache
+    Buffered,
+    // O_DIRECT, with batches of reads submitted asynchronously and cache fills
+    // written in the background
+    DirectAsync,
+};
+
+std::ostream&
+operator<<(std::ostream&,
+           const MountPointIoMode);
+
+std::istream&
+operator>>(std::istream&,
+           MountPointIoMode&);
+
 struct MountPointConfig
 {
     boost::filesystem::path path;
     uint64_t size;
+    MountPointIoMode io_mode;
 
     MountPointConfig(const boost::filesystem::path& p,
-                     uint64_t s)
+                     uint64_t s,
+                     MountPointIoMode m = MountPointIoMode::Buffered)
         : path(p)
         , size(s)
+        , io_mode(m)
     {}
 
     ~MountPointConfig() = default;
@@ -70,6 +92,7 @@ struct PropertyTreeVectorAccessor<volumedriver::MountPointConfig>
 {
     static const std::string path_key;
     static const std::string size_key;
+    static const std::string io_mode_key;
 
     // don't use fs::path here, as that leads to something like
     // "some_path": "\"\/foo\/bar\"" in the JSON output, but we do want the JSON
@@ -79,8 +102,11 @@ struct PropertyTreeVectorAccessor<volumedriver::MountPointConfig>
     {
         boost::filesystem::path p(pt.get<std::string>(path_key));
         youtils::DimensionedValue s(pt.get<youtils::DimensionedValue>(size_key));
+        const volumedriver::MountPointIoMode
+            m(pt.get<volumedriver::MountPointIoMode>(io_mode_key,
+                                                     volumedriver::MountPointIoMode::Buffered));
 
-        return volumedriver::MountPointConfig(p, s.getBytes());
+        return volumedriver::MountPointConfig(p, s.getBytes(), m);
     }
 
     static void
@@ -91,6 +117,13 @@ struct PropertyTreeVectorAccessor<volumedriver::MountPointConfig>
                cfg.path.string());
         pt.put(size_key,
                youtils::DimensionedValue(cfg.size).toString());
+        // only spelt out if it differs from the default to keep existing
+        // configs (and the SCOCache's) unchanged
+        if (cfg.io_mode != volumedriver::MountPointIoMode::Buffered)
+        {
+            pt.put(io_mode_key,
+                   cfg.io_mode);
+        }
     }
 };
 
@@ -14,6 +14,7 @@
 // but WITHOUT ANY WARRANTY of any kind.
 
 #include "OneFileTLogReader.h"
+#include "TLogCodec.h"
 #include "TLogWriter.h"
 #include "VolumeDriverError.h"
 
@@ -54,16 +55,23 @@ OneFileTLogReader::OneFileTLogReader(const fs::path& TLogPath,
 
         unlinkOnDestruction_ = true;
     }
-    setFileSize_(tmp);
 
     try
     {
+        tmp = maybe_decode_(tmp);
+        setFileSize_(tmp);
         file_.reset(new FileDescriptor(tmp, FDMode::Read));
     }
     CATCH_STD_ALL_EWHAT({
+            if (unlinkOnDestruction_)
+            {
+                fs::remove(tmp);
+            }
             VolumeDriverError::report(events::VolumeDriverErrorCode::ReadTLog,
                                       EWHAT,
-                                      VolumeId(bi->getNS().str()));
+                                      bi ?
+                                      boost::make_optional(VolumeId(bi->getNS().str())) :
+                                      boost::none);
             throw;
         });
 }
@@ -73,12 +81,19 @@ OneFileTLogReader::OneFileTLogReader(const fs::path& path)
     , unlinkOnDestruction_(false)
 {
     LOG_TRACE(path);
+    fs::path p(path);
+
     try
     {
-        setFileSize_(path);
-        file_.reset(new FileDescriptor(path,FDMode::Read));
+        p = maybe_decode_(path);
+        setFileSize_(p);
+        file_.reset(new FileDescriptor(p, FDMode::Read));
     }
     CATCH_STD_ALL_EWHAT({
+            if (unlinkOnDestruction_)
+            {
+                fs::remove(p);
+            }
             VolumeDriverError::report(events::VolumeDriverErrorCode::ReadTLog,
                                       EWHAT);
             throw;
@@ -102,6 +117,36 @@ OneFileTLogReader::~OneFileTLogReader()
     }
 }
 
+fs::path
+OneFileTLogReader::maybe_decode_(const fs::path& path)
+{
+    if (not TLogCodec::is_compact(path))
+    {
+        return path;
+    }
+
+    const fs::path raw(FileUtils::create_temp_file(path.parent_path(),
+                                                   path.filename().string() +
+                                                   "_decoded"));
+    try
+    {
+        TLogCodec::decode(path, raw);
+    }
+    catch (...)
+    {
+        fs::remove(raw);
+        throw;
+    }
+
+    if (unlinkOnDestruction_)
+    {
+        fs::remove(path);
+    }
+
+    unlinkOnDestruction_ = true;
+    return raw;
+}
+
 void
 OneFileTLogReader::setFileSize_(const fs::path& path)
 {
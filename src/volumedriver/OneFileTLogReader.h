@@ -49,6 +49,12 @@ private:
 
     void
     setFileSize_(const fs::path& path);
+
+    // TLogs on the backend may be compact encoded (cf. TLogCodec): decode
+    // those into a temporary raw TLog next to them which is removed again on
+    // destruction.
+    fs::path
+    maybe_decode_(const fs::path& path);
 };
 }
 
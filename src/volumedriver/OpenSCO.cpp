@@ -115,6 +115,14 @@ OpenSCO::pread(void* buf, size_t count, off_t off)
     return fd_.pread(buf, count, off);
 }
 
+ssize_t
+OpenSCO::preadv(const struct iovec* iov, int iovcnt, off_t off)
+{
+    checkMountPointOnline_();
+
+    return fd_.preadv(iov, iovcnt, off);
+}
+
 ssize_t
 OpenSCO::pwrite(const void* buf, size_t count, off_t off, uint32_t& throttle_usecs)
 {
@@ -40,6 +40,9 @@ public:
     ssize_t
     pread(void* buf, size_t count, off_t offset);
 
+    ssize_t
+    preadv(const struct iovec* iov, int iovcnt, off_t offset);
+
     ssize_t
     pwrite(const void* buf, size_t count, off_t offset, uint32_t& throttle_usecs);
 
@@ -0,0 +1,159 @@
+// Copyright (C) 2016 iNuron NV
+//
+// This file is part of Open vStorage Open Source Edition (OSE),
+// as available from
+//
+//      http://www.openvstorage.org and
+//      http://www.openvstorage.com.
+//
+// This file is free software; you can redistribute it and/or modify it
+// under the terms of the GNU Affero General Public License v3 (GNU AGPLv3)
+// as published by the Free Software Foundation, in version 3 as it comes in
+// the LICENSE.txt file of the Open vStorage OSE distribution.
+// Open vStorage is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY of any kind.
+
+#include "PartialReadExecutor.h"
+
+#include <algorithm>
+#include <exception>
+
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+
+namespace volumedriver
+{
+
+PartialReadExecutor::PartialReadExecutor(size_t nthreads)
+    : nthreads_(nthreads)
+    , work_(std::make_unique<boost::asio::io_service::work>(io_service_))
+{
+    LOG_INFO("starting " << nthreads_ << " threads");
+
+    for (size_t i = 0; i < nthreads_; ++i)
+    {
+        threads_.create_thread([this]
+                               {
+                                   io_service_.run();
+                               });
+    }
+}
+
+PartialReadExecutor::~PartialReadExecutor()
+{
+    LOG_INFO("stopping " << nthreads_ << " threads");
+
+    work_.reset();
+    threads_.join_all();
+}
+
+// Shared with the pool threads, which might only get to it after run()
+// returned - they then find all jobs claimed and leave it alone.
+struct PartialReadExecutor::Batch
+{
+    explicit Batch(std::vector<Job> js)
+        : jobs(std::move(js))
+    {}
+
+    const std::vector<Job> jobs;
+
+    boost::mutex lock;
+    boost::condition_variable cond;
+    // protected by lock
+    size_t next = 0;
+    size_t running = 0;
+    std::exception_ptr eptr;
+};
+
+void
+PartialReadExecutor::run_jobs_(Batch& batch,
+                               bool helper)
+{
+    while (true)
+    {
+        size_t i;
+
+        {
+            boost::lock_guard<decltype(batch.lock)> g(batch.lock);
+            if (batch.eptr or batch.next == batch.jobs.size())
+            {
+                return;
+            }
+
+            i = batch.next++;
+            if (helper)
+            {
+                ++batch.running;
+            }
+        }
+
+        std::exception_ptr eptr;
+
+        try
+        {
+            batch.jobs[i]();
+        }
+        catch (...)
+        {
+            eptr = std::current_exception();
+        }
+
+        boost::lock_guard<decltype(batch.lock)> g(batch.lock);
+
+        if (eptr and not batch.eptr)
+        {
+            batch.eptr = eptr;
+        }
+
+        if (helper and --batch.running == 0)
+        {
+            batch.cond.notify_all();
+        }
+    }
+}
+
+void
+PartialReadExecutor::run(std::vector<Job> jobs,
+                         size_t max_in_flight)
+{
+    const size_t workers = std::min({ jobs.size(),
+                                      std::max<size_t>(max_in_flight, 1),
+                                      nthreads_ + 1 });
+
+    if (workers <= 1)
+    {
+        for (const auto& job : jobs)
+        {
+            job();
+        }
+        return;
+    }
+
+    auto batch(std::make_shared<Batch>(std::move(jobs)));
+
+    for (size_t i = 1; i < workers; ++i)
+    {
+        io_service_.post([batch]
+                         {
+                             run_jobs_(*batch,
+                                       true);
+                         });
+    }
+
+    run_jobs_(*batch,
+              false);
+
+    boost::unique_lock<decltype(batch->lock)> u(batch->lock);
+    batch->cond.wait(u,
+                     [&]
+                     {
+                         return batch->running == 0;
+                     });
+
+    if (batch->eptr)
+    {
+        std::rethrow_exception(batch->eptr);
+    }
+}
+
+}
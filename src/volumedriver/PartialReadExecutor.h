@@ -0,0 +1,81 @@
+// Copyright (C) 2016 iNuron NV
+//
+// This file is part of Open vStorage Open Source Edition (OSE),
+// as available from
+//
+//      http://www.openvstorage.org and
+//      http://www.openvstorage.com.
+//
+// This file is free software; you can redistribute it and/or modify it
+// under the terms of the GNU Affero General Public License v3 (GNU AGPLv3)
+// as published by the Free Software Foundation, in version 3 as it comes in
+// the LICENSE.txt file of the Open vStorage OSE distribution.
+// Open vStorage is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY of any kind.
+
+#ifndef VD_PARTIAL_READ_EXECUTOR_H_
+#define VD_PARTIAL_READ_EXECUTOR_H_
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <boost/asio/io_service.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <youtils/Logging.h>
+
+namespace volumedriver
+{
+
+// Runs the independent backend partial reads of a single read request
+// concurrently. The calling thread participates in running the jobs and pool
+// threads only help out with the jobs nobody has claimed yet once they get
+// around to it, so a request never waits for pool threads that are busy
+// serving other requests - only for its own jobs that are being run. At most
+// max_in_flight jobs of a request run at the same time.
+class PartialReadExecutor
+{
+public:
+    using Job = std::function<void()>;
+
+    explicit PartialReadExecutor(size_t nthreads);
+
+    ~PartialReadExecutor();
+
+    PartialReadExecutor(const PartialReadExecutor&) = delete;
+
+    PartialReadExecutor&
+    operator=(const PartialReadExecutor&) = delete;
+
+    // Blocks until all jobs have finished. If a job throws, the jobs that
+    // were not started yet are skipped and the first exception is rethrown
+    // once the running ones are done.
+    void
+    run(std::vector<Job> jobs,
+        size_t max_in_flight);
+
+    size_t
+    threads() const
+    {
+        return nthreads_;
+    }
+
+private:
+    DECLARE_LOGGER("PartialReadExecutor");
+
+    struct Batch;
+
+    static void
+    run_jobs_(Batch&,
+              bool helper);
+
+    const size_t nthreads_;
+    boost::asio::io_service io_service_;
+    std::unique_ptr<boost::asio::io_service::work> work_;
+    boost::thread_group threads_;
+};
+
+}
+
+#endif // !VD_PARTIAL_READ_EXECUTOR_H_
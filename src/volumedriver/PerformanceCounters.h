@@ -16,6 +16,7 @@
 #ifndef PERFORMANCE_COUNTERS_H
 #define PERFORMANCE_COUNTERS_H
 
+#include "LatencyHistogram.h"
 #include "PerformanceCountersV1.h"
 
 #include <array>
@@ -455,6 +456,26 @@ struct PerformanceCounters
 
     RequestUSecsCounter sync_request_usecs;
 
+    // SCOs fetched by the read ahead that were subsequently read from (hit)
+    // or dropped without being read from (waste), in bytes
+    RequestSizeCounter read_ahead_hit_size;
+    RequestSizeCounter read_ahead_waste_size;
+
+    // bytes of a write request's payload copied in user space (unaligned
+    // read-modify-write, async DTL, cluster cache)
+    RequestSizeCounter write_copy_size;
+
+    // Latencies (in microseconds) of whole requests and of the stages of the
+    // I/O path, for percentiles.
+    LatencyHistogram read_latency;
+    LatencyHistogram write_latency;
+    LatencyHistogram metadata_lookup_latency;
+    LatencyHistogram cluster_cache_latency;
+    LatencyHistogram sco_read_latency;
+    LatencyHistogram backend_partial_read_latency;
+    LatencyHistogram dtl_send_latency;
+    LatencyHistogram throttle_latency;
+
     PerformanceCounters() = default;
 
     ~PerformanceCounters() = default;
@@ -499,7 +520,18 @@ struct PerformanceCounters
             EQ(unaligned_read_request_size) and
             EQ(backend_read_request_size) and
             EQ(backend_read_request_usecs) and
-            EQ(sync_request_usecs);
+            EQ(sync_request_usecs) and
+            EQ(read_ahead_hit_size) and
+            EQ(read_ahead_waste_size) and
+            EQ(write_copy_size) and
+            EQ(read_latency) and
+            EQ(write_latency) and
+            EQ(metadata_lookup_latency) and
+            EQ(cluster_cache_latency) and
+            EQ(sco_read_latency) and
+            EQ(backend_partial_read_latency) and
+            EQ(dtl_send_latency) and
+            EQ(throttle_latency);
 
 #undef EQ
     }
@@ -527,6 +559,17 @@ struct PerformanceCounters
         ADD(backend_read_request_size);
         ADD(backend_read_request_usecs);
         ADD(sync_request_usecs);
+        ADD(read_ahead_hit_size);
+        ADD(read_ahead_waste_size);
+        ADD(write_copy_size);
+        ADD(read_latency);
+        ADD(write_latency);
+        ADD(metadata_lookup_latency);
+        ADD(cluster_cache_latency);
+        ADD(sco_read_latency);
+        ADD(backend_partial_read_latency);
+        ADD(dtl_send_latency);
+        ADD(throttle_latency);
 
         return *this;
 #undef ADD
@@ -559,12 +602,25 @@ struct PerformanceCounters
         backend_read_request_usecs.reset();
 
         sync_request_usecs.reset();
+
+        read_ahead_hit_size.reset();
+        read_ahead_waste_size.reset();
+        write_copy_size.reset();
+
+        read_latency.reset();
+        write_latency.reset();
+        metadata_lookup_latency.reset();
+        cluster_cache_latency.reset();
+        sco_read_latency.reset();
+        backend_partial_read_latency.reset();
+        dtl_send_latency.reset();
+        throttle_latency.reset();
     }
 
     template<typename Archive>
     void
     serialize(Archive& ar,
-              const unsigned /* version */)
+              const unsigned version)
     {
 #define S(x)                                    \
         ar & BOOST_SERIALIZATION_NVP(x)
@@ -581,6 +637,29 @@ struct PerformanceCounters
         S(backend_read_request_usecs);
         S(sync_request_usecs);
 
+        if (version > 0)
+        {
+            S(read_ahead_hit_size);
+            S(read_ahead_waste_size);
+        }
+
+        if (version > 1)
+        {
+            S(read_latency);
+            S(write_latency);
+            S(metadata_lookup_latency);
+            S(cluster_cache_latency);
+            S(sco_read_latency);
+            S(backend_partial_read_latency);
+            S(dtl_send_latency);
+            S(throttle_latency);
+        }
+
+        if (version > 2)
+        {
+            S(write_copy_size);
+        }
+
 #undef S
     }
 
@@ -615,6 +694,6 @@ struct PerformanceCounters
 
 BOOST_CLASS_VERSION(volumedriver::RequestSizeCounter, 2);
 BOOST_CLASS_VERSION(volumedriver::RequestUSecsCounter, 2);
-BOOST_CLASS_VERSION(volumedriver::PerformanceCounters, 0);
+BOOST_CLASS_VERSION(volumedriver::PerformanceCounters, 3);
 
 #endif // PERFORMANCE_COUNTERS_H
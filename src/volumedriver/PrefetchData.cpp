@@ -17,6 +17,7 @@
 #include "SCOCache.h"
 #include "SCOFetcher.h"
 #include "VolManager.h"
+#include "Volume.h"
 
 #include <youtils/Catchers.h>
 
@@ -25,6 +26,9 @@ namespace volumedriver
 
 PrefetchData::PrefetchData(Volume& v)
     : VolumeBackPointer(getLogger__())
+    , volume_(v)
+    , ahead_begin_(0)
+    , ahead_end_(0)
     , stop_(false)
 {
     setVolume(&v);
@@ -50,7 +54,8 @@ PrefetchData::~PrefetchData()
         {
             boost::lock_guard<boost::mutex> g(mut);
             stop_ = true;
-            clear_();
+            scos.clear();
+            ahead_begin_ = ahead_end_ = 0;
             cond.notify_one();
         }
 
@@ -61,23 +66,39 @@ PrefetchData::~PrefetchData()
 
 void
 PrefetchData::addSCO(SCO a,
-                     float val)
+                     float val,
+                     IsReadAhead read_ahead)
 {
     boost::lock_guard<boost::mutex> g(mut);
 
-    scos.push(std::make_pair(a, val));
+    scos.push(a,
+              val,
+              read_ahead);
     cond.notify_one();
 }
 
 void
-PrefetchData::clear_()
+PrefetchData::readAhead(ClusterAddress begin,
+                        ClusterAddress end)
 {
-    ASSERT_LOCKABLE_LOCKED(mut);
+    boost::lock_guard<boost::mutex> g(mut);
 
-    while (not scos.empty())
+    // Ranges of the same stream are contiguous and are merged; anything else
+    // supersedes a range the thread didn't get to yet.
+    if (ahead_begin_ < ahead_end_ and
+        begin <= ahead_end_ and
+        ahead_begin_ <= end)
+    {
+        ahead_begin_ = std::min(ahead_begin_, begin);
+        ahead_end_ = std::max(ahead_end_, end);
+    }
+    else
     {
-        scos.pop();
+        ahead_begin_ = begin;
+        ahead_end_ = end;
     }
+
+    cond.notify_one();
 }
 
 void
@@ -87,67 +108,74 @@ PrefetchData::run_()
 
     while(true)
     {
-        if(not scos.empty())
-        {
-            SCO sconame;
-            float val;
-            {
-                boost::lock_guard<boost::mutex> g(mut);
-
-                if(scos.empty())
-                {
-                    continue;
-                }
-                sconame = scos.top().first;
-                val = scos.top().second;
-                scos.pop();
-            }
+        PrefetchQueue::Entry e;
+        ClusterAddress ahead_begin = 0;
+        ClusterAddress ahead_end = 0;
 
-            //Volume* vol = getVolume();
-
-            LOG_INFO(getVolume()->getName() << "Prefetching SCO " << sconame << " with SAP " << val);
-
-            ClusterLocation loc(sconame, 0);
-            BackendInterfacePtr bi = getVolume()->getBackendInterface(loc.cloneID())->clone();
-            BackendSCOFetcher fetcher(sconame,
-                                      getVolume(),
-                                      bi->clone(),
-                                      false); // Don't signal an error if we can't get a sco
-            const VolumeConfig cfg(getVolume()->get_config());
-            const uint64_t scoSize = cfg.getSCOSize();
-            bool res =
-                VolManager::get()->getSCOCache()->prefetchSCO(getVolume()->getNamespace(),
-                                                              sconame,
-                                                              scoSize,
-                                                              val,
-                                                              fetcher);
-
-            LOG_INFO(getVolume()->getName() << ": prefetching SCO " << sconame << " done, " <<
-                     (res ? "continuing" : "stopping") << " prefetching");
-
-            if(not res)
-            {
-                boost::lock_guard<boost::mutex> g(mut);
-                clear_();
-            }
-        }
-        else if(not stop_)
         {
             boost::unique_lock<boost::mutex> lock(mut);
-            if(not stop_)
+
+            while (scos.empty() and ahead_begin_ >= ahead_end_ and not stop_)
             {
                 LOG_INFO(getVolume()->getName() << ": no prefetch work, going to sleep");
                 cond.wait(lock);
                 LOG_INFO(getVolume()->getName() << ": waking up");
             }
-            else
+
+            if (stop_)
             {
                 break;
             }
+
+            if (ahead_begin_ < ahead_end_)
+            {
+                std::swap(ahead_begin, ahead_begin_);
+                std::swap(ahead_end, ahead_end_);
+            }
+            else
+            {
+                e = scos.pop();
+            }
+        }
+
+        if (ahead_begin < ahead_end)
+        {
+            // queues the SCOs to read ahead via addSCO
+            volume_.look_up_read_ahead_(ahead_begin,
+                                        ahead_end,
+                                        *this);
+            continue;
         }
-        else
+
+        const SCO sconame = e.sco;
+        const float val = e.sap;
+
+        LOG_INFO(getVolume()->getName() << "Prefetching SCO " << sconame << " with SAP " << val);
+
+        ClusterLocation loc(sconame, 0);
+        BackendInterfacePtr bi = getVolume()->getBackendInterface(loc.cloneID())->clone();
+        BackendSCOFetcher fetcher(sconame,
+                                  getVolume(),
+                                  bi->clone(),
+                                  false); // Don't signal an error if we can't get a sco
+        const VolumeConfig cfg(getVolume()->get_config());
+        const uint64_t scoSize = cfg.getSCOSize();
+        bool res =
+            VolManager::get()->getSCOCache()->prefetchSCO(getVolume()->getNamespace(),
+                                                          sconame,
+                                                          scoSize,
+                                                          val,
+                                                          fetcher);
+
+        LOG_INFO(getVolume()->getName() << ": prefetching SCO " << sconame << " done, " <<
+                 (res ? "continuing" : "stopping") << " prefetching");
+
+        if(not res)
         {
-            break;
+            // the remaining prefetches have lower SAPs and would be turned
+            // down as well; read ahead requests are only skipped individually
+            boost::lock_guard<boost::mutex> g(mut);
+            scos.drop_prefetches();
         }
     }
 
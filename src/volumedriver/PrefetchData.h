@@ -21,34 +21,112 @@
 #include "VolumeBackPointer.h"
 
 #include <queue>
-#include <utility>
+#include <vector>
 
 #include <boost/thread.hpp>
 
+#include <youtils/BooleanEnum.h>
 #include <youtils/Logging.h>
 
+VD_BOOLEAN_ENUM(IsReadAhead);
+
 namespace volumedriver
 {
 
 class VolManagerTestSetup;
 
-class PrefetchData
-    : public VolumeBackPointer
+// SCOs are handed out by descending SAP, SCOs with the same SAP (e.g. read
+// ahead, which uses the initial SAP) in the order they were added.
+class PrefetchQueue
 {
-    friend class VolManagerTestSetup;
+public:
+    struct Entry
+    {
+        SCO sco;
+        float sap = 0;
+        IsReadAhead read_ahead = IsReadAhead::F;
+        uint64_t seq = 0;
+    };
+
+    void
+    push(SCO sco,
+         float sap,
+         IsReadAhead read_ahead)
+    {
+        Entry e;
+        e.sco = sco;
+        e.sap = sap;
+        e.read_ahead = read_ahead;
+        e.seq = next_seq_++;
 
-    using TP = std::pair<SCO, float>;
+        queue_.push(e);
+    }
+
+    bool
+    empty() const
+    {
+        return queue_.empty();
+    }
+
+    size_t
+    size() const
+    {
+        return queue_.size();
+    }
+
+    Entry
+    pop()
+    {
+        Entry e(queue_.top());
+        queue_.pop();
+        return e;
+    }
+
+    void
+    clear()
+    {
+        queue_ = Queue();
+    }
 
+    // Drops all but the read ahead requests, which are not subject to the
+    // SAP based cut off of the SCOCache.
+    void
+    drop_prefetches()
+    {
+        Queue q;
+        while (not queue_.empty())
+        {
+            if (T(queue_.top().read_ahead))
+            {
+                q.push(queue_.top());
+            }
+            queue_.pop();
+        }
+
+        queue_ = std::move(q);
+    }
+
+private:
     struct Compare
     {
         bool
-        operator()(const TP& first, const TP& second)
+        operator()(const Entry& first, const Entry& second) const
         {
-            return first.second < second.second;
+            return first.sap < second.sap or
+                (first.sap == second.sap and first.seq > second.seq);
         }
     };
 
-    using SCOQueue = std::priority_queue<TP, std::vector<TP>, Compare>;
+    using Queue = std::priority_queue<Entry, std::vector<Entry>, Compare>;
+
+    Queue queue_;
+    uint64_t next_seq_ = 0;
+};
+
+class PrefetchData
+    : public VolumeBackPointer
+{
+    friend class VolManagerTestSetup;
 
 public:
     explicit PrefetchData(Volume& v);
@@ -62,22 +140,30 @@ public:
 
     void
     addSCO(SCO a,
-           float val);
+           float val,
+           IsReadAhead read_ahead = IsReadAhead::F);
+
+    // Look up the SCOs of the clusters [begin, end) and read them ahead. The
+    // lookup is done by the prefetch thread to keep it off the read path.
+    void
+    readAhead(ClusterAddress begin,
+              ClusterAddress end);
 
 private:
     DECLARE_LOGGER("PrefetchData");
 
+    Volume& volume_;
     boost::mutex mut;
-    SCOQueue scos;
+    PrefetchQueue scos;
+    // pending read ahead range, empty if ahead_begin_ == ahead_end_
+    ClusterAddress ahead_begin_;
+    ClusterAddress ahead_end_;
     bool stop_;
     boost::condition_variable cond;
     boost::thread thread_;
 
     void
     run_();
-
-    void
-    clear_();
 };
 
 }
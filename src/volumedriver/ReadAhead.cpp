@@ -0,0 +1,162 @@
+// Copyright (C) 2016 iNuron NV
+//
+// This file is part of Open vStorage Open Source Edition (OSE),
+// as available from
+//
+//      http://www.openvstorage.org and
+//      http://www.openvstorage.com.
+//
+// This file is free software; you can redistribute it and/or modify it
+// under the terms of the GNU Affero General Public License v3 (GNU AGPLv3)
+// as published by the Free Software Foundation, in version 3 as it comes in
+// the LICENSE.txt file of the Open vStorage OSE distribution.
+// Open vStorage is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY of any kind.
+
+#include "ReadAhead.h"
+
+#include <algorithm>
+
+namespace volumedriver
+{
+
+ReadAhead::Result
+ReadAhead::update(ClusterAddress ca,
+                  const std::vector<ClusterLocationAndHash>& locs,
+                  const Config& cfg,
+                  bool cache_pressure)
+{
+    Result res;
+
+    if (cfg.max_window == 0 or cfg.min_window == 0)
+    {
+        res.wasted = reset();
+        return res;
+    }
+
+    const uint64_t count = locs.size();
+
+    // Requests of a stream that are in flight concurrently can overtake each
+    // other, so allow for a request's worth of slack in both directions.
+    const bool sequential =
+        sequential_ > 0 and
+        ca <= next_ca_ + count and
+        ca + 2 * count >= next_ca_;
+
+    if (sequential)
+    {
+        ++sequential_;
+        next_ca_ = std::max(next_ca_, ca + count);
+    }
+    else
+    {
+        res.wasted = reset();
+        sequential_ = 1;
+        next_ca_ = ca + count;
+    }
+
+    if (not issued_.empty())
+    {
+        SCO prev;
+
+        for (const auto& l : locs)
+        {
+            const ClusterLocation& loc = l.clusterLocation;
+            if (loc.isNull() or loc.sco() == prev)
+            {
+                continue;
+            }
+
+            prev = loc.sco();
+
+            auto it = std::find(issued_.begin(),
+                                issued_.end(),
+                                prev);
+            if (it != issued_.end())
+            {
+                issued_.erase(it);
+                ++res.hits;
+            }
+        }
+
+        // SCOs the reader skipped (e.g. because of holes in the volume or
+        // because it was served from the cluster cache) are not waited for
+        // forever.
+        const size_t max_issued = 2 * (cfg.max_window / cfg.min_window) + 1;
+        while (issued_.size() > max_issued)
+        {
+            issued_.pop_front();
+            ++res.wasted;
+        }
+    }
+
+    if (sequential_ < cfg.trigger)
+    {
+        return res;
+    }
+
+    if (window_ == 0)
+    {
+        window_ = cfg.min_window;
+        ahead_ca_ = next_ca_;
+    }
+    else if (res.hits)
+    {
+        window_ *= 2;
+    }
+
+    window_ = std::min(window_,
+                       cfg.max_window);
+
+    if (cache_pressure)
+    {
+        window_ = std::max(cfg.min_window,
+                           window_ / 2);
+        return res;
+    }
+
+    ahead_ca_ = std::max(ahead_ca_,
+                         next_ca_);
+
+    // Only top up once half of the window was consumed to batch the lookups.
+    if (ahead_ca_ - next_ca_ <= window_ / 2)
+    {
+        res.ahead_begin = ahead_ca_;
+        res.ahead_end = next_ca_ + window_;
+        ahead_ca_ = res.ahead_end;
+    }
+
+    return res;
+}
+
+bool
+ReadAhead::issue(const SCO sco)
+{
+    if (std::find(issued_.begin(),
+                  issued_.end(),
+                  sco) != issued_.end())
+    {
+        return false;
+    }
+    else
+    {
+        issued_.push_back(sco);
+        return true;
+    }
+}
+
+size_t
+ReadAhead::reset()
+{
+    const size_t wasted = issued_.size();
+
+    issued_.clear();
+    next_ca_ = 0;
+    ahead_ca_ = 0;
+    sequential_ = 0;
+    window_ = 0;
+
+    return wasted;
+}
+
+}
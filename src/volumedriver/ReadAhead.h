@@ -0,0 +1,105 @@
+// Copyright (C) 2016 iNuron NV
+//
+// This file is part of Open vStorage Open Source Edition (OSE),
+// as available from
+//
+//      http://www.openvstorage.org and
+//      http://www.openvstorage.com.
+//
+// This file is free software; you can redistribute it and/or modify it
+// under the terms of the GNU Affero General Public License v3 (GNU AGPLv3)
+// as published by the Free Software Foundation, in version 3 as it comes in
+// the LICENSE.txt file of the Open vStorage OSE distribution.
+// Open vStorage is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY of any kind.
+
+#ifndef VD_READ_AHEAD_H_
+#define VD_READ_AHEAD_H_
+
+#include "ClusterLocationAndHash.h"
+#include "SCO.h"
+#include "Types.h"
+
+#include <deque>
+#include <vector>
+
+namespace volumedriver
+{
+
+// Sequential stream detector of a volume's read path: it follows the reads of
+// a volume and decides which part of the volume is to be fetched into the SCO
+// cache ahead of the reader.
+// The window starts out at min_window clusters once trigger consecutive
+// requests were found to be sequential and doubles (up to max_window) whenever
+// the reader arrives at a SCO that was read ahead; it is halved under SCO
+// cache pressure and dropped altogether if the stream is broken.
+// Not thread safe - callers are expected to serialize access.
+class ReadAhead
+{
+public:
+    struct Config
+    {
+        uint64_t trigger;
+        uint64_t min_window;
+        uint64_t max_window;
+    };
+
+    struct Result
+    {
+        // read ahead SCOs the reader arrived at
+        size_t hits = 0;
+        // read ahead SCOs that were given up on before the reader got there
+        size_t wasted = 0;
+        // the clusters [ahead_begin, ahead_end) are to be read ahead
+        ClusterAddress ahead_begin = 0;
+        ClusterAddress ahead_end = 0;
+    };
+
+    ReadAhead() = default;
+
+    ~ReadAhead() = default;
+
+    ReadAhead(const ReadAhead&) = delete;
+
+    ReadAhead&
+    operator=(const ReadAhead&) = delete;
+
+    // locs are the locations of the clusters [ca, ca + locs.size()) that are
+    // being read.
+    Result
+    update(ClusterAddress ca,
+           const std::vector<ClusterLocationAndHash>& locs,
+           const Config& cfg,
+           bool cache_pressure);
+
+    // Record that the SCO is being read ahead. Returns false if it already is.
+    bool
+    issue(const SCO sco);
+
+    // Forget about the stream; returns the number of read ahead SCOs dropped.
+    size_t
+    reset();
+
+    uint64_t
+    window() const
+    {
+        return window_;
+    }
+
+    size_t
+    pending() const
+    {
+        return issued_.size();
+    }
+
+private:
+    ClusterAddress next_ca_ = 0;
+    ClusterAddress ahead_ca_ = 0;
+    uint64_t sequential_ = 0;
+    uint64_t window_ = 0;
+    std::deque<SCO> issued_;
+};
+
+}
+
+#endif // !VD_READ_AHEAD_H_
@@ -245,6 +245,55 @@ RocksDBMetaDataBackend::getPage(CachePage& p)
     UNREACHABLE;
 }
 
+void
+RocksDBMetaDataBackend::getPages(const std::vector<CachePage*>& pages)
+{
+    LOG_TRACE(pages.size() << " pages");
+
+    std::vector<PageAddress> pas;
+    pas.reserve(pages.size());
+
+    std::vector<rdb::Slice> keys;
+    keys.reserve(pages.size());
+
+    for (const CachePage* p : pages)
+    {
+        check_page_address_(p->page_address());
+        pas.push_back(p->page_address());
+        keys.emplace_back(reinterpret_cast<const char*>(&pas.back()),
+                          sizeof(PageAddress));
+    }
+
+    std::vector<std::string> vals;
+    const std::vector<rdb::Status> status(db_->MultiGet(make_read_options(),
+                                                        keys,
+                                                        &vals));
+    VERIFY(status.size() == pages.size());
+    VERIFY(vals.size() == pages.size());
+
+    for (size_t i = 0; i < pages.size(); ++i)
+    {
+        switch (status[i].code())
+        {
+        case rdb::Status::kOk:
+            {
+                VERIFY(vals[i].size() == CachePage::size());
+                memcpy(pages[i]->data(), vals[i].data(), vals[i].size());
+                break;
+            }
+        case rdb::Status::kNotFound:
+            {
+                pages[i]->reset();
+                break;
+            }
+        default:
+            {
+                HANDLE(status[i]);
+            }
+        }
+    }
+}
+
 void
 RocksDBMetaDataBackend::putPage(const CachePage& p,
                                 int32_t used_clusters_diff)
@@ -45,6 +45,15 @@ public:
     bool
     getPage(CachePage& p) override final;
 
+    void
+    getPages(const std::vector<CachePage*>& pages) override final;
+
+    bool
+    concurrent_reads() const override final
+    {
+        return true;
+    }
+
     void
     putPage(const CachePage& p,
             int32_t used_clusters_delta) override final;
@@ -1268,6 +1268,18 @@ SCOCache::getSCO(const backend::Namespace& nsname,
                    false);
 }
 
+bool
+SCOCache::softCacheFull() const
+{
+    return softCacheFull_();
+}
+
+float
+SCOCache::initialXVal()
+{
+    return getInitialXVal_();
+}
+
 bool
 SCOCache::softCacheFull_() const
 {
@@ -89,6 +89,16 @@ public:
     findSCO_throw(const backend::Namespace& nspace,
                   SCO sco);
 
+    // The cache is considered full if there is less than backoff_gap free
+    // space on all mountpoints; prefetching of SCOs with a SAP lower than the
+    // one of the coldest cached SCO is refused then.
+    bool
+    softCacheFull() const;
+
+    // The SAP a SCO fetched on demand starts out with.
+    float
+    initialXVal();
+
     bool
     prefetchSCO(const backend::Namespace& nspace,
                 SCO scoName,
@@ -618,7 +618,10 @@ SnapshotManagement::scheduleWriteTLogToBackend(const TLogId& tlog_id,
                                              tlogpath,
                                              tlog_id,
                                              sconame,
-                                             tlog_crc));
+                                             tlog_crc,
+                                             VolManager::get()->compact_backend_tlogs.value() ?
+                                             backend_task::CompactTLog::T :
+                                             backend_task::CompactTLog::F));
 
         VolManager::get()->backend_thread_pool()->addTask(task.release());
     }
@@ -657,14 +660,11 @@ SnapshotManagement::cloneSnapshotPersistor() const
     return *sp;
 }
 
-fs::path
-SnapshotManagement::saveSnapshotToTempFile()
+std::string
+SnapshotManagement::saveSnapshotToString()
 {
     LOCKSNAP;
-    fs::path tmp_file = FileUtils::create_temp_file(tlogPath_,
-                                           "snapshots");
-    sp->saveToFile(tmp_file, SyncAndRename::F);
-    return tmp_file;
+    return sp->saveToString();
 }
 
 void
@@ -749,6 +749,29 @@ SnapshotManagement::addClusterEntry(const ClusterAddress address,
                    "add cluster entry");
 }
 
+void
+SnapshotManagement::addClusterEntries(const ClusterAddress* addresses,
+                                      const ClusterLocationAndHash* locations_and_hashes,
+                                      const size_t count)
+{
+    LOCKSNAP;
+    LOCKTLOG;
+    REQUIRE_CURRENT_TLOG;
+
+    halt_on_error_([&]()
+                   {
+                       for (size_t i = 0; i < count; ++i)
+                       {
+                           currentTLog_->add(addresses[i],
+                                             locations_and_hashes[i]);
+                       }
+
+                       numTLogEntries_ += count;
+                       sp->addCurrentBackendSize(count * getVolume()->getClusterSize());
+                   },
+                   "add cluster entries");
+}
+
 void
 SnapshotManagement::sync(const MaybeCheckSum& maybe_sco_crc)
 {
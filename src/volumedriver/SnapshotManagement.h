@@ -191,6 +191,11 @@ public:
     addClusterEntry(const ClusterAddress,
                     const ClusterLocationAndHash&);
 
+    void
+    addClusterEntries(const ClusterAddress*,
+                      const ClusterLocationAndHash*,
+                      const size_t count);
+
     void
     addSCOCRC(const CheckSum& t);
 
@@ -248,8 +253,8 @@ public:
     SnapshotPersistor
     cloneSnapshotPersistor() const;
 
-    boost::filesystem::path
-    saveSnapshotToTempFile();
+    std::string
+    saveSnapshotToString();
 
     void
     getSnapshotScrubbingWork(const boost::optional<SnapshotName>& start_snap,
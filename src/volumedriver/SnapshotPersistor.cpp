@@ -211,6 +211,16 @@ SnapshotPersistor::saveToFileSimple_(const fs::path& filename) const
                                                                           *this);
 }
 
+std::string
+SnapshotPersistor::saveToString() const
+{
+    std::stringstream ss;
+    yt::Serialization::serializeNVPAndFlush<boost::archive::xml_oarchive>(ss,
+                                                                          "snapshots",
+                                                                          *this);
+    return ss.str();
+}
+
 void
 SnapshotPersistor::newTLog()
 {
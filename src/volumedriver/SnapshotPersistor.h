@@ -135,6 +135,9 @@ public:
     saveToFile(const fs::path&,
                const SyncAndRename) const;
 
+    std::string
+    saveToString() const;
+
     void
     snapshot(const SnapshotName&,
              const SnapshotMetaData& = SnapshotMetaData(),
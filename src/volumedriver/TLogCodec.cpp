@@ -0,0 +1,528 @@
+// Copyright (C) 2016 iNuron NV
+//
+// This file is part of Open vStorage Open Source Edition (OSE),
+// as available from
+//
+//      http://www.openvstorage.org and
+//      http://www.openvstorage.com.
+//
+// This file is free software; you can redistribute it and/or modify it
+// under the terms of the GNU Affero General Public License v3 (GNU AGPLv3)
+// as published by the Free Software Foundation, in version 3 as it comes in
+// the LICENSE.txt file of the Open vStorage OSE distribution.
+// Open vStorage is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY of any kind.
+
+#include "Entry.h"
+#include "TLogCodec.h"
+
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include <youtils/Assert.h>
+#include <youtils/CheckSum.h>
+#include <youtils/FileDescriptor.h>
+
+namespace volumedriver
+{
+
+namespace fs = boost::filesystem;
+namespace yt = youtils;
+
+namespace
+{
+
+constexpr uint64_t tlog_codec_magic = 0x31474f4c54434456ULL; // "VDCTLOG1"
+
+// Bits of the header flags word; none are defined yet. Readers refuse
+// flags they do not know about, which leaves room for block compression.
+constexpr uint32_t known_flags = 0;
+
+struct __attribute__((__packed__)) FileHeader
+{
+    uint64_t magic;
+    uint32_t version;
+    uint32_t entry_size;
+    uint32_t flags;
+};
+
+struct __attribute__((__packed__)) BlockHeader
+{
+    uint32_t entries;
+    uint32_t payload_size;
+    uint32_t payload_crc;
+};
+
+// Offsets into a raw Entry - see ClusterLocation / SCO, which are packed:
+// [cluster address (8)][SCO offset (2)][SCO number (4), clone id, version]
+// [weed, if ENABLE_MD5_HASH]
+constexpr size_t loc_offset = sizeof(ClusterAddress);
+constexpr size_t sco_offset = loc_offset + sizeof(SCOOffset);
+constexpr size_t sco_size = sizeof(ClusterLocation) - sizeof(SCOOffset);
+constexpr size_t tail_offset = loc_offset + sizeof(ClusterLocation);
+
+static_assert(sco_size <= sizeof(uint64_t),
+              "SCO does not fit into a 64 bit word");
+
+enum class Tag
+    : uint8_t
+{
+    // null location (sync or CRC entry): varint cluster address, tail
+    NoLocation = 0,
+    // varint deltas of cluster address and offset, tail
+    SameSCO = 1,
+    // varint deltas of cluster address and SCO, varint offset, tail
+    NewSCO = 2,
+};
+
+inline uint64_t
+zigzag(int64_t v)
+{
+    return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+// varints of 64 bit values take up to 10 bytes
+constexpr size_t max_varint_size = 10;
+
+// Upper bound of the payload of a block of `count' entries: a tag and up to
+// three varints per entry, followed by the tail.
+inline uint64_t
+max_payload_size(uint64_t count)
+{
+    const size_t tail_size = Entry::getDataSize() - tail_offset;
+    return count * (1 + 3 * max_varint_size + tail_size);
+}
+
+inline uint16_t
+sco_offset_value(int64_t v)
+{
+    if (v < 0 or v > std::numeric_limits<uint16_t>::max())
+    {
+        throw TLogCodecException("SCO offset out of range in compact TLog");
+    }
+    return static_cast<uint16_t>(v);
+}
+
+inline int64_t
+unzigzag(uint64_t v)
+{
+    return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+inline void
+put_varint(std::vector<uint8_t>& out,
+           uint64_t v)
+{
+    while (v >= 0x80)
+    {
+        out.push_back(static_cast<uint8_t>(v) | 0x80);
+        v >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+class PayloadReader
+{
+public:
+    PayloadReader(const uint8_t* buf,
+                  size_t size)
+        : pos_(buf)
+        , end_(buf + size)
+    {}
+
+    uint64_t
+    varint()
+    {
+        uint64_t v = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7)
+        {
+            const uint8_t b = byte();
+            v |= static_cast<uint64_t>(b bitand 0x7f) << shift;
+            if ((b bitand 0x80) == 0)
+            {
+                return v;
+            }
+        }
+
+        throw TLogCodecException("varint overflow in compact TLog");
+    }
+
+    uint8_t
+    byte()
+    {
+        check_(1);
+        return *pos_++;
+    }
+
+    void
+    copy(uint8_t* dst,
+         size_t size)
+    {
+        check_(size);
+        memcpy(dst, pos_, size);
+        pos_ += size;
+    }
+
+    bool
+    done() const
+    {
+        return pos_ == end_;
+    }
+
+private:
+    const uint8_t* pos_;
+    const uint8_t* const end_;
+
+    void
+    check_(size_t size) const
+    {
+        if (static_cast<size_t>(end_ - pos_) < size)
+        {
+            throw TLogCodecException("truncated block in compact TLog");
+        }
+    }
+};
+
+// Reads size bytes unless EOF is hit first; returns the number of bytes read.
+size_t
+read_fully(yt::FileDescriptor& fd,
+           void* buf,
+           size_t size)
+{
+    size_t off = 0;
+    while (off < size)
+    {
+        const size_t r = fd.read(static_cast<uint8_t*>(buf) + off,
+                                 size - off);
+        if (r == 0)
+        {
+            break;
+        }
+        off += r;
+    }
+    return off;
+}
+
+void
+encode_block(const uint8_t* entries,
+             size_t count,
+             std::vector<uint8_t>& out)
+{
+    const size_t entry_size = Entry::getDataSize();
+    const size_t tail_size = entry_size - tail_offset;
+    const uint64_t null_loc = 0;
+
+    uint64_t prev_ca = 0;
+    uint64_t prev_sco = 0;
+    uint16_t prev_off = 0;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const uint8_t* e = entries + i * entry_size;
+
+        uint64_t ca;
+        memcpy(&ca, e, sizeof(ca));
+
+        if (memcmp(e + loc_offset, &null_loc, sizeof(ClusterLocation)) == 0)
+        {
+            out.push_back(static_cast<uint8_t>(Tag::NoLocation));
+            put_varint(out, ca);
+        }
+        else
+        {
+            uint16_t off;
+            memcpy(&off, e + loc_offset, sizeof(off));
+            uint64_t sco = 0;
+            memcpy(&sco, e + sco_offset, sco_size);
+
+            if (sco == prev_sco)
+            {
+                out.push_back(static_cast<uint8_t>(Tag::SameSCO));
+                put_varint(out, zigzag(ca - prev_ca));
+                put_varint(out, zigzag(static_cast<int64_t>(off) - prev_off));
+            }
+            else
+            {
+                out.push_back(static_cast<uint8_t>(Tag::NewSCO));
+                put_varint(out, zigzag(ca - prev_ca));
+                put_varint(out, zigzag(sco - prev_sco));
+                put_varint(out, off);
+            }
+
+            prev_ca = ca;
+            prev_sco = sco;
+            prev_off = off;
+        }
+
+        out.insert(out.end(), e + tail_offset, e + tail_offset + tail_size);
+    }
+}
+
+void
+decode_block(PayloadReader& in,
+             size_t count,
+             uint8_t* entries)
+{
+    const size_t entry_size = Entry::getDataSize();
+    const size_t tail_size = entry_size - tail_offset;
+
+    uint64_t prev_ca = 0;
+    uint64_t prev_sco = 0;
+    uint16_t prev_off = 0;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint8_t* e = entries + i * entry_size;
+        memset(e, 0x0, tail_offset);
+
+        const Tag tag = static_cast<Tag>(in.byte());
+        switch (tag)
+        {
+        case Tag::NoLocation:
+            {
+                const uint64_t ca = in.varint();
+                memcpy(e, &ca, sizeof(ca));
+                break;
+            }
+        case Tag::SameSCO:
+        case Tag::NewSCO:
+            {
+                const uint64_t ca = prev_ca + unzigzag(in.varint());
+                uint64_t sco = prev_sco;
+                uint16_t off;
+
+                if (tag == Tag::SameSCO)
+                {
+                    off = sco_offset_value(prev_off + unzigzag(in.varint()));
+                }
+                else
+                {
+                    sco += unzigzag(in.varint());
+                    const uint64_t o = in.varint();
+                    off = sco_offset_value(o > std::numeric_limits<uint16_t>::max() ?
+                                           -1 :
+                                           static_cast<int64_t>(o));
+                }
+
+                memcpy(e, &ca, sizeof(ca));
+                memcpy(e + loc_offset, &off, sizeof(off));
+                memcpy(e + sco_offset, &sco, sco_size);
+
+                prev_ca = ca;
+                prev_sco = sco;
+                prev_off = off;
+                break;
+            }
+        default:
+            throw TLogCodecException("unknown entry tag in compact TLog");
+        }
+
+        in.copy(e + tail_offset, tail_size);
+    }
+}
+
+}
+
+bool
+TLogCodec::is_compact(const fs::path& p)
+{
+    yt::FileDescriptor fd(p, yt::FDMode::Read);
+    uint64_t magic = 0;
+    return read_fully(fd, &magic, sizeof(magic)) == sizeof(magic) and
+        magic == tlog_codec_magic;
+}
+
+namespace
+{
+
+template<typename Sink>
+void
+encode_tlog(const fs::path& src,
+            Sink&& sink)
+{
+    const size_t entry_size = Entry::getDataSize();
+
+    yt::FileDescriptor in(src, yt::FDMode::Read);
+
+    const FileHeader hdr{ tlog_codec_magic,
+                          TLogCodec::version,
+                          static_cast<uint32_t>(entry_size),
+                          0 };
+    sink(&hdr, sizeof(hdr));
+
+    std::vector<uint8_t> raw(TLogCodec::entries_per_block * entry_size);
+    std::vector<uint8_t> payload;
+    payload.reserve(raw.size() + TLogCodec::entries_per_block);
+
+    while (true)
+    {
+        const size_t r = read_fully(in, raw.data(), raw.size());
+        if (r % entry_size != 0)
+        {
+            throw TLogCodecException("trailing garbage in TLog",
+                                     src.string().c_str());
+        }
+
+        const size_t count = r / entry_size;
+        if (count == 0)
+        {
+            break;
+        }
+
+        payload.clear();
+        encode_block(raw.data(), count, payload);
+
+        yt::CheckSum crc;
+        crc.update(payload.data(), payload.size());
+
+        const BlockHeader bhdr{ static_cast<uint32_t>(count),
+                                static_cast<uint32_t>(payload.size()),
+                                crc.getValue() };
+        sink(&bhdr, sizeof(bhdr));
+        sink(payload.data(), payload.size());
+
+        if (r < raw.size())
+        {
+            break;
+        }
+    }
+}
+
+}
+
+void
+TLogCodec::encode(const fs::path& src,
+                  const fs::path& dst)
+{
+    yt::FileDescriptor out(dst,
+                           yt::FDMode::Write,
+                           CreateIfNecessary::T);
+    out.truncate(0);
+
+    uint64_t size = 0;
+
+    encode_tlog(src,
+                [&](const void* buf, size_t len)
+                {
+                    out.write(buf, len);
+                    size += len;
+                });
+
+    out.sync();
+
+    LOG_DEBUG(src << ": encoded " << fs::file_size(src) << " bytes into " <<
+              size << " bytes");
+}
+
+void
+TLogCodec::encode(const fs::path& src,
+                  std::vector<uint8_t>& dst)
+{
+    dst.clear();
+
+    encode_tlog(src,
+                [&](const void* buf, size_t len)
+                {
+                    const uint8_t* p = static_cast<const uint8_t*>(buf);
+                    dst.insert(dst.end(), p, p + len);
+                });
+
+    LOG_DEBUG(src << ": encoded " << fs::file_size(src) << " bytes into " <<
+              dst.size() << " bytes");
+}
+
+void
+TLogCodec::decode(const fs::path& src,
+                  const fs::path& dst)
+{
+    const size_t entry_size = Entry::getDataSize();
+
+    yt::FileDescriptor in(src, yt::FDMode::Read);
+
+    FileHeader hdr;
+    if (read_fully(in, &hdr, sizeof(hdr)) != sizeof(hdr) or
+        hdr.magic != tlog_codec_magic)
+    {
+        LOG_ERROR(src << ": not a compact TLog");
+        throw TLogCodecException("not a compact TLog",
+                                 src.string().c_str());
+    }
+
+    if (hdr.version != version or
+        hdr.entry_size != entry_size or
+        (hdr.flags bitand ~known_flags) != 0)
+    {
+        LOG_ERROR(src << ": unsupported compact TLog: version " << hdr.version <<
+                  ", entry size " << hdr.entry_size << ", flags " << hdr.flags);
+        throw TLogCodecException("unsupported compact TLog",
+                                 src.string().c_str());
+    }
+
+    yt::FileDescriptor out(dst,
+                           yt::FDMode::Write,
+                           CreateIfNecessary::T);
+    out.truncate(0);
+
+    std::vector<uint8_t> raw;
+    std::vector<uint8_t> payload;
+
+    while (true)
+    {
+        BlockHeader bhdr;
+        const size_t r = read_fully(in, &bhdr, sizeof(bhdr));
+        if (r == 0)
+        {
+            break;
+        }
+
+        // checked before the CRC as it determines what is read
+        if (r != sizeof(bhdr) or
+            bhdr.entries > entries_per_block or
+            bhdr.payload_size > max_payload_size(bhdr.entries))
+        {
+            LOG_ERROR(src << ": corrupt block header");
+            throw TLogCodecException("corrupt block header in compact TLog",
+                                     src.string().c_str());
+        }
+
+        payload.resize(bhdr.payload_size);
+        if (read_fully(in, payload.data(), payload.size()) != payload.size())
+        {
+            LOG_ERROR(src << ": truncated block");
+            throw TLogCodecException("truncated block in compact TLog",
+                                     src.string().c_str());
+        }
+
+        yt::CheckSum crc;
+        crc.update(payload.data(), payload.size());
+        if (crc.getValue() != bhdr.payload_crc)
+        {
+            LOG_ERROR(src << ": block checksum mismatch");
+            throw TLogCodecException("block checksum mismatch in compact TLog",
+                                     src.string().c_str());
+        }
+
+        raw.resize(bhdr.entries * entry_size);
+
+        PayloadReader reader(payload.data(), payload.size());
+        decode_block(reader, bhdr.entries, raw.data());
+
+        if (not reader.done())
+        {
+            LOG_ERROR(src << ": trailing bytes in block");
+            throw TLogCodecException("trailing bytes in compact TLog block",
+                                     src.string().c_str());
+        }
+
+        out.write(raw.data(), raw.size());
+    }
+
+    out.sync();
+}
+
+}
+
+// Local Variables: **
+// mode: c++ **
+// End: **
@@ -0,0 +1,80 @@
+// Copyright (C) 2016 iNuron NV
+//
+// This file is part of Open vStorage Open Source Edition (OSE),
+// as available from
+//
+//      http://www.openvstorage.org and
+//      http://www.openvstorage.com.
+//
+// This file is free software; you can redistribute it and/or modify it
+// under the terms of the GNU Affero General Public License v3 (GNU AGPLv3)
+// as published by the Free Software Foundation, in version 3 as it comes in
+// the LICENSE.txt file of the Open vStorage OSE distribution.
+// Open vStorage is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY of any kind.
+
+#ifndef VD_TLOG_CODEC_H_
+#define VD_TLOG_CODEC_H_
+
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include <youtils/IOException.h>
+#include <youtils/Logging.h>
+
+namespace volumedriver
+{
+
+MAKE_EXCEPTION(TLogCodecException, fungi::IOException);
+
+// Compact encoding of TLogs as stored on the backend.
+//
+// A raw TLog is an array of fixed size Entry records; within a TLog cluster
+// addresses and SCO offsets mostly grow monotonically and the SCO number
+// rarely changes. The compact encoding stores
+//
+//   header: magic (8) | version (4) | entry size (4) | flags (4)
+//   blocks: entry count (4) | payload size (4) | payload crc32c (4) | payload
+//
+// where the payload holds up to entries_per_block entries, each one a tag byte
+// followed by zigzag varint deltas of the cluster address, SCO and offset
+// against the previous location entry in the block, and the remaining bytes
+// of the entry (the weed, if any) verbatim. Decoding reproduces the raw TLog
+// byte for byte so TLog checksums stay valid.
+//
+// The magic cannot be the start of a raw TLog: the first word of a raw entry
+// is either a cluster address (< 2^35) or a CRC with its type in bits 32..33.
+struct TLogCodec
+{
+    static constexpr uint32_t version = 1;
+    static constexpr uint32_t entries_per_block = 16384;
+
+    static bool
+    is_compact(const boost::filesystem::path&);
+
+    // Encode the raw TLog at src into dst, which is created or truncated.
+    static void
+    encode(const boost::filesystem::path& src,
+           const boost::filesystem::path& dst);
+
+    // Encode the raw TLog at src into memory.
+    static void
+    encode(const boost::filesystem::path& src,
+           std::vector<uint8_t>& dst);
+
+    // Decode the compact TLog at src into dst, which is created or truncated.
+    static void
+    decode(const boost::filesystem::path& src,
+           const boost::filesystem::path& dst);
+
+    DECLARE_LOGGER("TLogCodec");
+};
+
+}
+
+#endif // !VD_TLOG_CODEC_H_
+
+// Local Variables: **
+// mode: c++ **
+// End: **
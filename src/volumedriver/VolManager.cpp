@@ -156,13 +156,22 @@ try
           , default_cluster_size(pt)
           , metadata_cache_capacity(pt)
           , metadata_mds_slave_max_tlogs_behind(pt)
+          , metadata_mds_push_to_slaves(pt)
           , debug_metadata_path(pt)
           , arakoon_metadata_sequence_size(pt)
           , allow_inconsistent_partial_reads(pt)
           , volume_nullio(pt)
+          , partial_read_threads(pt)
+          , max_concurrent_partial_reads(pt)
+          , compact_backend_tlogs(pt)
+          , read_ahead_max_scos(pt)
+          , read_ahead_trigger(pt)
 {
     THROW_UNLESS((default_cluster_size.value() % VolumeConfig::default_lba_size()) == 0);
 
+    partial_read_executor_ =
+        std::make_unique<PartialReadExecutor>(partial_read_threads.value());
+
     periodicActions_.push_back(new yt::PeriodicAction("SCOCacheCleaner",
                                                       [this]
                                                       {
@@ -1499,6 +1508,22 @@ VolManager::getQueueSize(const VolumeId& volName)
     return v->getSCOSize() * getQueueCount(volName);
 }
 
+youtils::ThreadPoolQueueStats
+VolManager::getBackendQueueStats(const VolumeId& volName)
+{
+    SharedVolumePtr v = find_volume(volName);
+    return backend_thread_pool_.getQueueStats(v.get());
+}
+
+void
+VolManager::setBackendQueueWeight(const VolumeId& volName,
+                                  uint32_t weight)
+{
+    SharedVolumePtr v = find_volume(volName);
+    backend_thread_pool_.setWeight(v.get(),
+                                   weight);
+}
+
 bool
 VolManager::updateReadActivity()
 {
@@ -1794,10 +1819,16 @@ VolManager::update(const boost::property_tree::ptree& pt,
     default_cluster_size.update(pt, report);
     metadata_cache_capacity.update(pt, report);
     metadata_mds_slave_max_tlogs_behind.update(pt, report);
+    metadata_mds_push_to_slaves.update(pt, report);
     debug_metadata_path.update(pt, report);
     arakoon_metadata_sequence_size.update(pt, report);
     allow_inconsistent_partial_reads.update(pt, report);
     volume_nullio.update(pt, report);
+    partial_read_threads.update(pt, report);
+    max_concurrent_partial_reads.update(pt, report);
+    compact_backend_tlogs.update(pt, report);
+    read_ahead_max_scos.update(pt, report);
+    read_ahead_trigger.update(pt, report);
 }
 
 void
@@ -1829,10 +1860,16 @@ VolManager::persist(boost::property_tree::ptree& pt,
     default_cluster_size.persist(pt, reportDefault);
     metadata_cache_capacity.persist(pt, reportDefault);
     metadata_mds_slave_max_tlogs_behind.persist(pt, reportDefault);
+    metadata_mds_push_to_slaves.persist(pt, reportDefault);
     debug_metadata_path.persist(pt, reportDefault);
     arakoon_metadata_sequence_size.persist(pt, reportDefault);
     allow_inconsistent_partial_reads.persist(pt, reportDefault);
     volume_nullio.persist(pt, reportDefault);
+    partial_read_threads.persist(pt, reportDefault);
+    max_concurrent_partial_reads.persist(pt, reportDefault);
+    compact_backend_tlogs.persist(pt, reportDefault);
+    read_ahead_max_scos.persist(pt, reportDefault);
+    read_ahead_trigger.persist(pt, reportDefault);
 }
 
 std::shared_ptr<metadata_server::Manager>
@@ -19,6 +19,7 @@
 #include "ClusterCache.h"
 #include "DataStoreCallBack.h"
 #include "Events.h"
+#include "PartialReadExecutor.h"
 #include "SCOCache.h"
 #include "SnapshotManagement.h"
 #include "Volume.h"
@@ -144,6 +145,12 @@ public:
     VolPool*
     backend_thread_pool();
 
+    PartialReadExecutor&
+    partial_read_executor()
+    {
+        return *partial_read_executor_;
+    }
+
     void
     scheduleTask(VolPoolTask* t);
 
@@ -527,6 +534,7 @@ private:
 
     events::PublisherPtr event_publisher_;
     VolPool backend_thread_pool_;
+    std::unique_ptr<PartialReadExecutor> partial_read_executor_;
 
     VolumeMap volMap_;
 
@@ -586,10 +594,18 @@ public:
 private:
     DECLARE_PARAMETER(metadata_mds_slave_max_tlogs_behind);
 public:
+    DECLARE_PARAMETER(metadata_mds_push_to_slaves);
     DECLARE_PARAMETER(debug_metadata_path);
     DECLARE_PARAMETER(arakoon_metadata_sequence_size);
     DECLARE_PARAMETER(allow_inconsistent_partial_reads);
     DECLARE_PARAMETER(volume_nullio);
+private:
+    DECLARE_PARAMETER(partial_read_threads);
+public:
+    DECLARE_PARAMETER(max_concurrent_partial_reads);
+    DECLARE_PARAMETER(compact_backend_tlogs);
+    DECLARE_PARAMETER(read_ahead_max_scos);
+    DECLARE_PARAMETER(read_ahead_trigger);
 
 private:
     template<typename Id>
@@ -634,6 +650,15 @@ private:
     uint64_t
     getQueueSize(const VolumeId& volName);
 
+    youtils::ThreadPoolQueueStats
+    getBackendQueueStats(const VolumeId& volName);
+
+    // relative share of the backend thread pool - lost once the volume's
+    // backend queue is stopped
+    void
+    setBackendQueueWeight(const VolumeId& volName,
+                          uint32_t weight);
+
     bool
     checkEnoughFreeSpace_(const fs::path& p,
                           uint64_t minimal) const;
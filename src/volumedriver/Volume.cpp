@@ -22,6 +22,7 @@
 #include "CombinedTLogReader.h"
 #include "DataStoreNG.h"
 #include "FailOverCacheClientInterface.h"
+#include "FailOverCacheReplayer.h"
 #include "MDSMetaDataStore.h"
 #include "MetaDataStoreInterface.h"
 #include "PrefetchData.h"
@@ -83,7 +84,8 @@ static_assert(FLT_RADIX == 2, "Need to check code for non conforming FLT_RADIX")
     boost::unique_lock<decltype(unaligned_lock_)> uualg__(unaligned_lock_)
 
 #define SERIALIZE_WRITES()                              \
-    boost::lock_guard<lock_type> gwl__(write_lock_)
+    boost::lock_guard<lock_type> gwl__(write_lock_);    \
+    wait_for_inflight_writes_()
 
 #define LOCK_CONFIG_UPDATES()                                           \
     std::lock_guard<decltype(config_update_lock_)> gcfguplck__(config_update_lock_)
@@ -131,6 +133,9 @@ Volume::Volume(const VolumeConfig& vCfg,
     , mdstore_was_rebuilt_(false)
     , config_lock_()
     , write_lock_()
+    , write_seq_next_(0)
+    , write_seq_committed_(0)
+    , write_seq_dtl_sent_(0)
     , rwlock_("rwlock-" + vCfg.id_.str())
     , unaligned_lock_("unaligned-lock-" + vCfg.id_.str())
     , halted_(false)
@@ -714,7 +719,7 @@ void
 Volume::writeClusterMetaData_(ClusterAddress ca,
                               const ClusterLocationAndHash& loc_and_hash)
 {
-    ASSERT_WRITES_SERIALIZED();
+    // callers hold the DTL turn of the write pipeline (cf. writeClusters_)
     ASSERT_RLOCKED();
 
     snapshotManagement_->addClusterEntry(ca,
@@ -763,12 +768,15 @@ DtlInSync
 Volume::writeClustersToFailOverCache_(const std::vector<ClusterLocation>& locs,
                                       size_t num_locs,
                                       uint64_t start_address,
-                                      const uint8_t* buf)
+                                      const uint8_t* buf,
+                                      uint64_t& copied,
+                                      uint64_t& dtl_ticket)
 {
-    ASSERT_WRITES_SERIALIZED();
+    // callers hold the DTL turn of the write pipeline (cf. writeClusters_)
     ASSERT_RLOCKED();
 
     DtlInSync dtl_in_sync = DtlInSync::F;
+    dtl_ticket = 0;
 
     if (failover_->backup())
     {
@@ -791,24 +799,68 @@ Volume::writeClustersToFailOverCache_(const std::vector<ClusterLocation>& locs,
         LOG_VTRACE("sending TLog " << snapshotManagement_->getCurrentTLogId() <<
                    ", start address " << start_address);
 
-        while (not failover_->addEntries(locs,
-                                         num_locs,
-                                         start_address,
-                                         buf))
+        yt::SteadyTimer t;
+
+        // the sync bridge hands out a ticket to wait for the DTL's
+        // acknowledgement with once the DTL turn was passed on.
+        // The write_lock_ cannot be taken here as it ranks above the rwlock_,
+        // but later writers queue up behind the DTL turn anyway.
+        while (not failover_->sendEntries(locs,
+                                          num_locs,
+                                          start_address,
+                                          buf,
+                                          dtl_ticket))
         {
-            throttle_(foc_throttle_usecs_);
+            backoff_(foc_throttle_usecs_);
         }
 
-        if (failover_->mode() == FailOverCacheMode::Synchronous and
+        // With a ticket the entries were merely queued - the round trip is
+        // recorded once it was waited for.
+        if (dtl_ticket == 0)
+        {
+            const auto duration_us(bc::duration_cast<bc::microseconds>(t.elapsed()));
+            performance_counters().dtl_send_latency.record(duration_us.count());
+        }
+
+        const FailOverCacheMode mode = failover_->mode();
+
+        if (mode == FailOverCacheMode::Synchronous and
             getVolumeFailOverState() == VolumeFailOverState::OK_SYNC)
         {
             dtl_in_sync = DtlInSync::T;
         }
+        else if (mode == FailOverCacheMode::Asynchronous)
+        {
+            // the async bridge hangs on to the data beyond this request
+            copied += num_locs * clusterSize_;
+        }
     }
 
     return dtl_in_sync;
 }
 
+DtlInSync
+Volume::wait_for_failover_cache_(const uint64_t dtl_ticket,
+                                 unsigned& throttle_usecs)
+{
+    ASSERT_RLOCKED();
+
+    yt::SteadyTimer t;
+
+    failover_->waitForEntries(dtl_ticket);
+
+    const auto duration_us(bc::duration_cast<bc::microseconds>(t.elapsed()));
+    performance_counters().dtl_send_latency.record(duration_us.count());
+
+    // the time spent on the DTL counts towards the datastore throttle
+    throttle_usecs -= std::min<uint64_t>(throttle_usecs,
+                                         duration_us.count());
+
+    return getVolumeFailOverState() == VolumeFailOverState::OK_SYNC ?
+        DtlInSync::T :
+        DtlInSync::F;
+}
+
 DtlInSync
 Volume::write(const Lba lba,
               const uint8_t *buf,
@@ -867,6 +919,7 @@ Volume::write(const uint64_t off,
     const uint64_t aligned_len = nclusters * clusterSize_;
     const uint64_t aligned_off = ca * clusterSize_;
     DtlInSync dtl_in_sync = DtlInSync::F;
+    uint64_t copied = 0;
 
     if (aligned_off != off or
         aligned_len != len)
@@ -875,19 +928,10 @@ Volume::write(const uint64_t off,
 
         performance_counters().unaligned_write_request_size.count(len);
 
-        std::vector<uint8_t> bounce_buf(aligned_len);
-
-        read(aligned_off,
-             bounce_buf.data(),
-             bounce_buf.size());
-
-        memcpy(bounce_buf.data() + coff,
-               buf,
-               len);
-
-        dtl_in_sync = write_aligned_(aligned_off,
-                                     bounce_buf.data(),
-                                     bounce_buf.size());
+        dtl_in_sync = write_unaligned_(off,
+                                       buf,
+                                       len,
+                                       copied);
     }
     else
     {
@@ -899,19 +943,79 @@ Volume::write(const uint64_t off,
 
         dtl_in_sync = write_aligned_(aligned_off,
                                      buf,
-                                     aligned_len);
+                                     aligned_len,
+                                     copied);
     }
 
+    performance_counters().write_copy_size.count(copied);
+
     const auto duration_us(bc::duration_cast<bc::microseconds>(t.elapsed()));
     performance_counters().write_request_usecs.count(duration_us.count());
+    performance_counters().write_latency.record(duration_us.count());
 
     return dtl_in_sync;
 }
 
+DtlInSync
+Volume::write_unaligned_(const uint64_t off,
+                         const uint8_t* buf,
+                         uint64_t len,
+                         uint64_t& copied)
+{
+    // Only the partially written first and last cluster are read back, but
+    // the request is passed on as a single aligned write so it cannot end up
+    // more partially applied than an aligned one and is throttled like one.
+    ASSERT(len > 0);
+
+    const uint64_t coff = off % clusterSize_;
+    const uint64_t aligned_off = off - coff;
+    const uint64_t tail = (coff + len) % clusterSize_;
+    const uint64_t aligned_len = coff + len + (tail ? clusterSize_ - tail : 0);
+
+    // Frontend threads only hang on to a bounded bounce buffer; larger requests
+    // get one of their own.
+    static const uint64_t max_cached_bounce_size = 1ULL << 20;
+    static thread_local std::vector<uint8_t> cached_bounce_buf;
+    std::vector<uint8_t> large_bounce_buf;
+
+    std::vector<uint8_t>& bounce_buf = aligned_len <= max_cached_bounce_size ?
+        cached_bounce_buf :
+        large_bounce_buf;
+
+    bounce_buf.resize(aligned_len);
+
+    if (coff != 0)
+    {
+        read(aligned_off,
+             bounce_buf.data(),
+             clusterSize_);
+    }
+
+    if (tail != 0 and
+        (aligned_len > clusterSize_ or coff == 0))
+    {
+        read(aligned_off + aligned_len - clusterSize_,
+             bounce_buf.data() + aligned_len - clusterSize_,
+             clusterSize_);
+    }
+
+    memcpy(bounce_buf.data() + coff,
+           buf,
+           len);
+
+    copied += len;
+
+    return write_aligned_(aligned_off,
+                          bounce_buf.data(),
+                          aligned_len,
+                          copied);
+}
+
 DtlInSync
 Volume::write_aligned_(const uint64_t off,
                        const uint8_t* buf,
-                       uint64_t len)
+                       uint64_t len,
+                       uint64_t& copied)
 {
     LOG_VTRACE("off " << off << ", len " << len);
 
@@ -923,33 +1027,95 @@ Volume::write_aligned_(const uint64_t off,
 
     while (write_off < len)
     {
-        SERIALIZE_WRITES();
-
-        const ssize_t sco_cap =
-            dataStore_->getRemainingSCOCapacity() * clusterSize_;
-        // we need to guarantee that ourselves by forcing a SCO rollover
-        // when updating the SCOMultiplier
-        VERIFY(sco_cap >= 0); // can we really deal with sco_cap == 0?
+        SCOWriteReservation res;
+        uint64_t seq;
 
-        size_t dtl_cap = std::numeric_limits<size_t>::max();
+        // prevent tlog rollover interfering with snapshotting and friends -
+        // held from the reservation up to the commit of the reserved clusters.
+        boost::shared_lock<decltype(rwlock_)> rlock(rwlock_,
+                                                    boost::defer_lock);
         {
-            RLOCK();
+            boost::lock_guard<lock_type> g(write_lock_);
+            rlock.lock();
+
+            size_t dtl_cap = std::numeric_limits<size_t>::max();
             if (failover_)
             {
                 dtl_cap = failover_->max_entries() * getClusterSize();
             }
+
+            VERIFY(dtl_cap > 0);
+
+            const size_t num_locs =
+                std::min(write_len, dtl_cap) / clusterSize_;
+            VERIFY(num_locs > 0);
+
+            if (dataStore_->reserveClusters(num_locs, res) == 0)
+            {
+                // The current SCO is fully reserved: wait for the pending
+                // writes to it to be committed, the last of which rolls it
+                // over. If that failed we need to do it ourselves.
+                rlock.unlock();
+                wait_for_inflight_writes_();
+                rlock.lock();
+
+                if (dataStore_->reserveClusters(num_locs, res) == 0)
+                {
+                    rollover_full_sco_();
+                    VERIFY(dataStore_->reserveClusters(num_locs, res) > 0);
+                }
+            }
+
+            boost::lock_guard<decltype(write_seq_lock_)> l(write_seq_lock_);
+            seq = write_seq_next_++;
+        }
+
+        const size_t chunksize = res.num_locs * clusterSize_;
+        unsigned throttle_usecs = 0;
+        uint64_t dtl_ticket = 0;
+
+        // The DTL entries queued by writeClusters_ point into `buf': they
+        // must have been sent before we return, whichever way we leave.
+        auto dtl_exit(yt::make_scope_exit([&]
+                                          {
+                                              if (dtl_ticket != 0)
+                                              {
+                                                  try
+                                                  {
+                                                      failover_->waitForEntries(dtl_ticket);
+                                                  }
+                                                  CATCH_STD_ALL_LOG_IGNORE(getName() <<
+                                                                           ": failed to wait for DTL ticket " <<
+                                                                           dtl_ticket);
+                                              }
+                                          }));
+
+        DtlInSync in_sync = writeClusters_(off + write_off,
+                                           buf + write_off,
+                                           res,
+                                           seq,
+                                           throttle_usecs,
+                                           copied,
+                                           dtl_ticket);
+
+        // Outside of the commit turn so the next writers can get their entries
+        // to the DTL in the meantime (and ideally into the same round trip).
+        if (dtl_ticket != 0)
+        {
+            const uint64_t ticket = dtl_ticket;
+            dtl_ticket = 0;
+            in_sync = wait_for_failover_cache_(ticket,
+                                               throttle_usecs);
         }
 
-        VERIFY(dtl_cap > 0);
+        rlock.unlock();
 
-        const size_t chunksize =
-            std::min({write_len,
-                      dtl_cap,
-                      static_cast<size_t>(sco_cap)});
+        if (throttle_usecs > 0)
+        {
+            boost::lock_guard<lock_type> g(write_lock_);
+            throttle_(throttle_usecs);
+        }
 
-        const DtlInSync in_sync = writeClusters_(off + write_off,
-                                                 buf + write_off,
-                                                 chunksize);
         if (in_sync == DtlInSync::F)
         {
             dtl_in_sync = DtlInSync::F;
@@ -965,117 +1131,222 @@ Volume::write_aligned_(const uint64_t off,
     return dtl_in_sync;
 }
 
-namespace
+void
+Volume::wait_for_inflight_writes_()
+{
+    boost::unique_lock<decltype(write_seq_lock_)> u(write_seq_lock_);
+    write_seq_cond_.wait(u,
+                         [&]() -> bool
+                         {
+                             return write_seq_committed_ == write_seq_next_;
+                         });
+}
+
+void
+Volume::wait_for_write_turn_(const uint64_t seq)
 {
-ClusterLocationAndHash
-make_cluster_location_and_hash(const ClusterLocation& loc,
-                               const ClusterCacheMode ccmode,
-                               const uint8_t* buf,
-                               const size_t bufsize)
+    boost::unique_lock<decltype(write_seq_lock_)> u(write_seq_lock_);
+    write_seq_cond_.wait(u,
+                         [&]() -> bool
+                         {
+                             return write_seq_committed_ == seq;
+                         });
+}
+
+void
+Volume::finish_write_(const uint64_t seq)
 {
-    if (ccmode == ClusterCacheMode::ContentBased)
+    wait_for_write_turn_(seq);
+
     {
-        return ClusterLocationAndHash(loc,
-                                      buf,
-                                      bufsize);
+        boost::lock_guard<decltype(write_seq_lock_)> l(write_seq_lock_);
+        ++write_seq_committed_;
     }
-    else
+
+    write_seq_cond_.notify_all();
+}
+
+void
+Volume::wait_for_dtl_turn_(const uint64_t seq)
+{
+    boost::unique_lock<decltype(write_seq_lock_)> u(write_seq_lock_);
+    write_seq_cond_.wait(u,
+                         [&]() -> bool
+                         {
+                             return write_seq_dtl_sent_ == seq;
+                         });
+}
+
+void
+Volume::finish_dtl_send_(const uint64_t seq)
+{
+    wait_for_dtl_turn_(seq);
+
     {
-        return ClusterLocationAndHash(loc,
-                                      yt::Weed::null());
+        boost::lock_guard<decltype(write_seq_lock_)> l(write_seq_lock_);
+        ++write_seq_dtl_sent_;
     }
+
+    write_seq_cond_.notify_all();
 }
 
+void
+Volume::rollover_full_sco_()
+{
+    ASSERT_RLOCKED();
+
+    LOG_VDEBUG(getName() << ": requesting SCO rollover, adding CRC to tlog");
+    MaybeCheckSum cs = dataStore_->finalizeCurrentSCO();
+    VERIFY(cs);
+    snapshotManagement_->addSCOCRC(*cs);
 }
 
 DtlInSync
 Volume::writeClusters_(uint64_t addr,
                        const uint8_t* buf,
-                       uint64_t bufsize)
+                       SCOWriteReservation& res,
+                       const uint64_t seq,
+                       unsigned& throttle_usecs,
+                       uint64_t& copied,
+                       uint64_t& dtl_ticket)
 {
-    ASSERT_WRITES_SERIALIZED();
+    ASSERT_RLOCKED();
 
     VERIFY(addr % clusterSize_ == 0);
-    VERIFY(bufsize % clusterSize_ == 0);
 
-    size_t num_locs = bufsize / clusterSize_;
-    unsigned throttle_usecs = 0;
-    uint32_t ds_throttle = 0;
+    // whatever happens, the next writer must get its turns - the commit turn
+    // is passed on first.
+    auto dtl_exit(yt::make_scope_exit([&]
+                                      {
+                                          finish_dtl_send_(seq);
+                                      }));
+
+    // commitClusters settles the reservation whichever way it leaves, anything
+    // that throws before has to do so (in reservation order) as well.
+    bool settled = false;
+    bool committed = false;
+    auto commit_exit(yt::make_scope_exit([&]
+                                         {
+                                             if (not committed)
+                                             {
+                                                 if (not settled)
+                                                 {
+                                                     wait_for_write_turn_(seq);
+                                                     dataStore_->discardReservation(res);
+                                                 }
+
+                                                 finish_write_(seq);
+                                             }
+                                         }));
 
-    DtlInSync dtl_in_sync = DtlInSync::F;
+    const size_t num_locs = res.num_locs;
+    uint32_t ds_throttle = 0;
 
-    {
-        // prevent tlog rollover interfering with snapshotting and friends
-        RLOCK();
+    // concurrently with other writers: data to the SCO and content hashes
+    dataStore_->writeReservedClusters(res,
+                                      buf,
+                                      ds_throttle);
 
-        TODO("ArneT: reserve/clear vector \"cluster_locations\" so the nr of clusters can be derived in the failover_->addEntries call");
+    const ClusterCacheMode ccmode = effective_cluster_cache_mode();
 
-        dataStore_->writeClusters(buf,
-                                  cluster_locations_,
-                                  num_locs,
-                                  ds_throttle);
+    static thread_local std::vector<yt::Weed> weeds;
+    weeds.clear();
 
-        const ClusterCacheMode ccmode = effective_cluster_cache_mode();
+    if (ccmode == ClusterCacheMode::ContentBased and not res.error)
+    {
+        const yt::WeedAlgorithm algo = get_weed_algorithm();
 
+        weeds.reserve(num_locs);
         for (size_t i = 0; i < num_locs; ++i)
         {
-            const uint8_t* data = buf + i * clusterSize_;
-            uint64_t clusteraddr = addr + i * clusterSize_;
-            ClusterAddress ca = addr2CA(clusteraddr);
-            ClusterLocationAndHash
-                loc_and_hash(make_cluster_location_and_hash(cluster_locations_[i],
-                                                            ccmode,
-                                                            data,
-                                                            clusterSize_));
-
-            writeClusterMetaData_(ca,
-                                  loc_and_hash);
-
-            if (isCacheOnWrite())
-            {
-                add_to_cluster_cache_(ccmode,
-                                      ca,
-                                      loc_and_hash.weed(),
-                                      data);
-            }
-            else if (ccmode == ClusterCacheMode::LocationBased)
-            {
-                purge_from_cluster_cache_(ca,
-                                          loc_and_hash.weed());
-            }
+            weeds.emplace_back(yt::make_weed(algo,
+                                             buf + i * clusterSize_,
+                                             clusterSize_));
         }
+    }
 
-        yt::SteadyTimer t;
-        dtl_in_sync = writeClustersToFailOverCache_(cluster_locations_,
-                                                    num_locs,
-                                                    addr >> volOffset_,
-                                                    buf);
+    // in reservation order: checksum, metadata / tlog, cluster cache and SCO
+    // rollover, followed by the DTL
+    wait_for_write_turn_(seq);
+
+    settled = true;
+    dataStore_->commitClusters(res,
+                               buf,
+                               cluster_locations_);
 
-        throttle_usecs += bc::duration_cast<bc::microseconds>(t.elapsed()).count();
+    for (size_t i = 0; i < num_locs; ++i)
+    {
+        const uint8_t* data = buf + i * clusterSize_;
+        uint64_t clusteraddr = addr + i * clusterSize_;
+        ClusterAddress ca = addr2CA(clusteraddr);
+        const ClusterLocationAndHash
+            loc_and_hash(cluster_locations_[i],
+                         weeds.empty() ?
+                         yt::Weed::null() :
+                         weeds[i]);
 
-        const ssize_t sco_cap = dataStore_->getRemainingSCOCapacity();
-        VERIFY(sco_cap >= 0);
+        writeClusterMetaData_(ca,
+                              loc_and_hash);
 
-        if (sco_cap == 0)
+        if (isCacheOnWrite())
+        {
+            add_to_cluster_cache_(ccmode,
+                                  ca,
+                                  loc_and_hash.weed(),
+                                  data);
+            if (use_cluster_cache_(ccmode))
+            {
+                copied += clusterSize_;
+            }
+        }
+        else if (ccmode == ClusterCacheMode::LocationBased)
         {
-            LOG_VDEBUG(getName() << ": requesting SCO rollover, adding CRC to tlog");
-            MaybeCheckSum cs = dataStore_->finalizeCurrentSCO();
-            VERIFY(cs);
-            snapshotManagement_->addSCOCRC(*cs);
+            purge_from_cluster_cache_(ca,
+                                      loc_and_hash.weed());
         }
     }
 
+    const ssize_t sco_cap = dataStore_->getRemainingSCOCapacity();
+    VERIFY(sco_cap >= 0);
+
+    if (sco_cap == 0)
+    {
+        rollover_full_sco_();
+    }
+
     LOG_VTRACE("start_address " << addr <<
                " CA " << cluster_locations_[0]);
 
+    // cluster_locations_ belongs to the commit turn
+    static thread_local std::vector<ClusterLocation> locs;
+    locs.assign(cluster_locations_.begin(),
+                cluster_locations_.begin() + num_locs);
+
+    // Pass on the commit turn before getting the entries to the DTL in order
+    // not to hold up the commits of later writers while the DTL is backing off.
+    committed = true;
+    finish_write_(seq);
+
+    wait_for_dtl_turn_(seq);
+
+    yt::SteadyTimer t;
+    const DtlInSync dtl_in_sync =
+        writeClustersToFailOverCache_(locs,
+                                      num_locs,
+                                      addr >> volOffset_,
+                                      buf,
+                                      copied,
+                                      dtl_ticket);
+
+    const unsigned dtl_usecs =
+        bc::duration_cast<bc::microseconds>(t.elapsed()).count();
+
     if (ds_throttle > 0)
     {
         const unsigned ds_throttle_usecs = ds_throttle * num_locs;
         throttle_usecs =
             ds_throttle_usecs - std::min(ds_throttle_usecs,
-                                         throttle_usecs);
-
-        throttle_(throttle_usecs);
+                                         dtl_usecs);
     }
 
     return dtl_in_sync;
@@ -1166,6 +1437,7 @@ Volume::read(const uint64_t off,
 
     const auto duration_us(bc::duration_cast<bc::microseconds>(t.elapsed()));
     performance_counters().read_request_usecs.count(duration_us.count());
+    performance_counters().read_latency.record(duration_us.count());
 }
 
 void
@@ -1175,32 +1447,47 @@ Volume::readClusters_(uint64_t addr,
 {
     RLOCK();
 
-    // Z42: Move this to the caller or make it thread local storage to
-    // avoid allocations
-    std::vector<ClusterReadDescriptor> read_descriptors;
-    read_descriptors.reserve(bufsize / getClusterSize());
+    // Per thread scratch space: the vectors keep their capacity across
+    // requests so reads don't need to go to the allocator in the steady state.
+    static thread_local std::vector<ClusterReadDescriptor> read_descriptors;
+    static thread_local std::vector<ClusterLocationAndHash> locs;
+    static thread_local std::vector<ClusterCacheReadRequest> cache_reqs;
+
+    read_descriptors.clear();
+    cache_reqs.clear();
+
     const ClusterCacheMode ccmode = effective_cluster_cache_mode();
 
+    // One metadata lookup for the whole range instead of one per cluster.
+
+    try
+    {
+        yt::SteadyTimer t;
+
+        metaDataStore_->readClusters(addr2CA(addr),
+                                     bufsize / getClusterSize(),
+                                     locs);
+
+        const auto duration_us(bc::duration_cast<bc::microseconds>(t.elapsed()));
+        performance_counters().metadata_lookup_latency.record(duration_us.count());
+    }
+    CATCH_STD_ALL_EWHAT({
+            VolumeDriverError::report(events::VolumeDriverErrorCode::MetaDataStore,
+                                      EWHAT,
+                                      getName());
+            halt();
+            throw;
+        });
+
+    // All clusters that were written to are looked up in the cluster cache in
+    // one go, which allows it to submit the reads of the hits as a batch.
     for (uint64_t off = 0; off < bufsize; off += getClusterSize())
     {
         TODO("AR: go to the cluster cache immediately when LocationBased?");
 
-        ClusterLocationAndHash loc_and_hash;
-        ClusterAddress ca = addr2CA(addr + off);
+        const ClusterLocationAndHash& loc_and_hash = locs[off / getClusterSize()];
         ++readcounter_;
 
-        try
-        {
-            metaDataStore_->readCluster(ca, loc_and_hash);
-        }
-        CATCH_STD_ALL_EWHAT({
-                VolumeDriverError::report(events::VolumeDriverErrorCode::MetaDataStore,
-                                          EWHAT,
-                                          getName());
-                halt();
-                throw;
-            });
-
         LOG_VTRACE("lba " << ((addr + off) / getLBASize()) <<
                    " CA " << loc_and_hash);
 
@@ -1216,25 +1503,39 @@ Volume::readClusters_(uint64_t addr,
         }
         else
         {
-            const bool in_cache = find_in_cluster_cache_(ccmode,
-                                                         ca,
-                                                         loc_and_hash.weed(),
-                                                         buf + off);
+            cache_reqs.emplace_back(addr2CA(addr + off),
+                                    loc_and_hash.weed(),
+                                    buf + off);
+        }
+    }
 
-            if (in_cache)
-            {
-                ++readCacheHits_;
-                dataStore_->touchCluster(loc_and_hash.clusterLocation);
-            }
-            else
-            {
-                ++readCacheMisses_;
-                read_descriptors.
-                    push_back(ClusterReadDescriptor(loc_and_hash,
-                                                    ca,
-                                                    buf + off,
-                                                    getBackendInterface(loc_and_hash.clusterLocation.cloneID())->clone()));
-            }
+    find_in_cluster_cache_(ccmode,
+                           cache_reqs);
+
+    auto req_it = cache_reqs.begin();
+
+    for (const auto& loc_and_hash : locs)
+    {
+        if (loc_and_hash.clusterLocation.isNull())
+        {
+            continue;
+        }
+
+        VERIFY(req_it != cache_reqs.end());
+        const ClusterCacheReadRequest& req = *req_it++;
+
+        if (req.hit)
+        {
+            ++readCacheHits_;
+            dataStore_->touchCluster(loc_and_hash.clusterLocation);
+        }
+        else
+        {
+            ++readCacheMisses_;
+            read_descriptors.emplace_back(loc_and_hash,
+                                          req.ca,
+                                          req.buf,
+                                          getBackendInterface(loc_and_hash.clusterLocation.cloneID()).get());
         }
     }
 
@@ -1242,14 +1543,19 @@ Volume::readClusters_(uint64_t addr,
 
     if (effective_cluster_cache_behaviour() != ClusterCacheBehaviour::NoCache)
     {
-        for (const ClusterReadDescriptor& clrd : read_descriptors)
+        for (const ClusterCacheReadRequest& req : cache_reqs)
         {
-            add_to_cluster_cache_(ccmode,
-                                  clrd.getClusterAddress(),
-                                  clrd.weed(),
-                                  clrd.getBuffer());
+            if (not req.hit)
+            {
+                fill_cluster_cache_(ccmode,
+                                    req);
+            }
         }
     }
+
+    // only once this request is served
+    issue_read_ahead_(addr2CA(addr),
+                      locs);
 }
 
 std::tuple<uint64_t, uint64_t>
@@ -1447,6 +1753,7 @@ Volume::restoreSnapshot(const SnapshotName& name)
         VolManager::get()->backend_thread_pool()->stop(this, 10);
 
         prefetch_data_ = nullptr;
+        reset_read_ahead_();
 
         LOG_VINFO("Stopping the readcache");
 
@@ -2127,51 +2434,28 @@ Volume::removeUpToFromFailOverCache(const SCO sconame)
 }
 
 void
-Volume::replayClusterFromFailOverCache_(ClusterAddress ca,
-                                        const ClusterLocation& loc,
-                                        const uint8_t* buf)
+Volume::writeClustersMetaData_(const ClusterAddress* cas,
+                               const ClusterLocationAndHash* locs,
+                               size_t count)
 {
-    ASSERT_WRITES_SERIALIZED();
-    ASSERT_WLOCKED();
-
-    LOG_VTRACE("ca " << ca << ", loc " << loc << ", buf " << &buf);
-    checkNotHalted_();
-
-    uint32_t throttle = 0;
-    MaybeCheckSum forced_rollover;
-
-    if (loc.offset() == 0)
-    {
-        LOG_VTRACE("forced SCO rollover");
-        forced_rollover = dataStore_->finalizeCurrentSCO();
-    }
-
-    // This is an interesting location - we could end up creating SCOs larger
-    // than what is currently configured, i.e.
-    // dataStore_->getRemainingSCOCapacity() could return values < 0.
-    // So no sanity check here!
-    dataStore_->writeClusterToLocation(buf,
-                                       loc,
-                                       throttle);
-
-    // if the SCO is filled up at this stage it will be either rolled over on
-    // the next cluster replay or - if there is no next cluster - as part of
-    // the subsequent FOC replay steps (cf. replayFOC_).
-    if(forced_rollover)
-    {
-        snapshotManagement_->addSCOCRC(*forced_rollover);
-    }
-
-    ClusterLocationAndHash loc_and_hash(loc,
-                                        buf,
-                                        getClusterSize());
-    writeClusterMetaData_(ca,
-                          loc_and_hash);
+    ASSERT_RLOCKED();
 
-    if(throttle > 0)
+    snapshotManagement_->addClusterEntries(cas,
+                                           locs,
+                                           count);
+    try
     {
-        throttle_(throttle);
+        metaDataStore_->writeClusters(cas,
+                                      locs,
+                                      count);
     }
+    CATCH_STD_ALL_EWHAT({
+            VolumeDriverError::report(events::VolumeDriverErrorCode::MetaDataStore,
+                                      EWHAT,
+                                      getName());
+            halt();
+            throw;
+        });
 }
 
 uint64_t
@@ -2742,43 +3026,109 @@ Volume::replayFOC_(FailOverCacheProxy& foc)
     ASSERT_WRITES_SERIALIZED();
     ASSERT_WLOCKED();
 
-    auto fun([&](ClusterLocation loc,
-                 Lba lba,
-                 const byte* buf,
-                 size_t size)
-             {
-                 uint32_t counter = 0;
-                 LOG_VTRACE("Replaying " << loc << "lba " << lba);
-
-                 VERIFY(size == static_cast<size_t>(clusterSize_));
-
-                 const uint64_t off = lba.t * getLBASize();
-                 validateIOAlignment(off, size);
-
-                 while (true)
-                 {
-                     try
-                     {
-                         replayClusterFromFailOverCache_(addr2CA(off),
-                                                         loc,
-                                                         buf);
-                         return;
-                     }
-                     catch (TransientException& e)
-                     {
-                         LOG_VINFO("TransientException");
-                         if (++counter == 256)
-                         {
-                             throw;
-                         }
-                         boost::this_thread::sleep_for(bc::seconds(1));
-                     }
-                 }
-             });
+    // SCO data, runs on the replayer's writer thread
+    auto write([&](FailOverCacheReplayer::Batch& batch)
+               {
+                   LOG_VTRACE("Replaying " << batch.size() << " clusters from " <<
+                              batch.loc);
+                   checkNotHalted_();
+
+                   batch.addrs.clear();
+                   batch.addrs.reserve(batch.size());
+
+                   for (const auto& lba : batch.lbas)
+                   {
+                       const uint64_t off = lba * getLBASize();
+                       validateIOAlignment(off, clusterSize_);
+                       batch.addrs.push_back(addr2CA(off));
+                   }
+
+                   if (batch.loc.offset() == 0)
+                   {
+                       LOG_VTRACE("forced SCO rollover");
+                       batch.forced_rollover = dataStore_->finalizeCurrentSCO();
+                   }
+
+                   // This is an interesting location - we could end up
+                   // creating SCOs larger than what is currently configured,
+                   // i.e. dataStore_->getRemainingSCOCapacity() could return
+                   // values < 0. So no sanity check here!
+                   uint32_t throttle = 0;
+                   uint32_t counter = 0;
+
+                   while (true)
+                   {
+                       try
+                       {
+                           dataStore_->writeClustersToLocation(batch.data.data(),
+                                                               batch.loc,
+                                                               batch.size(),
+                                                               throttle);
+                           break;
+                       }
+                       catch (TransientException& e)
+                       {
+                           LOG_VINFO("TransientException");
+                           if (++counter == 256)
+                           {
+                               throw;
+                           }
+                           boost::this_thread::sleep_for(bc::seconds(1));
+                       }
+                   }
+
+                   batch.throttle_usecs = throttle * batch.size();
+
+                   batch.locs_and_hashes.clear();
+                   batch.locs_and_hashes.reserve(batch.size());
+
+                   for (size_t i = 0; i < batch.size(); ++i)
+                   {
+                       const ClusterLocation loc(batch.loc.sco(),
+                                                 batch.loc.offset() + i);
+                       batch.locs_and_hashes.emplace_back(loc,
+                                                          batch.data.data() + i * clusterSize_,
+                                                          clusterSize_);
+                   }
+               });
+
+    // metadata, runs on this thread as it holds the locks. If the SCO filled
+    // up it will either be rolled over with the next batch or - if there is
+    // none - below.
+    auto apply([&](FailOverCacheReplayer::Batch& batch)
+               {
+                   checkNotHalted_();
+
+                   if (batch.forced_rollover)
+                   {
+                       snapshotManagement_->addSCOCRC(*batch.forced_rollover);
+                   }
+
+                   writeClustersMetaData_(batch.addrs.data(),
+                                          batch.locs_and_hashes.data(),
+                                          batch.size());
+
+                   if (batch.throttle_usecs > 0)
+                   {
+                       throttle_(batch.throttle_usecs);
+                   }
+               });
 
     try
     {
-        foc.getEntries(std::move(fun));
+        FailOverCacheReplayer replay(clusterSize_);
+        const FailOverCacheReplayer::Stats stats(replay(foc,
+                                                        std::move(write),
+                                                        std::move(apply)));
+
+        const double secs = stats.duration.count() / 1e6;
+        const double mib = stats.clusters * clusterSize_ / (1024.0 * 1024.0);
+
+        LOG_VINFO("replayed " << stats.clusters << " clusters (" << mib <<
+                  " MiB) in " << stats.batches << " batches from the FailOverCache in " <<
+                  secs << " seconds: " <<
+                  (secs > 0 ? mib / secs : 0) << " MiB/s, " <<
+                  (secs > 0 ? stats.clusters / secs : 0) << " clusters/s");
 
         MaybeCheckSum cs = dataStore_->finalizeCurrentSCO();
 
@@ -3054,11 +3404,17 @@ Volume::getClusterCacheVolumeInfo() const
 }
 
 void
-Volume::throttle_(unsigned throttle_usecs) const
+Volume::throttle_(unsigned throttle_usecs)
 {
     // not needed but desired, otherwise the throttling will be pointless
     ASSERT_WRITES_SERIALIZED();
 
+    backoff_(throttle_usecs);
+}
+
+void
+Volume::backoff_(unsigned throttle_usecs)
+{
     if (throttle_usecs != 0)
     {
         tracepoint(openvstorage_volumedriver,
@@ -3076,7 +3432,12 @@ Volume::throttle_(unsigned throttle_usecs) const
 
         LOG_VDEBUG("throttling writes for " << throttle_usecs <<
                    " us");
+
+        yt::SteadyTimer t;
         usleep(throttle_usecs);
+
+        const auto duration_us(bc::duration_cast<bc::microseconds>(t.elapsed()));
+        performance_counters().throttle_latency.record(duration_us.count());
     }
 }
 
@@ -3291,6 +3652,23 @@ Volume::set_cluster_cache_limit(const boost::optional<ClusterCount>& limit)
     update_cluster_cache_limit_();
 }
 
+void
+Volume::set_weed_algorithm(const yt::WeedAlgorithm algo)
+{
+    LOG_VINFO("Setting the weed algorithm to " << algo);
+
+    // Weeds are opaque once written, so clusters hashed with the previous
+    // algorithm remain accessible - they just won't be deduplicated against
+    // the ones written from now on.
+    SERIALIZE_WRITES();
+    WLOCK();
+
+    update_config_([&](VolumeConfig& cfg)
+                   {
+                       cfg.weed_algorithm_ = algo;
+                   });
+}
+
 void
 Volume::update_cluster_cache_limit_()
 {
@@ -3424,14 +3802,9 @@ Volume::add_to_cluster_cache_(const ClusterCacheMode ccmode,
                               const youtils::Weed& weed,
                               const uint8_t* buf)
 {
-    // For now we only use the cache if it has the same cluster size. We could
-    // try harder and split volume clusters into smaller cache clusters.
-    ClusterCache& cache = VolManager::get()->getClusterCache();
-
-    if ((ClusterLocationAndHash::use_hash() or
-         ccmode != ClusterCacheMode::ContentBased) and
-        cache.cluster_size() == getClusterSize())
+    if (use_cluster_cache_(ccmode))
     {
+        ClusterCache& cache = VolManager::get()->getClusterCache();
         cache.add(getClusterCacheHandle(),
                   ca,
                   weed,
@@ -3457,28 +3830,43 @@ Volume::purge_from_cluster_cache_(const ClusterAddress ca,
 }
 
 bool
-Volume::find_in_cluster_cache_(const ClusterCacheMode ccmode,
-                               const ClusterAddress ca,
-                               const youtils::Weed& weed,
-                               uint8_t* buf)
+Volume::use_cluster_cache_(const ClusterCacheMode ccmode) const
 {
     // For now we only use the cache if it has the same cluster size. We could
     // try harder and split volume clusters into smaller cache clusters.
-    ClusterCache& cache = VolManager::get()->getClusterCache();
+    const ClusterCache& cache = VolManager::get()->getClusterCache();
+
+    return (ClusterLocationAndHash::use_hash() or
+            ccmode != ClusterCacheMode::ContentBased) and
+        cache.cluster_size() == getClusterSize();
+}
 
-    if ((ClusterLocationAndHash::use_hash() or
-         ccmode != ClusterCacheMode::ContentBased) and
-        cache.cluster_size() == getClusterSize())
+void
+Volume::find_in_cluster_cache_(const ClusterCacheMode ccmode,
+                               std::vector<ClusterCacheReadRequest>& reqs)
+{
+    if (use_cluster_cache_(ccmode) and not reqs.empty())
     {
-        return cache.read(getClusterCacheHandle(),
-                          ca,
-                          weed,
-                          buf,
-                          static_cast<size_t>(getClusterSize()));
+        yt::SteadyTimer t;
+
+        ClusterCache& cache = VolManager::get()->getClusterCache();
+        cache.read(getClusterCacheHandle(),
+                   reqs);
+
+        const auto duration_us(bc::duration_cast<bc::microseconds>(t.elapsed()));
+        performance_counters().cluster_cache_latency.record(duration_us.count());
     }
-    else
+}
+
+void
+Volume::fill_cluster_cache_(const ClusterCacheMode ccmode,
+                            const ClusterCacheReadRequest& req)
+{
+    if (use_cluster_cache_(ccmode))
     {
-        return false;
+        ClusterCache& cache = VolManager::get()->getClusterCache();
+        cache.fill(getClusterCacheHandle(),
+                   req);
     }
 }
 
@@ -3493,6 +3881,143 @@ Volume::get_prefetch_data_()
     return *prefetch_data_;
 }
 
+void
+Volume::issue_read_ahead_(const ClusterAddress ca,
+                          const std::vector<ClusterLocationAndHash>& locs)
+{
+    VolManager* vm = VolManager::get();
+    const uint64_t max_scos = vm->read_ahead_max_scos.value();
+
+    if (max_scos == 0)
+    {
+        return;
+    }
+
+    // Read ahead is best effort, so rather skip it than wait for another
+    // reader of this volume.
+    std::unique_lock<decltype(read_ahead_lock_)> u(read_ahead_lock_,
+                                                   std::try_to_lock);
+    if (not u.owns_lock())
+    {
+        return;
+    }
+
+    SCOCache& scocache = *vm->getSCOCache();
+    const uint64_t sco_clusters = getSCOMultiplier();
+    const ReadAhead::Config cfg{ vm->read_ahead_trigger.value(),
+                                 sco_clusters,
+                                 max_scos * sco_clusters };
+
+    const ReadAhead::Result res(read_ahead_.update(ca,
+                                                   locs,
+                                                   cfg,
+                                                   scocache.softCacheFull()));
+
+    const uint64_t sco_size = sco_clusters * getClusterSize();
+
+    for (size_t i = 0; i < res.hits; ++i)
+    {
+        performance_counters().read_ahead_hit_size.count(sco_size);
+    }
+
+    for (size_t i = 0; i < res.wasted; ++i)
+    {
+        performance_counters().read_ahead_waste_size.count(sco_size);
+    }
+
+    const ClusterAddress end = std::min<ClusterAddress>(res.ahead_end,
+                                                        getSize() / getClusterSize());
+    if (res.ahead_begin < end)
+    {
+        get_prefetch_data_().readAhead(res.ahead_begin,
+                                       end);
+    }
+}
+
+// Called by the prefetch thread.
+void
+Volume::look_up_read_ahead_(const ClusterAddress begin,
+                            const ClusterAddress end,
+                            PrefetchData& prefetch_data)
+{
+    // Don't hold up (or deadlock with) anyone who needs the volume exclusively,
+    // e.g. to restore a snapshot or to tear down the prefetch thread.
+    boost::shared_lock<decltype(rwlock_)> rlg(rwlock_,
+                                              boost::try_to_lock);
+    if (not rlg.owns_lock())
+    {
+        LOG_VDEBUG("volume is busy, not reading ahead");
+        return;
+    }
+
+    VolManager* vm = VolManager::get();
+    const uint64_t max_scos = vm->read_ahead_max_scos.value();
+
+    std::vector<ClusterLocationAndHash> ahead;
+
+    try
+    {
+        metaDataStore_->readClusters(begin,
+                                     end - begin,
+                                     ahead);
+    }
+    CATCH_STD_ALL_EWHAT({
+            LOG_VWARN("Failed to look up clusters to read ahead: " << EWHAT);
+            return;
+        });
+
+    SCOCache& scocache = *vm->getSCOCache();
+    const be::Namespace nspace(getNamespace());
+    const float sap = scocache.initialXVal();
+    SCO prev;
+    uint64_t issued = 0;
+
+    std::lock_guard<decltype(read_ahead_lock_)> g(read_ahead_lock_);
+
+    for (const auto& l : ahead)
+    {
+        const ClusterLocation& loc = l.clusterLocation;
+        if (loc.isNull() or loc.sco() == prev)
+        {
+            continue;
+        }
+
+        prev = loc.sco();
+
+        // also covers the SCOs that are not on the backend yet
+        if (scocache.findSCO(nspace,
+                             prev))
+        {
+            continue;
+        }
+
+        if (read_ahead_.issue(prev))
+        {
+            LOG_VDEBUG("reading ahead " << prev);
+            prefetch_data.addSCO(prev,
+                                 sap,
+                                 IsReadAhead::T);
+            if (++issued == max_scos)
+            {
+                break;
+            }
+        }
+    }
+}
+
+void
+Volume::reset_read_ahead_()
+{
+    std::lock_guard<decltype(read_ahead_lock_)> g(read_ahead_lock_);
+    const size_t wasted = read_ahead_.reset();
+    const uint64_t sco_size = getSCOSize();
+
+    for (size_t i = 0; i < wasted; ++i)
+    {
+        performance_counters().read_ahead_waste_size.count(sco_size);
+    }
+}
+
 }
 
 // Local Variables: **
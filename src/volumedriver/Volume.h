@@ -24,6 +24,7 @@
 #include "Lba.h"
 #include "NSIDMap.h"
 #include "PerformanceCounters.h"
+#include "ReadAhead.h"
 #include "RestartContext.h"
 #include "SCO.h"
 #include "SCOAccessData.h"
@@ -42,6 +43,7 @@
 #include <set>
 
 #include <boost/circular_buffer.hpp>
+#include <boost/thread/condition_variable.hpp>
 #include <boost/thread/mutex.hpp>
 #include <boost/utility.hpp>
 
@@ -65,6 +67,7 @@ namespace volumedriver
 {
 VD_BOOLEAN_ENUM(DeleteFailOverCache);
 
+struct ClusterCacheReadRequest;
 class ClusterReadDescriptor;
 class DataStoreNG;
 class FailOverCacheAsyncBridge;
@@ -72,6 +75,7 @@ class FailOverCacheSyncBridge;
 class MetaDataBackendConfig;
 class MetaDataStoreInterface;
 class PrefetchData;
+struct SCOWriteReservation;
 class ScrubberResult;
 class SnapshotManagement;
 class SnapshotPersistor;
@@ -96,6 +100,7 @@ class Volume
     friend class ErrorHandlingTest;
     friend class ::volumedrivertest::MetaDataStoreTest;
     friend void backend_task::WriteTLog::run(int);
+    friend class PrefetchData;
 
 public:
     VolumeFailOverState
@@ -466,6 +471,16 @@ public:
         return config_.cluster_cache_limit_;
     }
 
+    void
+    set_weed_algorithm(const youtils::WeedAlgorithm algo);
+
+    youtils::WeedAlgorithm
+    get_weed_algorithm() const
+    {
+        std::lock_guard<decltype(config_lock_)> g(config_lock_);
+        return config_.weed_algorithm_;
+    }
+
     ClusterCacheMode
     effective_cluster_cache_mode() const;
 
@@ -541,15 +556,27 @@ private:
 
     // LOCKING:
     // - rwlock allows concurrent reads / writes (R) vs. snapshotting etc (W)
-    // - write_lock_ is required to prevent write throttling from delaying reads,
-    //   which together with the write_lock_ boils down to a single write / multiple reads
-    //   for the moment.
+    // - write_lock_ is required to prevent write throttling from delaying reads.
+    //   Writers only hold it to reserve SCO space and a sequence number, then write
+    //   their data concurrently and commit (metadata / DTL / SCO rollover) in
+    //   sequence number order (cf. write_aligned_). SERIALIZE_WRITES() additionally
+    //   waits for all reserved writes to be committed.
     // - unaligned_lock_  is taken by unaligned writes to prevent RMW (the read part happens
     //   outside the write_lock_) from interfering with writes to the same cluster
     // -> lock order: unaligned_lock_ > write_lock_ > rwlock_
     typedef boost::mutex lock_type;
     mutable lock_type write_lock_;
 
+    // write pipeline: write_seq_next_ is handed out under the write_lock_,
+    // write_seq_committed_ is the next sequence number allowed to commit and
+    // write_seq_dtl_sent_ the next one allowed to send its entries to the DTL
+    // (which happens after passing on the commit turn).
+    boost::mutex write_seq_lock_;
+    boost::condition_variable write_seq_cond_;
+    uint64_t write_seq_next_;
+    uint64_t write_seq_committed_;
+    uint64_t write_seq_dtl_sent_;
+
     uint64_t intCeiling(uint64_t x, uint64_t y) {
         //rounds x up to nearest multiple of y
         return x % y ?  (x / y + 1) * y : x;
@@ -616,6 +643,10 @@ private:
 
     std::unique_ptr<PrefetchData> prefetch_data_;
 
+    // only one reader at a time feeds the read ahead, the others pass it by
+    std::mutex read_ahead_lock_;
+    ReadAhead read_ahead_;
+
     void
     processReloc_(const TLogName &relocName, bool deletions);
 
@@ -625,7 +656,29 @@ private:
     DtlInSync
     writeClusters_(uint64_t addr,
                    const uint8_t* buf,
-                   uint64_t bufsize);
+                   SCOWriteReservation& res,
+                   uint64_t seq,
+                   unsigned& throttle_usecs,
+                   uint64_t& copied,
+                   uint64_t& dtl_ticket);
+
+    void
+    wait_for_inflight_writes_();
+
+    void
+    wait_for_write_turn_(uint64_t seq);
+
+    void
+    finish_write_(uint64_t seq);
+
+    void
+    wait_for_dtl_turn_(uint64_t seq);
+
+    void
+    finish_dtl_send_(uint64_t seq);
+
+    void
+    rollover_full_sco_();
 
     void
     readClusters_(uint64_t addr,
@@ -667,15 +720,21 @@ private:
                           const ClusterLocationAndHash& loc);
 
     void
-    replayClusterFromFailOverCache_(ClusterAddress ca,
-                                    const ClusterLocation& loc,
-                                    const uint8_t* buf);
+    writeClustersMetaData_(const ClusterAddress* cas,
+                           const ClusterLocationAndHash* locs,
+                           size_t count);
 
     DtlInSync
     writeClustersToFailOverCache_(const std::vector<ClusterLocation>& locs,
                                   size_t num_locs,
                                   uint64_t start_address,
-                                  const uint8_t* buf);
+                                  const uint8_t* buf,
+                                  uint64_t& copied,
+                                  uint64_t& dtl_ticket);
+
+    DtlInSync
+    wait_for_failover_cache_(uint64_t dtl_ticket,
+                             unsigned& throttle_usecs);
 
     void
     writeConfigToBackend_(const VolumeConfig& cfg);
@@ -692,7 +751,10 @@ private:
                              const std::string&);
 
     void
-    throttle_(unsigned throttle_usecs) const;
+    throttle_(unsigned throttle_usecs);
+
+    void
+    backoff_(unsigned usecs);
 
     fs::path
     ensureDebugDataDirectory_();
@@ -757,18 +819,44 @@ private:
                               const youtils::Weed&);
 
     bool
+    use_cluster_cache_(const ClusterCacheMode) const;
+
+    void
     find_in_cluster_cache_(const ClusterCacheMode,
-                           const ClusterAddress,
-                           const youtils::Weed&,
-                           uint8_t*);
+                           std::vector<ClusterCacheReadRequest>&);
+
+    void
+    fill_cluster_cache_(const ClusterCacheMode,
+                        const ClusterCacheReadRequest&);
 
     PrefetchData&
     get_prefetch_data_();
 
+    void
+    issue_read_ahead_(const ClusterAddress,
+                      const std::vector<ClusterLocationAndHash>&);
+
+    void
+    look_up_read_ahead_(const ClusterAddress begin,
+                        const ClusterAddress end,
+                        PrefetchData&);
+
+    void
+    reset_read_ahead_();
+
+    // `copied' is increased by the number of bytes of the payload that are
+    // copied in user space (DTL, cluster cache).
     DtlInSync
     write_aligned_(const uint64_t off,
                    const uint8_t *buf,
-                   uint64_t len);
+                   uint64_t len,
+                   uint64_t& copied);
+
+    DtlInSync
+    write_unaligned_(const uint64_t off,
+                     const uint8_t *buf,
+                     uint64_t len,
+                     uint64_t& copied);
 };
 
 using SharedVolumePtr = std::shared_ptr<Volume>;
@@ -53,6 +53,7 @@ VolumeConfig::VolumeConfig()
     , sco_mult_(default_sco_multiplier())
     , readCacheEnabled_(true)
     , wan_backup_volume_role_(WanBackupVolumeRole::WanBackupNormal)
+    , weed_algorithm_(yt::WeedAlgorithm::Md5)
     , is_volume_template_(IsVolumeTemplate::F)
     , owner_tag_(OwnerTag(0))
 {}
@@ -87,6 +88,7 @@ VolumeConfig::VolumeConfig(const VolumeConfig& other)
     , cluster_cache_behaviour_(other.cluster_cache_behaviour_)
     , cluster_cache_mode_(other.cluster_cache_mode_)
     , cluster_cache_limit_(other.cluster_cache_limit_)
+    , weed_algorithm_(other.weed_algorithm_)
     , metadata_cache_capacity_(other.metadata_cache_capacity_)
     , metadata_backend_config_(other.metadata_backend_config_->clone())
     , is_volume_template_(other.is_volume_template_)
@@ -148,6 +150,7 @@ VolumeConfig::operator=(const VolumeConfig& other)
         cluster_cache_behaviour_ = other.cluster_cache_behaviour_;
         cluster_cache_mode_ = other.cluster_cache_mode_;
         cluster_cache_limit_ = other.cluster_cache_limit_;
+        weed_algorithm_ = other.weed_algorithm_;
         metadata_cache_capacity_ = other.metadata_cache_capacity_;
         metadata_backend_config_ = other.metadata_backend_config_->clone();
         is_volume_template_ = other.is_volume_template_;
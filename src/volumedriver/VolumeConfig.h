@@ -49,6 +49,7 @@
 #include <youtils/Assert.h>
 #include <youtils/EnumUtils.h>
 #include <youtils/Serialization.h>
+#include <youtils/WeedAlgorithm.h>
 
 namespace volumedriver
 {
@@ -86,6 +87,7 @@ public:
         , cluster_cache_behaviour_(t.get_cluster_cache_behaviour())
         , cluster_cache_mode_(t.get_cluster_cache_mode())
         , cluster_cache_limit_(t.get_cluster_cache_limit())
+        , weed_algorithm_(t.get_weed_algorithm())
         , metadata_cache_capacity_(t.get_metadata_cache_capacity())
         , metadata_backend_config_(t.get_metadata_backend_config() ?
                                    t.get_metadata_backend_config()->clone().release() :
@@ -183,6 +185,9 @@ public:
     boost::optional<ClusterCacheMode> cluster_cache_mode_;
     boost::optional<ClusterCount> cluster_cache_limit_;
 
+    /* Content hash of clusters, only relevant with a ContentBased cluster cache */
+    youtils::WeedAlgorithm weed_algorithm_;
+
     boost::optional<size_t> metadata_cache_capacity_;
 
     using MetaDataBackendConfigPtr = std::unique_ptr<MetaDataBackendConfig>;
@@ -317,7 +322,7 @@ private:
             // No backward compatibility for now.
             // The below checks are left in place in case we ever want to change that
             // and serve as documentation.
-            THROW_SERIALIZATION_ERROR(version, 11, 15);
+            THROW_SERIALIZATION_ERROR(version, 11, 16);
         }
 
         if(version == 4)
@@ -430,6 +435,15 @@ private:
             ar & BOOST_SERIALIZATION_NVP(metadata_cache_capacity_);
         }
 
+        if (version >= 16)
+        {
+            ar & BOOST_SERIALIZATION_NVP(weed_algorithm_);
+        }
+        else
+        {
+            weed_algorithm_ = youtils::WeedAlgorithm::Md5;
+        }
+
         // cf. comment in constructor.
         Namespace tmp = backend::Namespace(ns_);
     }
@@ -440,9 +454,9 @@ private:
     {
         using namespace boost::serialization;
 
-        if (version != 15)
+        if (version != 16)
         {
-            THROW_SERIALIZATION_ERROR(version, 15, 15);
+            THROW_SERIALIZATION_ERROR(version, 16, 16);
         }
 
         ar & BOOST_SERIALIZATION_NVP(id_);
@@ -467,6 +481,7 @@ private:
         ar & BOOST_SERIALIZATION_NVP(owner_tag_);
         ar & BOOST_SERIALIZATION_NVP(cluster_cache_limit_);
         ar & BOOST_SERIALIZATION_NVP(metadata_cache_capacity_);
+        ar & BOOST_SERIALIZATION_NVP(weed_algorithm_);
     }
 };
 
@@ -492,7 +507,7 @@ struct EnumTraits<volumedriver::VolumeConfig::WanBackupVolumeRole>
 
 }
 
-BOOST_CLASS_VERSION(volumedriver::VolumeConfig, 15);
+BOOST_CLASS_VERSION(volumedriver::VolumeConfig, 16);
 
 #endif /* !VOLUMECONFIG_H_ */
 
@@ -82,6 +82,7 @@ public:
         , C(cluster_cache_behaviour_)
         , C(cluster_cache_mode_)
         , C(cluster_cache_limit_)
+        , C(weed_algorithm_)
         , C(metadata_cache_capacity_)
     {}
 
@@ -103,6 +104,7 @@ public:
         , M(cluster_cache_behaviour_)
         , M(cluster_cache_mode_)
         , M(cluster_cache_limit_)
+        , M(weed_algorithm_)
         , M(metadata_cache_capacity_)
     {}
 
@@ -146,6 +148,7 @@ private:                                        \
     OPTIONAL_PARAM(ClusterCacheBehaviour, cluster_cache_behaviour);
     OPTIONAL_PARAM(ClusterCacheMode, cluster_cache_mode);
     OPTIONAL_PARAM(ClusterCount, cluster_cache_limit);
+    PARAM(youtils::WeedAlgorithm, weed_algorithm) = youtils::WeedAlgorithm::Md5;
     OPTIONAL_PARAM(uint32_t, metadata_cache_capacity);
 
 #undef OPTIONAL_PARAM
@@ -204,6 +207,7 @@ struct VanillaVolumeConfigParameters
     SETTER(cluster_cache_behaviour);
     SETTER(cluster_cache_mode);
     SETTER(cluster_cache_limit);
+    SETTER(weed_algorithm);
     SETTER(sco_multiplier);
     SETTER(tlog_multiplier);
     SETTER(max_non_disposable_factor);
@@ -243,6 +247,7 @@ struct CloneVolumeConfigParameters
     SETTER(cluster_cache_behaviour);
     SETTER(cluster_cache_mode);
     SETTER(cluster_cache_limit);
+    SETTER(weed_algorithm);
     SETTER(metadata_cache_capacity);
     SETTER(metadata_backend_config);
 };
@@ -210,6 +210,13 @@ DEFINE_INITIALIZED_PARAM_WITH_DEFAULT(metadata_mds_slave_max_tlogs_behind,
                                       ShowDocumentation::T,
                                       50);
 
+DEFINE_INITIALIZED_PARAM_WITH_DEFAULT(metadata_mds_push_to_slaves,
+                                      volmanager_component_name,
+                                      "metadata_mds_push_to_slaves",
+                                      "whether the MDS master streams metadata updates to the slaves instead of leaving them to poll the backend for TLogs",
+                                      ShowDocumentation::T,
+                                      false);
+
 DEFINE_INITIALIZED_PARAM_WITH_DEFAULT(debug_metadata_path,
                                       volmanager_component_name,
                                       "no_python_name",
@@ -231,6 +238,41 @@ DEFINE_INITIALIZED_PARAM_WITH_DEFAULT(volume_nullio,
                                       ShowDocumentation::F,
                                       false);
 
+DEFINE_INITIALIZED_PARAM_WITH_DEFAULT(partial_read_threads,
+                                      volmanager_component_name,
+                                      "partial_read_threads",
+                                      "Number of threads that issue backend partial reads on behalf of read requests (0: partial reads are issued sequentially by the reading thread)",
+                                      ShowDocumentation::T,
+                                      16);
+
+DEFINE_INITIALIZED_PARAM_WITH_DEFAULT(max_concurrent_partial_reads,
+                                      volmanager_component_name,
+                                      "max_concurrent_partial_reads",
+                                      "Maximum number of backend partial reads (one per SCO) a single read request issues concurrently (1: sequentially)",
+                                      ShowDocumentation::T,
+                                      8);
+
+DEFINE_INITIALIZED_PARAM_WITH_DEFAULT(compact_backend_tlogs,
+                                      volmanager_component_name,
+                                      "compact_backend_tlogs",
+                                      "Store TLogs delta / varint encoded on the backend. Such TLogs cannot be read by versions without support for the compact encoding",
+                                      ShowDocumentation::T,
+                                      false);
+
+DEFINE_INITIALIZED_PARAM_WITH_DEFAULT(read_ahead_max_scos,
+                                      volmanager_component_name,
+                                      "read_ahead_max_scos",
+                                      "Maximum size of the window (in SCOs) that is fetched into the SCO cache ahead of a sequential reader (0: no read ahead)",
+                                      ShowDocumentation::T,
+                                      0);
+
+DEFINE_INITIALIZED_PARAM_WITH_DEFAULT(read_ahead_trigger,
+                                      volmanager_component_name,
+                                      "read_ahead_trigger",
+                                      "Number of consecutive sequential read requests that start read ahead",
+                                      ShowDocumentation::T,
+                                      4);
+
 const char scocache_component_name[] = "scocache";
 
 DEFINE_INITIALIZED_PARAM_WITH_DEFAULT(datastore_throttle_usecs,
@@ -290,7 +332,7 @@ DEFINE_INITIALIZED_PARAM_WITH_DEFAULT(serialize_read_cache,
 DEFINE_INITIALIZED_PARAM_WITH_DEFAULT(clustercache_mount_points,
                                       kak_component_name,
                                       "clustercache_devices",
-                                      "An array of directories and sizes to be used as Read Cache mount points",
+                                      "An array of directories and sizes (and optionally an io_mode: Buffered (default) or DirectAsync) to be used as Read Cache mount points",
                                       ShowDocumentation::T,
                                       vd::MountPointConfigs());
 
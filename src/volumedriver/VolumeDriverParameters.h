@@ -72,6 +72,8 @@ DECLARE_RESETTABLE_INITIALIZED_PARAM_WITH_DEFAULT(allow_inconsistent_partial_rea
                                                   std::atomic<bool>);
 DECLARE_RESETTABLE_INITIALIZED_PARAM_WITH_DEFAULT(metadata_mds_slave_max_tlogs_behind,
                                                   uint32_t);
+DECLARE_RESETTABLE_INITIALIZED_PARAM_WITH_DEFAULT(metadata_mds_push_to_slaves,
+                                                  std::atomic<bool>);
 
 DECLARE_INITIALIZED_PARAM_WITH_DEFAULT(number_of_scos_in_tlog,
                                        uint32_t);
@@ -88,6 +90,17 @@ DECLARE_INITIALIZED_PARAM_WITH_DEFAULT(arakoon_metadata_sequence_size, uint32_t)
 DECLARE_INITIALIZED_PARAM_WITH_DEFAULT(volume_nullio,
                                        bool);
 
+DECLARE_INITIALIZED_PARAM_WITH_DEFAULT(partial_read_threads,
+                                       uint32_t);
+DECLARE_RESETTABLE_INITIALIZED_PARAM_WITH_DEFAULT(max_concurrent_partial_reads,
+                                                  std::atomic<uint32_t>);
+DECLARE_RESETTABLE_INITIALIZED_PARAM_WITH_DEFAULT(compact_backend_tlogs,
+                                                  std::atomic<bool>);
+DECLARE_RESETTABLE_INITIALIZED_PARAM_WITH_DEFAULT(read_ahead_max_scos,
+                                                  std::atomic<uint32_t>);
+DECLARE_RESETTABLE_INITIALIZED_PARAM_WITH_DEFAULT(read_ahead_trigger,
+                                                  std::atomic<uint32_t>);
+
 extern const char threadpool_component_name[];
 DECLARE_RESETTABLE_INITIALIZED_PARAM_WITH_DEFAULT(num_threads, uint32_t);
 
@@ -142,12 +142,18 @@ make_metadata_store(const VolumeConfig& config,
                          return VolManager::get()->mds_slave_max_tlogs_behind();
                      });
 
+            auto push_fun([]() -> bool
+                          {
+                              return VolManager::get()->metadata_mds_push_to_slaves.value();
+                          });
+
             return std::unique_ptr<MetaDataStoreInterface>(new MDSMetaDataStore(mcfg,
                                                                                 std::move(bi),
                                                                                 home,
                                                                                 owner_tag,
                                                                                 num_pages_cached,
-                                                                                std::move(fun)));
+                                                                                std::move(fun),
+                                                                                std::move(push_fun)));
         }
     }
 
@@ -321,6 +321,7 @@ WriteOnlyVolume::write(const Lba lba,
 
     const auto duration_us(bc::duration_cast<bc::microseconds>(t.elapsed()));
     performance_counters().write_request_usecs.count(duration_us.count());
+    performance_counters().write_latency.record(duration_us.count());
 
     VERIFY(off == len);
 }
@@ -15,6 +15,7 @@
 
 #include "BackendFactory.h"
 #include "FileBackend.h"
+#include "LogBackend.h"
 #include "MemoryBackend.h"
 
 namespace failovercache
@@ -28,6 +29,7 @@ namespace
 {
 
 const std::string safetyfile(".failovercache");
+const std::string segmentdir(".segments");
 
 const boost::optional<fs::path>&
 maybe_make_dir(const boost::optional<fs::path>& p)
@@ -43,7 +45,8 @@ maybe_make_dir(const boost::optional<fs::path>& p)
 }
 
 BackendFactory::BackendFactory(const boost::optional<fs::path>& path,
-                               const boost::optional<size_t> file_backend_buffer_size)
+                               const boost::optional<size_t> file_backend_buffer_size,
+                               const boost::optional<size_t> log_segment_size)
     : root_(maybe_make_dir(path))
     , file_backend_buffer_size_(file_backend_buffer_size)
 {
@@ -84,6 +87,12 @@ BackendFactory::BackendFactory(const boost::optional<fs::path>& path,
                 LOG_INFO("Not removing " << it->path());
             }
         }
+
+        if (log_segment_size and *log_segment_size > 0)
+        {
+            log_ = std::make_shared<SegmentLog>(*root_ / segmentdir,
+                                                *log_segment_size);
+        }
     }
 }
 
@@ -108,7 +117,13 @@ std::unique_ptr<Backend>
 BackendFactory::make_backend(const std::string& nspace,
                              const vd::ClusterSize csize)
 {
-    if (root_)
+    if (log_)
+    {
+        return std::make_unique<LogBackend>(log_,
+                                            nspace,
+                                            csize);
+    }
+    else if (root_)
     {
         return std::make_unique<FileBackend>(*root_,
                                              nspace,
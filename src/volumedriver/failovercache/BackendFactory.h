@@ -14,6 +14,7 @@
 // but WITHOUT ANY WARRANTY of any kind.
 
 #include "Backend.h"
+#include "SegmentLog.h"
 
 #include <boost/filesystem.hpp>
 
@@ -27,7 +28,8 @@ class BackendFactory
 {
 public:
     BackendFactory(const boost::optional<boost::filesystem::path>&,
-                   const boost::optional<size_t> file_backend_buffer_size);
+                   const boost::optional<size_t> file_backend_buffer_size,
+                   const boost::optional<size_t> log_segment_size = boost::none);
 
     ~BackendFactory();
 
@@ -48,6 +50,10 @@ private:
 
     const boost::optional<boost::filesystem::path> root_;
     const boost::optional<size_t> file_backend_buffer_size_;
+
+    // Only set if the log structured file backend is used. Shared with the
+    // LogBackends which might outlive the factory.
+    std::shared_ptr<SegmentLog> log_;
 };
 
 }
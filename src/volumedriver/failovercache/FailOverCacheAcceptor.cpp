@@ -33,13 +33,23 @@ using namespace fungi;
 
 FailOverCacheAcceptor::FailOverCacheAcceptor(const boost::optional<fs::path>& path,
                                              const boost::optional<size_t> file_backend_buffer_size,
-                                             const boost::chrono::microseconds busy_loop_duration)
-    : factory_(path, file_backend_buffer_size)
+                                             const boost::chrono::microseconds busy_loop_duration,
+                                             const unsigned reactor_threads,
+                                             const boost::optional<size_t> log_segment_size)
+    : factory_(path, file_backend_buffer_size, log_segment_size)
     , busy_loop_duration_(busy_loop_duration)
-{}
+{
+    if (reactor_threads > 0)
+    {
+        reactor_ = std::make_unique<FailOverCacheReactor>(*this,
+                                                          reactor_threads);
+    }
+}
 
 FailOverCacheAcceptor::~FailOverCacheAcceptor()
 {
+    reactor_.reset();
+
     int count = 0;
     {
         LOCK();
@@ -65,6 +75,13 @@ Protocol*
 FailOverCacheAcceptor::createProtocol(std::unique_ptr<fungi::Socket> s,
                                       fungi::SocketServer& parentServer)
 {
+    // rsockets cannot be used with epoll
+    if (reactor_ and not s->isRdma())
+    {
+        reactor_->add(std::move(s));
+        return &reactor_connection_;
+    }
+
     LOCK();
     protocols.push_back(new FailOverCacheProtocol(std::move(s),
                                                   parentServer,
@@ -17,6 +17,7 @@
 #define FAILOVERCACHEACCEPTOR_H
 
 #include "FailOverCacheProtocol.h"
+#include "FailOverCacheReactor.h"
 #include "BackendFactory.h"
 
 #include "../FailOverCacheStreamers.h"
@@ -47,7 +48,9 @@ class FailOverCacheAcceptor
 public:
     FailOverCacheAcceptor(const boost::optional<boost::filesystem::path>& root,
                           const boost::optional<size_t> file_backend_buffer_size,
-                          const boost::chrono::microseconds busy_loop_duration);
+                          const boost::chrono::microseconds busy_loop_duration,
+                          const unsigned reactor_threads = 0,
+                          const boost::optional<size_t> log_segment_size = boost::none);
 
     virtual ~FailOverCacheAcceptor();
 
@@ -89,6 +92,32 @@ private:
     BackendFactory factory_;
     const boost::chrono::microseconds busy_loop_duration_;
 
+    // Handed back to the SocketServer for connections that are taken over by
+    // the reactor.
+    struct ReactorConnection
+        : public fungi::Protocol
+    {
+        virtual void
+        start() override final
+        {}
+
+        virtual void
+        run() override final
+        {}
+
+        virtual const char*
+        getName() const override final
+        {
+            return "FailOverCacheReactorConnection";
+        }
+    };
+
+    ReactorConnection reactor_connection_;
+
+    // Serves TCP connections if configured, otherwise each connection gets
+    // a FailOverCacheProtocol.
+    std::unique_ptr<FailOverCacheReactor> reactor_;
+
     // for use by testers
     BackendPtr
     find_backend_(const std::string&);
@@ -15,8 +15,7 @@
 
 #include "FailOverCacheAcceptor.h"
 #include "FailOverCacheProtocol.h"
-#include "FailOverCacheStreamers.h"
-#include "fungilib/WrapByteArray.h"
+#include "Backend.h"
 #include "fungilib/use_rs.h"
 
 #include <signal.h>
@@ -30,7 +29,6 @@
 #include <rdma/rsocket.h>
 
 #include <youtils/Assert.h>
-#include <youtils/ScopeExit.h>
 #include <youtils/Timer.h>
 
 namespace failovercache
@@ -46,6 +44,8 @@ FailOverCacheProtocol::FailOverCacheProtocol(std::unique_ptr<fungi::Socket> sock
     : sock_(std::move(sock))
     , stream_(*sock_)
     , fact_(fact)
+    , handler_(stream_,
+               fact_)
     , use_rs_(sock_->isRdma())
     , stop_(false)
     , busy_loop_duration_(busy_loop_duration)
@@ -179,73 +179,17 @@ FailOverCacheProtocol::run()
                     break;
                 });
 
-            switch (com)
-            {
-            case volumedriver::Register:
-                LOG_TRACE("Executing Register");
-                register_();
-                LOG_TRACE("Finished Register");
-                break;
-
-            case volumedriver::Unregister:
-                LOG_TRACE("Executing Unregister");
-                unregister_();
-                LOG_TRACE("Finished Unregister");
-                break;
-
-            case volumedriver::AddEntries:
-                LOG_TRACE("Executing AddEntries");
-                addEntries_();
-                LOG_TRACE("Finished AddEntries");
-                break;
-            case volumedriver::GetEntries:
-                LOG_TRACE("Executing GetEntries");
-                getEntries_();
-                LOG_TRACE("Finished GetEntries");
-                break;
-            case volumedriver::Flush:
-                LOG_TRACE("Executing Flush");
-                Flush_();
-                LOG_TRACE("Finished Flush");
-                break;
-
-            case volumedriver::Clear:
-                LOG_TRACE("Executing Clear");
-                Clear_();
-                LOG_TRACE("Finished Clear");
-                break;
-
-            case volumedriver::GetSCORange:
-                LOG_TRACE("Executing GetSCORange");
-                getSCORange_();
-                LOG_TRACE("Finished GetSCORange");
-                break;
-
-            case volumedriver::GetSCO:
-                LOG_TRACE("Executing GetSCO");
-                getSCO_();
-                LOG_TRACE("Finished GetSCO");
-                break;
-            case volumedriver::RemoveUpTo:
-                LOG_TRACE("Executing RemoveUpTo");
-                removeUpTo_();
-                LOG_TRACE("Finished RemoveUpTo");
-
-                break;
-            default:
-                LOG_ERROR("DEFAULT BRANCH IN SWITCH...");
-                throw fungi :: IOException("no valid command");
-            }
+            handler_.handle(com);
         }
     }
     CATCH_STD_ALL_EWHAT({
             LOG_ERROR("Exception in thread: " << EWHAT);
-            returnNotOk();
+            handler_.returnNotOk();
         });
 
-    if(cache_)
+    if(handler_.backend())
     {
-        LOG_INFO("Exiting cache server for namespace: " << cache_->getNamespace());
+        LOG_INFO("Exiting cache server for namespace: " << handler_.backend()->getNamespace());
     }
     else
     {
@@ -253,227 +197,6 @@ FailOverCacheProtocol::run()
     }
 }
 
-void
-FailOverCacheProtocol::register_()
-{
-    volumedriver::CommandData<volumedriver::Register> data;
-    stream_ >> data;
-
-    LOG_INFO("Registering namespace " << data.ns_);
-    cache_ = fact_.lookup(data);
-    if(not cache_)
-    {
-        returnNotOk();
-    }
-    else
-    {
-        VERIFY(cache_->registered());
-        returnOk();
-    }
-}
-
-void
-FailOverCacheProtocol::unregister_()
-{
-    VERIFY(cache_);
-    LOG_INFO("Unregistering namespace " << cache_->getNamespace());
-    try
-    {
-        // cache_->unregister_();
-        fact_.remove(*cache_);
-        cache_ = nullptr;
-        stream_ << fungi::IOBaseStream::cork;
-        OUT_ENUM(stream_,volumedriver::Ok);
-        stream_ << fungi::IOBaseStream::uncork;
-    }
-    catch(...)
-    {
-        stream_ << fungi::IOBaseStream::cork;
-        OUT_ENUM(stream_, volumedriver::NotOk);
-        stream_ << fungi::IOBaseStream::uncork;
-    }
-
-}
-
-void
-FailOverCacheProtocol::addEntries_()
-{
-    VERIFY(cache_);
-
-    volumedriver::CommandData<volumedriver::AddEntries> data;
-    stream_ >> data;
-
-    // TODO: consider preventing empty AddEntries requests
-    if (data.entries_.empty())
-    {
-        VERIFY(data.buf_ == nullptr);
-    }
-    else
-    {
-        VERIFY(data.buf_ != nullptr);
-        cache_->addEntries(std::move(data.entries_),
-                           std::move(data.buf_));
-    }
-
-    returnOk();
-}
-
-void
-FailOverCacheProtocol::returnOk()
-{
-    stream_ << fungi::IOBaseStream::cork;
-    OUT_ENUM(stream_, volumedriver::Ok);
-    stream_ << fungi::IOBaseStream::uncork;
-}
-
-void
-FailOverCacheProtocol::returnNotOk()
-{
-    stream_ << fungi::IOBaseStream::cork;
-    OUT_ENUM(stream_, volumedriver::NotOk);
-    stream_ << fungi::IOBaseStream::uncork;
-}
-
-void
-FailOverCacheProtocol::Flush_()
-{
-    VERIFY(cache_);
-    LOG_TRACE("Flushing for namespace " <<  cache_->getNamespace());
-    cache_->flush();
-    returnOk();
-}
-
-void
-FailOverCacheProtocol::Clear_()
-{
-    VERIFY(cache_);
-    LOG_INFO("Clearing for namespace " << cache_->getNamespace());
-    cache_->clear();
-    returnOk();
-}
-
-void
-FailOverCacheProtocol::processFailOverCacheEntry_(volumedriver::ClusterLocation cli,
-                                                  int64_t lba,
-                                                  const byte* buf,
-                                                  int64_t size,
-                                                  bool cork)
-{
-    LOG_TRACE("Sending Entry for lba " << lba);
-    if (cork)
-    {
-        stream_ << fungi::IOBaseStream::cork;
-    }
-    stream_ << cli;
-    stream_ << lba;
-    const fungi::WrapByteArray a((byte*)buf, (int32_t)size);
-    stream_ << a;
-    if (cork)
-    {
-        stream_ << fungi::IOBaseStream::uncork;
-    }
-}
-
-void
-FailOverCacheProtocol::removeUpTo_()
-{
-    VERIFY(cache_);
-    LOG_INFO("Namespace " << cache_->getNamespace());
-
-
-    volumedriver::SCO sconame;
-
-    stream_ >> sconame;
-    try
-    {
-        cache_->removeUpTo(sconame);
-        returnOk();
-    }
-    CATCH_STD_ALL_EWHAT({
-            LOG_ERROR(cache_->getNamespace() <<
-                      ": caught exception removing SCOs up to " <<
-                      sconame << ": " << EWHAT);
-            returnNotOk();
-        });
-}
-
-void
-FailOverCacheProtocol::getEntries_()
-{
-    VERIFY(cache_);
-    LOG_INFO("Namespace " <<  cache_->getNamespace());
-
-    auto on_exit(yt::make_scope_exit([&]
-    {
-        try
-        {
-            stream_ << fungi::IOBaseStream::cork;
-            volumedriver::ClusterLocation end_cli;
-            stream_ << end_cli;
-            stream_ << fungi::IOBaseStream::uncork;
-        }
-        CATCH_STD_ALL_LOGLEVEL_IGNORE("Could not send eof data to FOC at the other end",
-                                      WARN);
-    }));
-
-    cache_->getEntries(boost::bind(&FailOverCacheProtocol::processFailOverCacheEntry_,
-                                   this,
-                                   _1,
-                                   _2,
-                                   _3,
-                                   _4,
-                                   true));
-}
-
-void
-FailOverCacheProtocol::getSCO_()
-{
-    VERIFY(cache_);
-    LOG_INFO("Namespace" << cache_->getNamespace());
-    SCO scoName;
-
-    stream_ >> scoName;
-
-    auto on_exit(yt::make_scope_exit([&]
-    {
-        try
-        {
-            volumedriver::ClusterLocation end_cli;
-            stream_ << end_cli;
-            stream_ << fungi::IOBaseStream::uncork;
-        }
-        CATCH_STD_ALL_LOGLEVEL_IGNORE("Could not send eof data to FOC at the other end",
-                                      WARN);
-    }));
-
-    stream_ << fungi::IOBaseStream::cork;
-    cache_->getSCO(scoName,
-                   boost::bind(&FailOverCacheProtocol::processFailOverCacheEntry_,
-                               this,
-                               _1,
-                               _2,
-                               _3,
-                               _4,
-                               false));
-}
-
-void
-FailOverCacheProtocol::getSCORange_()
-{
-    VERIFY(cache_);
-    LOG_INFO("Namespace" << cache_->getNamespace());
-    SCO oldest;
-    SCO youngest;
-    cache_->getSCORange(oldest,
-                        youngest);
-
-    stream_ << fungi::IOBaseStream::cork;
-    stream_ << oldest;
-    stream_ << youngest;
-
-    stream_ << fungi::IOBaseStream::uncork;
-}
-
 }
 
 // Local Variables: **
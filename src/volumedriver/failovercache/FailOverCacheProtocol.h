@@ -16,6 +16,8 @@
 #ifndef FAILOVERCACHEPROTOCOL_H
 #define FAILOVERCACHEPROTOCOL_H
 
+#include "FailOverCacheRequestHandler.h"
+
 #include "fungilib/Protocol.h"
 #include "fungilib/Socket.h"
 #include "fungilib/SocketServer.h"
@@ -59,56 +61,16 @@ public:
 private:
     DECLARE_LOGGER("FailOverCacheProtocol");
 
-    std::shared_ptr<Backend> cache_;
     std::unique_ptr<fungi::Socket> sock_;
     fungi::IOBaseStream stream_;
     fungi::Thread* thread_;
     FailOverCacheAcceptor& fact_;
+    FailOverCacheRequestHandler handler_;
     bool use_rs_;
     std::atomic<bool> stop_;
     int pipes_[2];
     boost::chrono::microseconds busy_loop_duration_;
 
-    void
-    addEntries_();
-
-    void
-    getEntries_();
-
-    void
-    Flush_();
-
-    void
-    register_();
-
-    void
-    unregister_();
-
-    void
-    getSCO_();
-
-    void
-    getSCORange_();
-
-    void
-    Clear_();
-
-    void
-    returnOk();
-
-    void
-    returnNotOk();
-
-    void
-    removeUpTo_();
-
-    void
-    processFailOverCacheEntry_(volumedriver::ClusterLocation cli,
-                               int64_t lba,
-                               const byte* buf,
-                               int64_t size,
-                               bool cork);
-
     bool
     poll_(int32_t& cmd);
 };
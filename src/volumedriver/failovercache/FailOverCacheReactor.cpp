@@ -0,0 +1,842 @@
+// Copyright (C) 2016 iNuron NV
+//
+// This file is part of Open vStorage Open Source Edition (OSE),
+// as available from
+//
+//      http://www.openvstorage.org and
+//      http://www.openvstorage.com.
+//
+// This file is free software; you can redistribute it and/or modify it
+// under the terms of the GNU Affero General Public License v3 (GNU AGPLv3)
+// as published by the Free Software Foundation, in version 3 as it comes in
+// the LICENSE.txt file of the Open vStorage OSE distribution.
+// Open vStorage is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY of any kind.
+
+#include "Backend.h"
+#include "FailOverCacheAcceptor.h"
+#include "FailOverCacheReactor.h"
+#include "FailOverCacheRequestHandler.h"
+
+#include "fungilib/Conversions.h"
+#include "fungilib/IOBaseStream.h"
+#include "fungilib/Socket.h"
+#include "fungilib/Streamable.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <functional>
+#include <thread>
+#include <unordered_map>
+
+#include <boost/thread/lock_guard.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <youtils/Assert.h>
+#include <youtils/Catchers.h>
+
+namespace failovercache
+{
+
+using namespace fungi;
+
+namespace
+{
+
+// Input is read in chunks of at least this size.
+const size_t recv_chunk_size = 256ULL << 10;
+
+// Responses are usually sent once all received requests were processed. Large
+// ones (GetEntries / GetSCO) are pushed out as far as the socket takes them as
+// soon as they exceed this size, and no further requests are processed until
+// the output dropped below it again.
+const size_t send_threshold = 4ULL << 20;
+
+// Upper bound for the size of a request - well above an AddEntries of
+// dtl_queue_depth clusters - so a bogus length cannot make us buffer
+// arbitrary amounts of data.
+const int32_t max_request_size = 64 << 20;
+
+// fungi::Streamable on in-memory buffers that uses the same framing as
+// fungi::Socket does for TCP: each corked chunk is preceded by its length.
+// Requests are handed in one frame at a time, responses are collected in out_.
+class FrameStream
+    : public Streamable
+{
+public:
+    using FlushFun = std::function<void()>;
+
+    explicit FrameStream(FlushFun fun)
+        : flush_fun_(std::move(fun))
+    {}
+
+    ~FrameStream() = default;
+
+    FrameStream(const FrameStream&) = delete;
+
+    FrameStream&
+    operator=(const FrameStream&) = delete;
+
+    void
+    set_request(const byte* buf,
+                int32_t size)
+    {
+        req_ = buf;
+        req_size_ = size;
+        req_off_ = 0;
+    }
+
+    virtual int32_t
+    read(byte* buf, int32_t n) override final
+    {
+        if (n < 0 or req_size_ - req_off_ < n)
+        {
+            throw IOException("FrameStream: read beyond end of request");
+        }
+
+        memcpy(buf, req_ + req_off_, n);
+        req_off_ += n;
+        return n;
+    }
+
+    virtual int32_t
+    write(const byte* buf, int32_t n) override final
+    {
+        out_.insert(out_.end(), buf, buf + n);
+        return n;
+    }
+
+    virtual void
+    setCork() override final
+    {
+        VERIFY(not corked_);
+        corked_ = true;
+        cork_pos_ = out_.size();
+        out_.resize(out_.size() + Conversions::intSize);
+    }
+
+    virtual void
+    clearCork() override final
+    {
+        VERIFY(corked_);
+        corked_ = false;
+        Conversions::bytesFromInt(out_.data() + cork_pos_,
+                                  out_.size() - cork_pos_ - Conversions::intSize);
+        if (pending() >= send_threshold)
+        {
+            flush_fun_();
+        }
+    }
+
+    virtual void
+    getCork() override final
+    {
+        // requests are deframed by the reactor
+    }
+
+    virtual void
+    setRequestTimeout(double) override final
+    {}
+
+    virtual void
+    close() override final
+    {
+        closed_ = true;
+    }
+
+    virtual void
+    closeNoThrow() override final
+    {
+        closed_ = true;
+    }
+
+    virtual bool
+    isClosed() const override final
+    {
+        return closed_;
+    }
+
+    size_t
+    pending() const
+    {
+        return out_.size() - out_off_;
+    }
+
+    const byte*
+    pending_data() const
+    {
+        return out_.data() + out_off_;
+    }
+
+    void
+    consumed(size_t n)
+    {
+        ASSERT(n <= pending());
+        out_off_ += n;
+        if (out_off_ == out_.size() and not corked_)
+        {
+            out_.clear();
+            out_off_ = 0;
+        }
+    }
+
+private:
+    FlushFun flush_fun_;
+
+    const byte* req_ = nullptr;
+    int32_t req_size_ = 0;
+    int32_t req_off_ = 0;
+
+    std::vector<byte> out_;
+    size_t out_off_ = 0;
+    size_t cork_pos_ = 0;
+    bool corked_ = false;
+    bool closed_ = false;
+};
+
+}
+
+class FailOverCacheReactor::Connection
+{
+public:
+    Connection(std::unique_ptr<Socket> sock,
+               FailOverCacheAcceptor& acceptor)
+        : sock_(std::move(sock))
+        , stream_([this]
+                  {
+                      if (not send())
+                      {
+                          throw IOException("FailOverCacheReactor: failed to send response");
+                      }
+                  })
+        , io_(stream_)
+        , handler_(io_,
+                   acceptor)
+    {
+        sock_->setNonBlocking();
+    }
+
+    ~Connection() = default;
+
+    Connection(const Connection&) = delete;
+
+    Connection&
+    operator=(const Connection&) = delete;
+
+    int
+    fd() const
+    {
+        return sock_->fileno();
+    }
+
+    // false: connection is to be closed
+    bool
+    receive()
+    {
+        if (in_.size() - in_end_ < recv_chunk_size)
+        {
+            in_.resize(in_end_ + recv_chunk_size);
+        }
+
+        while (true)
+        {
+            const ssize_t r = ::recv(fd(),
+                                     in_.data() + in_end_,
+                                     in_.size() - in_end_,
+                                     0);
+            if (r > 0)
+            {
+                in_end_ += r;
+                return true;
+            }
+            else if (r == 0)
+            {
+                LOG_INFO(name_() << ": connection closed by peer");
+                return false;
+            }
+            else if (errno == EAGAIN or errno == EWOULDBLOCK)
+            {
+                return true;
+            }
+            else if (errno != EINTR)
+            {
+                LOG_ERROR(name_() << ": failed to receive: " << strerror(errno));
+                return false;
+            }
+        }
+    }
+
+    enum class Status
+    {
+        Ok,
+        Close,
+        Registered,
+    };
+
+    // Executes the completely received requests. Stops after a (successful)
+    // registration as the connection might have to move to another loop.
+    Status
+    process()
+    {
+        Status status = Status::Ok;
+
+        while (in_end_ - in_begin_ >= static_cast<size_t>(Conversions::intSize))
+        {
+            // the rest has to wait until the client picked up its responses
+            if (stream_.pending() >= send_threshold)
+            {
+                break;
+            }
+
+            int32_t len = 0;
+            Conversions::intFromBytes(len,
+                                      in_.data() + in_begin_);
+            if (len < Conversions::intSize or len > max_request_size)
+            {
+                LOG_ERROR(name_() << ": invalid request size " << len);
+                return Status::Close;
+            }
+
+            const size_t frame_size = Conversions::intSize + len;
+            if (in_end_ - in_begin_ < frame_size)
+            {
+                break;
+            }
+
+            const bool was_registered = handler_.backend() != nullptr;
+
+            try
+            {
+                stream_.set_request(in_.data() + in_begin_ + Conversions::intSize,
+                                    len);
+                int32_t cmd;
+                io_ >> cmd;
+                handler_.handle(cmd);
+            }
+            CATCH_STD_ALL_EWHAT({
+                    LOG_ERROR(name_() << ": exception processing request: " << EWHAT);
+                    try
+                    {
+                        handler_.returnNotOk();
+                    }
+                    CATCH_STD_ALL_LOG_IGNORE(name_() << ": failed to return NotOk");
+                    status = Status::Close;
+                });
+
+            in_begin_ += frame_size;
+
+            if (status == Status::Close)
+            {
+                break;
+            }
+
+            if (not was_registered and handler_.backend())
+            {
+                status = Status::Registered;
+                break;
+            }
+        }
+
+        compact_();
+        return status;
+    }
+
+    // Sends as much of the pending output as possible without blocking.
+    // false: connection is to be closed
+    bool
+    send()
+    {
+        while (stream_.pending() > 0)
+        {
+            const ssize_t r = ::send(fd(),
+                                     stream_.pending_data(),
+                                     stream_.pending(),
+                                     MSG_NOSIGNAL);
+            if (r >= 0)
+            {
+                stream_.consumed(r);
+            }
+            else if (errno == EAGAIN or errno == EWOULDBLOCK)
+            {
+                break;
+            }
+            else if (errno != EINTR)
+            {
+                LOG_ERROR(name_() << ": failed to send: " << strerror(errno));
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool
+    output_pending() const
+    {
+        return stream_.pending() > 0;
+    }
+
+    const std::shared_ptr<Backend>&
+    backend() const
+    {
+        return handler_.backend();
+    }
+
+    uint32_t events = 0;
+
+private:
+    DECLARE_LOGGER("FailOverCacheReactorConnection");
+
+    std::unique_ptr<Socket> sock_;
+    FrameStream stream_;
+    IOBaseStream io_;
+    FailOverCacheRequestHandler handler_;
+
+    std::vector<byte> in_;
+    size_t in_begin_ = 0;
+    size_t in_end_ = 0;
+
+    std::string
+    name_() const
+    {
+        const auto& b = handler_.backend();
+        return b ? b->getNamespace() : std::string("<unregistered>");
+    }
+
+    void
+    compact_()
+    {
+        if (in_begin_ == in_end_)
+        {
+            in_begin_ = 0;
+            in_end_ = 0;
+
+            // don't hang on to the buffer a huge request required
+            if (in_.size() > 4 * recv_chunk_size)
+            {
+                std::vector<byte>().swap(in_);
+            }
+        }
+        else if (in_begin_ > 0)
+        {
+            memmove(in_.data(),
+                    in_.data() + in_begin_,
+                    in_end_ - in_begin_);
+            in_end_ -= in_begin_;
+            in_begin_ = 0;
+        }
+    }
+};
+
+class FailOverCacheReactor::Loop
+{
+public:
+    Loop(FailOverCacheReactor& reactor,
+         const size_t idx)
+        : reactor_(reactor)
+        , idx_(idx)
+        , epoll_fd_(::epoll_create1(EPOLL_CLOEXEC))
+        , event_fd_(::eventfd(0, EFD_NONBLOCK bitor EFD_CLOEXEC))
+        , stop_(false)
+    {
+        if (epoll_fd_ < 0 or event_fd_ < 0)
+        {
+            const int err = errno;
+            close_fds_();
+            throw IOException("FailOverCacheReactor: failed to create epoll / event fd",
+                              "",
+                              err);
+        }
+
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN;
+        ev.data.fd = event_fd_;
+
+        if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, event_fd_, &ev) < 0)
+        {
+            const int err = errno;
+            close_fds_();
+            throw IOException("FailOverCacheReactor: failed to add event fd to epoll",
+                              "",
+                              err);
+        }
+
+        thread_ = std::thread([this]
+                              {
+                                  run_();
+                              });
+    }
+
+    ~Loop()
+    {
+        stop();
+
+        conns_.clear();
+        incoming_.clear();
+        close_fds_();
+    }
+
+    Loop(const Loop&) = delete;
+
+    Loop&
+    operator=(const Loop&) = delete;
+
+    void
+    stop()
+    {
+        if (thread_.joinable())
+        {
+            stop_ = true;
+            wakeup_();
+            thread_.join();
+        }
+    }
+
+    // thread safe
+    void
+    adopt(std::unique_ptr<Connection> conn)
+    {
+        {
+            boost::lock_guard<decltype(lock_)> g(lock_);
+            incoming_.emplace_back(std::move(conn));
+        }
+
+        wakeup_();
+    }
+
+private:
+    DECLARE_LOGGER("FailOverCacheReactorLoop");
+
+    FailOverCacheReactor& reactor_;
+    const size_t idx_;
+    int epoll_fd_;
+    int event_fd_;
+    std::atomic<bool> stop_;
+
+    boost::mutex lock_;
+    std::vector<std::unique_ptr<Connection>> incoming_;
+
+    // only accessed from thread_
+    std::unordered_map<int, std::unique_ptr<Connection>> conns_;
+
+    std::thread thread_;
+
+    void
+    close_fds_()
+    {
+        if (event_fd_ >= 0)
+        {
+            ::close(event_fd_);
+            event_fd_ = -1;
+        }
+
+        if (epoll_fd_ >= 0)
+        {
+            ::close(epoll_fd_);
+            epoll_fd_ = -1;
+        }
+    }
+
+    void
+    wakeup_()
+    {
+        const uint64_t one = 1;
+        if (::write(event_fd_, &one, sizeof(one)) < 0)
+        {
+            LOG_ERROR("loop " << idx_ << ": failed to signal event fd: " <<
+                      strerror(errno));
+        }
+    }
+
+    void
+    pin_()
+    {
+        const unsigned ncpus = std::thread::hardware_concurrency();
+        if (ncpus == 0)
+        {
+            return;
+        }
+
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(idx_ % ncpus, &set);
+
+        const int ret = pthread_setaffinity_np(pthread_self(),
+                                               sizeof(set),
+                                               &set);
+        if (ret != 0)
+        {
+            LOG_WARN("loop " << idx_ << ": failed to pin thread to CPU " <<
+                     (idx_ % ncpus) << ": " << strerror(ret));
+        }
+    }
+
+    void
+    run_()
+    {
+        pin_();
+
+        LOG_INFO("loop " << idx_ << ": running");
+
+        std::vector<struct epoll_event> events(64);
+
+        while (not stop_)
+        {
+            const int n = ::epoll_wait(epoll_fd_,
+                                       events.data(),
+                                       events.size(),
+                                       -1);
+            if (n < 0)
+            {
+                if (errno != EINTR)
+                {
+                    LOG_ERROR("loop " << idx_ << ": epoll_wait failed: " <<
+                              strerror(errno));
+                }
+                continue;
+            }
+
+            for (int i = 0; i < n; ++i)
+            {
+                if (events[i].data.fd == event_fd_)
+                {
+                    uint64_t val;
+                    while (::read(event_fd_, &val, sizeof(val)) > 0)
+                    {}
+
+                    adopt_incoming_();
+                }
+                else
+                {
+                    handle_(events[i].data.fd,
+                            events[i].events);
+                }
+            }
+        }
+
+        LOG_INFO("loop " << idx_ << ": stopping, " << conns_.size() <<
+                 " connections left");
+    }
+
+    void
+    adopt_incoming_()
+    {
+        std::vector<std::unique_ptr<Connection>> incoming;
+
+        {
+            boost::lock_guard<decltype(lock_)> g(lock_);
+            std::swap(incoming,
+                      incoming_);
+        }
+
+        for (auto& c : incoming)
+        {
+            const int fd = c->fd();
+            c->events = 0;
+
+            auto res(conns_.emplace(fd,
+                                    std::move(c)));
+            VERIFY(res.second);
+
+            // there might be buffered requests / responses already
+            service_(fd,
+                     false);
+        }
+    }
+
+    void
+    handle_(const int fd,
+            const uint32_t events)
+    {
+        auto it = conns_.find(fd);
+        if (it == conns_.end())
+        {
+            LOG_WARN("loop " << idx_ << ": event for unknown fd " << fd);
+            return;
+        }
+
+        Connection& c = *it->second;
+
+        if (events bitand EPOLLOUT)
+        {
+            if (not c.send())
+            {
+                close_(fd);
+                return;
+            }
+        }
+
+        if (events bitand (EPOLLIN bitor EPOLLERR bitor EPOLLHUP))
+        {
+            service_(fd,
+                     true);
+        }
+        else if (not c.output_pending())
+        {
+            // drained: carry on with the requests that were held back
+            service_(fd,
+                     false);
+        }
+        else
+        {
+            update_interest_(fd);
+        }
+    }
+
+    void
+    service_(const int fd,
+             const bool readable)
+    {
+        Connection& c = *conns_[fd];
+
+        if (readable and not c.receive())
+        {
+            close_(fd);
+            return;
+        }
+
+        const Connection::Status status = c.process();
+
+        if (not c.send() or status == Connection::Status::Close)
+        {
+            close_(fd);
+            return;
+        }
+
+        if (status == Connection::Status::Registered)
+        {
+            Loop& home = reactor_.shard_(c.backend()->getNamespace());
+            if (&home != this)
+            {
+                LOG_INFO("loop " << idx_ << ": handing " <<
+                         c.backend()->getNamespace() << " over to loop " <<
+                         home.idx_);
+                std::unique_ptr<Connection> conn(detach_(fd));
+                home.adopt(std::move(conn));
+                return;
+            }
+            else
+            {
+                // process the remaining requests
+                service_(fd,
+                         false);
+                return;
+            }
+        }
+
+        update_interest_(fd);
+    }
+
+    // Wait for input only if there's no output pending - this throttles
+    // clients that do not pick up their responses.
+    void
+    update_interest_(const int fd)
+    {
+        Connection& c = *conns_[fd];
+        const uint32_t events = c.output_pending() ? EPOLLOUT : EPOLLIN;
+
+        if (events != c.events)
+        {
+            struct epoll_event ev;
+            memset(&ev, 0, sizeof(ev));
+            ev.events = events;
+            ev.data.fd = fd;
+
+            const int ret = ::epoll_ctl(epoll_fd_,
+                                        c.events == 0 ? EPOLL_CTL_ADD : EPOLL_CTL_MOD,
+                                        fd,
+                                        &ev);
+            if (ret < 0)
+            {
+                LOG_ERROR("loop " << idx_ << ": failed to update epoll interest of fd " <<
+                          fd << ": " << strerror(errno));
+                close_(fd);
+                return;
+            }
+
+            c.events = events;
+        }
+    }
+
+    std::unique_ptr<Connection>
+    detach_(const int fd)
+    {
+        auto it = conns_.find(fd);
+        VERIFY(it != conns_.end());
+
+        if (it->second->events != 0)
+        {
+            ::epoll_ctl(epoll_fd_,
+                        EPOLL_CTL_DEL,
+                        fd,
+                        nullptr);
+        }
+
+        std::unique_ptr<Connection> c(std::move(it->second));
+        conns_.erase(it);
+        return c;
+    }
+
+    void
+    close_(const int fd)
+    {
+        detach_(fd);
+    }
+};
+
+FailOverCacheReactor::FailOverCacheReactor(FailOverCacheAcceptor& acceptor,
+                                           const unsigned nthreads)
+    : acceptor_(acceptor)
+    , next_(0)
+{
+    VERIFY(nthreads > 0);
+
+    loops_.reserve(nthreads);
+    for (size_t i = 0; i < nthreads; ++i)
+    {
+        loops_.emplace_back(std::make_unique<Loop>(*this,
+                                                   i));
+    }
+
+    LOG_INFO("started " << nthreads << " reactor loops");
+}
+
+FailOverCacheReactor::~FailOverCacheReactor()
+{
+    // Loops hand connections to each other, so they all need to be stopped
+    // before any one of them goes away.
+    for (auto& l : loops_)
+    {
+        l->stop();
+    }
+
+    loops_.clear();
+}
+
+void
+FailOverCacheReactor::add(std::unique_ptr<Socket> sock)
+{
+    auto c(std::make_unique<Connection>(std::move(sock),
+                                        acceptor_));
+    loops_[next_++ % loops_.size()]->adopt(std::move(c));
+}
+
+FailOverCacheReactor::Loop&
+FailOverCacheReactor::shard_(const std::string& nspace)
+{
+    return *loops_[std::hash<std::string>()(nspace) % loops_.size()];
+}
+
+}
+
+// Local Variables: **
+// mode: c++ **
+// End: **
@@ -0,0 +1,84 @@
+// Copyright (C) 2016 iNuron NV
+//
+// This file is part of Open vStorage Open Source Edition (OSE),
+// as available from
+//
+//      http://www.openvstorage.org and
+//      http://www.openvstorage.com.
+//
+// This file is free software; you can redistribute it and/or modify it
+// under the terms of the GNU Affero General Public License v3 (GNU AGPLv3)
+// as published by the Free Software Foundation, in version 3 as it comes in
+// the LICENSE.txt file of the Open vStorage OSE distribution.
+// Open vStorage is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY of any kind.
+
+#ifndef FAILOVERCACHE_REACTOR_H_
+#define FAILOVERCACHE_REACTOR_H_
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <youtils/Logging.h>
+
+namespace fungi
+{
+class Socket;
+}
+
+namespace failovercache
+{
+
+class FailOverCacheAcceptor;
+
+// Event driven alternative to a FailOverCacheProtocol (and hence a thread) per
+// client connection: a fixed number of epoll loops, each running on a thread
+// pinned to a core, serve all (TCP) connections. Once a connection registered
+// its namespace it is moved to the loop that namespace hashes to, so all work
+// for a given Backend is done on the same thread.
+// The wire protocol is the same as FailOverCacheProtocol's.
+class FailOverCacheReactor
+{
+public:
+    FailOverCacheReactor(FailOverCacheAcceptor&,
+                         const unsigned nthreads);
+
+    ~FailOverCacheReactor();
+
+    FailOverCacheReactor(const FailOverCacheReactor&) = delete;
+
+    FailOverCacheReactor&
+    operator=(const FailOverCacheReactor&) = delete;
+
+    void
+    add(std::unique_ptr<fungi::Socket>);
+
+    size_t
+    size() const
+    {
+        return loops_.size();
+    }
+
+    class Connection;
+    class Loop;
+
+private:
+    DECLARE_LOGGER("FailOverCacheReactor");
+
+    FailOverCacheAcceptor& acceptor_;
+    std::vector<std::unique_ptr<Loop>> loops_;
+    std::atomic<size_t> next_;
+
+    Loop&
+    shard_(const std::string& nspace);
+};
+
+}
+
+#endif // !FAILOVERCACHE_REACTOR_H_
+
+// Local Variables: **
+// mode: c++ **
+// End: **
@@ -0,0 +1,113 @@
+// Copyright (C) 2016 iNuron NV
+//
+// This file is part of Open vStorage Open Source Edition (OSE),
+// as available from
+//
+//      http://www.openvstorage.org and
+//      http://www.openvstorage.com.
+//
+// This file is free software; you can redistribute it and/or modify it
+// under the terms of the GNU Affero General Public License v3 (GNU AGPLv3)
+// as published by the Free Software Foundation, in version 3 as it comes in
+// the LICENSE.txt file of the Open vStorage OSE distribution.
+// Open vStorage is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY of any kind.
+
+#ifndef FAILOVERCACHE_REQUEST_HANDLER_H_
+#define FAILOVERCACHE_REQUEST_HANDLER_H_
+
+#include "fungilib/IOBaseStream.h"
+
+#include "../ClusterLocation.h"
+
+#include <memory>
+
+#include <youtils/Logging.h>
+
+namespace failovercache
+{
+
+class FailOverCacheAcceptor;
+class Backend;
+
+// Executes the requests of one client connection on a stream. Shared by the
+// thread per connection FailOverCacheProtocol and the FailOverCacheReactor.
+class FailOverCacheRequestHandler
+{
+public:
+    FailOverCacheRequestHandler(fungi::IOBaseStream&,
+                                FailOverCacheAcceptor&);
+
+    ~FailOverCacheRequestHandler() = default;
+
+    FailOverCacheRequestHandler(const FailOverCacheRequestHandler&) = delete;
+
+    FailOverCacheRequestHandler&
+    operator=(const FailOverCacheRequestHandler&) = delete;
+
+    // The command was already read off the stream, its arguments (if any)
+    // are yet to be read.
+    void
+    handle(int32_t cmd);
+
+    void
+    returnNotOk();
+
+    const std::shared_ptr<Backend>&
+    backend() const
+    {
+        return cache_;
+    }
+
+private:
+    DECLARE_LOGGER("FailOverCacheRequestHandler");
+
+    fungi::IOBaseStream& stream_;
+    FailOverCacheAcceptor& fact_;
+    std::shared_ptr<Backend> cache_;
+
+    void
+    addEntries_();
+
+    void
+    getEntries_();
+
+    void
+    Flush_();
+
+    void
+    register_();
+
+    void
+    unregister_();
+
+    void
+    getSCO_();
+
+    void
+    getSCORange_();
+
+    void
+    Clear_();
+
+    void
+    returnOk();
+
+    void
+    removeUpTo_();
+
+    void
+    processFailOverCacheEntry_(volumedriver::ClusterLocation cli,
+                               int64_t lba,
+                               const byte* buf,
+                               int64_t size,
+                               bool cork);
+};
+
+}
+
+#endif // !FAILOVERCACHE_REQUEST_HANDLER_H_
+
+// Local Variables: **
+// mode: c++ **
+// End: **
@@ -33,6 +33,8 @@ FailOverCacheServer::FailOverCacheServer(const constructor_type& c)
     , transport_(vd::FailOverCacheTransport::TCP)
     , busy_loop_usecs_(0)
     , file_backend_buffer_size_(failovercache::FileBackend::default_stream_buffer_size())
+    , file_backend_segment_size_(0)
+    , reactor_threads_(0)
     , running_(false)
 {
     logger_ = &MainHelper::getLogger__();
@@ -56,6 +58,12 @@ FailOverCacheServer::FailOverCacheServer(const constructor_type& c)
         ("file-backend-buffer-size",
          po::value<size_t>(&file_backend_buffer_size_)->default_value(file_backend_buffer_size_),
          "stream buffer size for the file backend")
+        ("file-backend-segment-size",
+         po::value<size_t>(&file_backend_segment_size_)->default_value(file_backend_segment_size_),
+         "size of the preallocated segment files shared by all namespaces (written with O_DIRECT), 0 selects a file per SCO")
+        ("reactor-threads",
+         po::value<unsigned>(&reactor_threads_)->default_value(reactor_threads_),
+         "number of (pinned) epoll threads serving TCP connections, 0 selects a thread per connection")
         ("daemonize,D",
          "run as a daemon");
 }
@@ -130,11 +138,15 @@ FailOverCacheServer::run()
               ", port: " << port_ <<
               ", transport type: " << transport_ <<
               ", busy-loop usecs: " << busy_loop_usecs_ <<
-              ", file backend stream buffer size: " << file_backend_buffer_size_);
+              ", file backend stream buffer size: " << file_backend_buffer_size_ <<
+              ", file backend segment size: " << file_backend_segment_size_ <<
+              ", reactor threads: " << reactor_threads_);
 
     acceptor = std::make_unique<failovercache::FailOverCacheAcceptor>(path,
                                                                       file_backend_buffer_size_,
-                                                                      boost::chrono::microseconds(busy_loop_usecs_));
+                                                                      boost::chrono::microseconds(busy_loop_usecs_),
+                                                                      reactor_threads_,
+                                                                      file_backend_segment_size_);
 
     LOG_INFO("Running the SocketServer");
 
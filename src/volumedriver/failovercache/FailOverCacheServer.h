@@ -79,6 +79,8 @@ private:
     volumedriver::FailOverCacheTransport transport_;
     unsigned busy_loop_usecs_;
     size_t file_backend_buffer_size_;
+    size_t file_backend_segment_size_;
+    unsigned reactor_threads_;
 
     bool running_;
 
@@ -0,0 +1,204 @@
+// Copyright (C) 2016 iNuron NV
+//
+// This file is part of Open vStorage Open Source Edition (OSE),
+// as available from
+//
+//      http://www.openvstorage.org and
+//      http://www.openvstorage.com.
+//
+// This file is free software; you can redistribute it and/or modify it
+// under the terms of the GNU Affero General Public License v3 (GNU AGPLv3)
+// as published by the Free Software Foundation, in version 3 as it comes in
+// the LICENSE.txt file of the Open vStorage OSE distribution.
+// Open vStorage is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY of any kind.
+
+#include "LogBackend.h"
+
+#include <youtils/Assert.h>
+#include <youtils/Catchers.h>
+
+namespace failovercache
+{
+
+namespace vd = volumedriver;
+
+LogBackend::LogBackend(std::shared_ptr<SegmentLog> log,
+                       const std::string& nspace,
+                       const vd::ClusterSize csize)
+    : Backend(nspace,
+              csize)
+    , log_(std::move(log))
+    , current_(nullptr)
+{
+    VERIFY(log_);
+}
+
+LogBackend::~LogBackend()
+{
+    LOG_INFO(getNamespace() << ": releasing " << entries_.size() << " SCOs");
+
+    for (const auto& p : entries_)
+    {
+        try
+        {
+            release_(p.second);
+        }
+        CATCH_STD_ALL_LOG_IGNORE(getNamespace() << ": failed to release " << p.first);
+    }
+}
+
+size_t
+LogBackend::max_read_size()
+{
+    return 1ULL << 20;
+}
+
+void
+LogBackend::open(const vd::SCO sco)
+{
+    LOG_INFO(getNamespace() << ": opening " << sco);
+
+    const auto res(entries_.emplace(sco,
+                                    SCOEntries()));
+    VERIFY(res.second);
+    current_ = &res.first->second;
+}
+
+void
+LogBackend::close()
+{
+    current_ = nullptr;
+}
+
+void
+LogBackend::add_entries(std::vector<vd::FailOverCacheEntry> entries,
+                        std::unique_ptr<uint8_t[]> /* buf */)
+{
+    VERIFY(current_);
+
+    for (const auto& e : entries)
+    {
+        VERIFY(e.cli_.version() == 0);
+        VERIFY(e.cli_.cloneID() == 0);
+        VERIFY(e.size_ == cluster_size());
+    }
+
+    const std::vector<SegmentLog::Location> locs(log_->append(entries));
+    VERIFY(locs.size() == entries.size());
+
+    current_->reserve(current_->size() + entries.size());
+
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        current_->emplace_back(Entry{ entries[i].cli_,
+                                      entries[i].lba_,
+                                      locs[i] });
+    }
+}
+
+void
+LogBackend::flush()
+{
+    log_->flush();
+}
+
+void
+LogBackend::release_(const SCOEntries& entries)
+{
+    // Entries of a SCO are mostly in one or two segments, so batch the
+    // release per run of the same segment.
+    size_t i = 0;
+    while (i < entries.size())
+    {
+        const uint32_t seg = entries[i].loc.segment;
+        size_t count = 0;
+
+        while (i < entries.size() and entries[i].loc.segment == seg)
+        {
+            ++count;
+            ++i;
+        }
+
+        log_->release(seg,
+                      count);
+    }
+}
+
+void
+LogBackend::remove(const vd::SCO sco)
+{
+    LOG_INFO(getNamespace() << ": removing " << sco);
+
+    auto it = entries_.find(sco);
+    if (it != entries_.end())
+    {
+        if (current_ == &it->second)
+        {
+            current_ = nullptr;
+        }
+
+        SCOEntries entries(std::move(it->second));
+        entries_.erase(it);
+
+        release_(entries);
+    }
+}
+
+void
+LogBackend::get_entries(const vd::SCO sco,
+                        Backend::EntryProcessorFun& fun)
+{
+    LOG_INFO(getNamespace() << ": processing " << sco);
+
+    const auto it = entries_.find(sco);
+    if (it == entries_.end())
+    {
+        return;
+    }
+
+    const SCOEntries& entries = it->second;
+    const size_t slot = SegmentLog::slot_size(cluster_size());
+    const size_t max_slots = std::max<size_t>(1,
+                                              max_read_size() / slot);
+
+    SegmentLog::AlignedBuffer buf(SegmentLog::make_aligned_buffer(max_slots * slot));
+
+    // Entries of a SCO were appended in order and are hence mostly adjacent in
+    // the log: read them in runs.
+    size_t i = 0;
+    while (i < entries.size())
+    {
+        const SegmentLog::Location& start = entries[i].loc;
+        size_t n = 1;
+
+        while (i + n < entries.size() and
+               n < max_slots and
+               entries[i + n].loc.segment == start.segment and
+               entries[i + n].loc.offset == start.offset + n * slot)
+        {
+            ++n;
+        }
+
+        log_->read(start,
+                   n * slot,
+                   buf.get());
+
+        for (size_t j = 0; j < n; ++j)
+        {
+            const Entry& e = entries[i + j];
+
+            LOG_DEBUG(getNamespace() << ": sending entry " << e.cli <<
+                      ", lba " << e.lba);
+
+            fun(e.cli,
+                e.lba,
+                buf.get() + j * slot,
+                cluster_size());
+        }
+
+        i += n;
+    }
+}
+
+}
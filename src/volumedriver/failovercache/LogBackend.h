@@ -0,0 +1,107 @@
+// Copyright (C) 2016 iNuron NV
+//
+// This file is part of Open vStorage Open Source Edition (OSE),
+// as available from
+//
+//      http://www.openvstorage.org and
+//      http://www.openvstorage.com.
+//
+// This file is free software; you can redistribute it and/or modify it
+// under the terms of the GNU Affero General Public License v3 (GNU AGPLv3)
+// as published by the Free Software Foundation, in version 3 as it comes in
+// the LICENSE.txt file of the Open vStorage OSE distribution.
+// Open vStorage is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY of any kind.
+
+#ifndef DTL_LOG_BACKEND_H_
+#define DTL_LOG_BACKEND_H_
+
+#include "Backend.h"
+#include "SegmentLog.h"
+
+#include <memory>
+#include <unordered_map>
+
+namespace failovercache
+{
+
+// Keeps a namespace's entries in the SegmentLog shared with all other
+// namespaces, with only the index in memory.
+class LogBackend
+    : public Backend
+{
+public:
+    LogBackend(std::shared_ptr<SegmentLog>,
+               const std::string&,
+               const volumedriver::ClusterSize);
+
+    ~LogBackend();
+
+    LogBackend(const LogBackend&) = delete;
+
+    LogBackend&
+    operator=(const LogBackend&) = delete;
+
+    virtual void
+    open(const volumedriver::SCO) override final;
+
+    virtual void
+    close() override final;
+
+    virtual void
+    add_entries(std::vector<volumedriver::FailOverCacheEntry>,
+                std::unique_ptr<uint8_t[]>) override final;
+
+    virtual void
+    flush() override final;
+
+    virtual void
+    remove(const volumedriver::SCO) override final;
+
+    virtual void
+    get_entries(const volumedriver::SCO,
+                Backend::EntryProcessorFun&) override final;
+
+    static size_t
+    max_read_size();
+
+private:
+    DECLARE_LOGGER("DtlLogBackend");
+
+    std::shared_ptr<SegmentLog> log_;
+
+    struct Entry
+    {
+        volumedriver::ClusterLocation cli;
+        uint64_t lba;
+        SegmentLog::Location loc;
+    };
+
+    using SCOEntries = std::vector<Entry>;
+
+    SCOEntries* current_;
+
+    struct Hash
+    {
+        size_t
+        operator()(const volumedriver::SCO sco) const
+        {
+            return sco.number();
+        }
+    };
+
+    std::unordered_map<volumedriver::SCO,
+                       SCOEntries,
+                       Hash> entries_;
+
+    void
+    release_(const SCOEntries&);
+};
+
+}
+
+#endif // !DTL_LOG_BACKEND_H_
+
+// Local Variables: **
+// mode: c++ **
+// End: **
@@ -0,0 +1,433 @@
+// Copyright (C) 2016 iNuron NV
+//
+// This file is part of Open vStorage Open Source Edition (OSE),
+// as available from
+//
+//      http://www.openvstorage.org and
+//      http://www.openvstorage.com.
+//
+// This file is free software; you can redistribute it and/or modify it
+// under the terms of the GNU Affero General Public License v3 (GNU AGPLv3)
+// as published by the Free Software Foundation, in version 3 as it comes in
+// the LICENSE.txt file of the Open vStorage OSE distribution.
+// Open vStorage is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY of any kind.
+
+#include "SegmentLog.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <boost/thread/lock_guard.hpp>
+
+#include <youtils/Assert.h>
+#include <youtils/Catchers.h>
+#include <youtils/IOException.h>
+
+namespace failovercache
+{
+
+namespace fs = boost::filesystem;
+namespace vd = volumedriver;
+
+#define LOCK()                                  \
+    boost::lock_guard<decltype(lock_)> lg__(lock_)
+
+SegmentLog::Segment::Segment(const fs::path& p,
+                             bool& direct_io,
+                             const size_t size)
+    : path(p)
+    , fd(-1)
+    , id(0)
+    , live(0)
+{
+    const int flags = O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC;
+
+    if (direct_io)
+    {
+        fd = ::open(path.string().c_str(),
+                    flags | O_DIRECT,
+                    S_IRUSR | S_IWUSR);
+        if (fd < 0 and errno == EINVAL)
+        {
+            LOG_WARN(path << ": failed to open with O_DIRECT: " << strerror(errno) <<
+                     " - falling back to buffered I/O");
+            direct_io = false;
+        }
+    }
+
+    if (not direct_io)
+    {
+        fd = ::open(path.string().c_str(),
+                    flags,
+                    S_IRUSR | S_IWUSR);
+    }
+
+    if (fd < 0)
+    {
+        throw fungi::IOException("SegmentLog: failed to create segment",
+                                 path.string().c_str(),
+                                 errno);
+    }
+
+    const int ret = ::posix_fallocate(fd,
+                                      0,
+                                      size);
+    if (ret != 0)
+    {
+        ::close(fd);
+        ::unlink(path.string().c_str());
+        throw fungi::IOException("SegmentLog: failed to preallocate segment",
+                                 path.string().c_str(),
+                                 ret);
+    }
+}
+
+SegmentLog::Segment::~Segment()
+{
+    if (::close(fd) < 0)
+    {
+        LOG_ERROR(path << ": failed to close: " << strerror(errno) << " - ignoring");
+    }
+
+    if (::unlink(path.string().c_str()) < 0 and errno != ENOENT)
+    {
+        LOG_ERROR(path << ": failed to unlink: " << strerror(errno) << " - ignoring");
+    }
+}
+
+SegmentLog::SegmentLog(const fs::path& root,
+                       const size_t segment_size,
+                       const size_t staging_size,
+                       const size_t max_spare_segments)
+    : root_(root)
+    , segment_size_(slot_size(segment_size))
+    , staging_size_(std::min(slot_size(staging_size),
+                             segment_size_))
+    , max_spare_segments_(max_spare_segments)
+    , direct_io_(true)
+    , next_id_(0)
+    , next_file_(0)
+    , active_(nullptr)
+    , write_off_(0)
+    , staging_(make_aligned_buffer(staging_size_))
+    , staged_(0)
+{
+    VERIFY(segment_size_ > 0);
+
+    LOG_INFO(root_ << ": segment size " << segment_size_ <<
+             ", staging buffer size " << staging_size_ <<
+             ", max spare segments " << max_spare_segments_);
+
+    fs::create_directories(root_);
+}
+
+SegmentLog::~SegmentLog()
+{
+    LOG_INFO(root_ << ": removing " << segments_.size() << " segments, " <<
+             spare_.size() << " spares");
+
+    active_ = nullptr;
+    segments_.clear();
+    spare_.clear();
+
+    try
+    {
+        fs::remove_all(root_);
+    }
+    CATCH_STD_ALL_LOG_IGNORE(root_ << ": failed to remove");
+}
+
+size_t
+SegmentLog::default_staging_size()
+{
+    return 1ULL << 20;
+}
+
+size_t
+SegmentLog::default_max_spare_segments()
+{
+    return 2;
+}
+
+SegmentLog::AlignedBuffer
+SegmentLog::make_aligned_buffer(const size_t size)
+{
+    void* p = nullptr;
+    if (::posix_memalign(&p,
+                         alignment(),
+                         size) != 0)
+    {
+        throw std::bad_alloc();
+    }
+
+    return AlignedBuffer(static_cast<uint8_t*>(p));
+}
+
+size_t
+SegmentLog::segments() const
+{
+    LOCK();
+    return segments_.size();
+}
+
+size_t
+SegmentLog::spare_segments() const
+{
+    LOCK();
+    return spare_.size();
+}
+
+void
+SegmentLog::flush_staging_()
+{
+    VERIFY(active_ != nullptr or staged_ == 0);
+
+    size_t off = 0;
+    while (off < staged_)
+    {
+        const ssize_t ret = ::pwrite(active_->fd,
+                                     staging_.get() + off,
+                                     staged_ - off,
+                                     write_off_ + off);
+        if (ret < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            throw fungi::IOException("SegmentLog: failed to write segment",
+                                     active_->path.string().c_str(),
+                                     errno);
+        }
+
+        off += ret;
+    }
+
+    write_off_ += staged_;
+    staged_ = 0;
+}
+
+void
+SegmentLog::roll_()
+{
+    flush_staging_();
+
+    if (active_ != nullptr)
+    {
+        const uint32_t id = active_->id;
+        const bool dead = active_->live == 0;
+        active_ = nullptr;
+
+        if (dead)
+        {
+            reclaim_(id);
+        }
+    }
+
+    SegmentPtr seg;
+
+    if (spare_.empty())
+    {
+        const fs::path p(root_ / ("segment_" + std::to_string(next_file_++)));
+        LOG_INFO("creating " << p);
+        seg = std::make_unique<Segment>(p,
+                                        direct_io_,
+                                        segment_size_);
+    }
+    else
+    {
+        seg = std::move(spare_.back());
+        spare_.pop_back();
+        LOG_DEBUG("recycling " << seg->path);
+    }
+
+    seg->id = next_id_++;
+    seg->live = 0;
+
+    active_ = seg.get();
+    write_off_ = 0;
+
+    const auto res(segments_.emplace(active_->id,
+                                     std::move(seg)));
+    VERIFY(res.second);
+}
+
+void
+SegmentLog::reclaim_(const uint32_t id)
+{
+    auto it = segments_.find(id);
+    VERIFY(it != segments_.end());
+    VERIFY(it->second.get() != active_);
+    VERIFY(it->second->live == 0);
+
+    SegmentPtr seg(std::move(it->second));
+    segments_.erase(it);
+
+    if (spare_.size() < max_spare_segments_)
+    {
+        LOG_DEBUG("keeping " << seg->path << " as spare");
+        spare_.emplace_back(std::move(seg));
+    }
+    else
+    {
+        LOG_INFO("removing " << seg->path);
+    }
+}
+
+std::vector<SegmentLog::Location>
+SegmentLog::append(const std::vector<vd::FailOverCacheEntry>& entries)
+{
+    std::vector<Location> locs;
+    locs.reserve(entries.size());
+
+    LOCK();
+
+    try
+    {
+        for (const auto& e : entries)
+        {
+            const size_t slot = slot_size(e.size_);
+            VERIFY(slot <= staging_size_);
+
+            if (active_ == nullptr or
+                write_off_ + staged_ + slot > segment_size_)
+            {
+                roll_();
+            }
+
+            if (staged_ + slot > staging_size_)
+            {
+                flush_staging_();
+            }
+
+            uint8_t* dst = staging_.get() + staged_;
+            memcpy(dst,
+                   e.buffer_,
+                   e.size_);
+            memset(dst + e.size_,
+                   0,
+                   slot - e.size_);
+
+            locs.emplace_back(Location{ active_->id,
+                                        write_off_ + staged_ });
+
+            staged_ += slot;
+            ++active_->live;
+        }
+    }
+    catch (...)
+    {
+        // The caller doesn't get to know the locations, so it will never
+        // release them: drop the entries of this batch again.
+        size_t i = 0;
+        while (i < locs.size())
+        {
+            const uint32_t id = locs[i].segment;
+            size_t count = 0;
+
+            for (; i < locs.size() and locs[i].segment == id; ++i)
+            {
+                ++count;
+            }
+
+            drop_(id,
+                  count);
+        }
+
+        throw;
+    }
+
+    return locs;
+}
+
+void
+SegmentLog::flush()
+{
+    LOCK();
+    flush_staging_();
+}
+
+void
+SegmentLog::read(const Location& loc,
+                 size_t size,
+                 uint8_t* buf)
+{
+    VERIFY(size % alignment() == 0);
+    VERIFY(loc.offset + size <= segment_size_);
+
+    int fd = -1;
+    const char* path = nullptr;
+
+    {
+        LOCK();
+
+        auto it = segments_.find(loc.segment);
+        VERIFY(it != segments_.end());
+
+        const Segment& seg = *it->second;
+        VERIFY(&seg != active_ or
+               loc.offset + size <= write_off_);
+
+        // The segment cannot go away while the caller holds live entries in
+        // it, so it's safe to use the fd without holding the lock.
+        fd = seg.fd;
+        path = seg.path.c_str();
+    }
+
+    size_t off = 0;
+    while (off < size)
+    {
+        const ssize_t ret = ::pread(fd,
+                                    buf + off,
+                                    size - off,
+                                    loc.offset + off);
+        if (ret < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            throw fungi::IOException("SegmentLog: failed to read segment",
+                                     path,
+                                     errno);
+        }
+        else if (ret == 0)
+        {
+            throw fungi::IOException("SegmentLog: short read from segment",
+                                     path);
+        }
+
+        off += ret;
+    }
+}
+
+void
+SegmentLog::release(const uint32_t segment,
+                    const size_t count)
+{
+    LOCK();
+    drop_(segment,
+          count);
+}
+
+void
+SegmentLog::drop_(const uint32_t segment,
+                  const size_t count)
+{
+    auto it = segments_.find(segment);
+    VERIFY(it != segments_.end());
+
+    Segment& seg = *it->second;
+    VERIFY(seg.live >= count);
+
+    seg.live -= count;
+    if (seg.live == 0 and &seg != active_)
+    {
+        reclaim_(segment);
+    }
+}
+
+}
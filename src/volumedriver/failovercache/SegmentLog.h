@@ -0,0 +1,195 @@
+// Copyright (C) 2016 iNuron NV
+//
+// This file is part of Open vStorage Open Source Edition (OSE),
+// as available from
+//
+//      http://www.openvstorage.org and
+//      http://www.openvstorage.com.
+//
+// This file is free software; you can redistribute it and/or modify it
+// under the terms of the GNU Affero General Public License v3 (GNU AGPLv3)
+// as published by the Free Software Foundation, in version 3 as it comes in
+// the LICENSE.txt file of the Open vStorage OSE distribution.
+// Open vStorage is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY of any kind.
+
+#ifndef DTL_SEGMENT_LOG_H_
+#define DTL_SEGMENT_LOG_H_
+
+#include "../FailOverCacheStreamers.h"
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <youtils/Logging.h>
+
+namespace failovercache
+{
+
+// Append-only store shared by all LogBackends of a DTL server: the entries of
+// all namespaces end up in large, preallocated segment files that are written
+// with O_DIRECT in aligned batches. The store does not know about namespaces
+// or SCOs - the backends keep the index and hand back the locations they no
+// longer need. Segments without live entries are recycled (or unlinked if
+// there are enough spares already) instead of creating / removing a file per
+// SCO.
+class SegmentLog
+{
+public:
+    struct Location
+    {
+        uint32_t segment;
+        uint64_t offset;
+    };
+
+    SegmentLog(const boost::filesystem::path& root,
+               const size_t segment_size,
+               const size_t staging_size = default_staging_size(),
+               const size_t max_spare_segments = default_max_spare_segments());
+
+    ~SegmentLog();
+
+    SegmentLog(const SegmentLog&) = delete;
+
+    SegmentLog&
+    operator=(const SegmentLog&) = delete;
+
+    // Copies the entries' data to the staging buffer and returns their
+    // locations (in order). The data is written out once the staging buffer
+    // fills up or on flush().
+    std::vector<Location>
+    append(const std::vector<volumedriver::FailOverCacheEntry>&);
+
+    void
+    flush();
+
+    // Reads `size` bytes (a multiple of slot_size()) at `loc` into `buf`, which
+    // needs to be aligned to alignment(). The range needs to have been flushed.
+    void
+    read(const Location& loc,
+         size_t size,
+         uint8_t* buf);
+
+    // Drops `count` entries living in `segment`.
+    void
+    release(const uint32_t segment,
+            const size_t count);
+
+    // The space an entry of `size` bytes occupies in a segment.
+    static size_t
+    slot_size(const size_t size)
+    {
+        return ((size + alignment() - 1) / alignment()) * alignment();
+    }
+
+    static constexpr size_t
+    alignment()
+    {
+        // O_DIRECT requires buffers, offsets and sizes to be aligned to the
+        // logical block size of the device - use the most conservative value.
+        return 4096;
+    }
+
+    static size_t
+    default_staging_size();
+
+    static size_t
+    default_max_spare_segments();
+
+    const boost::filesystem::path&
+    root() const
+    {
+        return root_;
+    }
+
+    size_t
+    segments() const;
+
+    size_t
+    spare_segments() const;
+
+    struct FreeDeleter
+    {
+        void
+        operator()(uint8_t* p) const
+        {
+            ::free(p);
+        }
+    };
+
+    using AlignedBuffer = std::unique_ptr<uint8_t, FreeDeleter>;
+
+    static AlignedBuffer
+    make_aligned_buffer(const size_t size);
+
+private:
+    DECLARE_LOGGER("DtlSegmentLog");
+
+    struct Segment
+    {
+        Segment(const boost::filesystem::path&,
+                bool& direct_io,
+                const size_t size);
+
+        ~Segment();
+
+        Segment(const Segment&) = delete;
+
+        Segment&
+        operator=(const Segment&) = delete;
+
+        const boost::filesystem::path path;
+        int fd;
+        uint32_t id;
+        size_t live;
+    };
+
+    using SegmentPtr = std::unique_ptr<Segment>;
+
+    // protects everything below
+    mutable boost::mutex lock_;
+
+    const boost::filesystem::path root_;
+    const size_t segment_size_;
+    const size_t staging_size_;
+    const size_t max_spare_segments_;
+
+    // Cleared once a segment could not be opened with O_DIRECT (e.g. on tmpfs).
+    bool direct_io_;
+
+    std::unordered_map<uint32_t, SegmentPtr> segments_;
+    std::vector<SegmentPtr> spare_;
+    uint32_t next_id_;
+    uint64_t next_file_;
+
+    Segment* active_;
+    // offset in the active segment the staging buffer will be written to
+    uint64_t write_off_;
+    AlignedBuffer staging_;
+    size_t staged_;
+
+    void
+    flush_staging_();
+
+    void
+    roll_();
+
+    void
+    reclaim_(const uint32_t id);
+
+    void
+    drop_(const uint32_t segment,
+          const size_t count);
+};
+
+}
+
+#endif // !DTL_SEGMENT_LOG_H_
+
+// Local Variables: **
+// mode: c++ **
+// End: **
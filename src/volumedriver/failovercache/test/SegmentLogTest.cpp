@@ -0,0 +1,299 @@
+// Copyright (C) 2016 iNuron NV
+//
+// This file is part of Open vStorage Open Source Edition (OSE),
+// as available from
+//
+//      http://www.openvstorage.org and
+//      http://www.openvstorage.com.
+//
+// This file is free software; you can redistribute it and/or modify it
+// under the terms of the GNU Affero General Public License v3 (GNU AGPLv3)
+// as published by the Free Software Foundation, in version 3 as it comes in
+// the LICENSE.txt file of the Open vStorage OSE distribution.
+// Open vStorage is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY of any kind.
+
+#include "../SegmentLog.h"
+
+#include "../../ClusterLocation.h"
+#include "../../FailOverCacheStreamers.h"
+
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include <boost/filesystem/fstream.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include <youtils/FileUtils.h>
+#include <youtils/ScopeExit.h>
+
+namespace failovercachetest
+{
+
+namespace fs = boost::filesystem;
+namespace yt = youtils;
+
+using namespace failovercache;
+using namespace volumedriver;
+
+class SegmentLogTest
+    : public testing::Test
+{
+protected:
+    SegmentLogTest()
+        : root_(yt::FileUtils::temp_path() /
+                ("segmentlog-test-" + boost::lexical_cast<std::string>(getpid())))
+    {}
+
+    virtual void
+    SetUp()
+    {
+        yt::FileUtils::removeAllNoThrow(root_);
+    }
+
+    virtual void
+    TearDown()
+    {
+        yt::FileUtils::removeAllNoThrow(root_);
+    }
+
+    static constexpr size_t entry_size = SegmentLog::alignment();
+
+    // data of entry `n`
+    std::vector<uint8_t>
+    make_data(const size_t n) const
+    {
+        return std::vector<uint8_t>(entry_size,
+                                    static_cast<uint8_t>(n));
+    }
+
+    std::vector<SegmentLog::Location>
+    append(SegmentLog& log,
+           const size_t first,
+           const size_t count)
+    {
+        std::vector<std::vector<uint8_t>> bufs;
+        std::vector<FailOverCacheEntry> entries;
+
+        bufs.reserve(count);
+        entries.reserve(count);
+
+        for (size_t i = first; i < first + count; ++i)
+        {
+            bufs.emplace_back(make_data(i));
+            entries.emplace_back(ClusterLocation(1),
+                                 i,
+                                 bufs.back().data(),
+                                 entry_size);
+        }
+
+        return log.append(entries);
+    }
+
+    void
+    check_data(SegmentLog& log,
+               const SegmentLog::Location& loc,
+               const size_t n)
+    {
+        SegmentLog::AlignedBuffer buf(SegmentLog::make_aligned_buffer(entry_size));
+        log.read(loc,
+                 entry_size,
+                 buf.get());
+
+        const std::vector<uint8_t> exp(make_data(n));
+        EXPECT_EQ(0,
+                  memcmp(exp.data(),
+                         buf.get(),
+                         entry_size));
+    }
+
+    size_t
+    files(const fs::path& p) const
+    {
+        size_t n = 0;
+        for (fs::directory_iterator it(p); it != fs::directory_iterator(); ++it)
+        {
+            ++n;
+        }
+
+        return n;
+    }
+
+    const fs::path root_;
+};
+
+constexpr size_t SegmentLogTest::entry_size;
+
+TEST_F(SegmentLogTest, rollover)
+{
+    const size_t per_segment = 4;
+    const size_t count = 10;
+
+    SegmentLog log(root_,
+                   per_segment * entry_size,
+                   2 * entry_size,
+                   0);
+
+    const std::vector<SegmentLog::Location> locs(append(log,
+                                                        0,
+                                                        count));
+    ASSERT_EQ(count, locs.size());
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        EXPECT_EQ(i / per_segment, locs[i].segment);
+        EXPECT_EQ((i % per_segment) * entry_size, locs[i].offset);
+    }
+
+    EXPECT_EQ(3U, log.segments());
+    EXPECT_EQ(3U, files(root_));
+
+    log.flush();
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        check_data(log,
+                   locs[i],
+                   i);
+    }
+}
+
+TEST_F(SegmentLogTest, spares)
+{
+    const size_t per_segment = 4;
+
+    SegmentLog log(root_,
+                   per_segment * entry_size,
+                   per_segment * entry_size,
+                   1);
+
+    const std::vector<SegmentLog::Location> locs(append(log,
+                                                        0,
+                                                        3 * per_segment));
+    EXPECT_EQ(3U, log.segments());
+    EXPECT_EQ(0U, log.spare_segments());
+
+    // kept as spare
+    log.release(locs[0].segment,
+                per_segment);
+
+    EXPECT_EQ(2U, log.segments());
+    EXPECT_EQ(1U, log.spare_segments());
+    EXPECT_EQ(3U, files(root_));
+
+    // unlinked as there are enough spares already
+    log.release(locs[per_segment].segment,
+                per_segment);
+
+    EXPECT_EQ(1U, log.segments());
+    EXPECT_EQ(1U, log.spare_segments());
+    EXPECT_EQ(2U, files(root_));
+
+    // the active segment is full - the next one is the recycled spare
+    const std::vector<SegmentLog::Location> locs2(append(log,
+                                                         100,
+                                                         1));
+    ASSERT_EQ(1U, locs2.size());
+    EXPECT_EQ(0U, locs2[0].offset);
+
+    EXPECT_EQ(2U, log.segments());
+    EXPECT_EQ(0U, log.spare_segments());
+    EXPECT_EQ(2U, files(root_));
+
+    log.flush();
+
+    check_data(log,
+               locs2[0],
+               100);
+
+    check_data(log,
+               locs[2 * per_segment],
+               2 * per_segment);
+}
+
+TEST_F(SegmentLogTest, failed_append)
+{
+    const size_t per_segment = 4;
+
+    SegmentLog log(root_,
+                   per_segment * entry_size,
+                   per_segment * entry_size,
+                   0);
+
+    const std::vector<SegmentLog::Location> locs(append(log,
+                                                        0,
+                                                        2));
+    ASSERT_EQ(2U, locs.size());
+    EXPECT_EQ(1U, log.segments());
+
+    // make creating the next segment fail
+    const fs::path blocker(root_ / "segment_1");
+    fs::ofstream(blocker).close();
+
+    EXPECT_THROW(append(log,
+                        2,
+                        per_segment),
+                 std::exception);
+
+    // the entries of the failed batch must not keep the segment alive
+    log.release(locs[0].segment,
+                locs.size());
+
+    EXPECT_EQ(0U, log.segments());
+
+    fs::remove(blocker);
+
+    const std::vector<SegmentLog::Location> locs2(append(log,
+                                                         10,
+                                                         1));
+    ASSERT_EQ(1U, locs2.size());
+    EXPECT_EQ(1U, log.segments());
+
+    log.flush();
+
+    check_data(log,
+               locs2[0],
+               10);
+}
+
+// tmpfs does not support O_DIRECT on older kernels, which makes SegmentLog
+// fall back to buffered I/O.
+TEST_F(SegmentLogTest, tmpfs)
+{
+    const fs::path shm("/dev/shm");
+    if (not fs::is_directory(shm))
+    {
+        std::cout << shm << " not available - skipping test" << std::endl;
+        return;
+    }
+
+    const fs::path root(shm / root_.filename());
+    yt::FileUtils::removeAllNoThrow(root);
+
+    auto on_exit(yt::make_scope_exit([&]
+                                     {
+                                         yt::FileUtils::removeAllNoThrow(root);
+                                     }));
+
+    const size_t count = 6;
+
+    SegmentLog log(root,
+                   4 * entry_size,
+                   2 * entry_size,
+                   0);
+
+    const std::vector<SegmentLog::Location> locs(append(log,
+                                                        0,
+                                                        count));
+    log.flush();
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        check_data(log,
+                   locs[i],
+                   i);
+    }
+}
+
+}
@@ -314,6 +314,87 @@ struct TableHandle
         return counters;
     }
 
+    virtual void
+    set_slaves(const vd::MDSNodeConfigs& slaves,
+               vd::OwnerTag owner_tag) override final
+    {
+        auto b([&](mdsproto::Methods::SetSlavesParams::Builder& builder)
+               {
+                   // LOG_TRACE(nspace_ << ": building SetSlaves request");
+                   builder.setNspace(nspace_);
+                   builder.setOwnerTag(static_cast<uint64_t>(owner_tag));
+
+                   size_t idx = 0;
+                   auto l = builder.initSlaves(slaves.size());
+
+                   for (const auto& s : slaves)
+                   {
+                       auto e = l[idx];
+                       e.setAddress(s.address());
+                       e.setPort(s.port());
+                       ++idx;
+                   }
+               });
+
+        auto r([&](mdsproto::Methods::SetSlavesResults::Reader&)
+               {
+                   // LOG_TRACE(nspace_ << ": reading SetSlaves response");
+               });
+
+        client_->interact_<mdsproto::RequestHeader::Type::SetSlaves>(std::move(b),
+                                                                     std::move(r));
+    }
+
+    virtual InSync
+    replicate(uint64_t stream_id,
+              uint64_t seqnum,
+              const Updates& updates) override final
+    {
+        auto b([&](mdsproto::Methods::ReplicateParams::Builder& builder)
+               {
+                   // LOG_TRACE(nspace_ << ": building Replicate request of size " << updates.size());
+                   builder.setNspace(nspace_);
+                   builder.setStreamId(stream_id);
+                   builder.setSeqNum(seqnum);
+
+                   size_t idx = 0;
+                   auto ul = builder.initUpdates(updates.size());
+
+                   for (const auto& u : updates)
+                   {
+                       auto ue = ul[idx];
+                       ue.setBarrier(u.barrier == Barrier::T);
+
+                       size_t ridx = 0;
+                       auto rl = ue.initRecords(u.records.size());
+
+                       for (const auto& r : u.records)
+                       {
+                           auto re = rl[ridx];
+                           re.setKey(capnp::Data::Reader(static_cast<const kj::byte*>(r.key.data),
+                                                         r.key.size));
+                           re.setVal(capnp::Data::Reader(static_cast<const kj::byte*>(r.val.data),
+                                                         r.val.size));
+                           ++ridx;
+                       }
+
+                       ++idx;
+                   }
+               });
+
+        InSync in_sync = InSync::F;
+
+        auto r([&](mdsproto::Methods::ReplicateResults::Reader& reader)
+               {
+                   // LOG_TRACE(nspace_ << ": reading Replicate response");
+                   in_sync = reader.getInSync() ? InSync::T : InSync::F;
+               });
+
+        client_->interact_<mdsproto::RequestHeader::Type::Replicate>(std::move(b),
+                                                                     std::move(r));
+        return in_sync;
+    }
+
     const std::string nspace_;
     ClientNG::Ptr client_;
 };
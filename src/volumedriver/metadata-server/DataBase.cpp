@@ -35,6 +35,7 @@ std::shared_ptr<DataBase>
 DataBase::create(const DataBaseInterfacePtr& db,
                  const be::BackendConnectionManagerPtr& cm,
                  const yt::PeriodicActionPool::Ptr& act_pool,
+                 const ReplicationPool::Ptr& repl_pool,
                  const fs::path& scratch_dir,
                  uint32_t cached_pages,
                  const std::atomic<uint64_t>& poll_secs)
@@ -42,6 +43,7 @@ DataBase::create(const DataBaseInterfacePtr& db,
     std::shared_ptr<DataBase> p(new DataBase(db,
                                              cm,
                                              act_pool,
+                                             repl_pool,
                                              scratch_dir,
                                              cached_pages,
                                              poll_secs));
@@ -54,12 +56,14 @@ DataBase::create(const DataBaseInterfacePtr& db,
 DataBase::DataBase(const DataBaseInterfacePtr& db,
                    const be::BackendConnectionManagerPtr& cm,
                    const yt::PeriodicActionPool::Ptr& act_pool,
+                   const ReplicationPool::Ptr& repl_pool,
                    const fs::path& scratch_dir,
                    uint32_t cached_pages,
                    const std::atomic<uint64_t>& poll_secs)
     : db_(db)
     , cm_(cm)
     , act_pool_(act_pool)
+    , repl_pool_(repl_pool)
     , scratch_dir_(scratch_dir)
     , cached_pages_(cached_pages)
     , poll_secs_(poll_secs)
@@ -144,6 +148,7 @@ DataBase::create_table_(const std::string& nspace,
     auto table(std::make_shared<Table>(db_,
                                        cm_->newBackendInterface(be::Namespace(nspace)),
                                        act_pool_,
+                                       repl_pool_,
                                        scratch_dir(nspace),
                                        cached_pages_,
                                        poll_secs_,
@@ -45,6 +45,7 @@ public:
     create(const DataBaseInterfacePtr&,
            const backend::BackendConnectionManagerPtr&,
            const youtils::PeriodicActionPool::Ptr&,
+           const ReplicationPool::Ptr&,
            const boost::filesystem::path& scratch_dir,
            uint32_t cached_pages,
            const std::atomic<uint64_t>& poll_secs);
@@ -83,6 +84,7 @@ private:
     DataBaseInterfacePtr db_;
     backend::BackendConnectionManagerPtr cm_;
     youtils::PeriodicActionPool::Ptr act_pool_;
+    ReplicationPool::Ptr repl_pool_;
     const boost::filesystem::path scratch_dir_;
     const uint32_t cached_pages_;
     const std::atomic<uint64_t>& poll_secs_;
@@ -95,6 +97,7 @@ private:
     DataBase(const DataBaseInterfacePtr&,
              const backend::BackendConnectionManagerPtr&,
              const youtils::PeriodicActionPool::Ptr&,
+             const ReplicationPool::Ptr&,
              const boost::filesystem::path& scratch_dir,
              uint32_t cached_pages,
              const std::atomic<uint64_t>& poll_secs);
@@ -27,11 +27,13 @@
 
 #include <youtils/BooleanEnum.h>
 
+#include <volumedriver/MDSNodeConfig.h>
 #include <volumedriver/OwnerTag.h>
 #include <volumedriver/ScrubId.h>
 #include <volumedriver/Types.h>
 
 VD_BOOLEAN_ENUM(Barrier);
+VD_BOOLEAN_ENUM(InSync);
 
 namespace metadata_server
 {
@@ -267,6 +269,42 @@ public:
     virtual TableCounters
     get_counters(volumedriver::Reset) = 0;
 
+    // Push based replication: a master table forwards its updates to the
+    // slaves registered here (an empty list stops that). Slaves that fall out
+    // of sync keep catching up from the backend.
+    virtual void
+    set_slaves(const volumedriver::MDSNodeConfigs&,
+               volumedriver::OwnerTag) = 0;
+
+    struct Update
+    {
+        Update(const Records& recs,
+               Barrier b)
+            : records(recs)
+            , barrier(b)
+        {}
+
+        ~Update() = default;
+
+        Update(const Update&) = default;
+
+        Update&
+        operator=(const Update&) = default;
+
+        Records records;
+        Barrier barrier;
+    };
+
+    using Updates = std::vector<Update>;
+
+    // Slave side of the above: `seqnum' is the sequence number of the first of
+    // the updates within the master's stream `stream_id'. Returns whether the
+    // table is in sync with that stream, i.e. whether the updates were applied.
+    virtual InSync
+    replicate(uint64_t stream_id,
+              uint64_t seqnum,
+              const Updates&) = 0;
+
 private:
     Role role_ = Role::Slave;
     volumedriver::OwnerTag owner_tag_ = volumedriver::OwnerTag(0);
@@ -52,6 +52,10 @@ Manager::Manager(const bpt::ptree& pt,
                                                mds_bg_threads.value() ?
                                                mds_bg_threads.value() :
                                                boost::thread::hardware_concurrency()))
+    , repl_pool_(ReplicationPool::create("mds-replication",
+                                         mds_bg_threads.value() ?
+                                         mds_bg_threads.value() :
+                                         boost::thread::hardware_concurrency()))
 {
     LOCK();
     nodes_ = make_nodes_((ip::PARAMETER_TYPE(mds_nodes)(pt)).value());
@@ -249,6 +253,7 @@ Manager::make_server_(const ServerConfig& cfg) const
                                                              cfg.rocks_config),
                              cm_,
                              act_pool_,
+                             repl_pool_,
                              cfg.scratch_path,
                              mds_cached_pages.value(),
                              mds_poll_secs.value()));
@@ -118,6 +118,7 @@ private:
 
     backend::BackendConnectionManagerPtr cm_;
     youtils::PeriodicActionPool::Ptr act_pool_;
+    ReplicationPool::Ptr repl_pool_;
 
     // protects nodes_
     mutable boost::mutex lock_;
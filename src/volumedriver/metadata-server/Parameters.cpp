@@ -135,7 +135,7 @@ DEFINE_INITIALIZED_PARAM_WITH_DEFAULT(mds_threads,
 DEFINE_INITIALIZED_PARAM_WITH_DEFAULT(mds_bg_threads,
                                       mds_component_name,
                                       "mds_bg_threads",
-                                      "Number of MDS background threads per node (0 -> autoconfiguration based on the number of available CPUs)",
+                                      "Number of MDS background threads (periodic checks and forwarding updates to slaves, respectively) per node (0 -> autoconfiguration based on the number of available CPUs)",
                                       ShowDocumentation::F,
                                       4);
 
@@ -53,6 +53,8 @@ req_hdr_reminder(RequestHeader::Type t)
         C(CatchUp);
         C(GetTableCounters);
         C(GetOwnerTag);
+        C(SetSlaves);
+        C(Replicate);
         // If the compiler yells at you that you've forgotten dealing with an enum
         // value chances are that it's also missing from the translations map below.
         // If so add it RIGHT NOW.
@@ -109,6 +111,8 @@ operator<<(std::ostream& os,
         P(CatchUp),
         P(GetTableCounters),
         P(GetOwnerTag),
+        P(SetSlaves),
+        P(Replicate),
     };
 
 #undef P
@@ -71,6 +71,8 @@ struct RequestHeader
         CatchUp = 10,
         GetTableCounters = 11,
         GetOwnerTag = 12,
+        SetSlaves = 13,
+        Replicate = 14,
     };
 
     RequestHeader() = default;
@@ -192,6 +194,8 @@ MAKE_REQUEST(ApplyRelocationLogs);
 MAKE_REQUEST(CatchUp);
 MAKE_REQUEST(GetTableCounters);
 MAKE_REQUEST(GetOwnerTag);
+MAKE_REQUEST(SetSlaves);
+MAKE_REQUEST(Replicate);
 
 #undef MAKE_REQUEST
 
@@ -0,0 +1,596 @@
+// Copyright (C) 2016 iNuron NV
+//
+// This file is part of Open vStorage Open Source Edition (OSE),
+// as available from
+//
+//      http://www.openvstorage.org and
+//      http://www.openvstorage.com.
+//
+// This file is free software; you can redistribute it and/or modify it
+// under the terms of the GNU Affero General Public License v3 (GNU AGPLv3)
+// as published by the Free Software Foundation, in version 3 as it comes in
+// the LICENSE.txt file of the Open vStorage OSE distribution.
+// Open vStorage is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY of any kind.
+
+#include "ClientNG.h"
+#include "Replicator.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include <boost/thread.hpp>
+
+#include <youtils/Assert.h>
+#include <youtils/Catchers.h>
+#include <youtils/SourceOfUncertainty.h>
+
+namespace metadata_server
+{
+
+namespace vd = volumedriver;
+namespace yt = youtils;
+
+struct ReplicationPool::Update
+{
+    Update(const TableInterface::Records& recs,
+           Barrier b)
+        : barrier(b)
+    {
+        records.reserve(recs.size());
+
+        for (const auto& r : recs)
+        {
+            boost::optional<std::string> val;
+            if (r.val.data != nullptr)
+            {
+                val = std::string(static_cast<const char*>(r.val.data),
+                                  r.val.size);
+            }
+
+            records.emplace_back(std::string(static_cast<const char*>(r.key.data),
+                                             r.key.size),
+                                 std::move(val));
+        }
+    }
+
+    ~Update() = default;
+
+    Update(const Update&) = delete;
+
+    Update&
+    operator=(const Update&) = delete;
+
+    TableInterface::Update
+    view() const
+    {
+        TableInterface::Records recs;
+        recs.reserve(records.size());
+
+        for (const auto& r : records)
+        {
+            recs.emplace_back(Key(r.first),
+                              r.second ?
+                              Value(r.second->data(),
+                                    r.second->size()) :
+                              Value(None()));
+        }
+
+        return TableInterface::Update(recs,
+                                      barrier);
+    }
+
+    // a value of boost::none denotes a deletion
+    std::vector<std::pair<std::string, boost::optional<std::string>>> records;
+    const Barrier barrier;
+};
+
+// Per slave node: the connection and the namespaces (Senders) that have updates
+// queued for it.
+class ReplicationPool::Link
+{
+public:
+    explicit Link(const vd::MDSNodeConfig& c)
+        : cfg(c)
+    {}
+
+    ~Link() = default;
+
+    Link(const Link&) = delete;
+
+    Link&
+    operator=(const Link&) = delete;
+
+    const vd::MDSNodeConfig cfg;
+
+    // protected by ReplicationPool::lock_; `active' is set while the link is
+    // queued on the pool or being served by one of its threads
+    bool active = false;
+    std::deque<SenderPtr> ready;
+
+    // only accessed by the thread serving the link
+    std::shared_ptr<ClientNG> client;
+    uint64_t generation = 0;
+    std::chrono::steady_clock::time_point backoff_until;
+};
+
+// Per (namespace, slave node): the updates yet to be sent.
+class ReplicationPool::Sender
+{
+public:
+    Sender(const std::string& ns,
+           const LinkPtr& l,
+           const std::shared_ptr<std::atomic<bool>>& rs,
+           const size_t mq,
+           const size_t mb)
+        : nspace(ns)
+        , link(l)
+        , resync(rs)
+        , max_queued(mq)
+        , max_batch(mb)
+    {
+        VERIFY(max_queued > 0);
+        VERIFY(max_batch > 0);
+    }
+
+    ~Sender() = default;
+
+    Sender(const Sender&) = delete;
+
+    Sender&
+    operator=(const Sender&) = delete;
+
+    const std::string nspace;
+    const LinkPtr link;
+    const std::shared_ptr<std::atomic<bool>> resync;
+    const size_t max_queued;
+    const size_t max_batch;
+
+    // protected by ReplicationPool::lock_
+    bool stopped = false;
+    bool ready = false;
+    std::deque<Entry> queue;
+    uint64_t dropped = 0;
+
+    // only accessed by the thread serving the link
+    TableInterfacePtr table;
+    uint64_t generation = 0;
+    bool in_sync = false;
+};
+
+ReplicationPool::Ptr
+ReplicationPool::create(const std::string& name,
+                        const size_t nthreads,
+                        const boost::optional<std::chrono::seconds>& timeout)
+{
+    return Ptr(new ReplicationPool(name,
+                                   nthreads,
+                                   timeout));
+}
+
+ReplicationPool::ReplicationPool(const std::string& name,
+                                 const size_t nthreads,
+                                 const boost::optional<std::chrono::seconds>& timeout)
+    : name_(name)
+    , timeout_(timeout)
+    , stop_(false)
+{
+    VERIFY(nthreads > 0);
+
+    LOG_INFO(name_ << ": starting " << nthreads << " threads");
+
+    try
+    {
+        for (size_t i = 0; i < nthreads; ++i)
+        {
+            threads_.create_thread([this]
+                                   {
+                                       run_();
+                                   });
+        }
+    }
+    catch (...)
+    {
+        {
+            boost::lock_guard<decltype(lock_)> g(lock_);
+            stop_ = true;
+            cond_.notify_all();
+        }
+
+        threads_.join_all();
+        throw;
+    }
+}
+
+ReplicationPool::~ReplicationPool()
+{
+    LOG_INFO(name_ << ": stopping");
+
+    {
+        boost::lock_guard<decltype(lock_)> g(lock_);
+        stop_ = true;
+        cond_.notify_all();
+    }
+
+    try
+    {
+        threads_.join_all();
+    }
+    CATCH_STD_ALL_LOG_IGNORE(name_ << ": failed to join threads");
+
+    // break the Link <-> Sender cycles of the links that were still queued
+    for (auto& l : ready_)
+    {
+        l->ready.clear();
+    }
+
+    ready_.clear();
+}
+
+ReplicationPool::SenderPtr
+ReplicationPool::add_sender_(const std::string& nspace,
+                             const vd::MDSNodeConfig& cfg,
+                             const std::shared_ptr<std::atomic<bool>>& resync,
+                             const size_t max_queued,
+                             const size_t max_batch)
+{
+    boost::lock_guard<decltype(lock_)> g(lock_);
+
+    LinkPtr link(links_[cfg].lock());
+    if (link == nullptr)
+    {
+        link = std::make_shared<Link>(cfg);
+        links_[cfg] = link;
+    }
+
+    // drop the entries of links that went away in the meantime
+    for (auto it = links_.begin(); it != links_.end();)
+    {
+        if (it->second.expired())
+        {
+            it = links_.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    return std::make_shared<Sender>(nspace,
+                                    link,
+                                    resync,
+                                    max_queued,
+                                    max_batch);
+}
+
+void
+ReplicationPool::remove_sender_(const SenderPtr& s)
+{
+    boost::lock_guard<decltype(lock_)> g(lock_);
+
+    s->stopped = true;
+    s->queue.clear();
+
+    if (s->ready)
+    {
+        auto& ready = s->link->ready;
+        ready.erase(std::remove(ready.begin(),
+                                ready.end(),
+                                s),
+                    ready.end());
+        s->ready = false;
+    }
+}
+
+void
+ReplicationPool::push_(const SenderPtr& s,
+                       const Entry& e)
+{
+    boost::lock_guard<decltype(lock_)> g(lock_);
+
+    if (s->stopped)
+    {
+        return;
+    }
+
+    if (s->queue.size() >= s->max_queued)
+    {
+        s->queue.pop_front();
+        ++s->dropped;
+    }
+
+    s->queue.push_back(e);
+
+    if (not s->ready)
+    {
+        s->ready = true;
+        s->link->ready.push_back(s);
+    }
+
+    if (not s->link->active)
+    {
+        s->link->active = true;
+        ready_.push_back(s->link);
+        cond_.notify_one();
+    }
+}
+
+void
+ReplicationPool::run_()
+{
+    pthread_setname_np(pthread_self(), "mds_replicator");
+
+    boost::unique_lock<decltype(lock_)> u(lock_);
+
+    while (true)
+    {
+        cond_.wait(u,
+                   [&]() -> bool
+                   {
+                       return stop_ or not ready_.empty();
+                   });
+
+        if (stop_)
+        {
+            break;
+        }
+
+        LinkPtr link(std::move(ready_.front()));
+        ready_.pop_front();
+
+        SenderPtr sender;
+        std::vector<Entry> batch;
+        uint64_t dropped = 0;
+
+        if (not link->ready.empty())
+        {
+            sender = std::move(link->ready.front());
+            link->ready.pop_front();
+
+            // Only contiguous updates of the same stream go into a batch.
+            auto& queue = sender->queue;
+            while (not queue.empty() and batch.size() < sender->max_batch)
+            {
+                const Entry& e = queue.front();
+                if (not batch.empty() and
+                    (e.stream_id != batch.back().stream_id or
+                     e.seqnum != batch.back().seqnum + 1))
+                {
+                    break;
+                }
+
+                batch.push_back(e);
+                queue.pop_front();
+            }
+
+            std::swap(dropped,
+                      sender->dropped);
+
+            // take turns with the other namespaces on this link
+            if (queue.empty())
+            {
+                sender->ready = false;
+            }
+            else
+            {
+                link->ready.push_back(sender);
+            }
+        }
+
+        if (not batch.empty())
+        {
+            u.unlock();
+
+            if (dropped)
+            {
+                LOG_WARN(sender->nspace << ": " << link->cfg <<
+                         " could not keep up, dropped " << dropped << " updates");
+            }
+
+            send_(*link,
+                  *sender,
+                  batch);
+
+            batch.clear();
+            sender.reset();
+
+            u.lock();
+        }
+
+        if (link->ready.empty())
+        {
+            link->active = false;
+        }
+        else
+        {
+            ready_.push_back(std::move(link));
+            cond_.notify_one();
+        }
+    }
+}
+
+void
+ReplicationPool::send_(Link& link,
+                       Sender& sender,
+                       const std::vector<Entry>& batch)
+{
+    VERIFY(not batch.empty());
+
+    // Don't hammer a slave that's out to lunch - the updates queued up in the
+    // meantime are dropped and the slave catches up from the backend.
+    if (std::chrono::steady_clock::now() < link.backoff_until)
+    {
+        sender.in_sync = false;
+        *sender.resync = true;
+        return;
+    }
+
+    try
+    {
+        if (sender.table == nullptr or sender.generation != link.generation)
+        {
+            sender.table = nullptr;
+
+            if (link.client == nullptr)
+            {
+                link.client = ClientNG::create(link.cfg,
+                                               8ULL << 10,
+                                               timeout_);
+            }
+
+            sender.table = link.client->open(sender.nspace);
+            sender.generation = link.generation;
+        }
+
+        TableInterface::Updates updates;
+        updates.reserve(batch.size());
+
+        for (const auto& e : batch)
+        {
+            updates.emplace_back(e.update->view());
+        }
+
+        const InSync in_sync = sender.table->replicate(batch.front().stream_id,
+                                                       batch.front().seqnum,
+                                                       updates);
+        if (in_sync == InSync::F)
+        {
+            *sender.resync = true;
+        }
+
+        if ((in_sync == InSync::T) != sender.in_sync)
+        {
+            LOG_INFO(sender.nspace << ": " << link.cfg << " is " <<
+                     (in_sync == InSync::T ? "now" : "no longer") <<
+                     " in sync with stream " << batch.front().stream_id <<
+                     ", seqnum " << batch.front().seqnum);
+            sender.in_sync = in_sync == InSync::T;
+        }
+    }
+    CATCH_STD_ALL_EWHAT({
+            LOG_ERROR(sender.nspace << ": failed to forward " << batch.size() <<
+                      " updates to " << link.cfg << ": " << EWHAT);
+
+            // the connection is shared by all namespaces on this link
+            sender.table = nullptr;
+            link.client = nullptr;
+            ++link.generation;
+            link.backoff_until = std::chrono::steady_clock::now() +
+                std::chrono::seconds(1);
+
+            sender.in_sync = false;
+            *sender.resync = true;
+        });
+}
+
+Replicator::Replicator(const ReplicationPool::Ptr& pool,
+                       const std::string& nspace,
+                       const vd::MDSNodeConfigs& slaves,
+                       const std::string& sync_key,
+                       const size_t max_queued,
+                       const size_t max_batch)
+    : pool_(pool)
+    , nspace_(nspace)
+    , slaves_(slaves)
+    , sync_key_(sync_key)
+    , resync_(std::make_shared<std::atomic<bool>>(false))
+    , next_seqnum_(0)
+{
+    VERIFY(pool_);
+
+    restart();
+
+    LOG_INFO(nspace_ << ": forwarding updates to " << slaves_.size() <<
+             " slaves, max queued updates per slave " << max_queued <<
+             ", max batch size " << max_batch);
+
+    senders_.reserve(slaves_.size());
+
+    for (const auto& s : slaves_)
+    {
+        LOG_INFO("\t" << s);
+        senders_.emplace_back(pool_->add_sender_(nspace_,
+                                                 s,
+                                                 resync_,
+                                                 max_queued,
+                                                 max_batch));
+    }
+}
+
+Replicator::~Replicator()
+{
+    LOG_INFO(nspace_ << ": no longer forwarding updates");
+
+    for (auto& s : senders_)
+    {
+        pool_->remove_sender_(s);
+    }
+}
+
+void
+Replicator::restart()
+{
+    stream_id_ = yt::SourceOfUncertainty()(static_cast<uint64_t>(1),
+                                           std::numeric_limits<uint64_t>::max());
+    next_seqnum_ = 0;
+    sync_val_ = boost::none;
+
+    LOG_INFO(nspace_ << ": starting replication stream " << stream_id_);
+}
+
+boost::optional<std::string>
+Replicator::sync_value(const TableInterface::Records& recs,
+                       const std::string& sync_key)
+{
+    if (recs.size() == 1 and
+        recs[0].val.data != nullptr and
+        recs[0].key.size == sync_key.size() and
+        memcmp(recs[0].key.data,
+               sync_key.data(),
+               sync_key.size()) == 0)
+    {
+        return std::string(static_cast<const char*>(recs[0].val.data),
+                           recs[0].val.size);
+    }
+    else
+    {
+        return boost::none;
+    }
+}
+
+void
+Replicator::forward(const TableInterface::Records& recs,
+                    Barrier barrier)
+{
+    if (sync_val_ and resync_->exchange(false))
+    {
+        // Give slaves that fell out of sync a point to rejoin at. This does not
+        // modify the state of slaves that are in sync.
+        const TableInterface::Records sync_recs{ Record(Key(sync_key_),
+                                                        Value(*sync_val_)) };
+        push_(std::make_shared<const Update>(sync_recs,
+                                             Barrier::T));
+    }
+
+    push_(std::make_shared<const Update>(recs,
+                                         barrier));
+    sync_val_ = sync_value(recs,
+                           sync_key_);
+}
+
+void
+Replicator::push_(UpdatePtr u)
+{
+    const Entry e{ stream_id_,
+                   next_seqnum_++,
+                   std::move(u) };
+
+    for (auto& s : senders_)
+    {
+        pool_->push_(s,
+                     e);
+    }
+}
+
+}
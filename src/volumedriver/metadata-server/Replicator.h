@@ -0,0 +1,204 @@
+// Copyright (C) 2016 iNuron NV
+//
+// This file is part of Open vStorage Open Source Edition (OSE),
+// as available from
+//
+//      http://www.openvstorage.org and
+//      http://www.openvstorage.com.
+//
+// This file is free software; you can redistribute it and/or modify it
+// under the terms of the GNU Affero General Public License v3 (GNU AGPLv3)
+// as published by the Free Software Foundation, in version 3 as it comes in
+// the LICENSE.txt file of the Open vStorage OSE distribution.
+// Open vStorage is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY of any kind.
+
+#ifndef META_DATA_SERVER_REPLICATOR_H_
+#define META_DATA_SERVER_REPLICATOR_H_
+
+#include "Interface.h"
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/optional.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <youtils/Logging.h>
+
+#include <volumedriver/MDSNodeConfig.h>
+
+namespace metadata_server
+{
+
+class Replicator;
+
+// Sends the updates of all Replicators of an MDS node with a fixed number of
+// threads and one connection per slave node. A slave node is only ever served
+// by one thread at a time which takes turns between the namespaces that have
+// updates queued for it, so an unreachable slave ties up at most one thread
+// (for at most the client timeout) and does not hold up the other slaves.
+class ReplicationPool
+{
+public:
+    using Ptr = std::shared_ptr<ReplicationPool>;
+
+    static Ptr
+    create(const std::string& name,
+           const size_t nthreads,
+           const boost::optional<std::chrono::seconds>& timeout = std::chrono::seconds(30));
+
+    ~ReplicationPool();
+
+    ReplicationPool(const ReplicationPool&) = delete;
+
+    ReplicationPool&
+    operator=(const ReplicationPool&) = delete;
+
+private:
+    DECLARE_LOGGER("MetaDataServerReplicationPool");
+
+    friend class Replicator;
+
+    // Owning copy of the records as the table's ones only point to the
+    // caller's data.
+    struct Update;
+    using UpdatePtr = std::shared_ptr<const Update>;
+
+    struct Entry
+    {
+        uint64_t stream_id;
+        uint64_t seqnum;
+        UpdatePtr update;
+    };
+
+    class Link;
+    class Sender;
+
+    using LinkPtr = std::shared_ptr<Link>;
+    using SenderPtr = std::shared_ptr<Sender>;
+
+    const std::string name_;
+    const boost::optional<std::chrono::seconds> timeout_;
+
+    // protects everything below and the queues of the Links / Senders
+    boost::mutex lock_;
+    boost::condition_variable cond_;
+    bool stop_;
+    std::map<volumedriver::MDSNodeConfig, std::weak_ptr<Link>> links_;
+    std::deque<LinkPtr> ready_;
+
+    boost::thread_group threads_;
+
+    ReplicationPool(const std::string& name,
+                    const size_t nthreads,
+                    const boost::optional<std::chrono::seconds>& timeout);
+
+    SenderPtr
+    add_sender_(const std::string& nspace,
+                const volumedriver::MDSNodeConfig&,
+                const std::shared_ptr<std::atomic<bool>>& resync,
+                const size_t max_queued,
+                const size_t max_batch);
+
+    void
+    remove_sender_(const SenderPtr&);
+
+    void
+    push_(const SenderPtr&,
+          const Entry&);
+
+    void
+    run_();
+
+    void
+    send_(Link&,
+          Sender&,
+          const std::vector<Entry>&);
+};
+
+// Master side of the push based replication (cf. TableInterface::replicate):
+// updates are numbered within a stream and queued per slave on the shared
+// ReplicationPool, so a slow or unreachable slave does not hold up the others.
+// If a slave cannot keep up, the oldest updates are dropped - the slave notices
+// the gap in the sequence numbers, leaves the stream and catches up from the
+// backend until it can rejoin at a sync point, i.e. an update consisting of
+// nothing but the `sync_key' record (the cork). Whenever a slave reports to be
+// out of sync the next update is preceded by a re-set of the current sync record
+// if the master is at such a point.
+class Replicator
+{
+public:
+    Replicator(const ReplicationPool::Ptr&,
+               const std::string& nspace,
+               const volumedriver::MDSNodeConfigs& slaves,
+               const std::string& sync_key,
+               const size_t max_queued = 4096,
+               const size_t max_batch = 128);
+
+    // Does not wait for updates that are being sent.
+    ~Replicator();
+
+    Replicator(const Replicator&) = delete;
+
+    Replicator&
+    operator=(const Replicator&) = delete;
+
+    // Not thread safe - updates need to be forwarded in the order they were
+    // applied to the master table anyway.
+    void
+    forward(const TableInterface::Records&,
+            Barrier);
+
+    // Start a new stream, e.g. after clearing the master table.
+    void
+    restart();
+
+    const volumedriver::MDSNodeConfigs&
+    slaves() const
+    {
+        return slaves_;
+    }
+
+    // The value of the `sync_key' record if the records consist of nothing else.
+    static boost::optional<std::string>
+    sync_value(const TableInterface::Records&,
+               const std::string& sync_key);
+
+private:
+    DECLARE_LOGGER("MetaDataServerReplicator");
+
+    using Update = ReplicationPool::Update;
+    using UpdatePtr = ReplicationPool::UpdatePtr;
+    using Entry = ReplicationPool::Entry;
+
+    const ReplicationPool::Ptr pool_;
+    const std::string nspace_;
+    const volumedriver::MDSNodeConfigs slaves_;
+    const std::string sync_key_;
+
+    // shared with the senders, which might outlive us
+    const std::shared_ptr<std::atomic<bool>> resync_;
+
+    uint64_t stream_id_;
+    uint64_t next_seqnum_;
+
+    // value of the sync record iff it was the last one forwarded
+    boost::optional<std::string> sync_val_;
+
+    std::vector<ReplicationPool::SenderPtr> senders_;
+
+    void
+    push_(UpdatePtr);
+};
+
+}
+
+#endif // !META_DATA_SERVER_REPLICATOR_H_
@@ -226,6 +226,21 @@ RocksTable::get_counters(vd::Reset)
     VERIFY(0 == "RocksTable::get_table_counters shouldn't be invoked");
 }
 
+void
+RocksTable::set_slaves(const vd::MDSNodeConfigs&,
+                       vd::OwnerTag)
+{
+    VERIFY(0 == "RocksTable::set_slaves shouldn't be invoked");
+}
+
+InSync
+RocksTable::replicate(uint64_t,
+                      uint64_t,
+                      const TableInterface::Updates&)
+{
+    VERIFY(0 == "RocksTable::replicate shouldn't be invoked");
+}
+
 rocksdb::ColumnFamilyMetaData
 RocksTable::column_family_metadata()
 {
@@ -84,6 +84,15 @@ public:
     virtual TableCounters
     get_counters(volumedriver::Reset) override final;
 
+    virtual void
+    set_slaves(const volumedriver::MDSNodeConfigs&,
+               volumedriver::OwnerTag) override final;
+
+    virtual InSync
+    replicate(uint64_t stream_id,
+              uint64_t seqnum,
+              const TableInterface::Updates&) override final;
+
     rocksdb::ColumnFamilyMetaData
     column_family_metadata();
 
@@ -302,6 +302,8 @@ ServerNG::dispatch_(const std::shared_ptr<C>& conn,
         CASE(CatchUp, catch_up_, yt::DeferExecution::T);
         CASE(GetTableCounters, get_table_counters_, yt::DeferExecution::F);
         CASE(GetOwnerTag, get_owner_tag_, yt::DeferExecution::F);
+        CASE(SetSlaves, set_slaves_, yt::DeferExecution::T);
+        CASE(Replicate, replicate_, yt::DeferExecution::T);
     }
 
 #undef CASE
@@ -936,4 +938,74 @@ ServerNG::get_owner_tag_(mdsproto::Methods::GetOwnerTagParams::Reader& reader,
     builder.setOwnerTag(static_cast<const uint64_t>(owner_tag));
 }
 
+void
+ServerNG::set_slaves_(mdsproto::Methods::SetSlavesParams::Reader& reader,
+                      mdsproto::Methods::SetSlavesResults::Builder&)
+{
+    const std::string nspace(reader.getNspace().begin(),
+                             reader.getNspace().size());
+    const vd::OwnerTag owner_tag(reader.getOwnerTag());
+
+    auto slaves_reader(reader.getSlaves());
+    vd::MDSNodeConfigs slaves;
+    slaves.reserve(slaves_reader.size());
+
+    for (const auto& s : slaves_reader)
+    {
+        slaves.emplace_back(std::string(s.getAddress().begin(),
+                                        s.getAddress().size()),
+                            s.getPort());
+    }
+
+    // LOG_TRACE("request to set " << slaves.size() << " slaves of " << nspace);
+
+    db_->open(nspace)->set_slaves(slaves,
+                                  owner_tag);
+}
+
+void
+ServerNG::replicate_(mdsproto::Methods::ReplicateParams::Reader& reader,
+                     mdsproto::Methods::ReplicateResults::Builder& builder)
+{
+    const std::string nspace(reader.getNspace().begin(),
+                             reader.getNspace().size());
+
+    auto updates_reader(reader.getUpdates());
+
+    TableInterface::Updates updates;
+    updates.reserve(updates_reader.size());
+
+    for (const auto& u : updates_reader)
+    {
+        auto recs_reader(u.getRecords());
+
+        TableInterface::Records recs;
+        recs.reserve(recs_reader.size());
+
+        for (const auto& r : recs_reader)
+        {
+            capnp::Data::Reader kreader(r.getKey());
+            Key k(kreader.size() ? kreader.begin() : nullptr,
+                  kreader.size());
+
+            capnp::Data::Reader vreader(r.getVal());
+            Value v(vreader.size() ? vreader.begin() : nullptr,
+                    vreader.size());
+
+            recs.emplace_back(Record(k, v));
+        }
+
+        updates.emplace_back(recs,
+                             u.getBarrier() ? Barrier::T : Barrier::F);
+    }
+
+    // LOG_TRACE("replicate request to " << nspace << ", seqnum " <<
+    //           reader.getSeqNum() << ", size " << updates.size());
+
+    const InSync in_sync(db_->open(nspace)->replicate(reader.getStreamId(),
+                                                      reader.getSeqNum(),
+                                                      updates));
+    builder.setInSync(in_sync == InSync::T);
+}
+
 }
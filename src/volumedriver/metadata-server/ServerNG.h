@@ -249,6 +249,14 @@ private:
     void
     get_owner_tag_(metadata_server_protocol::Methods::GetOwnerTagParams::Reader&,
                    metadata_server_protocol::Methods::GetOwnerTagResults::Builder&);
+
+    void
+    set_slaves_(metadata_server_protocol::Methods::SetSlavesParams::Reader&,
+                metadata_server_protocol::Methods::SetSlavesResults::Builder&);
+
+    void
+    replicate_(metadata_server_protocol::Methods::ReplicateParams::Reader&,
+               metadata_server_protocol::Methods::ReplicateResults::Builder&);
 };
 
 }
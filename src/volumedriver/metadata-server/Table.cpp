@@ -19,6 +19,7 @@
 
 #include <youtils/Assert.h>
 
+#include <volumedriver/MDSMetaDataBackend.h>
 #include <volumedriver/MetaDataStoreBuilder.h>
 #include <volumedriver/NSIDMapBuilder.h>
 #include <volumedriver/OwnerTag.h>
@@ -50,6 +51,7 @@ namespace yt = youtils;
 Table::Table(const DataBaseInterfacePtr& db,
              be::BackendInterfacePtr bi,
              const yt::PeriodicActionPool::Ptr& act_pool,
+             const ReplicationPool::Ptr& repl_pool,
              const fs::path& scratch_dir,
              const uint32_t max_cached_pages,
              const std::atomic<uint64_t>& poll_secs,
@@ -63,6 +65,10 @@ Table::Table(const DataBaseInterfacePtr& db,
     , max_cached_pages_(max_cached_pages)
     , scratch_dir_(scratch_dir)
     , drop_callback_(std::move(drop_callback))
+    , repl_pool_(repl_pool)
+    , in_sync_(false)
+    , stream_id_(0)
+    , next_seqnum_(0)
 {
     VERIFY(bi_->getNS().str() == table_->nspace());
 
@@ -120,6 +126,7 @@ Table::set_role(Role role,
                 vd::OwnerTag owner_tag)
 {
     decltype(act_) stop_act;
+    decltype(replicator_) stop_replicator;
 
     LOCKW();
 
@@ -135,10 +142,12 @@ Table::set_role(Role role,
         case Role::Master:
             {
                 stop_act = std::move(act_);
+                leave_stream_("becoming master");
                 break;
             }
         case Role::Slave:
             {
+                stop_replicator = std::move(replicator_);
                 start_(sc::milliseconds(0));
                 break;
             }
@@ -201,6 +210,8 @@ Table::apply_relocations(const vd::ScrubId& exp_backend_scrub_id,
     }
     else
     {
+        leave_stream_("applying relocations");
+
         vd::MetaDataStoreBuilder builder(*mdstore,
                                          bi_->clone(),
                                          scratch_dir_);
@@ -296,6 +307,12 @@ Table::multiset(const TableInterface::Records& records,
     table_->multiset(records,
                      barrier,
                      owner_tag);
+
+    if (replicator_)
+    {
+        replicator_->forward(records,
+                             barrier);
+    }
 }
 
 TableInterface::MaybeStrings
@@ -317,6 +334,18 @@ Table::work_()
 
     if (TableInterface::get_role() == Role::Slave)
     {
+        // Updates might have been lost without us noticing (there were none
+        // after them), so we only rely on the stream as long as it's lively.
+        if (in_sync_ and
+            sc::steady_clock::now() - last_replicated_ < sc::seconds(poll_secs_.load()))
+        {
+            LOG_INFO(table_->nspace() <<
+                     ": in sync with the master's replication stream, no need to poll the backend");
+            return yt::PeriodicActionContinue::T;
+        }
+
+        leave_stream_("polling the backend");
+
         try
         {
             auto mdstore(make_mdstore_());
@@ -361,6 +390,11 @@ Table::clear(vd::OwnerTag owner_tag)
     check_updates_permitted_(owner_tag,
                              "clear");
     table_->clear(owner_tag);
+
+    if (replicator_)
+    {
+        replicator_->restart();
+    }
 }
 
 size_t
@@ -379,6 +413,11 @@ Table::catch_up(vd::DryRun dry_run,
     }
     else
     {
+        if (dry_run == vd::DryRun::F)
+        {
+            leave_stream_("catching up");
+        }
+
         auto mdstore(make_mdstore_());
 
         vd::MetaDataStoreBuilder builder(*mdstore,
@@ -434,4 +473,136 @@ Table::update_counters_(const vd::MetaDataStoreBuilder::Result& res)
     }
 }
 
+void
+Table::set_slaves(const vd::MDSNodeConfigs& slaves,
+                  vd::OwnerTag owner_tag)
+{
+    LOG_INFO(table_->nspace() << ": request to forward updates to " <<
+             slaves.size() << " slaves, owner tag " << owner_tag);
+
+    decltype(replicator_) old_replicator;
+
+    LOCKW();
+    LOCK_OWNER();
+
+    check_updates_permitted_(owner_tag,
+                             "set_slaves");
+
+    if (replicator_ and replicator_->slaves() == slaves)
+    {
+        LOG_INFO(table_->nspace() << ": already forwarding updates to these slaves");
+        return;
+    }
+
+    old_replicator = std::move(replicator_);
+
+    if (not slaves.empty())
+    {
+        replicator_ = std::make_unique<Replicator>(repl_pool_,
+                                                   table_->nspace(),
+                                                   slaves,
+                                                   vd::MDSMetaDataBackend::cork_record_key());
+    }
+}
+
+InSync
+Table::replicate(const uint64_t stream_id,
+                 const uint64_t seqnum,
+                 const TableInterface::Updates& updates)
+{
+    // Don't queue up behind a rebuild from the backend or a role change - the
+    // master will give us another chance to rejoin its stream.
+    boost::upgrade_lock<decltype(rwlock_)> ulg(rwlock_,
+                                               boost::try_to_lock);
+    if (not ulg.owns_lock())
+    {
+        return InSync::F;
+    }
+
+    if (TableInterface::get_role() != Role::Slave)
+    {
+        LOG_WARN(table_->nspace() << ": ignoring replicated updates while in role " <<
+                 TableInterface::get_role());
+        return InSync::F;
+    }
+
+    size_t first = 0;
+
+    if (not in_sync_ or
+        stream_id != stream_id_ or
+        seqnum != next_seqnum_)
+    {
+        if (in_sync_)
+        {
+            LOG_WARN(table_->nspace() << ": expected seqnum " << next_seqnum_ <<
+                     " of stream " << stream_id_ << ", got seqnum " << seqnum <<
+                     " of stream " << stream_id);
+            leave_stream_("gap in the replication stream");
+        }
+
+        // We can (re)join where the master is at the cork we have - a full
+        // rebuild from the backend doesn't leave anything else to rely on.
+        const std::string& cork_key(vd::MDSMetaDataBackend::cork_record_key());
+        const TableInterface::Keys keys{ Key(cork_key) };
+        const TableInterface::MaybeStrings cork(table_->multiget(keys));
+
+        if (cork[0] == boost::none)
+        {
+            return InSync::F;
+        }
+
+        while (first < updates.size() and
+               Replicator::sync_value(updates[first].records,
+                                      cork_key) != cork[0])
+        {
+            ++first;
+        }
+
+        if (first == updates.size())
+        {
+            return InSync::F;
+        }
+
+        LOG_INFO(table_->nspace() << ": joining replication stream " << stream_id <<
+                 " at seqnum " << (seqnum + first));
+
+        // the sync point itself does not carry anything new
+        ++first;
+        in_sync_ = true;
+        stream_id_ = stream_id;
+    }
+
+    try
+    {
+        for (size_t i = first; i < updates.size(); ++i)
+        {
+            table_->multiset(updates[i].records,
+                             updates[i].barrier,
+                             TableInterface::owner_tag());
+        }
+    }
+    CATCH_STD_ALL_EWHAT({
+            LOG_ERROR(table_->nspace() << ": failed to apply replicated updates: " <<
+                      EWHAT);
+            leave_stream_("failed to apply replicated updates");
+            throw;
+        });
+
+    next_seqnum_ = seqnum + updates.size();
+    last_replicated_ = sc::steady_clock::now();
+
+    return InSync::T;
+}
+
+void
+Table::leave_stream_(const char* why)
+{
+    if (in_sync_)
+    {
+        LOG_INFO(table_->nspace() << ": leaving replication stream " << stream_id_ <<
+                 ": " << why);
+        in_sync_ = false;
+    }
+}
+
 }
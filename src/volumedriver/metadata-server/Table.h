@@ -17,7 +17,9 @@
 #define META_DATA_SERVER_TABLE_H_
 
 #include "Interface.h"
+#include "Replicator.h"
 
+#include <chrono>
 #include <functional>
 #include <memory>
 
@@ -82,6 +84,7 @@ public:
     Table(const DataBaseInterfacePtr&,
           backend::BackendInterfacePtr bi,
           const youtils::PeriodicActionPool::Ptr&,
+          const ReplicationPool::Ptr&,
           const boost::filesystem::path& scratch_dir,
           const uint32_t max_cached_pages,
           const std::atomic<uint64_t>& poll_secs,
@@ -132,6 +135,15 @@ public:
     virtual TableCounters
     get_counters(volumedriver::Reset) override final;
 
+    virtual void
+    set_slaves(const volumedriver::MDSNodeConfigs&,
+               volumedriver::OwnerTag) override final;
+
+    virtual InSync
+    replicate(uint64_t stream_id,
+              uint64_t seqnum,
+              const TableInterface::Updates&) override final;
+
     void
     stop();
 
@@ -158,6 +170,17 @@ private:
     TableCounters counters_;
     DropCallback drop_callback_;
 
+    // master role: forwards the updates to the slaves, if any.
+    ReplicationPool::Ptr repl_pool_;
+    std::unique_ptr<Replicator> replicator_;
+
+    // slave role: position within the master's replication stream. Protected by
+    // rwlock_ being held in upgrade or exclusive mode.
+    bool in_sync_;
+    uint64_t stream_id_;
+    uint64_t next_seqnum_;
+    std::chrono::steady_clock::time_point last_replicated_;
+
     void
     start_(const std::chrono::milliseconds& ramp_up);
 
@@ -177,6 +200,9 @@ private:
     void
     update_counters_(const volumedriver::MetaDataStoreBuilder::Result&);
 
+    void
+    leave_stream_(const char* why);
+
     volumedriver::NSIDMap&
     get_nsid_map_();
 };
@@ -110,6 +110,24 @@ public:
         return lock_()->get_counters(reset);
     }
 
+    virtual void
+    set_slaves(const volumedriver::MDSNodeConfigs& slaves,
+               volumedriver::OwnerTag owner_tag) override final
+    {
+        lock_()->set_slaves(slaves,
+                            owner_tag);
+    }
+
+    virtual InSync
+    replicate(uint64_t stream_id,
+              uint64_t seqnum,
+              const Updates& updates) override final
+    {
+        return lock_()->replicate(stream_id,
+                                  seqnum,
+                                  updates);
+    }
+
     MAKE_EXCEPTION(Exception,
                    fungi::IOException);
 
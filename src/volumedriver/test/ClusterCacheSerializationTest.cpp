@@ -50,7 +50,8 @@ public:
 
     ClusterCacheFakeStore(const fs::path& path,
                           const uint64_t size,
-                          const size_t csize)
+                          const size_t csize,
+                          const MountPointIoMode = MountPointIoMode::Buffered)
         : path_(path)
         , cluster_size_(csize)
         , total_size_(size - (size % cluster_size_))
@@ -78,6 +79,17 @@ public:
         return cluster_size_;
     }
 
+    using ReadRequest = ClusterCacheDiskStore::ReadRequest;
+
+    void
+    read(std::vector<ReadRequest>& reqs)
+    {
+        for (auto& req : reqs)
+        {
+            req.result = cluster_size_;
+        }
+    }
+
     void
     check(const yt::Weed&,
          uint32_t)
@@ -108,6 +120,10 @@ public:
     reinstate()
     {}
 
+    void
+    set_io_mode(const MountPointIoMode)
+    {}
+
     void
     sync()
     {}
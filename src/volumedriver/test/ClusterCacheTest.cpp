@@ -20,13 +20,19 @@
 #include <sys/ioctl.h>
 #include <sys/mount.h>
 
+#include <atomic>
+#include <numeric>
+
 #include <boost/filesystem/fstream.hpp>
 
 #include <youtils/DimensionedValue.h>
 #include <youtils/IOException.h>
 #include <youtils/Logging.h>
 #include <youtils/ScopeExit.h>
+#include <youtils/SourceOfUncertainty.h>
+#include <youtils/System.h>
 #include <youtils/wall_timer.h>
+#include <youtils/WeedAlgorithm.h>
 
 #include "../Api.h"
 #include "../VolManager.h"
@@ -1851,6 +1857,92 @@ TEST_P(ClusterCacheTest, error_during_deserialization)
 #endif
 }
 
+TEST_P(ClusterCacheTest, murmur3_weeds_survive_deserialization)
+{
+    const auto wrns(make_random_namespace());
+    SharedVolumePtr v = newVolume(*wrns);
+
+    v->set_cluster_cache_behaviour(ClusterCacheBehaviour::CacheOnWrite);
+    v->set_weed_algorithm(yt::WeedAlgorithm::Murmur3_128);
+
+    const std::string s("The weeds of the fields, the weeds of the sea");
+
+    const size_t count = 1;
+    writeClusters(*v,
+                  count,
+                  s);
+    checkClusters(*v,
+                  count,
+                  s);
+
+    bpt::ptree pt;
+    VolManager::get()->persistConfiguration(pt,
+                                            ReportDefault::T);
+
+    const ip::PARAMETER_TYPE(serialize_read_cache) serialize(pt);
+    ASSERT_TRUE(serialize.value());
+
+    temporarilyStopVolManager();
+    restartVolManager(pt);
+
+    localRestart(wrns->ns());
+
+    v = getVolume(VolumeId(wrns->ns().str()));
+    EXPECT_EQ(yt::WeedAlgorithm::Murmur3_128,
+              v->get_weed_algorithm());
+
+    checkClusters(*v,
+                  count,
+                  s);
+
+    // the (checked) entry must not have been thrown away
+#ifdef ENABLE_MD5_HASH
+    CHECK_STATS(Devices(2),
+                Hits(count),
+                Misses(0),
+                Entries(count));
+#else
+    CHECK_STATS(Devices(2),
+                Hits(0),
+                Misses(0),
+                Entries(0));
+#endif
+}
+
+TEST_P(ClusterCacheTest, disk_store_check)
+{
+    const size_t csize = VolManager::get()->getClusterCache().cluster_size();
+    const size_t nclusters = 2;
+
+    const fs::path path(setupClusterCacheDevice("disk_store_check",
+                                                (nclusters + 1) * csize));
+
+    ClusterCacheDiskStore store(path,
+                                (nclusters + 1) * csize,
+                                csize);
+
+    const std::vector<uint8_t> buf(csize, 'w');
+    ASSERT_EQ(static_cast<ssize_t>(csize),
+              store.write(buf.data(),
+                          1));
+
+    for (const auto algo : { yt::WeedAlgorithm::Md5,
+                             yt::WeedAlgorithm::Murmur3_128 })
+    {
+        EXPECT_NO_THROW(store.check(yt::make_weed(algo,
+                                                  buf.data(),
+                                                  buf.size()),
+                                    1)) << algo;
+    }
+
+    const std::vector<uint8_t> other(csize, 'v');
+    EXPECT_THROW(store.check(yt::make_weed(yt::WeedAlgorithm::Murmur3_128,
+                                           other.data(),
+                                           other.size()),
+                             1),
+                 ClusterCacheDiskStore::VerificationFailedException);
+}
+
 TEST_P(ClusterCacheTest, invalidation_when_default_behaviour_is_no_cache)
 {
     set_cluster_cache_default_behaviour(ClusterCacheBehaviour::CacheOnWrite);
@@ -1898,6 +1990,192 @@ TEST_P(ClusterCacheTest, invalidation_when_default_behaviour_is_no_cache)
                 Entries(count));
 }
 
+TEST_P(ClusterCacheTest, direct_async_store)
+{
+    const size_t csize = VolManager::get()->getClusterCache().cluster_size();
+    const size_t nclusters = 64;
+
+    const fs::path path(setupClusterCacheDevice("direct_async_store",
+                                                (nclusters + 1) * csize));
+
+    // falls back to Buffered if the underlying fs doesn't support O_DIRECT, which
+    // is fine as the outcome has to be the same
+    ClusterCacheDiskStore store(path,
+                                (nclusters + 1) * csize,
+                                csize,
+                                MountPointIoMode::DirectAsync);
+
+    std::cout << path << ": io mode " << store.io_mode() << std::endl;
+
+    // one byte more to also get buffers that aren't suitably aligned for O_DIRECT
+    std::vector<uint8_t> wbuf(nclusters * csize + 1);
+
+    for (size_t i = 0; i < nclusters; ++i)
+    {
+        uint8_t* buf = wbuf.data() + (i % 2) + i * csize;
+        memset(buf, i, csize);
+        ASSERT_EQ(static_cast<ssize_t>(csize),
+                  store.write(buf,
+                              i));
+    }
+
+    std::vector<uint8_t> rbuf(nclusters * csize + 1);
+    std::vector<ClusterCacheDiskStore::ReadRequest> reqs;
+    reqs.reserve(nclusters);
+
+    // reverse order and alternating alignment
+    for (size_t i = 0; i < nclusters; ++i)
+    {
+        reqs.emplace_back(rbuf.data() + (i % 2) + i * csize,
+                          nclusters - i - 1);
+    }
+
+    store.read(reqs);
+
+    for (size_t i = 0; i < nclusters; ++i)
+    {
+        ASSERT_EQ(static_cast<ssize_t>(csize),
+                  reqs[i].result);
+
+        const std::vector<uint8_t> ref(csize, nclusters - i - 1);
+        EXPECT_EQ(0,
+                  memcmp(ref.data(),
+                         reqs[i].buf,
+                         csize));
+    }
+
+    std::vector<uint8_t> buf(csize + 1);
+    ASSERT_EQ(static_cast<ssize_t>(csize),
+              store.read(buf.data() + 1,
+                         7));
+    EXPECT_EQ(std::vector<uint8_t>(csize, 7),
+              std::vector<uint8_t>(buf.begin() + 1,
+                                   buf.end()));
+
+    // the io mode survives a trip through the config
+    MountPointConfigs cfgs{ MountPointConfig(path,
+                                             (nclusters + 1) * csize,
+                                             MountPointIoMode::DirectAsync),
+                            MountPointConfig(path,
+                                             (nclusters + 1) * csize) };
+
+    bpt::ptree pt;
+    ip::PARAMETER_TYPE(clustercache_mount_points)(cfgs).persist(pt);
+    ip::PARAMETER_TYPE(clustercache_mount_points) param(pt);
+    EXPECT_EQ(cfgs,
+              param.value());
+}
+
+TEST_P(ClusterCacheTest, hit_throughput)
+{
+    auto& cc = VolManager::get()->getClusterCache();
+    const size_t csize = cc.cluster_size();
+
+    const uint64_t max_threads =
+        yt::System::get_env_with_default<uint64_t>("CLUSTER_CACHE_MAX_THREADS",
+                                                   64);
+    const uint64_t duration_ms =
+        yt::System::get_env_with_default<uint64_t>("CLUSTER_CACHE_BENCH_MSECS",
+                                                   1000);
+    const uint64_t nclusters =
+        std::min<uint64_t>(yt::System::get_env_with_default<uint64_t>("CLUSTER_CACHE_BENCH_CLUSTERS",
+                                                                      16384),
+                           cc.totalSizeInEntries() / 2);
+    ASSERT_LT(0U,
+              nclusters);
+
+    auto run([&](const ClusterCacheMode mode)
+             {
+                 const OwnerTag otag(1);
+                 const ClusterCacheHandle handle(cc.registerVolume(otag,
+                                                                   mode));
+                 auto on_exit(yt::make_scope_exit([&]
+                                                  {
+                                                      cc.deregisterVolume(otag);
+                                                  }));
+
+                 std::vector<yt::Weed> weeds;
+                 weeds.reserve(nclusters);
+
+                 std::vector<uint8_t> buf(csize);
+                 for (uint64_t i = 0; i < nclusters; ++i)
+                 {
+                     memcpy(buf.data(),
+                            &i,
+                            sizeof(i));
+                     weeds.emplace_back(buf.data(),
+                                        buf.size());
+                     cc.add(handle,
+                            i,
+                            weeds.back(),
+                            buf.data(),
+                            buf.size());
+                 }
+
+                 for (uint64_t nthreads = 1; nthreads <= max_threads; nthreads *= 2)
+                 {
+                     std::atomic<bool> stop(false);
+                     std::vector<uint64_t> hits(nthreads, 0);
+                     std::vector<uint64_t> misses(nthreads, 0);
+                     std::vector<boost::thread> threads;
+                     threads.reserve(nthreads);
+
+                     for (uint64_t t = 0; t < nthreads; ++t)
+                     {
+                         threads.emplace_back([&, t]
+                                              {
+                                                  yt::SourceOfUncertainty sou;
+                                                  std::vector<uint8_t> rbuf(csize);
+
+                                                  while (not stop)
+                                                  {
+                                                      const uint64_t i = sou(nclusters - 1);
+                                                      if (cc.read(handle,
+                                                                  i,
+                                                                  weeds[i],
+                                                                  rbuf.data(),
+                                                                  rbuf.size()))
+                                                      {
+                                                          ++hits[t];
+                                                      }
+                                                      else
+                                                      {
+                                                          ++misses[t];
+                                                      }
+                                                  }
+                                              });
+                     }
+
+                     yt::wall_timer wt;
+                     boost::this_thread::sleep_for(boost::chrono::milliseconds(duration_ms));
+                     stop = true;
+
+                     for (auto& t : threads)
+                     {
+                         t.join();
+                     }
+
+                     const double elapsed = wt.elapsed();
+
+                     EXPECT_EQ(0U,
+                               std::accumulate(misses.begin(),
+                                               misses.end(),
+                                               0ULL));
+
+                     const uint64_t total = std::accumulate(hits.begin(),
+                                                            hits.end(),
+                                                            0ULL);
+
+                     std::cout << mode << ", " << nclusters << " clusters, " <<
+                         nthreads << " threads: " << (total / elapsed) <<
+                         " hits/s" << std::endl;
+                 }
+             });
+
+    run(ClusterCacheMode::LocationBased);
+    run(ClusterCacheMode::ContentBased);
+}
+
 namespace
 {
 
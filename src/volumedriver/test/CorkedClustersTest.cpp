@@ -0,0 +1,264 @@
+// Copyright (C) 2016 iNuron NV
+//
+// This file is part of Open vStorage Open Source Edition (OSE),
+// as available from
+//
+//      http://www.openvstorage.org and
+//      http://www.openvstorage.com.
+//
+// This file is free software; you can redistribute it and/or modify it
+// under the terms of the GNU Affero General Public License v3 (GNU AGPLv3)
+// as published by the Free Software Foundation, in version 3 as it comes in
+// the LICENSE.txt file of the Open vStorage OSE distribution.
+// Open vStorage is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY of any kind.
+
+#include "../CorkedClusters.h"
+
+#include "VolumeDriverTestConfig.h"
+
+#include <map>
+
+#include <youtils/SourceOfUncertainty.h>
+#include <youtils/System.h>
+#include <youtils/wall_timer.h>
+
+namespace volumedrivertest
+{
+
+using namespace volumedriver;
+namespace yt = youtils;
+
+class CorkedClustersTest
+    : public testing::Test
+{
+protected:
+    using RefMap = std::map<ClusterAddress, ClusterLocationAndHash>;
+
+    static ClusterLocationAndHash
+    make_loc(SCONumber num)
+    {
+        const std::vector<uint8_t> buf(16, num & 0xff);
+        return ClusterLocationAndHash(ClusterLocation(num),
+                                      buf.data(),
+                                      buf.size());
+    }
+
+    void
+    check(const CorkedClusters& cc,
+          const RefMap& ref)
+    {
+        ASSERT_EQ(ref.size(), cc.size());
+
+        for (const auto& p : ref)
+        {
+            const ClusterLocationAndHash* loc = cc.find(p.first);
+            ASSERT_TRUE(loc != nullptr) << "CA " << p.first;
+            EXPECT_EQ(p.second.clusterLocation,
+                      loc->clusterLocation);
+        }
+
+        const std::vector<CorkedClusters::Entry> vec(cc.sorted_entries());
+        ASSERT_EQ(ref.size(), vec.size());
+
+        auto it = ref.begin();
+        for (const auto& e : vec)
+        {
+            EXPECT_EQ(it->first, e.first);
+            EXPECT_EQ(it->second.clusterLocation,
+                      e.second.clusterLocation);
+            ++it;
+        }
+    }
+
+    template<typename Insert,
+             typename Find>
+    void
+    measure(const char* desc,
+            const std::vector<ClusterAddress>& cas,
+            Insert&& insert,
+            Find&& find)
+    {
+        yt::wall_timer wt;
+
+        for (const auto& ca : cas)
+        {
+            insert(ca);
+        }
+
+        const double t_insert = wt.elapsed();
+        wt.restart();
+
+        size_t found = 0;
+        for (const auto& ca : cas)
+        {
+            if (find(ca))
+            {
+                ++found;
+            }
+        }
+
+        const double t_find = wt.elapsed();
+
+        EXPECT_EQ(cas.size(), found);
+
+        std::cout << desc << ": " << cas.size() << " random inserts: " <<
+            (cas.size() / t_insert) << " ops/s, lookups: " <<
+            (cas.size() / t_find) << " ops/s" << std::endl;
+    }
+
+    yt::SourceOfUncertainty sou_;
+};
+
+TEST_F(CorkedClustersTest, empty)
+{
+    const CorkedClusters cc;
+
+    EXPECT_TRUE(cc.empty());
+    EXPECT_EQ(0U, cc.size());
+    EXPECT_TRUE(cc.find(0) == nullptr);
+    EXPECT_TRUE(cc.sorted_entries().empty());
+
+    size_t count = 0;
+    cc.for_each_in_range(0,
+                         1ULL << 20,
+                         [&](ClusterAddress,
+                             const ClusterLocationAndHash&)
+                         {
+                             ++count;
+                         });
+
+    EXPECT_EQ(0U, count);
+}
+
+TEST_F(CorkedClustersTest, insert_and_overwrite)
+{
+    CorkedClusters cc;
+    RefMap ref;
+
+    const size_t count = 1ULL << 14;
+
+    // sequential, strided and random addresses - enough of them to make the
+    // table grow a few times.
+    for (size_t i = 0; i < count; ++i)
+    {
+        const std::vector<ClusterAddress> cas{ i,
+                                               i << 12,
+                                               sou_(1ULL << 40) };
+        for (const auto& ca : cas)
+        {
+            const ClusterLocationAndHash loc(make_loc(sou_(1U << 30) + 1));
+            cc.insert(ca, loc);
+            ref[ca] = loc;
+        }
+    }
+
+    check(cc, ref);
+
+    for (size_t i = 0; i < count; i += 3)
+    {
+        const ClusterLocationAndHash loc(make_loc(i + 1));
+        cc.insert(i, loc);
+        ref[i] = loc;
+    }
+
+    check(cc, ref);
+
+    EXPECT_TRUE(cc.find(count) == nullptr);
+}
+
+TEST_F(CorkedClustersTest, range)
+{
+    CorkedClusters cc;
+    RefMap ref;
+
+    for (ClusterAddress ca = 0; ca < 4096; ca += 7)
+    {
+        const ClusterLocationAndHash loc(make_loc(ca + 1));
+        cc.insert(ca, loc);
+        ref[ca] = loc;
+    }
+
+    auto check_range([&](ClusterAddress begin,
+                         ClusterAddress end)
+                     {
+                         RefMap found;
+                         cc.for_each_in_range(begin,
+                                              end,
+                                              [&](ClusterAddress ca,
+                                                  const ClusterLocationAndHash& loc)
+                                              {
+                                                  EXPECT_TRUE(found.emplace(ca, loc).second);
+                                              });
+
+                         const RefMap exp(ref.lower_bound(begin),
+                                          ref.lower_bound(end));
+                         ASSERT_EQ(exp.size(), found.size());
+
+                         for (const auto& p : exp)
+                         {
+                             EXPECT_EQ(p.second.clusterLocation,
+                                       found.at(p.first).clusterLocation);
+                         }
+                     });
+
+    // small ranges are probed, large ones are scanned
+    check_range(0, 1);
+    check_range(0, 7);
+    check_range(5, 300);
+    check_range(0, 4096);
+    check_range(1000, 1ULL << 20);
+    check_range(10, 10);
+}
+
+TEST_F(CorkedClustersTest, performance)
+{
+    const size_t count = yt::System::get_env_with_default<size_t>("CORKED_CLUSTERS",
+                                                                  1ULL << 20);
+    const ClusterAddress max_ca = yt::System::get_env_with_default<ClusterAddress>("MAX_CA",
+                                                                                   1ULL << 28);
+
+    std::vector<ClusterAddress> cas;
+    cas.reserve(count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        cas.push_back(sou_(max_ca));
+    }
+
+    const ClusterLocationAndHash loc(make_loc(1));
+
+    {
+        RefMap m;
+        measure("std::map",
+                cas,
+                [&](ClusterAddress ca)
+                {
+                    m[ca] = loc;
+                },
+                [&](ClusterAddress ca)
+                {
+                    return m.find(ca) != m.end();
+                });
+    }
+
+    {
+        CorkedClusters cc;
+        measure("CorkedClusters",
+                cas,
+                [&](ClusterAddress ca)
+                {
+                    cc.insert(ca, loc);
+                },
+                [&](ClusterAddress ca)
+                {
+                    return cc.find(ca) != nullptr;
+                });
+    }
+}
+
+}
+
+// Local Variables: **
+// mode: c++ **
+// End: **
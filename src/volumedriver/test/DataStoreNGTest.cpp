@@ -154,7 +154,7 @@ protected:
         descs.push_back(ClusterReadDescriptor(loc_and_hash,
                                               0,
                                               buf,
-                                              std::move(bi)));
+                                              bi.get()));
         dStore_->readClusters(descs);
     }
 
@@ -183,12 +183,12 @@ protected:
             ClusterLocationAndHash loc_and_hash(loc[i],
                                                 &buf[0] + (i * csize),
                                                 csize);
-            BackendInterfacePtr bi = vol_->getBackendInterface(loc[i].cloneID())->clone();
+            const BackendInterface* bi = vol_->getBackendInterface(loc[i].cloneID()).get();
             VERIFY(bi);
             descs.push_back(ClusterReadDescriptor(loc_and_hash,
                                                   i * csize,
                                                   &buf[i * csize],
-                                                  std::move(bi)));
+                                                  bi));
 
             const ClusterLocation& loc = loc_and_hash.clusterLocation;
             ASSERT_TRUE(locs.emplace(boost::lexical_cast<std::string>(loc)).second) <<
@@ -622,6 +622,79 @@ TEST_P(DataStoreNGTest, removeSCO)
     readClusters(1, pattern, &loc);
 }
 
+TEST_P(DataStoreNGTest, scattered_read_buffers)
+{
+    const size_t n = 8;
+    std::vector<ClusterLocation> locs(n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        writeClusters(1, 0xcafe0000 + i, &locs[i]);
+    }
+
+    for (size_t i = 1; i < n; ++i)
+    {
+        ASSERT_EQ(locs[0].sco(), locs[i].sco());
+        ASSERT_EQ(locs[i - 1].offset() + 1, locs[i].offset());
+    }
+
+    const size_t csize = dStore_->getClusterSize();
+
+    auto check([&]
+               {
+                   // every other cluster sized gap in the buffer is left
+                   // alone, so the SCO contiguous run has to be read into
+                   // non-contiguous buffers
+                   std::vector<uint8_t> buf(2 * n * csize, 0xff);
+                   std::vector<ClusterReadDescriptor> descs;
+                   descs.reserve(n);
+
+                   for (size_t i = 0; i < n; ++i)
+                   {
+                       uint8_t* b = &buf[2 * i * csize];
+                       ClusterLocationAndHash loc_and_hash(locs[i],
+                                                           b,
+                                                           csize);
+                       descs.emplace_back(loc_and_hash,
+                                          i * csize,
+                                          b,
+                                          vol_->getBackendInterface(locs[i].cloneID()).get());
+                   }
+
+                   dStore_->readClusters(descs);
+
+                   for (size_t i = 0; i < n; ++i)
+                   {
+                       const uint32_t* p =
+                           reinterpret_cast<const uint32_t*>(&buf[2 * i * csize]);
+                       for (size_t j = 0; j < csize / sizeof(*p); ++j)
+                       {
+                           ASSERT_EQ(0xcafe0000 + i, p[j]) << "cluster " << i;
+                       }
+
+                       for (size_t j = 0; j < csize; ++j)
+                       {
+                           ASSERT_EQ(0xff, buf[(2 * i + 1) * csize + j]) <<
+                               "gap after cluster " << i << " was overwritten";
+                       }
+                   }
+               });
+
+    check();
+
+    dStore_->finalizeCurrentSCO();
+    syncToBackend(*vol_);
+    dStore_->writtenToBackendUpTo(locs[0].sco());
+    dStore_->removeSCO(locs[0].sco(), false);
+
+    SCOCache* sc = VolManager::get()->getSCOCache();
+    ASSERT_TRUE(nullptr == sc->findSCO(getNamespace(),
+                                       locs[0].sco()));
+
+    // now through the backend partial read path
+    check();
+}
+
 /*
   TEST_P(DataStoreNGTest, removeSCOsForSnapshotRestore)
   {
@@ -858,6 +931,113 @@ TEST_P(DataStoreNGTest, scoFullTest)
               dStore_->getRemainingSCOCapacity());
 }
 
+TEST_P(DataStoreNGTest, failed_reservation_fences_sco)
+{
+    const size_t csize = dStore_->getClusterSize();
+    std::vector<uint8_t> buf(csize);
+    std::vector<ClusterLocation> locs(1);
+    uint32_t throttle = 0;
+
+    SCOWriteReservation res1;
+    ASSERT_EQ(1U,
+              dStore_->reserveClusters(1,
+                                       res1));
+
+    SCOWriteReservation res2;
+    ASSERT_EQ(1U,
+              dStore_->reserveClusters(1,
+                                       res2));
+
+    dStore_->writeReservedClusters(res2,
+                                   buf.data(),
+                                   throttle);
+    EXPECT_FALSE(res2.error);
+
+    res1.error = std::string("injected write error");
+
+    EXPECT_THROW(dStore_->commitClusters(res1,
+                                         buf.data(),
+                                         locs),
+                 TransientException);
+
+    // res2 might still be writing to the range behind res1: no new reservations
+    // until it's discarded
+    SCOWriteReservation res3;
+    EXPECT_EQ(0U,
+              dStore_->reserveClusters(1,
+                                       res3));
+
+    EXPECT_THROW(dStore_->commitClusters(res2,
+                                         buf.data(),
+                                         locs),
+                 TransientException);
+
+    ASSERT_EQ(1U,
+              dStore_->reserveClusters(1,
+                                       res3));
+
+    dStore_->writeReservedClusters(res3,
+                                   buf.data(),
+                                   throttle);
+    ASSERT_FALSE(res3.error);
+
+    dStore_->commitClusters(res3,
+                            buf.data(),
+                            locs);
+    EXPECT_EQ(res3.loc,
+              locs[0]);
+}
+
+TEST_P(DataStoreNGTest, discarded_reservation_fences_sco)
+{
+    const size_t csize = dStore_->getClusterSize();
+    std::vector<uint8_t> buf(csize);
+    std::vector<ClusterLocation> locs(1);
+    uint32_t throttle = 0;
+
+    SCOWriteReservation res1;
+    ASSERT_EQ(1U,
+              dStore_->reserveClusters(1,
+                                       res1));
+
+    SCOWriteReservation res2;
+    ASSERT_EQ(1U,
+              dStore_->reserveClusters(1,
+                                       res2));
+
+    dStore_->writeReservedClusters(res1,
+                                   buf.data(),
+                                   throttle);
+    ASSERT_FALSE(res1.error);
+
+    // the writer of res1 gave up before committing
+    dStore_->discardReservation(res1);
+
+    SCOWriteReservation res3;
+    EXPECT_EQ(0U,
+              dStore_->reserveClusters(1,
+                                       res3));
+
+    dStore_->discardReservation(res2);
+
+    ASSERT_EQ(1U,
+              dStore_->reserveClusters(1,
+                                       res3));
+    EXPECT_EQ(res1.loc,
+              res3.loc);
+
+    dStore_->writeReservedClusters(res3,
+                                   buf.data(),
+                                   throttle);
+    ASSERT_FALSE(res3.error);
+
+    dStore_->commitClusters(res3,
+                            buf.data(),
+                            locs);
+    EXPECT_EQ(res3.loc,
+              locs[0]);
+}
+
 // VOLDRV-143
 TEST_P(DataStoreNGTest, errorOnFinalizeSCO)
 {
@@ -54,6 +54,8 @@ FailOverCacheTestContext::FailOverCacheTestContext(FailOverCacheTestSetup& setup
                                                    const boost::optional<std::string>& addr,
                                                    const uint16_t port,
                                                    const boost::chrono::microseconds busy_retry_duration,
+                                                   const unsigned reactor_threads,
+                                                   const size_t log_segment_size,
                                                    const boost::optional<size_t> file_backend_buffer_size)
     : setup_(setup)
     , addr_(addr)
@@ -61,7 +63,9 @@ FailOverCacheTestContext::FailOverCacheTestContext(FailOverCacheTestSetup& setup
     , acceptor_(make_directory(setup_.path,
                                port_),
                 file_backend_buffer_size,
-                busy_retry_duration)
+                busy_retry_duration,
+                reactor_threads,
+                log_segment_size)
     , server_(fungi::SocketServer::createSocketServer(acceptor_,
                                                       addr_,
                                                       port_,
@@ -103,14 +107,20 @@ FailOverCacheTestSetup::transport_(vd::FailOverCacheTransport::TCP);
 boost::chrono::microseconds
 FailOverCacheTestSetup::busy_retry_duration_(0);
 
-FailOverCacheTestSetup::FailOverCacheTestSetup(const boost::optional<fs::path>& p)
+FailOverCacheTestSetup::FailOverCacheTestSetup(const boost::optional<fs::path>& p,
+                                               const unsigned nreactor_threads,
+                                               const size_t nlog_segment_size)
         : path(p)
+        , reactor_threads(nreactor_threads)
+        , log_segment_size(nlog_segment_size)
 {
     if (path)
     {
         fs::create_directories(*path);
     }
-    LOG_INFO("path " << path << ", port base " << port_base_);
+    LOG_INFO("path " << path << ", port base " << port_base_ <<
+             ", reactor threads " << reactor_threads <<
+             ", log segment size " << log_segment_size);
 }
 
 FailOverCacheTestSetup::~FailOverCacheTestSetup()
@@ -156,7 +166,9 @@ FailOverCacheTestSetup::start_one_foc()
     foctest_context_ptr ctx(new FailOverCacheTestContext(*this,
                                                          addr,
                                                          port,
-                                                         busy_retry_duration_));
+                                                         busy_retry_duration_,
+                                                         reactor_threads,
+                                                         log_segment_size));
     ports_.insert(port);
 
     return ctx;
@@ -47,6 +47,8 @@ private:
                              const boost::optional<std::string>& addr,
                              const uint16_t port,
                              const boost::chrono::microseconds busy_retry_duration,
+                             const unsigned reactor_threads,
+                             const size_t log_segment_size,
                              const boost::optional<size_t> file_backend_buffer_size = boost::none);
 
     FailOverCacheTestContext(const FailOverCacheTestContext&) = delete;
@@ -84,7 +86,9 @@ class FailOverCacheTestSetup
     friend class ::VolumeDriverTest;
 
 public:
-    explicit FailOverCacheTestSetup(const boost::optional<boost::filesystem::path>&);
+    explicit FailOverCacheTestSetup(const boost::optional<boost::filesystem::path>&,
+                                    const unsigned reactor_threads = 0,
+                                    const size_t log_segment_size = 0);
 
     ~FailOverCacheTestSetup();
 
@@ -119,6 +123,12 @@ public:
 
     const boost::optional<boost::filesystem::path> path;
 
+    // 0: the DTL uses a thread per connection
+    const unsigned reactor_threads;
+
+    // 0: the DTL file backend uses a file per SCO
+    const size_t log_segment_size;
+
 private:
     DECLARE_LOGGER("FailOverCacheTestSetup");
 
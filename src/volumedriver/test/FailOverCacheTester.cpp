@@ -26,6 +26,7 @@
 #include <future>
 
 #include <youtils/Timer.h>
+#include <youtils/wall_timer.h>
 
 namespace volumedriver
 {
@@ -942,6 +943,81 @@ TEST_P(FailOverCacheTester, DISABLED_a_whole_lotta_clients)
     }
 }
 
+TEST_P(FailOverCacheTester, concurrent_writers)
+{
+    auto wrns = make_random_namespace();
+    auto foc_ctx(start_one_foc());
+
+    const FailOverCacheMode mode = GetParam().foc_mode();
+
+    SharedVolumePtr v = newVolume(*wrns);
+    v->setFailOverCacheConfig(foc_ctx->config(mode));
+
+    v->scheduleBackendSync();
+    waitForThisBackendWrite(*v);
+
+    ASSERT_EQ(VolumeFailOverState::OK_SYNC,
+              v->getVolumeFailOverState());
+
+    const size_t nthreads = 8;
+    const size_t nwrites = 512;
+    const size_t csize = v->getClusterSize();
+    const uint64_t lbas_per_cluster = csize / v->getLBASize();
+
+    auto fun([&](const size_t t)
+             {
+                 const std::vector<uint8_t> buf(csize, 'a' + t);
+
+                 for (size_t i = 0; i < nwrites; ++i)
+                 {
+                     const DtlInSync in_sync =
+                         v->write(Lba((t * nwrites + i) * lbas_per_cluster),
+                                  buf.data(),
+                                  buf.size());
+                     EXPECT_EQ(mode == FailOverCacheMode::Synchronous ?
+                               DtlInSync::T :
+                               DtlInSync::F,
+                               in_sync);
+                 }
+             });
+
+    youtils::wall_timer w;
+
+    std::vector<std::future<void>> futures;
+    futures.reserve(nthreads);
+
+    for (size_t t = 0; t < nthreads; ++t)
+    {
+        futures.emplace_back(std::async(std::launch::async,
+                                        [&fun, t]
+                                        {
+                                            fun(t);
+                                        }));
+    }
+
+    for (auto& f : futures)
+    {
+        f.get();
+    }
+
+    const double t = w.elapsed();
+
+    std::cout << mode << ": " << nthreads << " writers, " << nthreads * nwrites <<
+        " writes of " << csize << " bytes took " << t << " seconds -> " <<
+        (nthreads * nwrites) / t << " IOPS" << std::endl;
+
+    EXPECT_EQ(VolumeFailOverState::OK_SYNC,
+              v->getVolumeFailOverState());
+
+    for (size_t t = 0; t < nthreads; ++t)
+    {
+        checkVolume(*v,
+                    Lba(t * nwrites * lbas_per_cluster),
+                    nwrites * csize,
+                    std::string(1, 'a' + t));
+    }
+}
+
 // Might be better suited in SimpleVolumeTest or sth. similar?
 TEST_P(FailOverCacheTester, dtl_in_sync)
 {
@@ -1070,13 +1146,28 @@ const VolumeDriverTestConfig sync_foc_in_memory_config =
     .use_cluster_cache(true)
     .foc_mode(FailOverCacheMode::Synchronous)
     .foc_in_memory(true);
+
+const VolumeDriverTestConfig sync_foc_reactor_config =
+    VolumeDriverTestConfig()
+    .use_cluster_cache(true)
+    .foc_mode(FailOverCacheMode::Synchronous)
+    .foc_reactor_threads(2);
+
+// small segments to exercise rolling over / recycling them
+const VolumeDriverTestConfig sync_foc_log_config =
+    VolumeDriverTestConfig()
+    .use_cluster_cache(true)
+    .foc_mode(FailOverCacheMode::Synchronous)
+    .foc_log_segment_size(1ULL << 20);
 }
 
 INSTANTIATE_TEST_CASE_P(FailOverCacheTesters,
                         FailOverCacheTester,
                         ::testing::Values(cluster_cache_config,
                                           sync_foc_config,
-                                          sync_foc_in_memory_config));
+                                          sync_foc_in_memory_config,
+                                          sync_foc_reactor_config,
+                                          sync_foc_log_config));
 
 }
 
@@ -0,0 +1,170 @@
+// Copyright (C) 2016 iNuron NV
+//
+// This file is part of Open vStorage Open Source Edition (OSE),
+// as available from
+//
+//      http://www.openvstorage.org and
+//      http://www.openvstorage.com.
+//
+// This file is free software; you can redistribute it and/or modify it
+// under the terms of the GNU Affero General Public License v3 (GNU AGPLv3)
+// as published by the Free Software Foundation, in version 3 as it comes in
+// the LICENSE.txt file of the Open vStorage OSE distribution.
+// Open vStorage is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY of any kind.
+
+#include "../LatencyHistogram.h"
+
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <boost/archive/xml_iarchive.hpp>
+#include <boost/archive/xml_oarchive.hpp>
+
+#include <gtest/gtest.h>
+
+namespace volumedrivertest
+{
+
+using namespace volumedriver;
+
+class LatencyHistogramTest
+    : public testing::Test
+{};
+
+TEST_F(LatencyHistogramTest, buckets)
+{
+    using H = LatencyHistogram;
+
+    for (size_t i = 0; i < H::num_buckets; ++i)
+    {
+        const uint64_t lo = H::bucket_lower_bound(i);
+        const uint64_t hi = H::bucket_upper_bound(i);
+
+        ASSERT_LT(lo, hi);
+        EXPECT_EQ(i, H::bucket_index(lo));
+        EXPECT_EQ(i, H::bucket_index(hi - 1));
+
+        if (i + 1 < H::num_buckets)
+        {
+            EXPECT_EQ(hi, H::bucket_lower_bound(i + 1));
+        }
+
+        // relative error bound
+        if (lo >= H::sub_buckets)
+        {
+            EXPECT_GE(1.0 / H::sub_buckets,
+                      static_cast<double>(hi - 1 - lo) / lo);
+        }
+    }
+
+    EXPECT_EQ(H::num_buckets - 1,
+              H::bucket_index(std::numeric_limits<uint64_t>::max()));
+    EXPECT_EQ(H::num_buckets - 1,
+              H::bucket_index(1ULL << H::max_value_bits));
+}
+
+TEST_F(LatencyHistogramTest, percentiles)
+{
+    LatencyHistogram h;
+
+    EXPECT_EQ(0U, h.events());
+    EXPECT_EQ(0U, h.percentile(99));
+
+    for (uint64_t i = 1; i <= 1000; ++i)
+    {
+        h.record(i);
+    }
+
+    EXPECT_EQ(1000U, h.events());
+    EXPECT_EQ(500500U, h.sum());
+    EXPECT_EQ(1000U, h.max());
+
+    auto check([&](double p,
+                   uint64_t exp)
+               {
+                   const uint64_t v = h.percentile(p);
+                   EXPECT_LE(exp, v) << "p" << p;
+                   EXPECT_GE(exp + exp / LatencyHistogram::sub_buckets, v) << "p" << p;
+               });
+
+    check(50, 500);
+    check(90, 900);
+    check(99, 990);
+    EXPECT_EQ(1000U, h.percentile(100));
+
+    h.reset();
+    EXPECT_EQ(0U, h.events());
+    EXPECT_EQ(0U, h.max());
+}
+
+TEST_F(LatencyHistogramTest, concurrent_recorders)
+{
+    LatencyHistogram h;
+    const size_t nthreads = 8;
+    const size_t count = 10000;
+
+    std::vector<std::thread> threads;
+    threads.reserve(nthreads);
+
+    for (size_t i = 0; i < nthreads; ++i)
+    {
+        threads.emplace_back([&h, i, count]
+                             {
+                                 for (size_t j = 0; j < count; ++j)
+                                 {
+                                     h.record(i * 100 + j % 100);
+                                 }
+                             });
+    }
+
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+
+    EXPECT_EQ(nthreads * count, h.events());
+    EXPECT_EQ((nthreads - 1) * 100 + 99, h.max());
+
+    const LatencyHistogram copy(h);
+    EXPECT_EQ(h, copy);
+
+    LatencyHistogram sum(h);
+    sum += copy;
+    EXPECT_EQ(2 * h.events(), sum.events());
+    EXPECT_EQ(2 * h.sum(), sum.sum());
+    EXPECT_EQ(h.max(), sum.max());
+}
+
+TEST_F(LatencyHistogramTest, serialization)
+{
+    LatencyHistogram h;
+
+    for (uint64_t i = 0; i < 100000; i += 7)
+    {
+        h.record(i);
+    }
+
+    std::stringstream ss;
+
+    {
+        boost::archive::xml_oarchive oa(ss);
+        oa << boost::serialization::make_nvp("histogram",
+                                             h);
+    }
+
+    LatencyHistogram g;
+    EXPECT_NE(h, g);
+
+    {
+        boost::archive::xml_iarchive ia(ss);
+        ia >> boost::serialization::make_nvp("histogram",
+                                             g);
+    }
+
+    EXPECT_EQ(h, g);
+    EXPECT_EQ(h.percentile(99.9), g.percentile(99.9));
+}
+
+}
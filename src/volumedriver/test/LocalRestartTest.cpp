@@ -1533,6 +1533,75 @@ TEST_P(LocalRestartTest, RestartWithFOCAndRemovedSCO2)
     checkCurrentBackendSize(*v);
 }
 
+TEST_P(LocalRestartTest, RestartWithFOCSpanningSCOs)
+{
+    auto foc_ctx(start_one_foc());
+
+    auto ns_ptr = make_random_namespace();
+
+    const backend::Namespace& ns = ns_ptr->ns();
+
+    SharedVolumePtr v = newVolume("vol1",
+                                  ns);
+    ASSERT_NO_THROW(v->setFailOverCacheConfig(foc_ctx->config(GetParam().foc_mode())));
+
+    const uint64_t cluster_size = v->getClusterSize();
+    const uint64_t lbas_per_cluster = cluster_size / v->getLBASize();
+    const uint32_t sco_mult = v->getSCOMultiplier();
+
+    // several SCOs and more than one replay batch, written backwards so
+    // cluster addresses and SCO locations differ
+    const uint64_t nclusters = 3 * sco_mult + 7;
+    const uint64_t nscos = (nclusters + sco_mult - 1) / sco_mult;
+
+    {
+        SCOPED_DESTROY_VOLUME_UNBLOCK_BACKEND(v, 2,
+                                              DeleteLocalData::F,
+                                              RemoveVolumeCompletely::F);
+        for (uint64_t i = 0; i < nclusters; ++i)
+        {
+            const uint64_t c = nclusters - i - 1;
+            writeToVolume(*v,
+                          Lba(c * lbas_per_cluster),
+                          cluster_size,
+                          boost::lexical_cast<std::string>(c));
+        }
+    }
+
+    v = 0;
+
+    SCOCache* sc = VolManager::get()->getSCOCache();
+    SCOAccessData sad(ns);
+
+    sc->enableNamespace(ns,
+                        0,
+                        100,
+                        sad);
+
+    for (uint64_t i = 1; i <= nscos; ++i)
+    {
+        CachedSCOPtr sco_ptr = sc->findSCO(ns,
+                                           ClusterLocation(i).sco());
+        ASSERT_TRUE(sco_ptr.get());
+        fs::remove(sco_ptr->path());
+    }
+
+    sc->disableNamespace(ns);
+
+    ASSERT_NO_THROW(v = localRestart(ns));
+    ASSERT_TRUE(v != nullptr);
+
+    for (uint64_t c = 0; c < nclusters; ++c)
+    {
+        checkVolume(*v,
+                    Lba(c * lbas_per_cluster),
+                    cluster_size,
+                    boost::lexical_cast<std::string>(c));
+    }
+
+    checkCurrentBackendSize(*v);
+}
+
 TEST_P(LocalRestartTest, RestartWithFOCAndFuckedUpSCO)
 {
     auto foc_ctx(start_one_foc());
@@ -49,6 +49,7 @@ namespace volumedrivertest
 namespace bc = boost::chrono;
 namespace be = backend;
 namespace fs = boost::filesystem;
+namespace ip = initialized_params;
 namespace mds = metadata_server;
 namespace yt = youtils;
 namespace ytt = youtilstest;
@@ -2102,6 +2103,144 @@ TEST_P(MDSVolumeTest, slave_stress)
     }
 }
 
+TEST_P(MDSVolumeTest, push_to_slaves)
+{
+    // the slaves only catch up from the backend when asked to
+    mds_manager_ = mds_test_setup_->make_manager(cm_,
+                                                 2,
+                                                 std::chrono::seconds(3600));
+
+    const auto set_push([](bool push)
+                        {
+                            boost::property_tree::ptree pt;
+                            VolManager::get()->persistConfiguration(pt);
+                            ip::PARAMETER_TYPE(metadata_mds_push_to_slaves)(push).persist(pt);
+                            UpdateReport u_rep;
+                            ConfigurationReport c_rep;
+                            VolManager::get()->updateConfiguration(pt,
+                                                                   u_rep,
+                                                                   c_rep);
+                            ASSERT_EQ(push,
+                                      VolManager::get()->metadata_mds_push_to_slaves.value());
+                        });
+
+    set_push(true);
+
+    auto on_exit(yt::make_scope_exit([&]
+                                     {
+                                         set_push(false);
+                                     }));
+
+    const mds::ServerConfigs scfgs(mds_manager_->server_configs());
+    ASSERT_EQ(2U,
+              scfgs.size());
+
+    const auto wrns(make_random_namespace());
+    SharedVolumePtr v = make_volume(*wrns);
+
+    size_t count = 0;
+
+    const auto write_and_snapshot([&]
+                                  {
+                                      const size_t n = ++count;
+                                      const std::string s(boost::lexical_cast<std::string>(n));
+                                      writeToVolume(*v,
+                                                    Lba(v->getClusterMultiplier() * n),
+                                                    v->getClusterSize(),
+                                                    s);
+                                      v->createSnapshot(SnapshotName("snap-"s + s));
+                                      waitForThisBackendWrite(*v);
+                                  });
+
+    // The slave only has the master's cork once it caught up from the backend,
+    // after that the updates are pushed to it. Updates forwarded while the
+    // master backs off from a slave that was gone are lost, so the slave might
+    // need another round of catching up.
+    const auto check_push([&](const MDSNodeConfig& master_cfg,
+                              const MDSNodeConfig& slave_cfg)
+                          {
+                              mds::ClientNG::Ptr client(mds::ClientNG::create(slave_cfg));
+                              mds::TableInterfacePtr table(client->open(wrns->ns().str()));
+                              EXPECT_TRUE(mds::Role::Slave == table->get_role());
+
+                              MDSMetaDataBackend mdb(master_cfg,
+                                                     wrns->ns(),
+                                                     boost::none,
+                                                     boost::none);
+
+                              MetaDataBackendInterfacePtr
+                                  sdb(std::make_shared<MDSMetaDataBackend>(slave_cfg,
+                                                                           wrns->ns(),
+                                                                           boost::none,
+                                                                           boost::none));
+
+                              const auto wait_for_sync([&]() -> bool
+                                                       {
+                                                           for (size_t i = 0; i < 20; ++i)
+                                                           {
+                                                               if (sdb->lastCorkUUID() == mdb.lastCorkUUID())
+                                                               {
+                                                                   return true;
+                                                               }
+                                                               boost::this_thread::sleep_for(bc::milliseconds(100));
+                                                           }
+                                                           return false;
+                                                       });
+
+                              bool in_sync = false;
+
+                              for (size_t i = 0; not in_sync and i < 5; ++i)
+                              {
+                                  table->catch_up(DryRun::F);
+                                  table->get_counters(Reset::T);
+
+                                  write_and_snapshot();
+                                  write_and_snapshot();
+
+                                  in_sync = wait_for_sync();
+                              }
+
+                              ASSERT_TRUE(in_sync);
+
+                              EXPECT_EQ(v->getMetaDataStore()->lastCork(),
+                                        sdb->lastCorkUUID());
+
+                              check_counters(*table,
+                                             0,
+                                             0,
+                                             0,
+                                             Reset::F);
+
+                              CachedMetaDataStore md(sdb,
+                                                     "slave");
+                              check_metadata(*v,
+                                             md);
+                          });
+
+    write_and_snapshot();
+
+    // the volume registered the slave with the master on construction
+    check_push(scfgs[0].node_config,
+               scfgs[1].node_config);
+
+    // ... and registers the old master as slave with the new one on failover
+    mds_manager_->stop_one(scfgs[0].node_config);
+
+    checkVolume(*v,
+                Lba(0),
+                v->getClusterSize(),
+                "");
+
+    check_config(*v,
+                 node_configs(),
+                 true);
+
+    mds_manager_->start_one(scfgs[0]);
+
+    check_push(scfgs[1].node_config,
+               scfgs[0].node_config);
+}
+
 namespace
 {
 
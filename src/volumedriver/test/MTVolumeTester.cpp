@@ -15,6 +15,11 @@
 
 #include "VolManagerTestSetup.h"
 
+#include <boost/lexical_cast.hpp>
+
+#include <youtils/System.h>
+#include <youtils/wall_timer.h>
+
 namespace volumedriver
 {
 
@@ -257,6 +262,86 @@ TEST_P(MTVolumeTester, snapshotting)
     v->checkConsistency();
 }
 
+// Writes to disjoint LBA ranges of a single volume with an increasing number of
+// threads. Mostly useful as a benchmark for the write pipeline (cf.
+// Volume::write_aligned_); the amount of data can be tweaked with
+// WRITE_SCALING_MAX_THREADS and WRITE_SCALING_SIZE_MIB.
+TEST_P(MTVolumeTester, write_scaling)
+{
+    const size_t max_threads =
+        youtils::System::get_env_with_default<size_t>("WRITE_SCALING_MAX_THREADS",
+                                                      8);
+    const uint64_t size =
+        youtils::System::get_env_with_default<uint64_t>("WRITE_SCALING_SIZE_MIB",
+                                                        32) << 20;
+    const uint64_t block_size = 4096;
+
+    auto ns_ptr = make_random_namespace();
+
+    SharedVolumePtr v = newVolume("volume",
+                                  ns_ptr->ns(),
+                                  VolumeSize(size));
+
+    for (size_t nthreads = 1; nthreads <= max_threads; nthreads *= 2)
+    {
+        const uint64_t slice = (size / nthreads) / block_size * block_size;
+        ASSERT_LT(0U, slice);
+
+        std::vector<std::string> patterns;
+        patterns.reserve(nthreads);
+
+        for (size_t i = 0; i < nthreads; ++i)
+        {
+            patterns.emplace_back(boost::lexical_cast<std::string>(nthreads) +
+                                  "-" +
+                                  boost::lexical_cast<std::string>(i));
+        }
+
+        auto fun([&](size_t i)
+                 {
+                     const uint64_t off = i * slice;
+                     for (uint64_t o = 0; o < slice; o += block_size)
+                     {
+                         writeToVolume(*v,
+                                       Lba((off + o) / v->getLBASize()),
+                                       block_size,
+                                       patterns[i]);
+                     }
+                 });
+
+        youtils::wall_timer t;
+
+        std::vector<boost::thread> threads;
+        threads.reserve(nthreads);
+
+        for (size_t i = 0; i < nthreads; ++i)
+        {
+            threads.emplace_back(fun, i);
+        }
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        const double secs = t.elapsed();
+        std::cout << nthreads << " writer(s): " << (slice * nthreads) << " bytes in " <<
+            secs << " s -> " << ((slice * nthreads) / (secs * (1 << 20))) <<
+            " MiB/s" << std::endl;
+
+        for (size_t i = 0; i < nthreads; ++i)
+        {
+            checkVolume(*v,
+                        Lba(i * slice / v->getLBASize()),
+                        slice,
+                        patterns[i]);
+        }
+    }
+
+    syncToBackend(*v);
+    v->checkConsistency();
+}
+
 INSTANTIATE_TEST(MTVolumeTester);
 }
 
@@ -16,6 +16,7 @@
 #include "MDSTestSetup.h"
 
 #include <iostream>
+#include <thread>
 
 #include <boost/algorithm/string.hpp>
 
@@ -687,6 +688,255 @@ TEST_P(MetaDataServerTest, owner_tag)
     check();
 }
 
+TEST_P(MetaDataServerTest, replication_stream)
+{
+    be::BackendTestSetup::WithRandomNamespace wrns("",
+                                                   cm_);
+
+    auto client(make_client());
+    mds::TableInterfacePtr table(client->open(wrns.ns().str()));
+
+    const vd::OwnerTag owner_tag(1);
+
+    table->set_role(mds::Role::Master,
+                    owner_tag);
+
+    const std::string cork_key(vd::MDSMetaDataBackend::cork_record_key());
+    const std::string cork(yt::UUID().str());
+
+    set(table,
+        mds::Record(mds::Key(cork_key),
+                    mds::Value(cork)),
+        owner_tag);
+
+    table->set_role(mds::Role::Slave,
+                    owner_tag);
+
+    const std::string val("val");
+    const std::vector<std::string> keys{ "one", "two", "three" };
+
+    const auto update([&](const std::string& k) -> mds::TableInterface::Update
+                      {
+                          const mds::TableInterface::Records
+                              recs{ mds::Record(mds::Key(k),
+                                                mds::Value(val)) };
+                          return mds::TableInterface::Update(recs,
+                                                             Barrier::F);
+                      });
+
+    const mds::TableInterface::Records
+        sync_recs{ mds::Record(mds::Key(cork_key),
+                               mds::Value(cork)) };
+    const mds::TableInterface::Update sync_point(sync_recs,
+                                                 Barrier::T);
+
+    // The slave's periodic action might briefly hold the table when it becomes
+    // a slave, which is also reported as not being in sync.
+    const auto replicate([&](uint64_t seqnum,
+                             const mds::TableInterface::Updates& updates)
+                         {
+                             for (size_t i = 0; i < 100; ++i)
+                             {
+                                 if (table->replicate(1,
+                                                      seqnum,
+                                                      updates) == InSync::T)
+                                 {
+                                     return InSync::T;
+                                 }
+                                 std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                             }
+                             return InSync::F;
+                         });
+
+    // no sync point to join at
+    EXPECT_EQ(InSync::F,
+              table->replicate(1,
+                               0,
+                               { update(keys[0]) }));
+    EXPECT_EQ(boost::none,
+              get(table, mds::Key(keys[0])));
+
+    EXPECT_EQ(InSync::T,
+              replicate(1,
+                        { update(keys[0]),
+                          sync_point,
+                          update(keys[1]) }));
+
+    EXPECT_EQ(boost::none,
+              get(table, mds::Key(keys[0])));
+    EXPECT_EQ(val,
+              get(table, mds::Key(keys[1])));
+
+    // gap
+    EXPECT_EQ(InSync::F,
+              table->replicate(1,
+                               5,
+                               { update(keys[2]) }));
+    EXPECT_EQ(boost::none,
+              get(table, mds::Key(keys[2])));
+
+    // no replicated updates are accepted in master role
+    table->set_role(mds::Role::Master,
+                    owner_tag);
+
+    EXPECT_EQ(InSync::F,
+              table->replicate(1,
+                               4,
+                               { update(keys[2]) }));
+    EXPECT_EQ(boost::none,
+              get(table, mds::Key(keys[2])));
+}
+
+TEST_P(MetaDataServerTest, push_replication)
+{
+    // A pair of servers whose slave tables poll the backend every second unless
+    // they're in sync with the master's replication stream. The namespace is
+    // empty on the backend, so anything the slave gets was pushed to it.
+    std::unique_ptr<mds::Manager> mgr(mds_test_setup_->make_manager(cm_,
+                                                                    2,
+                                                                    std::chrono::seconds(1)));
+
+    const mds::ServerConfigs scfgs(mgr->server_configs());
+    ASSERT_EQ(2U, scfgs.size());
+
+    be::BackendTestSetup::WithRandomNamespace wrns("",
+                                                   cm_);
+
+    const std::string nspace(wrns.ns().str());
+
+    const auto make_table([&](const vd::MDSNodeConfig& cfg) -> mds::TableInterfacePtr
+                          {
+                              auto client(mds::ClientNG::create(cfg,
+                                                                GetParam().shmem_size,
+                                                                boost::none,
+                                                                GetParam().force_remote));
+                              return client->open(nspace);
+                          });
+
+    const vd::OwnerTag owner_tag(1);
+    const std::string cork_key(vd::MDSMetaDataBackend::cork_record_key());
+    const std::string cork(yt::UUID().str());
+    const mds::Record cork_rec{ mds::Key(cork_key),
+                                mds::Value(cork) };
+
+    mds::TableInterfacePtr mtable(make_table(scfgs[0].node_config));
+    mtable->set_role(mds::Role::Master,
+                     owner_tag);
+    set(mtable,
+        cork_rec,
+        owner_tag);
+
+    // the slave joins the stream where the master is at the cork it has
+    mds::TableInterfacePtr stable(make_table(scfgs[1].node_config));
+    stable->set_role(mds::Role::Master,
+                     owner_tag);
+    set(stable,
+        cork_rec,
+        owner_tag);
+    stable->set_role(mds::Role::Slave,
+                     owner_tag);
+
+    mtable->set_slaves(vd::MDSNodeConfigs{ scfgs[1].node_config },
+                       owner_tag);
+
+    const auto replicated([&](const std::string& key,
+                              const std::string& val) -> bool
+                          {
+                              for (size_t i = 0; i < 20; ++i)
+                              {
+                                  if (get(stable, mds::Key(key)) == val)
+                                  {
+                                      return true;
+                                  }
+                                  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                              }
+                              return false;
+                          });
+
+    const auto update([&](const std::string& key,
+                          const std::string& val)
+                      {
+                          set(mtable,
+                              mds::Record(mds::Key(key),
+                                          mds::Value(val)),
+                              owner_tag);
+                      });
+
+    // Updates following a sync point - the slave might be busy polling the
+    // backend or the sender backing off, hence the retries.
+    const auto sync_and_update([&](const std::string& key,
+                                   const std::string& val) -> bool
+                               {
+                                   for (size_t i = 0; i < 20; ++i)
+                                   {
+                                       set(mtable,
+                                           cork_rec,
+                                           owner_tag);
+                                       update(key,
+                                              val);
+                                       if (replicated(key,
+                                                      val))
+                                       {
+                                           return true;
+                                       }
+                                   }
+                                   return false;
+                               });
+
+    // in sync: updates are forwarded as they come
+    ASSERT_TRUE(sync_and_update("one",
+                                "1"));
+
+    update("two",
+           "2");
+    EXPECT_TRUE(replicated("two",
+                           "2"));
+
+    // Without updates the slave falls back to polling the backend and leaves
+    // the stream, and can only rejoin at the next sync point.
+    std::this_thread::sleep_for(std::chrono::seconds(3));
+
+    update("three",
+           "3");
+    EXPECT_FALSE(replicated("three",
+                            "3"));
+
+    EXPECT_TRUE(sync_and_update("four",
+                                "4"));
+
+    // clearing the master starts a new stream
+    mtable->clear(owner_tag);
+
+    update("five",
+           "5");
+    EXPECT_FALSE(replicated("five",
+                            "5"));
+
+    EXPECT_TRUE(sync_and_update("six",
+                                "6"));
+
+    // updates sent while the slave is gone are dropped - it resyncs once it's back
+    stable = nullptr;
+    mgr->stop_one(scfgs[1].node_config);
+
+    update("seven",
+           "7");
+
+    mgr->start_one(scfgs[1]);
+    stable = make_table(scfgs[1].node_config);
+
+    const std::string seven("seven");
+
+    EXPECT_TRUE(mds::Role::Slave == stable->get_role());
+    EXPECT_EQ(boost::none,
+              get(stable, mds::Key(seven)));
+
+    EXPECT_TRUE(sync_and_update("eight",
+                                "8"));
+    EXPECT_EQ(boost::none,
+              get(stable, mds::Key(seven)));
+}
+
 TEST_P(MetaDataServerTest, python_client_cork_id)
 {
     be::BackendTestSetup::WithRandomNamespace wrns("",
@@ -18,6 +18,8 @@
 #include "VolManagerTestSetup.h"
 
 #include <cassert>
+#include <functional>
+#include <future>
 #include <map>
 #include <iostream>
 #include <sstream>
@@ -1109,6 +1111,457 @@ TEST_P(MetaDataStoreTest, LRU)
     }
 }
 
+// Cache hits only take a shared lock, so 4k random reads of cached pages are
+// expected to scale with the number of readers.
+TEST_P(MetaDataStoreTest, cached_random_read_scalability)
+{
+    const uint32_t npages(yt::System::get_env_with_default<uint32_t>("MD_PAGES",
+                                                                     32));
+    const uint32_t max_threads(yt::System::get_env_with_default<uint32_t>("MAX_THREADS",
+                                                                          8));
+    const uint64_t reads_per_thread(yt::System::get_env_with_default<uint64_t>("READS_PER_THREAD",
+                                                                               1ULL << 18));
+
+    const uint64_t locs = npages * CachePage::capacity();
+    const uint64_t vsize = locs * default_cluster_size();
+
+    auto ns_ptr = make_random_namespace();
+
+    SharedVolumePtr v = newVolume("volume",
+                                  ns_ptr->ns(),
+                                  VolumeSize(vsize),
+                                  default_sco_multiplier(),
+                                  default_lba_size(),
+                                  default_cluster_multiplier(),
+                                  npages);
+
+    MetaDataStoreInterface* md = v->getMetaDataStore();
+
+    for (uint64_t i = 0; i < locs; ++i)
+    {
+        const ClusterLocationAndHash clh(ClusterLocation(i + 1),
+                                         w);
+        md->writeCluster(i, clh);
+    }
+
+    md->cork(yt::UUID());
+    md->unCork();
+
+    MetaDataStoreStats mds;
+    md->getStats(mds);
+
+    ASSERT_EQ(npages, mds.cached_pages);
+    const uint64_t misses = mds.cache_misses;
+
+    auto fun([&]() -> double
+             {
+                 yt::SourceOfUncertainty sou;
+                 yt::wall_timer wt;
+
+                 for (uint64_t i = 0; i < reads_per_thread; ++i)
+                 {
+                     const ClusterAddress ca = sou(locs - 1);
+                     ClusterLocationAndHash clh;
+                     md->readCluster(ca, clh);
+                     EXPECT_EQ(ClusterLocation(ca + 1),
+                               clh.clusterLocation);
+                 }
+
+                 return reads_per_thread / wt.elapsed();
+             });
+
+    for (uint32_t nthreads = 1; nthreads <= max_threads; nthreads *= 2)
+    {
+        std::vector<std::future<double>> futures;
+        futures.reserve(nthreads);
+
+        for (uint32_t i = 0; i < nthreads; ++i)
+        {
+            futures.emplace_back(std::async(std::launch::async,
+                                            fun));
+        }
+
+        double iops = 0;
+        for (auto& f : futures)
+        {
+            iops += f.get();
+        }
+
+        std::cout << nthreads << " thread(s), " << npages <<
+            " cached pages: " << iops << " cached 4k random read lookups/s" <<
+            std::endl;
+    }
+
+    md->getStats(mds);
+    EXPECT_EQ(misses, mds.cache_misses);
+}
+
+// Concurrent misses on the same page are expected to be coalesced into a
+// single backend fetch.
+TEST_P(MetaDataStoreTest, concurrent_cold_reads)
+{
+    const uint32_t npages = 8;
+    const uint32_t nthreads = 8;
+    const uint64_t locs = npages * CachePage::capacity();
+    const uint64_t vsize = locs * default_cluster_size();
+
+    auto ns_ptr = make_random_namespace();
+
+    SharedVolumePtr v = newVolume("volume",
+                                  ns_ptr->ns(),
+                                  VolumeSize(vsize),
+                                  default_sco_multiplier(),
+                                  default_lba_size(),
+                                  default_cluster_multiplier(),
+                                  npages);
+
+    auto md = dynamic_cast<CachedMetaDataStore*>(v->getMetaDataStore());
+    if (md == nullptr)
+    {
+        // MDSMetaDataStore - it uses a CachedMetaDataStore under the hood but
+        // we can't get at it from here.
+        return;
+    }
+
+    for (uint64_t i = 0; i < locs; ++i)
+    {
+        const ClusterLocationAndHash clh(ClusterLocation(i + 1),
+                                         w);
+        md->writeCluster(i, clh);
+    }
+
+    md->cork(yt::UUID());
+    md->unCork(boost::none);
+
+    md->drop_cache_including_dirty_pages();
+
+    MetaDataStoreStats mds;
+    md->getStats(mds);
+    ASSERT_EQ(0U, mds.cached_pages);
+
+    const uint64_t misses = mds.cache_misses;
+
+    auto fun([&]
+             {
+                 for (uint64_t ca = 0; ca < locs; ++ca)
+                 {
+                     ClusterLocationAndHash clh;
+                     md->readCluster(ca, clh);
+                     EXPECT_EQ(ClusterLocation(ca + 1),
+                               clh.clusterLocation);
+                 }
+             });
+
+    std::vector<std::future<void>> futures;
+    futures.reserve(nthreads);
+
+    for (uint32_t i = 0; i < nthreads; ++i)
+    {
+        futures.emplace_back(std::async(std::launch::async,
+                                        fun));
+    }
+
+    for (auto& f : futures)
+    {
+        f.get();
+    }
+
+    md->getStats(mds);
+    EXPECT_EQ(npages, mds.cached_pages);
+    EXPECT_EQ(misses + npages, mds.cache_misses);
+}
+
+// Pages that were hit since the CLOCK hand last passed them get a second
+// chance, so a hot page survives a scan over the rest of the volume.
+TEST_P(MetaDataStoreTest, clock_eviction)
+{
+    const uint32_t npages = 4;
+    const uint64_t locs = (npages + 1) * CachePage::capacity();
+    const uint64_t vsize = locs * default_cluster_size();
+
+    auto ns_ptr = make_random_namespace();
+
+    SharedVolumePtr v = newVolume("volume",
+                                  ns_ptr->ns(),
+                                  VolumeSize(vsize),
+                                  default_sco_multiplier(),
+                                  default_lba_size(),
+                                  default_cluster_multiplier(),
+                                  npages);
+
+    auto md = dynamic_cast<CachedMetaDataStore*>(v->getMetaDataStore());
+    if (md == nullptr)
+    {
+        return;
+    }
+
+    for (uint64_t i = 0; i < locs; ++i)
+    {
+        const ClusterLocationAndHash clh(ClusterLocation(i + 1),
+                                         w);
+        md->writeCluster(i, clh);
+    }
+
+    md->cork(yt::UUID());
+    md->unCork(boost::none);
+
+    md->drop_cache_including_dirty_pages();
+
+    auto read([&](PageAddress pa) -> uint64_t
+              {
+                  MetaDataStoreStats mds;
+                  md->getStats(mds);
+                  const uint64_t misses = mds.cache_misses;
+
+                  const ClusterAddress ca = CachePage::clusterAddress(pa);
+                  ClusterLocationAndHash clh;
+                  md->readCluster(ca, clh);
+                  EXPECT_EQ(ClusterLocation(ca + 1),
+                            clh.clusterLocation);
+
+                  md->getStats(mds);
+                  return mds.cache_misses - misses;
+              });
+
+    for (PageAddress pa = 0; pa < npages; ++pa)
+    {
+        EXPECT_EQ(1U, read(pa));
+    }
+
+    EXPECT_EQ(0U, read(0));
+    EXPECT_EQ(1U, read(npages));
+    EXPECT_EQ(0U, read(0));
+    EXPECT_EQ(1U, read(1));
+}
+
+// Dirty pages evicted while uncorking are written back after the cache lock
+// was dropped - make sure none of them get lost.
+TEST_P(MetaDataStoreTest, evicted_dirty_pages)
+{
+    const uint32_t npages = 2;
+    const uint64_t locs = 4 * npages * CachePage::capacity();
+    const uint64_t vsize = locs * default_cluster_size();
+
+    auto ns_ptr = make_random_namespace();
+
+    SharedVolumePtr v = newVolume("volume",
+                                  ns_ptr->ns(),
+                                  VolumeSize(vsize),
+                                  default_sco_multiplier(),
+                                  default_lba_size(),
+                                  default_cluster_multiplier(),
+                                  npages);
+
+    auto md = dynamic_cast<CachedMetaDataStore*>(v->getMetaDataStore());
+    if (md == nullptr)
+    {
+        return;
+    }
+
+    for (uint64_t i = 0; i < locs; ++i)
+    {
+        const ClusterLocationAndHash clh(ClusterLocation(i + 1),
+                                         w);
+        md->writeCluster(i, clh);
+    }
+
+    md->cork(yt::UUID());
+    md->unCork(boost::none);
+
+    MetaDataStoreStats mds;
+    md->getStats(mds);
+    EXPECT_EQ(locs, mds.used_clusters);
+
+    md->drop_cache_including_dirty_pages();
+
+    std::vector<ClusterLocationAndHash> clhs;
+    md->readClusters(0,
+                     locs,
+                     clhs);
+
+    ASSERT_EQ(locs, clhs.size());
+
+    for (uint64_t i = 0; i < locs; ++i)
+    {
+        EXPECT_EQ(ClusterLocation(i + 1),
+                  clhs[i].clusterLocation);
+    }
+
+    md->getStats(mds);
+    EXPECT_EQ(locs, mds.used_clusters);
+}
+
+TEST_P(MetaDataStoreTest, read_cluster_ranges)
+{
+    const uint32_t npages = 4;
+    const uint64_t page_entries = CachePage::capacity();
+    const uint64_t locs = npages * page_entries;
+    const uint64_t vsize = locs * default_cluster_size();
+
+    auto ns_ptr = make_random_namespace();
+
+    SharedVolumePtr v = newVolume("volume",
+                                  ns_ptr->ns(),
+                                  VolumeSize(vsize),
+                                  default_sco_multiplier(),
+                                  default_lba_size(),
+                                  default_cluster_multiplier(),
+                                  npages / 2);
+
+    MetaDataStoreInterface* md = v->getMetaDataStore();
+
+    // every other cluster ends up in the pages, some of the others stay
+    // corked and a few get discarded.
+    for (uint64_t i = 0; i < locs; i += 2)
+    {
+        md->writeCluster(i,
+                         ClusterLocationAndHash(ClusterLocation(i + 1),
+                                                w));
+    }
+
+    md->cork(yt::UUID());
+    md->unCork();
+
+    for (uint64_t i = 1; i < locs; i += 4)
+    {
+        md->writeCluster(i,
+                         ClusterLocationAndHash(ClusterLocation(i + 1),
+                                                w));
+    }
+
+    for (uint64_t i = 0; i < locs; i += 8)
+    {
+        md->writeCluster(i,
+                         ClusterLocationAndHash::discarded_location_and_hash());
+    }
+
+    auto check([&](ClusterAddress start,
+                   size_t count)
+               {
+                   std::vector<ClusterLocationAndHash> vec;
+                   md->readClusters(start,
+                                    count,
+                                    vec);
+                   ASSERT_EQ(count, vec.size());
+
+                   for (size_t i = 0; i < count; ++i)
+                   {
+                       ClusterLocationAndHash clh;
+                       md->readCluster(start + i,
+                                       clh);
+                       EXPECT_EQ(clh.clusterLocation,
+                                 vec[i].clusterLocation) << "CA " << (start + i);
+#ifdef ENABLE_MD5_HASH
+                       EXPECT_EQ(clh.weed(),
+                                 vec[i].weed()) << "CA " << (start + i);
+#endif
+                   }
+               });
+
+    check(0, 0);
+    check(0, 1);
+    check(0, locs);
+    check(page_entries - 3, 7);
+    check(page_entries / 2, 2 * page_entries);
+    check(locs - 1, 1);
+
+    md->cork(yt::UUID());
+    md->unCork();
+
+    check(0, locs);
+    check(page_entries + 1, page_entries + 5);
+}
+
+// Compares per-cluster lookups with range lookups for large sequential reads
+// (by default 1 MiB worth of 4k clusters per read).
+TEST_P(MetaDataStoreTest, sequential_range_read_performance)
+{
+    const uint32_t npages(yt::System::get_env_with_default<uint32_t>("MD_PAGES",
+                                                                     64));
+    const uint32_t cache_pages(yt::System::get_env_with_default<uint32_t>("MD_CACHE_PAGES",
+                                                                          npages));
+    const uint32_t range_size(yt::System::get_env_with_default<uint32_t>("RANGE_SIZE",
+                                                                         256));
+    const uint32_t iterations(yt::System::get_env_with_default<uint32_t>("ITERATIONS",
+                                                                         16));
+
+    const uint64_t locs = npages * CachePage::capacity();
+    const uint64_t vsize = locs * default_cluster_size();
+
+    auto ns_ptr = make_random_namespace();
+
+    SharedVolumePtr v = newVolume("volume",
+                                  ns_ptr->ns(),
+                                  VolumeSize(vsize),
+                                  default_sco_multiplier(),
+                                  default_lba_size(),
+                                  default_cluster_multiplier(),
+                                  cache_pages);
+
+    MetaDataStoreInterface* md = v->getMetaDataStore();
+
+    for (uint64_t i = 0; i < locs; ++i)
+    {
+        md->writeCluster(i,
+                         ClusterLocationAndHash(ClusterLocation(i + 1),
+                                                w));
+    }
+
+    md->cork(yt::UUID());
+    md->unCork();
+
+    auto run([&](const char* desc,
+                 std::function<void(ClusterAddress,
+                                    std::vector<ClusterLocationAndHash>&)> fun)
+             {
+                 std::vector<ClusterLocationAndHash> vec;
+                 uint64_t clusters = 0;
+                 yt::wall_timer wt;
+
+                 for (uint32_t i = 0; i < iterations; ++i)
+                 {
+                     for (ClusterAddress ca = 0;
+                          ca + range_size <= locs;
+                          ca += range_size)
+                     {
+                         fun(ca, vec);
+                         ASSERT_EQ(range_size, vec.size());
+                         EXPECT_EQ(ClusterLocation(ca + 1),
+                                   vec.front().clusterLocation);
+                         EXPECT_EQ(ClusterLocation(ca + range_size),
+                                   vec.back().clusterLocation);
+                         clusters += range_size;
+                     }
+                 }
+
+                 std::cout << desc << ": " << (clusters / wt.elapsed()) <<
+                     " clusters/s (range size " << range_size <<
+                     ", cached pages " << cache_pages << "/" << npages << ")" <<
+                     std::endl;
+             });
+
+    run("readCluster",
+        [&](ClusterAddress ca,
+            std::vector<ClusterLocationAndHash>& vec)
+        {
+            vec.resize(range_size);
+            for (size_t i = 0; i < range_size; ++i)
+            {
+                md->readCluster(ca + i,
+                                vec[i]);
+            }
+        });
+
+    run("readClusters",
+        [&](ClusterAddress ca,
+            std::vector<ClusterLocationAndHash>& vec)
+        {
+            md->readClusters(ca,
+                             range_size,
+                             vec);
+        });
+}
+
 TEST_P(MetaDataStoreTest, DISABLED_page_compression)
 {
     const uint32_t num_pages(youtils::System::get_env_with_default("NUM_PAGES",
@@ -0,0 +1,120 @@
+// Copyright (C) 2016 iNuron NV
+//
+// This file is part of Open vStorage Open Source Edition (OSE),
+// as available from
+//
+//      http://www.openvstorage.org and
+//      http://www.openvstorage.com.
+//
+// This file is free software; you can redistribute it and/or modify it
+// under the terms of the GNU Affero General Public License v3 (GNU AGPLv3)
+// as published by the Free Software Foundation, in version 3 as it comes in
+// the LICENSE.txt file of the Open vStorage OSE distribution.
+// Open vStorage is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY of any kind.
+
+#include "../PartialReadExecutor.h"
+
+#include <atomic>
+#include <future>
+#include <stdexcept>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+namespace volumedrivertest
+{
+
+using namespace volumedriver;
+
+class PartialReadExecutorTest
+    : public testing::Test
+{};
+
+TEST_F(PartialReadExecutorTest, all_jobs)
+{
+    PartialReadExecutor ex(4);
+
+    const size_t njobs = 64;
+    std::atomic<size_t> ran(0);
+    std::vector<PartialReadExecutor::Job> jobs(njobs,
+                                               [&]
+                                               {
+                                                   ++ran;
+                                               });
+
+    ex.run(jobs,
+           8);
+
+    EXPECT_EQ(njobs, ran);
+}
+
+TEST_F(PartialReadExecutorTest, errors)
+{
+    PartialReadExecutor ex(4);
+
+    std::vector<PartialReadExecutor::Job> jobs(16,
+                                               []
+                                               {
+                                                   throw std::runtime_error("meh");
+                                               });
+
+    EXPECT_THROW(ex.run(jobs,
+                        8),
+                 std::runtime_error);
+}
+
+// A request must not wait for pool threads that are busy with the jobs of
+// other requests.
+TEST_F(PartialReadExecutorTest, no_head_of_line_blocking)
+{
+    PartialReadExecutor ex(1);
+
+    std::promise<void> block;
+    std::shared_future<void> blocked(block.get_future().share());
+    std::promise<void> started;
+
+    auto blocker(std::async(std::launch::async,
+                            [&]
+                            {
+                                std::atomic<bool> first(true);
+                                std::vector<PartialReadExecutor::Job>
+                                    jobs(2,
+                                         [&]
+                                         {
+                                             if (first.exchange(false))
+                                             {
+                                                 started.set_value();
+                                             }
+                                             blocked.wait();
+                                         });
+                                ex.run(jobs,
+                                       2);
+                            }));
+
+    started.get_future().wait();
+
+    std::atomic<size_t> ran(0);
+    std::vector<PartialReadExecutor::Job> jobs(4,
+                                               [&]
+                                               {
+                                                   ++ran;
+                                               });
+
+    auto f(std::async(std::launch::async,
+                      [&]
+                      {
+                          ex.run(jobs,
+                                 4);
+                      }));
+
+    EXPECT_EQ(std::future_status::ready,
+              f.wait_for(std::chrono::seconds(10)));
+    EXPECT_EQ(4U, ran);
+
+    block.set_value();
+    blocker.get();
+    f.get();
+}
+
+}
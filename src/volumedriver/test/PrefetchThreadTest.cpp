@@ -142,6 +142,58 @@ TEST_P(PrefetchThreadTest, test_two)
                   RemoveVolumeCompletely::F);
 }
 
+TEST_P(PrefetchThreadTest, queue_order)
+{
+    PrefetchQueue q;
+
+    const float initial = 1;
+
+    // read ahead: same SAP, fetched in the order they were issued
+    for (uint32_t i = 0; i < 10; ++i)
+    {
+        q.push(SCO(SCONumber(100 + i)),
+               initial,
+               IsReadAhead::T);
+    }
+
+    q.push(SCO(SCONumber(1)),
+           2 * initial,
+           IsReadAhead::F);
+
+    q.push(SCO(SCONumber(2)),
+           initial / 2,
+           IsReadAhead::F);
+
+    ASSERT_EQ(12U,
+              q.size());
+
+    EXPECT_EQ(SCO(SCONumber(1)),
+              q.pop().sco);
+
+    for (uint32_t i = 0; i < 5; ++i)
+    {
+        EXPECT_EQ(SCO(SCONumber(100 + i)),
+                  q.pop().sco);
+    }
+
+    // a failed prefetch drops the remaining prefetches but not the read ahead
+    q.drop_prefetches();
+
+    ASSERT_EQ(5U,
+              q.size());
+
+    for (uint32_t i = 5; i < 10; ++i)
+    {
+        const PrefetchQueue::Entry e(q.pop());
+        EXPECT_EQ(SCO(SCONumber(100 + i)),
+                  e.sco);
+        EXPECT_EQ(IsReadAhead::T,
+                  e.read_ahead);
+    }
+
+    EXPECT_TRUE(q.empty());
+}
+
 INSTANTIATE_TEST(PrefetchThreadTest);
 
 }
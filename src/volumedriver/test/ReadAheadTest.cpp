@@ -0,0 +1,193 @@
+// Copyright (C) 2016 iNuron NV
+//
+// This file is part of Open vStorage Open Source Edition (OSE),
+// as available from
+//
+//      http://www.openvstorage.org and
+//      http://www.openvstorage.com.
+//
+// This file is free software; you can redistribute it and/or modify it
+// under the terms of the GNU Affero General Public License v3 (GNU AGPLv3)
+// as published by the Free Software Foundation, in version 3 as it comes in
+// the LICENSE.txt file of the Open vStorage OSE distribution.
+// Open vStorage is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY of any kind.
+
+#include "../ReadAhead.h"
+
+#include <gtest/gtest.h>
+
+namespace volumedrivertest
+{
+
+using namespace volumedriver;
+
+class ReadAheadTest
+    : public testing::Test
+{
+protected:
+    // 4 clusters per SCO, the data of the volume was written sequentially
+    static constexpr uint64_t sco_clusters = 4;
+
+    const ReadAhead::Config cfg{ 2,
+                                 sco_clusters,
+                                 4 * sco_clusters };
+
+    static std::vector<ClusterLocationAndHash>
+    locs(ClusterAddress ca,
+         size_t count)
+    {
+        std::vector<ClusterLocationAndHash> v;
+        v.reserve(count);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const ClusterAddress c = ca + i;
+            v.emplace_back(ClusterLocation(c / sco_clusters + 1,
+                                           c % sco_clusters));
+        }
+
+        return v;
+    }
+
+    // issues the SCOs of the clusters to be read ahead like the volume does
+    static size_t
+    issue(ReadAhead& ra,
+          const ReadAhead::Result& res)
+    {
+        size_t n = 0;
+        for (const auto& l : locs(res.ahead_begin,
+                                  res.ahead_end - res.ahead_begin))
+        {
+            if (ra.issue(l.clusterLocation.sco()))
+            {
+                ++n;
+            }
+        }
+
+        return n;
+    }
+};
+
+constexpr uint64_t ReadAheadTest::sco_clusters;
+
+TEST_F(ReadAheadTest, random)
+{
+    ReadAhead ra;
+
+    for (const ClusterAddress ca : { 100, 7, 300, 42, 1000 })
+    {
+        const ReadAhead::Result res(ra.update(ca,
+                                              locs(ca, 1),
+                                              cfg,
+                                              false));
+        EXPECT_EQ(0U, res.hits);
+        EXPECT_EQ(0U, res.wasted);
+        EXPECT_EQ(res.ahead_begin, res.ahead_end);
+        EXPECT_EQ(0U, ra.window());
+    }
+}
+
+TEST_F(ReadAheadTest, sequential)
+{
+    ReadAhead ra;
+
+    ReadAhead::Result res(ra.update(0,
+                                    locs(0, 2),
+                                    cfg,
+                                    false));
+    EXPECT_EQ(res.ahead_begin, res.ahead_end);
+
+    res = ra.update(2,
+                    locs(2, 2),
+                    cfg,
+                    false);
+
+    EXPECT_EQ(sco_clusters, ra.window());
+    EXPECT_EQ(4U, res.ahead_begin);
+    EXPECT_EQ(8U, res.ahead_end);
+    EXPECT_EQ(1U, issue(ra, res));
+
+    size_t hits = 0;
+    size_t wasted = 0;
+
+    for (ClusterAddress ca = 4; ca < 64; ca += 2)
+    {
+        res = ra.update(ca,
+                        locs(ca, 2),
+                        cfg,
+                        false);
+        hits += res.hits;
+        wasted += res.wasted;
+
+        if (res.ahead_begin != res.ahead_end)
+        {
+            EXPECT_LE(ca + 2, res.ahead_begin);
+            EXPECT_GE(ca + 2 + ra.window(), res.ahead_end);
+            issue(ra, res);
+        }
+    }
+
+    EXPECT_EQ(cfg.max_window, ra.window());
+    EXPECT_EQ(15U, hits);
+    EXPECT_EQ(0U, wasted);
+    EXPECT_NE(0U, ra.pending());
+
+    // breaking the stream drops whatever was read ahead
+    const size_t pending = ra.pending();
+    res = ra.update(0,
+                    locs(0, 2),
+                    cfg,
+                    false);
+
+    EXPECT_EQ(pending, res.wasted);
+    EXPECT_EQ(0U, ra.pending());
+    EXPECT_EQ(0U, ra.window());
+}
+
+TEST_F(ReadAheadTest, cache_pressure)
+{
+    ReadAhead ra;
+    ClusterAddress ca = 0;
+
+    for (; ca < 32; ca += 2)
+    {
+        const ReadAhead::Result res(ra.update(ca,
+                                              locs(ca, 2),
+                                              cfg,
+                                              false));
+        issue(ra, res);
+    }
+
+    ASSERT_EQ(cfg.max_window, ra.window());
+
+    for (size_t i = 0; i < 4; ++i, ca += 2)
+    {
+        const ReadAhead::Result res(ra.update(ca,
+                                              locs(ca, 2),
+                                              cfg,
+                                              true));
+        EXPECT_EQ(res.ahead_begin, res.ahead_end);
+    }
+
+    EXPECT_EQ(cfg.min_window, ra.window());
+}
+
+TEST_F(ReadAheadTest, disabled)
+{
+    ReadAhead ra;
+    const ReadAhead::Config off{ 2, sco_clusters, 0 };
+
+    for (ClusterAddress ca = 0; ca < 32; ca += 2)
+    {
+        const ReadAhead::Result res(ra.update(ca,
+                                              locs(ca, 2),
+                                              off,
+                                              false));
+        EXPECT_EQ(res.ahead_begin, res.ahead_end);
+    }
+
+    EXPECT_EQ(0U, ra.window());
+}
+
+}
@@ -0,0 +1,351 @@
+// Copyright (C) 2016 iNuron NV
+//
+// This file is part of Open vStorage Open Source Edition (OSE),
+// as available from
+//
+//      http://www.openvstorage.org and
+//      http://www.openvstorage.com.
+//
+// This file is free software; you can redistribute it and/or modify it
+// under the terms of the GNU Affero General Public License v3 (GNU AGPLv3)
+// as published by the Free Software Foundation, in version 3 as it comes in
+// the LICENSE.txt file of the Open vStorage OSE distribution.
+// Open vStorage is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY of any kind.
+
+#include "VolManagerTestSetup.h"
+
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <thread>
+
+#include "../ClusterCacheBehaviour.h"
+#include "../ClusterCacheMode.h"
+
+// This test lives in a binary of its own (volumedriver_allocation_test) as it
+// replaces the global allocation functions.
+
+namespace
+{
+
+// Only allocations made by the thread that enabled counting are counted.
+thread_local bool count_allocations = false;
+thread_local uint64_t allocations = 0;
+
+void*
+counting_alloc(size_t size,
+               size_t align = 0) noexcept
+{
+    if (count_allocations)
+    {
+        ++allocations;
+    }
+
+    if (size == 0)
+    {
+        size = 1;
+    }
+
+    if (align > alignof(std::max_align_t))
+    {
+        void* p = nullptr;
+        return posix_memalign(&p, align, size) == 0 ? p : nullptr;
+    }
+    else
+    {
+        return malloc(size);
+    }
+}
+
+void*
+counting_alloc_or_throw(size_t size,
+                        size_t align = 0)
+{
+    void* p = counting_alloc(size,
+                             align);
+    if (p == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+
+    return p;
+}
+
+}
+
+// Replacements of all the global allocation functions - they merely forward to
+// malloc / free unless counting is enabled on the calling thread.
+void*
+operator new(size_t size)
+{
+    return counting_alloc_or_throw(size);
+}
+
+void*
+operator new[](size_t size)
+{
+    return counting_alloc_or_throw(size);
+}
+
+void*
+operator new(size_t size,
+             const std::nothrow_t&) noexcept
+{
+    return counting_alloc(size);
+}
+
+void*
+operator new[](size_t size,
+               const std::nothrow_t&) noexcept
+{
+    return counting_alloc(size);
+}
+
+void
+operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+void
+operator delete[](void* p) noexcept
+{
+    free(p);
+}
+
+void
+operator delete(void* p,
+                const std::nothrow_t&) noexcept
+{
+    free(p);
+}
+
+void
+operator delete[](void* p,
+                  const std::nothrow_t&) noexcept
+{
+    free(p);
+}
+
+void
+operator delete(void* p,
+                size_t) noexcept
+{
+    free(p);
+}
+
+void
+operator delete[](void* p,
+                  size_t) noexcept
+{
+    free(p);
+}
+
+#ifdef __cpp_aligned_new
+
+void*
+operator new(size_t size,
+             std::align_val_t align)
+{
+    return counting_alloc_or_throw(size,
+                                   static_cast<size_t>(align));
+}
+
+void*
+operator new[](size_t size,
+               std::align_val_t align)
+{
+    return counting_alloc_or_throw(size,
+                                   static_cast<size_t>(align));
+}
+
+void*
+operator new(size_t size,
+             std::align_val_t align,
+             const std::nothrow_t&) noexcept
+{
+    return counting_alloc(size,
+                          static_cast<size_t>(align));
+}
+
+void*
+operator new[](size_t size,
+               std::align_val_t align,
+               const std::nothrow_t&) noexcept
+{
+    return counting_alloc(size,
+                          static_cast<size_t>(align));
+}
+
+void
+operator delete(void* p,
+                std::align_val_t) noexcept
+{
+    free(p);
+}
+
+void
+operator delete[](void* p,
+                  std::align_val_t) noexcept
+{
+    free(p);
+}
+
+void
+operator delete(void* p,
+                size_t,
+                std::align_val_t) noexcept
+{
+    free(p);
+}
+
+void
+operator delete[](void* p,
+                  size_t,
+                  std::align_val_t) noexcept
+{
+    free(p);
+}
+
+void
+operator delete(void* p,
+                std::align_val_t,
+                const std::nothrow_t&) noexcept
+{
+    free(p);
+}
+
+void
+operator delete[](void* p,
+                  std::align_val_t,
+                  const std::nothrow_t&) noexcept
+{
+    free(p);
+}
+
+#endif
+
+namespace volumedrivertest
+{
+
+using namespace volumedriver;
+
+class ReadAllocationTest
+    : public VolManagerTestSetup
+{
+public:
+    ReadAllocationTest()
+        : VolManagerTestSetup("ReadAllocationTest")
+    {}
+
+    struct AllocationCounter
+    {
+        AllocationCounter()
+        {
+            allocations = 0;
+            count_allocations = true;
+        }
+
+        ~AllocationCounter()
+        {
+            count_allocations = false;
+        }
+
+        uint64_t
+        count() const
+        {
+            return allocations;
+        }
+    };
+};
+
+TEST_P(ReadAllocationTest, cached_read)
+{
+    const auto wrns(make_random_namespace());
+    SharedVolumePtr v = newVolume(*wrns);
+
+    v->set_cluster_cache_behaviour(ClusterCacheBehaviour::CacheOnRead);
+    v->set_cluster_cache_mode(ClusterCacheMode::LocationBased);
+
+    const size_t csize = v->getClusterSize();
+    const std::string pattern("allocation free");
+
+    writeToVolume(*v,
+                  Lba(0),
+                  csize,
+                  pattern);
+
+    // suitably aligned for O_DIRECT, otherwise DirectAsync mount points have to
+    // resort to a bounce buffer
+    void* mem = nullptr;
+    ASSERT_EQ(0,
+              posix_memalign(&mem,
+                             4096,
+                             csize));
+    std::unique_ptr<uint8_t, decltype(&free)> buf(static_cast<uint8_t*>(mem),
+                                                 &free);
+
+    // The first read misses the cluster cache and fills it (in the background
+    // with DirectAsync mount points), the next ones hit and warm up the per
+    // thread scratch space of the read path.
+    for (size_t i = 0; i < 100; ++i)
+    {
+        const uint64_t hits = v->getClusterCacheHits();
+        v->read(Lba(0),
+                buf.get(),
+                csize);
+        if (v->getClusterCacheHits() > hits)
+        {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    v->read(Lba(0),
+            buf.get(),
+            csize);
+
+    const uint64_t hits = v->getClusterCacheHits();
+    uint64_t count = 0;
+
+    {
+        const AllocationCounter counter;
+        v->read(Lba(0),
+                buf.get(),
+                csize);
+        count = counter.count();
+    }
+
+    EXPECT_EQ(hits + 1,
+              v->getClusterCacheHits());
+    EXPECT_EQ(0U,
+              count);
+
+    checkVolume(*v,
+                Lba(0),
+                csize,
+                pattern);
+}
+
+namespace
+{
+
+const VolumeDriverTestConfig cluster_cache_config =
+    VolumeDriverTestConfig().use_cluster_cache(true);
+
+// falls back to Buffered if the underlying fs doesn't support O_DIRECT
+const VolumeDriverTestConfig direct_async_cluster_cache_config =
+    VolumeDriverTestConfig()
+    .use_cluster_cache(true)
+    .cluster_cache_io_mode(MountPointIoMode::DirectAsync);
+
+}
+
+INSTANTIATE_TEST_CASE_P(ReadAllocationTests,
+                        ReadAllocationTest,
+                        ::testing::Values(cluster_cache_config,
+                                          direct_async_cluster_cache_config));
+
+}
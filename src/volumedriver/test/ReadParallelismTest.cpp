@@ -17,6 +17,8 @@
 #include <boost/thread.hpp>
 #include "../Api.h"
 #include <youtils/wall_timer.h>
+
+#include <boost/lexical_cast.hpp>
 #include <youtils/SourceOfUncertainty.h>
 #include <youtils/System.h>
 
@@ -203,6 +205,113 @@ TEST_P(ReadParallelismTest, DISABLED_single_read)
     }
 }
 
+// A read from the tip of a clone chain whose clusters are spread over the
+// SCOs of all ancestors: with partial reads issued concurrently the latency is
+// roughly that of a single backend request instead of the sum over all levels.
+TEST_P(ReadParallelismTest, clone_chain_reads)
+{
+    const size_t levels =
+        yt::System::get_env_with_default("READ_PARALLELISM_CLONE_LEVELS",
+                                         5ULL);
+    const size_t iterations =
+        yt::System::get_env_with_default("READ_PARALLELISM_ITERATIONS",
+                                         20ULL);
+    ASSERT_LT(1U, levels);
+    ASSERT_LT(0U, iterations);
+
+    const size_t clusters = 4 * levels;
+    const uint64_t csize = default_cluster_size();
+
+    auto pattern([](size_t level) -> std::string
+                 {
+                     return "level-" + boost::lexical_cast<std::string>(level);
+                 });
+
+    std::vector<std::unique_ptr<backend::BackendTestSetup::WithRandomNamespace>> nss;
+    nss.emplace_back(make_random_namespace());
+
+    SharedVolumePtr v = newVolume("volume-0",
+                                  nss.back()->ns());
+
+    for (size_t l = 0; l < levels; ++l)
+    {
+        for (size_t i = l; i < clusters; i += levels)
+        {
+            writeToVolume(*v,
+                          Lba(i * csize / 512),
+                          csize,
+                          pattern(l));
+        }
+
+        if (l == levels - 1)
+        {
+            break;
+        }
+
+        const SnapshotName snap("snap-" + boost::lexical_cast<std::string>(l));
+        v->createSnapshot(snap);
+        waitForThisBackendWrite(*v);
+
+        const backend::Namespace& parent = nss.back()->ns();
+        nss.emplace_back(make_random_namespace());
+
+        v = createClone("volume-" + boost::lexical_cast<std::string>(l + 1),
+                        nss.back()->ns(),
+                        parent,
+                        snap);
+        ASSERT_TRUE(v != nullptr);
+    }
+
+    std::vector<uint8_t> buf(clusters * csize);
+
+    auto measure([&](uint32_t max_in_flight) -> std::vector<double>
+                 {
+                     VolManager::get()->max_concurrent_partial_reads.update(max_in_flight);
+
+                     std::vector<double> lat;
+                     lat.reserve(iterations);
+
+                     for (size_t i = 0; i < iterations; ++i)
+                     {
+                         yt::wall_timer wt;
+                         v->read(Lba(0),
+                                 buf.data(),
+                                 buf.size());
+                         lat.push_back(wt.elapsed());
+                     }
+
+                     std::sort(lat.begin(),
+                               lat.end());
+
+                     auto pct([&](double p) -> double
+                              {
+                                  return lat[std::min(lat.size() - 1,
+                                                      static_cast<size_t>(p * lat.size()))];
+                              });
+
+                     std::cout << "max_concurrent_partial_reads " << max_in_flight <<
+                         ", " << levels << " levels: p50 " << pct(0.5) <<
+                         "s, p99 " << pct(0.99) <<
+                         "s, max " << lat.back() << "s" << std::endl;
+
+                     return lat;
+                 });
+
+    const std::vector<double> seq(measure(1));
+    const std::vector<double> par(measure(levels));
+
+    EXPECT_GT(seq[seq.size() / 2],
+              par[par.size() / 2]);
+
+    for (size_t i = 0; i < clusters; ++i)
+    {
+        checkVolume(*v,
+                    Lba(i * csize / 512),
+                    csize,
+                    pattern(i % levels));
+    }
+}
+
 namespace
 {
 const VolumeDriverTestConfig thisConfig =
@@ -2768,6 +2768,55 @@ TEST_P(SimpleVolumeTest, bytewise)
     check("\0\0\0\0", first.size() + second.size() + third.size());
 }
 
+TEST_P(SimpleVolumeTest, write_copies)
+{
+    auto wrns(make_random_namespace());
+    SharedVolumePtr v = newVolume(*wrns);
+
+    v->set_cluster_cache_behaviour(ClusterCacheBehaviour::NoCache);
+
+    const size_t csize = v->getClusterSize();
+    const size_t off = csize / 2;
+    const std::vector<uint8_t> wbuf(4 * csize, 'x');
+
+    PerformanceCounters& pc = v->performance_counters();
+    pc.reset_all_counters();
+
+    auto check_copied([&](uint64_t exp)
+                      {
+                          EXPECT_EQ(exp, pc.write_copy_size.sum());
+                          pc.reset_all_counters();
+                      });
+
+    // aligned: straight from the caller's buffer into the SCO
+    v->write(0,
+             wbuf.data(),
+             wbuf.size());
+    check_copied(0);
+
+    // unaligned: the payload is bounced into a single aligned write
+    v->write(off,
+             wbuf.data(),
+             wbuf.size());
+    check_copied(wbuf.size());
+
+    v->write(off,
+             wbuf.data(),
+             1);
+    check_copied(1);
+
+    std::vector<uint8_t> rbuf(6 * csize);
+    v->read(0,
+            rbuf.data(),
+            rbuf.size());
+
+    for (size_t i = 0; i < rbuf.size(); ++i)
+    {
+        ASSERT_EQ(i < off + wbuf.size() ? 'x' : 0,
+                  rbuf[i]) << "offset " << i;
+    }
+}
+
 TEST_P(SimpleVolumeTest, get_page)
 {
     static const size_t vsize = yt::System::get_env_with_default("SIMPLE_TEST_VOLUME_SIZE",
@@ -26,6 +26,7 @@
 #include <boost/timer.hpp>
 #include <boost/scope_exit.hpp>
 
+#include <youtils/FileDescriptor.h>
 #include <youtils/FileUtils.h>
 #include <youtils/System.h>
 
@@ -35,6 +36,7 @@
 #include "../TLogReader.h"
 #include "../BackwardTLogReader.h"
 #include "../TLog.h"
+#include "../TLogCodec.h"
 #include "../Types.h"
 
 namespace volumedrivertest
@@ -497,6 +499,137 @@ TEST_F(TLogTest, forth_and_back)
     ASSERT_TRUE(r.nextAny() == nullptr);
 }
 
+TEST_F(TLogTest, compact_encoding)
+{
+    const fs::path raw(directory_ / "raw");
+    const fs::path compact(directory_ / "compact");
+    const fs::path decoded(directory_ / "decoded");
+
+    const size_t count = 3 * TLogCodec::entries_per_block + 17;
+    const youtils::Weed weed(VolManagerTestSetup::growWeed());
+
+    {
+        TLogWriter w(raw);
+
+        SCONumber sco = 1;
+        SCOOffset off = 0;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (i % 1000 == 999)
+            {
+                w.add();
+            }
+            else if (i % 4096 == 4095)
+            {
+                w.add(CheckSum(i));
+                ++sco;
+                off = 0;
+            }
+            else
+            {
+                const ClusterAddress ca = (i % 7) ? i : (i * 7919) % 100000;
+                w.add(ca,
+                      ClusterLocationAndHash(ClusterLocation(sco, off++),
+                                             weed));
+            }
+        }
+
+        w.close();
+    }
+
+    EXPECT_FALSE(TLogCodec::is_compact(raw));
+
+    TLogCodec::encode(raw, compact);
+
+    EXPECT_TRUE(TLogCodec::is_compact(compact));
+    EXPECT_GT(fs::file_size(raw), fs::file_size(compact));
+
+    TLogCodec::decode(compact, decoded);
+
+    EXPECT_EQ(yt::FileUtils::calculate_checksum(raw),
+              yt::FileUtils::calculate_checksum(decoded));
+
+    auto check([&](TLogReaderInterface& x,
+                   TLogReaderInterface& y)
+               {
+                   const Entry* ex;
+                   size_t n = 0;
+                   while ((ex = x.nextAny()))
+                   {
+                       const Entry* ey = y.nextAny();
+                       ASSERT_TRUE(ey != nullptr);
+                       ASSERT_EQ(0, memcmp(ex, ey, Entry::getDataSize()));
+                       ++n;
+                   }
+                   EXPECT_TRUE(y.nextAny() == nullptr);
+                   EXPECT_EQ(count + 1, n);
+               });
+
+    {
+        TLogReader x(raw);
+        TLogReader y(compact);
+        check(x, y);
+    }
+
+    {
+        BackwardTLogReader x(raw);
+        BackwardTLogReader y(compact);
+        check(x, y);
+    }
+
+    {
+        const std::vector<std::string> xs{ raw.filename().string() };
+        const std::vector<std::string> ys{ compact.filename().string() };
+
+        auto x(CombinedTLogReader::create(directory_,
+                                          xs,
+                                          nullptr));
+        auto y(CombinedTLogReader::create(directory_,
+                                          ys,
+                                          nullptr));
+        check(*x, *y);
+    }
+
+    // the temporary decoded TLogs are gone, the compact one is left alone
+    EXPECT_EQ(3,
+              std::distance(fs::directory_iterator(directory_),
+                            fs::directory_iterator()));
+}
+
+TEST_F(TLogTest, compact_encoding_bogus_payload_size)
+{
+    const fs::path raw(directory_ / "raw");
+    const fs::path compact(directory_ / "compact");
+    const fs::path decoded(directory_ / "decoded");
+
+    {
+        TLogWriter w(raw);
+        w.add(ClusterAddress(1),
+              ClusterLocationAndHash(ClusterLocation(1, 0),
+                                     VolManagerTestSetup::growWeed()));
+        w.close();
+    }
+
+    TLogCodec::encode(raw, compact);
+
+    {
+        // payload size of the first block, which follows the file header
+        // (magic, version, entry size, flags) and the block's entry count
+        const off_t off = sizeof(uint64_t) + 3 * sizeof(uint32_t) + sizeof(uint32_t);
+        const uint32_t size = std::numeric_limits<uint32_t>::max();
+
+        yt::FileDescriptor fd(compact,
+                              yt::FDMode::Write);
+        fd.pwrite(&size,
+                  sizeof(size),
+                  off);
+    }
+
+    EXPECT_THROW(TLogCodec::decode(compact, decoded),
+                 TLogCodecException);
+}
+
 }
 
 // Local Variables: **
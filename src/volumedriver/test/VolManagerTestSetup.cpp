@@ -445,7 +445,9 @@ VolManagerTestSetup::VolManagerTestSetup(const VolManagerTestSetupParameters& pa
     : be::BackendTestSetup()
     , FailOverCacheTestSetup(GetParam().foc_in_memory() ?
                              boost::none :
-                             boost::optional<fs::path>(yt::FileUtils::temp_path(params.name()) / "foc"))
+                             boost::optional<fs::path>(yt::FileUtils::temp_path(params.name()) / "foc"),
+                             GetParam().foc_reactor_threads(),
+                             GetParam().foc_log_segment_size())
     , testName_(params.name())
     , directory_(yt::FileUtils::temp_path(testName_))
     , configuration_(directory_ / "configuration")
@@ -919,9 +921,11 @@ VolManagerTestSetup::startVolManager()
 
 
             vec.push_back(MountPointConfig(cc_mp1_path_.string(),
-                                           theFirst.getBytes()));
+                                           theFirst.getBytes(),
+                                           GetParam().cluster_cache_io_mode()));
             vec.push_back(MountPointConfig(cc_mp2_path_.string(),
-                                           theFirst.getBytes()));
+                                           theFirst.getBytes(),
+                                           GetParam().cluster_cache_io_mode()));
         }
 
         PARAMETER_TYPE(clustercache_mount_points)(vec).persist(pt);
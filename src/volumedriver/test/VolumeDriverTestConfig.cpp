@@ -26,7 +26,10 @@ operator<<(std::ostream& os,
 {
     return os <<
         "VolumeDriverTestConfig{use_cluster_cache=" << c.use_cluster_cache() <<
+        ", cluster_cache_io_mode=" << c.cluster_cache_io_mode() <<
         ", foc_in_memory=" << c.foc_in_memory() <<
+        ", foc_reactor_threads=" << c.foc_reactor_threads() <<
+        ", foc_log_segment_size=" << c.foc_log_segment_size() <<
         ", foc_mode=" << c.foc_mode() <<
         ", cluster_multiplier=" << c.cluster_multiplier() <<
         "}";
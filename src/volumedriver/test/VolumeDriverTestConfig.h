@@ -17,6 +17,7 @@
 #define VD_TEST_CONFIG_H_
 
 #include "../FailOverCacheMode.h"
+#include "../MountPointConfig.h"
 #include "../Types.h"
 #include "../VolumeConfig.h"
 
@@ -53,7 +54,10 @@ struct VolumeDriverTestConfig
     type name ## _
 
     PARAM(bool, use_cluster_cache) = false;
+    PARAM(MountPointIoMode, cluster_cache_io_mode) = MountPointIoMode::Buffered;
     PARAM(bool, foc_in_memory) = false;
+    PARAM(unsigned, foc_reactor_threads) = 0;
+    PARAM(size_t, foc_log_segment_size) = 0;
     PARAM(FailOverCacheMode, foc_mode) = FailOverCacheMode::Asynchronous;
     PARAM(ClusterMultiplier, cluster_multiplier) =
         VolumeConfig::default_cluster_multiplier();
@@ -68,6 +68,9 @@
 #include "Assert.h"
 #include "CheckSum.h"
 
+#include <nmmintrin.h>
+#include <wmmintrin.h>
+
 #include <boost/io/ios_state.hpp>
 
 namespace youtils
@@ -656,6 +659,98 @@ crc32c_hw(uint32_t crc,
     return crc32bit;
 }
 
+// x^n mod P in the bit-reflected representation of the CRC register.
+uint32_t
+crc32c_xpow(size_t n)
+{
+    uint32_t r = 0x80000000; // x^0
+    while (n-- > 0)
+    {
+        r = (r & 1) ? (r >> 1) ^ 0x82f63b78 : r >> 1;
+    }
+    return r;
+}
+
+// The crc32 instruction has a latency of 3 cycles but a throughput of 1 per
+// cycle, so we run 3 independent streams over adjacent blocks and combine the
+// partial CRCs afterwards: crc(A|B) = shift(crc(A), |B|) ^ crc(0, B), with
+// shift(c, n) = c * x^(8n) mod P. A carry-less multiplication by
+// x^(8n - 33) mod P followed by a crc32 of the (64 bit) product gets us there -
+// the 33 accounts for the one bit shift of the reflected product and for the
+// x^32 the crc32 instruction multiplies its input with.
+const size_t crc32c_long_block = 8192;
+const size_t crc32c_short_block = 256;
+
+const uint32_t crc32c_long_shift = crc32c_xpow(8 * crc32c_long_block - 33);
+const uint32_t crc32c_short_shift = crc32c_xpow(8 * crc32c_short_block - 33);
+
+inline uint32_t
+crc32c_shift(uint32_t crc,
+             uint32_t k)
+{
+    const __m128i p = _mm_clmulepi64_si128(_mm_cvtsi32_si128(crc),
+                                           _mm_cvtsi32_si128(k),
+                                           0);
+    return __builtin_ia32_crc32di(0,
+                                  _mm_cvtsi128_si64(p));
+}
+
+uint32_t
+crc32c_hw_3way_blocks(uint32_t crc,
+                      const char*& p_buf,
+                      size_t& length,
+                      const size_t block,
+                      const uint32_t k)
+{
+    while (length >= 3 * block)
+    {
+        uint64_t crc0 = crc;
+        uint64_t crc1 = 0;
+        uint64_t crc2 = 0;
+
+        const char* end = p_buf + block;
+        while (p_buf < end)
+        {
+            crc0 = __builtin_ia32_crc32di(crc0, *(uint64_t*) p_buf);
+            crc1 = __builtin_ia32_crc32di(crc1, *(uint64_t*) (p_buf + block));
+            crc2 = __builtin_ia32_crc32di(crc2, *(uint64_t*) (p_buf + 2 * block));
+            p_buf += sizeof(uint64_t);
+        }
+
+        crc = crc32c_shift(crc0, k) ^ crc1;
+        crc = crc32c_shift(crc, k) ^ crc2;
+
+        p_buf += 2 * block;
+        length -= 3 * block;
+    }
+
+    return crc;
+}
+
+uint32_t
+crc32c_hw_3way(uint32_t crc,
+               const void* data,
+               size_t length)
+{
+    const char* p_buf = (const char*) data;
+
+    crc = crc32c_hw_3way_blocks(crc,
+                                p_buf,
+                                length,
+                                crc32c_long_block,
+                                crc32c_long_shift);
+
+    crc = crc32c_hw_3way_blocks(crc,
+                                p_buf,
+                                length,
+                                crc32c_short_block,
+                                crc32c_short_shift);
+
+    return crc32c_hw(crc,
+                     p_buf,
+                     length);
+}
+
 using Fun = uint32_t (*)(uint32_t crc, const void* data, size_t length);
 
 Fun
@@ -671,7 +766,14 @@ choose_implementation()
     __builtin_cpu_init();
     if (__builtin_cpu_supports("sse4.2"))
     {
-        return crc32c_hw;
+        if (__builtin_cpu_supports("pclmul"))
+        {
+            return crc32c_hw_3way;
+        }
+        else
+        {
+            return crc32c_hw;
+        }
     }
     else
     {
@@ -705,6 +807,16 @@ CheckSum::crc32c_hw_(value_type crc,
                      length);
 }
 
+CheckSum::value_type
+CheckSum::crc32c_hw_3way_(value_type crc,
+                          const void* data,
+                          size_t length)
+{
+    return crc32c_hw_3way(crc,
+                          data,
+                          length);
+}
+
 void
 CheckSum::update(const void* buf,
                  uint64_t size)
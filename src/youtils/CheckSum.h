@@ -110,6 +110,11 @@ private:
     crc32c_hw_(value_type crc,
                const void* data,
                size_t length);
+
+    static value_type
+    crc32c_hw_3way_(value_type crc,
+                    const void* data,
+                    size_t length);
 };
 
 std::ostream&
@@ -186,6 +186,20 @@ FileDescriptor::pread(void* const buf,
     return s;
 }
 
+size_t
+FileDescriptor::preadv(const struct iovec* iov,
+                       int iovcnt,
+                       off_t pos)
+{
+    ssize_t s = ::preadv(fd_, iov, iovcnt, pos);
+    if (s < 0)
+    {
+        throw FileDescriptorException(errno,
+                                    FileDescriptorException::Exception::ReadException);
+    }
+    return s;
+}
+
 size_t
 FileDescriptor::write(const void* const buf,
                       size_t size)
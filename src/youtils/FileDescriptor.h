@@ -20,6 +20,8 @@
 #include "CreateIfNecessary.h"
 #include "Logging.h"
 
+#include <sys/uio.h>
+
 #include <boost/filesystem.hpp>
 
 VD_BOOLEAN_ENUM(SyncOnCloseAndDestructor);
@@ -123,6 +125,12 @@ public:
           size_t size,
           off_t pos);
 
+    // iovcnt must not exceed IOV_MAX
+    size_t
+    preadv(const struct iovec* iov,
+           int iovcnt,
+           off_t pos);
+
     size_t
     write(const void* const buf,
           size_t size);
@@ -313,6 +313,85 @@ FileUtils::safe_copy(const std::string& istr,
                dst);
 }
 
+void
+FileUtils::safe_copy(const fs::path& src,
+                     const fs::path& dst,
+                     const CheckSum& expected,
+                     const SyncFileBeforeRename sync_before_rename)
+{
+    if (not fs::exists(src))
+    {
+        LOG_ERROR("Could not safe copy " << src << ": no such file");
+        throw CopyNoSourceException("Could not safe copy file, no source");
+    }
+
+    const fs::path tmp = create_temp_file(dst);
+    ALWAYS_CLEANUP_FILE(tmp);
+
+    {
+        FileDescriptor in(src, FDMode::Read);
+        FileDescriptor out(tmp,
+                           FDMode::Write,
+                           CreateIfNecessary::F,
+                           SyncOnCloseAndDestructor::F);
+        std::vector<uint8_t> buf(1ULL << 20);
+        CheckSum chksum;
+
+        while (true)
+        {
+            const size_t ret = in.read(buf.data(), buf.size());
+            if (ret == 0)
+            {
+                break;
+            }
+            chksum.update(buf.data(), ret);
+            out.write(buf.data(), ret);
+        }
+
+        if (chksum != expected)
+        {
+            LOG_ERROR(src << ": checksum mismatch: expected " << expected <<
+                      ", calculated " << chksum);
+            throw CopyCheckSumMismatchException("Could not safe copy file, checksum mismatch",
+                                                src.string().c_str());
+        }
+
+        if (T(sync_before_rename))
+        {
+            out.sync();
+        }
+    }
+
+    fs::rename(tmp,
+               dst);
+}
+
+void
+FileUtils::safe_write(const void* buf,
+                      size_t size,
+                      const fs::path& dst,
+                      const SyncFileBeforeRename sync_before_rename)
+{
+    const fs::path tmp = create_temp_file(dst);
+    ALWAYS_CLEANUP_FILE(tmp);
+
+    {
+        FileDescriptor out(tmp,
+                           FDMode::Write,
+                           CreateIfNecessary::F,
+                           SyncOnCloseAndDestructor::F);
+        out.write(buf, size);
+
+        if (T(sync_before_rename))
+        {
+            out.sync();
+        }
+    }
+
+    fs::rename(tmp,
+               dst);
+}
+
 void
 FileUtils::statvfs_(const fs::path& path,
                     struct statvfs* st)
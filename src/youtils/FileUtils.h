@@ -43,6 +43,7 @@ public:
     MAKE_EXCEPTION(NotAFileException, FileUtils::Exception);
     MAKE_EXCEPTION(CopyException, FileUtils::Exception);
     MAKE_EXCEPTION(CopyNoSourceException, FileUtils::CopyException);
+    MAKE_EXCEPTION(CopyCheckSumMismatchException, FileUtils::CopyException);
 
 
     // Return a path that should be used as temp directory
@@ -106,6 +107,20 @@ public:
               const boost::filesystem::path& dst,
               const SyncFileBeforeRename = SyncFileBeforeRename::T);
 
+    // Like safe_copy, but the checksum of src is calculated while copying and
+    // dst is only put in place if it matches the expected one.
+    static void
+    safe_copy(const boost::filesystem::path& src,
+              const boost::filesystem::path& dst,
+              const CheckSum& expected,
+              const SyncFileBeforeRename = SyncFileBeforeRename::T);
+
+    static void
+    safe_write(const void* buf,
+               size_t size,
+               const boost::filesystem::path& dst,
+               const SyncFileBeforeRename = SyncFileBeforeRename::T);
+
     static uint64_t
     filesystem_size(const boost::filesystem::path& path);
 
@@ -52,6 +52,21 @@ public:
                        digest_);
     }
 
+    // Digest computed with an alternative algorithm producing digests of the
+    // same size (cf. WeedAlgorithm.h). The result cannot be told apart from one
+    // computed with Traits - it's up to the user to keep track of that.
+    template<typename OtherTraits>
+    MessageDigest(const uint8_t* input,
+                  const uint64_t input_size,
+                  const OtherTraits&)
+    {
+        static_assert(OtherTraits::digest_size == Traits::digest_size,
+                      "digest sizes differ");
+        OtherTraits::digest(input,
+                            input_size,
+                            digest_);
+    }
+
     explicit MessageDigest(const std::string& str)
     {
         VERIFY(str.length() == 2 * Traits::digest_size);
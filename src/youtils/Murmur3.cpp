@@ -0,0 +1,132 @@
+// Copyright (C) 2016 iNuron NV
+//
+// This file is part of Open vStorage Open Source Edition (OSE),
+// as available from
+//
+//      http://www.openvstorage.org and
+//      http://www.openvstorage.com.
+//
+// This file is free software; you can redistribute it and/or modify it
+// under the terms of the GNU Affero General Public License v3 (GNU AGPLv3)
+// as published by the Free Software Foundation, in version 3 as it comes in
+// the LICENSE.txt file of the Open vStorage OSE distribution.
+// Open vStorage is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY of any kind.
+
+#include "Murmur3.h"
+
+#include <string.h>
+
+namespace youtils
+{
+
+namespace
+{
+
+inline uint64_t
+rotl64(uint64_t x, int8_t r)
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+inline uint64_t
+fmix64(uint64_t k)
+{
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return k;
+}
+
+inline uint64_t
+load64(const uint8_t* p)
+{
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+const uint32_t seed = 0;
+
+}
+
+void
+Murmur3Traits::digest(const uint8_t* data,
+                      size_t len,
+                      Digest& digest)
+{
+    const size_t nblocks = len / 16;
+
+    uint64_t h1 = seed;
+    uint64_t h2 = seed;
+
+    const uint64_t c1 = 0x87c37b91114253d5ULL;
+    const uint64_t c2 = 0x4cf5ad432745937fULL;
+
+    for (size_t i = 0; i < nblocks; ++i)
+    {
+        uint64_t k1 = load64(data + i * 16);
+        uint64_t k2 = load64(data + i * 16 + 8);
+
+        k1 *= c1; k1 = rotl64(k1, 31); k1 *= c2; h1 ^= k1;
+
+        h1 = rotl64(h1, 27); h1 += h2; h1 = h1 * 5 + 0x52dce729;
+
+        k2 *= c2; k2 = rotl64(k2, 33); k2 *= c1; h2 ^= k2;
+
+        h2 = rotl64(h2, 31); h2 += h1; h2 = h2 * 5 + 0x38495ab5;
+    }
+
+    const uint8_t* tail = data + nblocks * 16;
+
+    uint64_t k1 = 0;
+    uint64_t k2 = 0;
+
+    switch (len & 15)
+    {
+    case 15: k2 ^= static_cast<uint64_t>(tail[14]) << 48;
+    case 14: k2 ^= static_cast<uint64_t>(tail[13]) << 40;
+    case 13: k2 ^= static_cast<uint64_t>(tail[12]) << 32;
+    case 12: k2 ^= static_cast<uint64_t>(tail[11]) << 24;
+    case 11: k2 ^= static_cast<uint64_t>(tail[10]) << 16;
+    case 10: k2 ^= static_cast<uint64_t>(tail[9]) << 8;
+    case 9: k2 ^= static_cast<uint64_t>(tail[8]) << 0;
+        k2 *= c2; k2 = rotl64(k2, 33); k2 *= c1; h2 ^= k2;
+
+    case 8: k1 ^= static_cast<uint64_t>(tail[7]) << 56;
+    case 7: k1 ^= static_cast<uint64_t>(tail[6]) << 48;
+    case 6: k1 ^= static_cast<uint64_t>(tail[5]) << 40;
+    case 5: k1 ^= static_cast<uint64_t>(tail[4]) << 32;
+    case 4: k1 ^= static_cast<uint64_t>(tail[3]) << 24;
+    case 3: k1 ^= static_cast<uint64_t>(tail[2]) << 16;
+    case 2: k1 ^= static_cast<uint64_t>(tail[1]) << 8;
+    case 1: k1 ^= static_cast<uint64_t>(tail[0]) << 0;
+        k1 *= c1; k1 = rotl64(k1, 31); k1 *= c2; h1 ^= k1;
+    }
+
+    h1 ^= len;
+    h2 ^= len;
+
+    h1 += h2;
+    h2 += h1;
+
+    h1 = fmix64(h1);
+    h2 = fmix64(h2);
+
+    h1 += h2;
+    h2 += h1;
+
+    static_assert(sizeof(h1) + sizeof(h2) == digest_size,
+                  "digest size mismatch");
+
+    memcpy(digest.data(), &h1, sizeof(h1));
+    memcpy(digest.data() + sizeof(h1), &h2, sizeof(h2));
+}
+
+}
+
+// Local Variables: **
+// mode: c++ **
+// End: **
@@ -0,0 +1,47 @@
+// Copyright (C) 2016 iNuron NV
+//
+// This file is part of Open vStorage Open Source Edition (OSE),
+// as available from
+//
+//      http://www.openvstorage.org and
+//      http://www.openvstorage.com.
+//
+// This file is free software; you can redistribute it and/or modify it
+// under the terms of the GNU Affero General Public License v3 (GNU AGPLv3)
+// as published by the Free Software Foundation, in version 3 as it comes in
+// the LICENSE.txt file of the Open vStorage OSE distribution.
+// Open vStorage is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY of any kind.
+
+#ifndef YT_MURMUR3_H_
+#define YT_MURMUR3_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace youtils
+{
+
+// MurmurHash3_x64_128 (by Austin Appleby, placed in the public domain) - not a
+// cryptographic hash, but a lot cheaper than MD5 while producing digests of the
+// same size. Cf. WeedAlgorithm.h for its use as an alternative Weed.
+struct Murmur3Traits
+{
+    static constexpr size_t digest_size = 16;
+
+    using Digest = std::array<uint8_t, digest_size>;
+
+    static void
+    digest(const uint8_t* buf,
+           size_t size,
+           Digest& digest);
+};
+
+}
+
+#endif // YT_MURMUR3_H_
+
+// Local Variables: **
+// mode: c++ **
+// End: **
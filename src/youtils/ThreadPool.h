@@ -23,7 +23,10 @@
 #include "InitializedParam.h"
 #include "wall_timer.h"
 
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <chrono>
 #include <cstring>
 #include <cstdlib>
 #include <memory>
@@ -43,6 +46,47 @@ namespace youtils
 {
 VD_BOOLEAN_ENUM(BarrierTask);
 
+// Scheduling class of a task. Tasks of a single producer are always run in
+// queue order - the priority of the task at the head of a producer's queue
+// decides which producer is served next. Priority classes share the pool by
+// weight (cf. task_priority_weight) so lower ones aren't starved.
+enum class TaskPriority
+{
+    Low,
+    Normal,
+    High,
+};
+
+// Relative share of the dispatches a priority class gets while all classes
+// have tasks queued.
+inline unsigned
+task_priority_weight(const TaskPriority prio)
+{
+    switch (prio)
+    {
+    case TaskPriority::Low:
+        return 1;
+    case TaskPriority::Normal:
+        return 32;
+    case TaskPriority::High:
+        return 1024;
+    }
+
+    return 1;
+}
+
+// Per producer queue statistics. Wait times are measured from the moment a
+// task was added until it was handed to a worker thread.
+struct ThreadPoolQueueStats
+{
+    uint64_t queued = 0;
+    uint64_t max_queued = 0;
+    uint64_t dispatched = 0;
+    uint64_t total_wait_usecs = 0;
+    uint64_t max_wait_usecs = 0;
+    uint32_t weight = 1;
+};
+
 template<typename T>
 struct ThreadPoolTraits
 {};
@@ -187,6 +231,12 @@ public:
         virtual const T&
         getProducerID() const = 0;
 
+        virtual TaskPriority
+        priority() const
+        {
+            return TaskPriority::Normal;
+        }
+
         typedef T Producer_t;
 
         BarrierTask
@@ -222,9 +272,12 @@ public:
         }
 
     private:
+        friend class ThreadPool;
+
         const BarrierTask barrier_;
         mutable volatile boost::uint32_t errors_;
         youtils::wall_timer error_timer_;
+        std::chrono::steady_clock::time_point queued_at_;
 
         uint64_t
         microSecondsSinceLastError_()
@@ -391,10 +444,13 @@ private:
         : public TaskQueue
     {
     public:
-        Queue(ThreadPool* p)
+        Queue(ThreadPool* p,
+              uint32_t weight = 1)
             : p_(p)
             , w_(0)
             , halted_(false)
+            , weight_(weight)
+            , credits_(weight)
         {}
 
         Queue(const Queue&) = delete;
@@ -471,6 +527,16 @@ private:
             }
         }
 
+        // Not halted and the head is not held back by a barrier - whether
+        // its task may run yet (cf. Task::runnable) is left to active().
+        bool
+        ready()
+        {
+            return not halted_ and
+                not this_type::empty() and
+                not (this_type::front().isBarrier() and w_ != 0);
+        }
+
         bool
         gethalted()
         {
@@ -483,12 +549,99 @@ private:
             halted_ = halted;
         }
 
+        // only valid if not empty
+        TaskPriority
+        priority() const
+        {
+            return this_type::front().priority();
+        }
+
+        void
+        enqueued(Task& t)
+        {
+            t.queued_at_ = std::chrono::steady_clock::now();
+            ++stats_.queued;
+            stats_.max_queued = std::max(stats_.max_queued,
+                                         stats_.queued);
+        }
+
+        void
+        dispatched(const Task& t)
+        {
+            using namespace std::chrono;
+
+            const uint64_t usecs =
+                duration_cast<microseconds>(steady_clock::now() -
+                                            t.queued_at_).count();
+            --stats_.queued;
+            ++stats_.dispatched;
+            stats_.total_wait_usecs += usecs;
+            stats_.max_wait_usecs = std::max(stats_.max_wait_usecs,
+                                             usecs);
+        }
+
+        ThreadPoolQueueStats
+        stats() const
+        {
+            ThreadPoolQueueStats s(stats_);
+            s.weight = weight_;
+            return s;
+        }
+
+        void
+        setWeight(uint32_t weight)
+        {
+            VERIFY(weight > 0);
+            weight_ = weight;
+            refill();
+        }
+
+        void
+        refill()
+        {
+            credits_ = weight_;
+        }
+
+        // Returns false once the queue has used up its turn.
+        bool
+        consume_credit()
+        {
+            VERIFY(credits_ > 0);
+            if (--credits_ == 0)
+            {
+                refill();
+                return false;
+            }
+            else
+            {
+                return true;
+            }
+        }
+
+        typedef bi::list_member_hook<bi::link_mode<bi::auto_unlink>> ReadyHook;
+
+        // managed by ThreadPool::update_ready_
+        ReadyHook ready_hook_;
+        TaskPriority ready_priority_ = TaskPriority::Normal;
+
     private:
         ThreadPool* p_;
         uint32_t w_; // # of tasks being processed
         bool halted_;
+        // # of consecutive round robin turns this queue gets
+        uint32_t weight_;
+        uint32_t credits_;
+        ThreadPoolQueueStats stats_;
     };
 
+    // Queues with a task that might be dispatched, by the priority of their
+    // head task and in round robin order.
+    typedef bi::list<Queue,
+                     bi::member_hook<Queue,
+                                     typename Queue::ReadyHook,
+                                     &Queue::ready_hook_>,
+                     bi::constant_time_size<false>> ReadyList;
+
 public:
     typedef Queue QueueType;
     typedef QueueType* QueueTypePtr;
@@ -501,9 +654,10 @@ public:
                                 pt)
         , num_threads(pt)
         , stop_(false)
-        , queueIt_(taskQueues_.begin())
         , currentTasks_(num_threads.value())
     {
+        priority_deficits_.fill(0);
+
         try
         {
             LOCK_QUEUES();
@@ -520,7 +674,6 @@ public:
     void
     init_()
     {
-        queueIt_ = taskQueues_.begin();
         VERIFY(runnables_.empty());
         VERIFY(threads_.empty());
 
@@ -573,48 +726,85 @@ public:
             throw fungi::IOException("Can't add task: ThreadPool is stopping");
         }
 
-        QueueIterator_t it = taskQueues_.find(t->getProducerID());
-        if(it == taskQueues_.end())
-        {
-            QueueTypePtr theNewQueue = new QueueType(this);
-            theNewQueue->push_back(*t);
-            taskQueues_[t->getProducerID()] = theNewQueue;
-            queueIt_ = taskQueues_.begin();
-        }
-        else
-        {
-            it->second->push_back(*t);
-        }
+        QueueTypePtr q = get_or_create_queue_(t->getProducerID());
+        q->push_back(*t);
+        q->enqueued(*t);
+        update_ready_(*q);
+
         LOG_TRACE("Scheduled task " << t->getName());
 
         queues_cond_var_.notify_one();
     }
 
+    // Each priority class serves its ready queues round robin; a queue gets
+    // as many consecutive turns as its weight. Priority classes are picked by
+    // smooth weighted round robin over the classes with a runnable queue (each
+    // gets its weight added to its deficit, the one with the highest deficit
+    // is served and pays the sum of the weights), so higher ones are served
+    // most of the time but lower ones still make progress.
+    // Only the ready lists are looked at, so the cost of a dispatch does not
+    // grow with the number of idle queues - merely queues whose head task is
+    // backing off after an error are skipped.
     Task *
     getTaskInt(ThreadPoolRunnable* tpr)
     {
         boost::unique_lock<lock_type> l(queues_lock_);
 
-        Task* t = 0;
-        QueueIterator_t it = queueIt_;
+        std::array<QueueTypePtr, num_priorities_> candidates;
+        candidates.fill(nullptr);
+
+        for (size_t i = 0; i < num_priorities_; ++i)
+        {
+            ReadyList& ready = ready_queues_[i];
+            typename ReadyList::iterator it = ready.begin();
 
-        if (not taskQueues_.empty() and
-            not it->second->active())
+            while (it != ready.end())
+            {
+                QueueType& q = *it++;
+                if (q.active())
+                {
+                    if (static_cast<size_t>(q.priority()) == i)
+                    {
+                        candidates[i] = &q;
+                        break;
+                    }
+                    else
+                    {
+                        // active() moved another task to the head
+                        update_ready_(q);
+                    }
+                }
+            }
+        }
+
+        int64_t total = 0;
+        size_t pick = 0;
+        bool picked = false;
+
+        for (size_t i = 0; i < num_priorities_; ++i)
         {
-            do
+            if (candidates[i] == nullptr)
+            {
+                priority_deficits_[i] = 0;
+            }
+            else
             {
-                ++it;
-                if (it == taskQueues_.end())
+                const int64_t w =
+                    task_priority_weight(static_cast<TaskPriority>(i));
+                priority_deficits_[i] += w;
+                total += w;
+
+                // ties go to the higher priority
+                if (not picked or
+                    priority_deficits_[i] >= priority_deficits_[pick])
                 {
-                    it=taskQueues_.begin();
+                    pick = i;
+                    picked = true;
                 }
             }
-            while(it!=queueIt_ and
-                  not it->second->active());
         }
 
-        if(taskQueues_.empty() or
-           not it->second->active())
+        if (not picked)
         {
             LOG_TRACE("No task for the wicked, going to sleep");
             uint64_t usecs =
@@ -626,14 +816,23 @@ public:
         }
         else
         {
-            ++queueIt_;
-            if(queueIt_ == taskQueues_.end())
+            priority_deficits_[pick] -= total;
+
+            QueueType& q = *candidates[pick];
+
+            Task* t = &q.front();
+            q.pop_front();
+            q.dispatched(*t);
+            q.addW();
+
+            if (not q.consume_credit())
             {
-                queueIt_ = taskQueues_.begin();
+                // turn's over, back to the end of the line
+                q.ready_hook_.unlink();
             }
-            t = &it->second->front();
-            it->second->pop_front();
-            it->second->addW();
+
+            update_ready_(q);
+
             LOG_TRACE("Returning task " << t->getName());
 
             LOCK_CURRENT_TASKS();
@@ -668,6 +867,7 @@ public:
                 throw fungi::IOException("No such queue");
             }
             it->second->setHalted(true);
+            update_ready_(*it->second);
         }
 
         while(tasksRunning(id))
@@ -698,7 +898,6 @@ public:
                 }
                 delete it->second;
                 taskQueues_.erase(id);
-                queueIt_ = taskQueues_.begin();
             }
         }
         while(tasksRunning(id))
@@ -756,7 +955,6 @@ public:
                 }
                 delete it->second;
                 taskQueues_.erase(it->first);
-                queueIt_ = taskQueues_.end();
             }
         }
         stop_ = true;
@@ -823,6 +1021,39 @@ public:
         return it->second->size();
     }
 
+    // The weight sticks to the queue until it is stopped.
+    void
+    setWeight(const T& queue,
+              uint32_t weight)
+    {
+        if (weight == 0)
+        {
+            throw fungi::IOException("Queue weight must be > 0");
+        }
+
+        LOCK_QUEUES();
+
+        if (stop_)
+        {
+            throw fungi::IOException("Can't set weight: ThreadPool is stopping");
+        }
+
+        get_or_create_queue_(queue)->setWeight(weight);
+    }
+
+    ThreadPoolQueueStats
+    getQueueStats(const T& queue)
+    {
+        LOCK_QUEUES();
+
+        QueueIterator_t it = taskQueues_.find(queue);
+        if(it == taskQueues_.end())
+        {
+            return ThreadPoolQueueStats();
+        }
+        return it->second->stats();
+    }
+
     bool
     noTasksPresent(const T& queue)
     {
@@ -882,6 +1113,7 @@ public:
             throw fungi::IOException("Queue gone");
         }
         it->second->removeW();
+        update_ready_(*it->second);
     }
 
     void
@@ -930,10 +1162,55 @@ public:
                 q->push_back(*t);
             }
         }
-        it->second->removeW();
+        q->enqueued(*t);
+        q->removeW();
+        update_ready_(*q);
     }
 
 private:
+    // Keeps the queue on the ready list of its head task's priority while it
+    // is ready; a queue that drops off forfeits the rest of its turn.
+    // queues_lock_ must be held.
+    void
+    update_ready_(QueueType& q)
+    {
+        const bool ready = q.ready();
+
+        if (q.ready_hook_.is_linked())
+        {
+            if (ready and q.ready_priority_ == q.priority())
+            {
+                return;
+            }
+
+            q.ready_hook_.unlink();
+            q.refill();
+        }
+
+        if (ready)
+        {
+            q.ready_priority_ = q.priority();
+            ready_queues_[static_cast<size_t>(q.ready_priority_)].push_back(q);
+        }
+    }
+
+    // queues_lock_ must be held
+    QueueTypePtr
+    get_or_create_queue_(const T& id)
+    {
+        QueueIterator_t it = taskQueues_.find(id);
+        if(it == taskQueues_.end())
+        {
+            QueueTypePtr theNewQueue = new QueueType(this);
+            taskQueues_[id] = theNewQueue;
+            return theNewQueue;
+        }
+        else
+        {
+            return it->second;
+        }
+    }
+
     //    const std::string name_;
     typename traits::number_of_threads_type num_threads;
 
@@ -953,8 +1230,13 @@ private:
 
     bool stop_;
 
-    //INVARIANT: (queueIt_ == taskQueues_.end()) => taskQueue.empty()
-    QueueIterator_t queueIt_;
+    static constexpr size_t num_priorities_ =
+        static_cast<size_t>(TaskPriority::High) + 1;
+
+    std::array<ReadyList, num_priorities_> ready_queues_;
+
+    // smooth weighted round robin over the priority classes, cf. getTaskInt
+    std::array<int64_t, num_priorities_> priority_deficits_;
     std::vector<Task*> currentTasks_;
 
     DECLARE_LOGGER("ThreadPool");
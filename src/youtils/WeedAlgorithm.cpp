@@ -0,0 +1,107 @@
+// Copyright (C) 2016 iNuron NV
+//
+// This file is part of Open vStorage Open Source Edition (OSE),
+// as available from
+//
+//      http://www.openvstorage.org and
+//      http://www.openvstorage.com.
+//
+// This file is free software; you can redistribute it and/or modify it
+// under the terms of the GNU Affero General Public License v3 (GNU AGPLv3)
+// as published by the Free Software Foundation, in version 3 as it comes in
+// the LICENSE.txt file of the Open vStorage OSE distribution.
+// Open vStorage is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY of any kind.
+
+#include "Assert.h"
+#include "Murmur3.h"
+#include "StreamUtils.h"
+#include "WeedAlgorithm.h"
+
+#include <iostream>
+
+#include <boost/bimap.hpp>
+
+namespace youtils
+{
+
+namespace
+{
+
+void
+reminder(WeedAlgorithm) __attribute__((unused));
+
+void
+reminder(WeedAlgorithm a)
+{
+    switch (a)
+    {
+    case WeedAlgorithm::Md5:
+    case WeedAlgorithm::Murmur3_128:
+        // If the compiler yells at you that you've forgotten dealing with an enum
+        // value here chances are that it's also missing from the translations map
+        // and from make_weed below. If so add it NOW.
+        break;
+    }
+}
+
+using TranslationsMap = boost::bimap<WeedAlgorithm, std::string>;
+
+TranslationsMap
+init_translations()
+{
+    const std::vector<TranslationsMap::value_type> initv{
+        { WeedAlgorithm::Md5, "Md5" },
+        { WeedAlgorithm::Murmur3_128, "Murmur3_128" },
+    };
+
+    return TranslationsMap(initv.begin(),
+                           initv.end());
+}
+
+}
+
+Weed
+make_weed(const WeedAlgorithm algo,
+          const uint8_t* buf,
+          const size_t size)
+{
+    switch (algo)
+    {
+    case WeedAlgorithm::Md5:
+        return Weed(buf,
+                    size);
+    case WeedAlgorithm::Murmur3_128:
+        return Weed(buf,
+                    size,
+                    Murmur3Traits());
+    }
+
+    UNREACHABLE;
+}
+
+std::ostream&
+operator<<(std::ostream& os,
+           const WeedAlgorithm a)
+{
+    static const TranslationsMap translations(init_translations());
+    return StreamUtils::stream_out(translations.left,
+                                   os,
+                                   a);
+}
+
+std::istream&
+operator>>(std::istream& is,
+           WeedAlgorithm& a)
+{
+    static const TranslationsMap translations(init_translations());
+    return StreamUtils::stream_in(translations.right,
+                                  is,
+                                  a);
+}
+
+}
+
+// Local Variables: **
+// mode: c++ **
+// End: **
@@ -0,0 +1,60 @@
+// Copyright (C) 2016 iNuron NV
+//
+// This file is part of Open vStorage Open Source Edition (OSE),
+// as available from
+//
+//      http://www.openvstorage.org and
+//      http://www.openvstorage.com.
+//
+// This file is free software; you can redistribute it and/or modify it
+// under the terms of the GNU Affero General Public License v3 (GNU AGPLv3)
+// as published by the Free Software Foundation, in version 3 as it comes in
+// the LICENSE.txt file of the Open vStorage OSE distribution.
+// Open vStorage is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY of any kind.
+
+#ifndef YT_WEED_ALGORITHM_H_
+#define YT_WEED_ALGORITHM_H_
+
+#include "Md5.h"
+
+#include <iosfwd>
+#include <cstdint>
+
+namespace youtils
+{
+
+// Algorithm used to compute the Weed (content hash) of a cluster. The weed is
+// only computed when data is written and is an opaque key from then on (TLogs,
+// metadata, content based cluster cache), so weeds of different algorithms
+// can coexist - a volume can switch to another one without invalidating
+// anything but (content based) deduplication against data written with the
+// previous one.
+// The values are persisted, so don't change them.
+enum class WeedAlgorithm
+    : uint8_t
+{
+    Md5 = 0,
+    Murmur3_128 = 1,
+};
+
+Weed
+make_weed(const WeedAlgorithm algo,
+          const uint8_t* buf,
+          const size_t size);
+
+std::ostream&
+operator<<(std::ostream&,
+           const WeedAlgorithm);
+
+std::istream&
+operator>>(std::istream&,
+           WeedAlgorithm&);
+
+}
+
+#endif // !YT_WEED_ALGORITHM_H_
+
+// Local Variables: **
+// mode: c++ **
+// End: **
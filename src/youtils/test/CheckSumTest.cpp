@@ -47,9 +47,51 @@ public:
                                         size);
     }
 
+    static uint32_t
+    crc32c_hw(uint32_t crc,
+              const void* data,
+              size_t size)
+    {
+        return yt::CheckSum::crc32c_hw_(crc,
+                                        data,
+                                        size);
+    }
+
+    static uint32_t
+    crc32c_hw_3way(uint32_t crc,
+                   const void* data,
+                   size_t size)
+    {
+        return yt::CheckSum::crc32c_hw_3way_(crc,
+                                             data,
+                                             size);
+    }
+
 protected:
     DECLARE_LOGGER("CheckSumTest");
 
+    using Fun = uint32_t (*)(uint32_t, const void*, size_t);
+
+    static std::vector<std::pair<const char*, Fun>>
+    implementations()
+    {
+        std::vector<std::pair<const char*, Fun>> funs;
+        funs.emplace_back("sw", &crc32c_sw);
+
+#ifndef __clang__
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("sse4.2"))
+        {
+            funs.emplace_back("hw", &crc32c_hw);
+            if (__builtin_cpu_supports("pclmul"))
+            {
+                funs.emplace_back("hw_3way", &crc32c_hw_3way);
+            }
+        }
+#endif
+        return funs;
+    }
+
     template<typename T,
              typename Traits = CheckSumTraits<T>>
     void
@@ -358,6 +400,70 @@ TEST_F(CheckSumTest, perf)
     perftest(cs);
 }
 
+TEST_F(CheckSumTest, implementations_agree)
+{
+    const auto funs(implementations());
+
+    // large enough for several rounds of the long interleaved blocks, plus
+    // room for misaligning the start
+    std::vector<uint8_t> buf(3 * 3 * 8192 + 3 * 256 + 64);
+    for (size_t i = 0; i < buf.size(); ++i)
+    {
+        buf[i] = (i * 7919) ^ (i >> 8);
+    }
+
+    const std::vector<size_t> sizes { 0, 1, 7, 8, 9, 255, 256, 767, 768, 769,
+            4096, 3 * 8192 - 1, 3 * 8192, 3 * 8192 + 3 * 256 + 5,
+            buf.size() - 64 };
+
+    for (size_t off = 0; off < 16; ++off)
+    {
+        for (const auto size : sizes)
+        {
+            const uint32_t exp = crc32c_sw(~0U,
+                                           buf.data() + off,
+                                           size);
+            for (const auto& f : funs)
+            {
+                EXPECT_EQ(exp,
+                          f.second(~0U,
+                                   buf.data() + off,
+                                   size)) << f.first << ": offset " << off <<
+                    ", size " << size;
+            }
+        }
+    }
+}
+
+TEST_F(CheckSumTest, throughput)
+{
+    const size_t size = yt::System::get_env_with_default<size_t>("CHECKSUM_BUFFER_SIZE",
+                                                                 1ULL << 20);
+    const uint64_t count = yt::System::get_env_with_default<uint64_t>("ITERATIONS",
+                                                                      256);
+
+    const std::vector<uint8_t> buf(size, 0xab);
+
+    for (const auto& f : implementations())
+    {
+        uint32_t crc = ~0U;
+        yt::wall_timer w;
+
+        for (uint64_t i = 0; i < count; ++i)
+        {
+            crc = f.second(crc,
+                           buf.data(),
+                           buf.size());
+        }
+
+        const double t = w.elapsed();
+
+        std::cout << f.first << ": " << count << " x " << size << " bytes took " <<
+            t << " seconds => " << (count * size / t / 1e9) << " GB/s (" <<
+            std::hex << crc << std::dec << ")" << std::endl;
+    }
+}
+
 TEST_F(CheckSumTest, known_values)
 {
     const std::string numbers("1234567890");
@@ -199,6 +199,41 @@ TEST_F(FileUtilsTest, copy)
     EXPECT_EQ(content, read);
 }
 
+TEST_F(FileUtilsTest, copy_with_checksum)
+{
+    const std::string content("some content");
+
+    const fs::path a = FileUtils::create_temp_file_in_temp_dir("a");
+    ALWAYS_CLEANUP_FILE(a);
+    FileUtils::safe_write(content.data(),
+                          content.size(),
+                          a);
+
+    EXPECT_EQ(content.size(), fs::file_size(a));
+
+    CheckSum cs;
+    cs.update(content.data(), content.size());
+
+    EXPECT_EQ(cs, FileUtils::calculate_checksum(a));
+
+    const fs::path b = FileUtils::create_temp_file_in_temp_dir("b");
+    ALWAYS_CLEANUP_FILE(b);
+    fs::remove(b);
+
+    EXPECT_THROW(FileUtils::safe_copy(a,
+                                      b,
+                                      CheckSum(1)),
+                 FileUtils::CopyCheckSumMismatchException);
+
+    EXPECT_FALSE(fs::exists(b));
+
+    FileUtils::safe_copy(a,
+                         b,
+                         cs);
+
+    EXPECT_EQ(cs, FileUtils::calculate_checksum(b));
+}
+
 }
 // Local Variables: **
 // End: **
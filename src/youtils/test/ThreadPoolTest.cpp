@@ -479,6 +479,29 @@ std::list<int> TestTask::ran;
 std::vector<int> TestTask::by;
 boost::mutex *TestTask::m;
 
+class PriorityTestTask
+    : public TestTask
+{
+public:
+    PriorityTestTask(int i,
+                     int producer,
+                     TaskPriority prio)
+        : TestTask(i,
+                   0,
+                   producer)
+        , prio_(prio)
+    {}
+
+    virtual TaskPriority
+    priority() const
+    {
+        return prio_;
+    }
+
+private:
+    const TaskPriority prio_;
+};
+
 class BlockingTask : public ThisThreadPoolType::Task
 {
 public:
@@ -1086,6 +1109,131 @@ TEST_F(TestThreadPool,fairness3)
     check(1, 2);
 }
 
+TEST_F(TestThreadPool, priorities)
+{
+    ThisThreadPoolType tp(1);
+    boost::mutex m;
+    m.lock();
+
+    tp.addTask(new BlockingTask(m, 1000));
+    sleep(1);
+
+    for (int i = 0; i < 10; ++i)
+    {
+        tp.addTask(new PriorityTestTask(i, 0, TaskPriority::Low));
+    }
+
+    for (int i = 10; i < 20; ++i)
+    {
+        tp.addTask(new PriorityTestTask(i, 1, TaskPriority::Normal));
+    }
+
+    tp.addTask(new PriorityTestTask(20, 2, TaskPriority::High));
+
+    m.unlock();
+    sleep(1);
+
+    std::list<int> expected;
+    expected.push_back(20);
+    for (int i = 10; i < 20; ++i)
+    {
+        expected.push_back(i);
+    }
+    for (int i = 0; i < 10; ++i)
+    {
+        expected.push_back(i);
+    }
+
+    EXPECT_TRUE(expected == TestTask::ran);
+}
+
+TEST_F(TestThreadPool, low_priority_is_not_starved)
+{
+    ThisThreadPoolType tp(1);
+    boost::mutex m;
+    m.lock();
+
+    tp.addTask(new BlockingTask(m, 1000));
+    sleep(1);
+
+    const int normal = 100;
+
+    for (int i = 1; i <= normal; ++i)
+    {
+        tp.addTask(new PriorityTestTask(i, 1, TaskPriority::Normal));
+    }
+
+    tp.addTask(new PriorityTestTask(0, 0, TaskPriority::Low));
+
+    m.unlock();
+    sleep(1);
+
+    ASSERT_EQ(static_cast<size_t>(normal + 1),
+              TestTask::ran.size());
+
+    // Normal still takes precedence ...
+    EXPECT_EQ(1,
+              TestTask::ran.front());
+
+    // ... but Low gets its share instead of waiting for Normal to run dry
+    const auto it = std::find(TestTask::ran.begin(),
+                              TestTask::ran.end(),
+                              0);
+    ASSERT_TRUE(it != TestTask::ran.end());
+
+    const auto pos = std::distance(TestTask::ran.begin(),
+                                   it);
+    EXPECT_GE(task_priority_weight(TaskPriority::Normal) +
+              task_priority_weight(TaskPriority::Low),
+              static_cast<unsigned>(pos));
+}
+
+TEST_F(TestThreadPool, weights_and_stats)
+{
+    ThisThreadPoolType tp(1);
+    boost::mutex m;
+    m.lock();
+
+    tp.addTask(new BlockingTask(m, 1000));
+    sleep(1);
+
+    EXPECT_THROW(tp.setWeight(0, 0),
+                 fungi::IOException);
+
+    tp.setWeight(0, 3);
+
+    for (int i = 0; i < 6; ++i)
+    {
+        tp.addTask(new TestTask(i, 0, 0));
+        tp.addTask(new TestTask(100 + i, 0, 1));
+    }
+
+    const ThreadPoolQueueStats before(tp.getQueueStats(0));
+    EXPECT_EQ(6U, before.queued);
+    EXPECT_EQ(6U, before.max_queued);
+    EXPECT_EQ(0U, before.dispatched);
+    EXPECT_EQ(3U, before.weight);
+
+    m.unlock();
+    sleep(1);
+
+    const std::list<int> expected{ 0, 1, 2, 100, 3, 4, 5, 101, 102, 103, 104, 105 };
+    EXPECT_TRUE(expected == TestTask::ran);
+
+    for (int q = 0; q < 2; ++q)
+    {
+        const ThreadPoolQueueStats stats(tp.getQueueStats(q));
+        EXPECT_EQ(0U, stats.queued);
+        EXPECT_EQ(6U, stats.max_queued);
+        EXPECT_EQ(6U, stats.dispatched);
+        EXPECT_LE(stats.max_wait_usecs, stats.total_wait_usecs);
+        EXPECT_LT(0U, stats.max_wait_usecs);
+    }
+
+    EXPECT_EQ(1U, tp.getQueueStats(1).weight);
+    EXPECT_EQ(0U, tp.getQueueStats(42).dispatched);
+}
+
 TEST_F(TestThreadPool, barriertest1)
 {
     bool ba1 = false, ba2 = false, ba3 = false, ba4 = false, ba5=true;
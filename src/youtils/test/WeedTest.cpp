@@ -17,6 +17,7 @@
 #include "../System.h"
 #include <../wall_timer.h>
 #include "../Md5.h"
+#include "../WeedAlgorithm.h"
 
 #include <fstream>
 #include <sstream>
@@ -231,6 +232,74 @@ TEST_F(WeedTest, performance)
         " seconds => " << (count * buf.size() / (t * 1024 * 1024)) << " MiB/s" << std::endl;
 }
 
+TEST_F(WeedTest, murmur3)
+{
+    const std::string s("The quick brown fox jumps over the lazy dog");
+
+    const Weed w(make_weed(WeedAlgorithm::Murmur3_128,
+                           reinterpret_cast<const uint8_t*>(s.data()),
+                           s.size()));
+
+    EXPECT_EQ(Weed("6c1b07bc7bbc4be347939ac4a93c437a"),
+              w);
+
+    EXPECT_NE(Weed(reinterpret_cast<const uint8_t*>(s.data()),
+                   s.size()),
+              w);
+
+    EXPECT_EQ(Weed(reinterpret_cast<const uint8_t*>(s.data()),
+                   s.size()),
+              make_weed(WeedAlgorithm::Md5,
+                        reinterpret_cast<const uint8_t*>(s.data()),
+                        s.size()));
+}
+
+TEST_F(WeedTest, algorithm_stringification)
+{
+    for (const auto a : { WeedAlgorithm::Md5,
+                          WeedAlgorithm::Murmur3_128 })
+    {
+        std::stringstream ss;
+        ss << a;
+
+        WeedAlgorithm b = a == WeedAlgorithm::Md5 ?
+            WeedAlgorithm::Murmur3_128 :
+            WeedAlgorithm::Md5;
+        ss >> b;
+
+        EXPECT_EQ(a, b);
+    }
+}
+
+// Per-cluster CPU cost of the weed algorithms on the write path.
+TEST_F(WeedTest, algorithm_performance)
+{
+    const uint64_t count = System::get_env_with_default("NUM_WEEDS",
+                                                        1ULL << 16);
+
+    std::vector<uint8_t> buf(4096);
+
+    for (const auto a : { WeedAlgorithm::Md5,
+                          WeedAlgorithm::Murmur3_128 })
+    {
+        wall_timer wt;
+        for (uint64_t i = 0; i < count; ++i)
+        {
+            *reinterpret_cast<uint64_t*>(buf.data()) = i;
+            const Weed w(make_weed(a,
+                                   buf.data(),
+                                   buf.size()));
+            EXPECT_NE(Weed::null(), w);
+        }
+
+        const double t = wt.elapsed();
+
+        std::cout << a << ": " << count << " hashes of 4k clusters took " << t <<
+            " seconds => " << (t * 1e9 / count) << " ns / cluster, " <<
+            (count * buf.size() / (t * 1024 * 1024)) << " MiB/s" << std::endl;
+    }
+}
+
 TEST_F(WeedTest, from_stream)
 {
     const std::string s("MdFive");